@@ -372,36 +372,41 @@ QByteArray getRgbUid(const MSO::OfficeArtDggContainer &dgg, quint32 pib, quint32
     return QByteArray();
 }
 
+QByteArray createPicture(KoStore *store, KoXmlWriter *manifest, const MSO::OfficeArtBStoreContainerFileBlock &block, QMap<QByteArray, QString> &fileNames)
+{
+    PictureReference ref = savePicture(block, store);
+
+    if (ref.name.length() == 0) {
+#ifdef DEBUG_PICTURES
+        qDebug() << "Empty picture reference, probably an empty slot";
+#endif
+        return QByteArray();
+    }
+    // check if the MD4 digest is up2date
+    if (block.anon.is<MSO::OfficeArtFBSE>()) {
+        const MSO::OfficeArtFBSE *fbse = block.anon.get<MSO::OfficeArtFBSE>();
+        if (fbse->rgbUid != ref.uid) {
+            ref.uid = fbse->rgbUid;
+        }
+    }
+
+    if (manifest) {
+        manifest->addManifestEntry("Pictures/" + ref.name, ref.mimetype);
+    }
+
+    fileNames[ref.uid] = ref.name;
+    return ref.uid;
+}
+
 QMap<QByteArray, QString> createPictures(KoStore *store, KoXmlWriter *manifest, const QList<MSO::OfficeArtBStoreContainerFileBlock> *rgfb)
 {
-    PictureReference ref;
     QMap<QByteArray, QString> fileNames;
 
     if (!rgfb)
         return fileNames;
 
     foreach (const MSO::OfficeArtBStoreContainerFileBlock &block, *rgfb) {
-        ref = savePicture(block, store);
-
-        if (ref.name.length() == 0) {
-#ifdef DEBUG_PICTURES
-            qDebug() << "Empty picture reference, probably an empty slot";
-#endif
-            continue;
-        }
-        // check if the MD4 digest is up2date
-        if (block.anon.is<MSO::OfficeArtFBSE>()) {
-            const MSO::OfficeArtFBSE *fbse = block.anon.get<MSO::OfficeArtFBSE>();
-            if (fbse->rgbUid != ref.uid) {
-                ref.uid = fbse->rgbUid;
-            }
-        }
-
-        if (manifest) {
-            manifest->addManifestEntry("Pictures/" + ref.name, ref.mimetype);
-        }
-
-        fileNames[ref.uid] = ref.name;
+        createPicture(store, manifest, block, fileNames);
     }
 #ifdef DEBUG_PICTURES
     qDebug() << "fileNames: DEBUG";
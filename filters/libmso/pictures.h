@@ -67,6 +67,15 @@ QByteArray getRgbUid(const MSO::OfficeArtDggContainer &dgg, quint32 pib, quint32
  **/
 QMap<QByteArray, QString> createPictures(KoStore *store, KoXmlWriter *manifest, const QList<MSO::OfficeArtBStoreContainerFileBlock> *rgfb);
 
+/**
+ * Save a single picture into the ODF store and write the appropriate manifest
+ * entry, like createPictures() does for each record of a list.
+ *
+ * @param fileNames map of picture names vs. MD4 digests the picture is added to
+ * @return MD4 digest of the picture or an empty array when an error occurred.
+ **/
+QByteArray createPicture(KoStore *store, KoXmlWriter *manifest, const MSO::OfficeArtBStoreContainerFileBlock &block, QMap<QByteArray, QString> &fileNames);
+
 /**
  * Note: Copied from filters/libkowmf/qwmf.cc, the name is confusing as
  * the method convert the data into BMP and then into QImage
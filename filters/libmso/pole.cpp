@@ -29,7 +29,7 @@
 
 #include "pole.h"
 
-#include <fstream>
+#include <algorithm>
 #include <ios> // for std::hex
 #include <iostream>
 #include <list>
@@ -38,6 +38,7 @@
 #include <vector>
 
 #include <QDebug>
+#include <QFile>
 #include <QList>
 #include <QString>
 
@@ -160,7 +161,8 @@ class StorageIO
 public:
     Storage *storage; // owner
     std::string filename; // filename
-    std::fstream file; // associated with above name
+    QFile file; // associated with above name
+    const unsigned char *mapped; // the whole file mapped into memory, or null
     int result; // result of operation
     bool opened; // true if file is opened
     unsigned long filesize; // size of the file
@@ -217,6 +219,7 @@ public:
     unsigned long tell();
     int getch();
     unsigned long read(unsigned char *data, unsigned long maxlen);
+    const unsigned char *data();
 
 private:
     unsigned long readInternal(unsigned char *data, unsigned long maxlen);
@@ -237,6 +240,11 @@ private:
     unsigned long cache_size;
     unsigned long cache_pos;
     void updateCache();
+
+    // the whole stream, either inside the mapped file or in view_data
+    const unsigned char *view;
+    std::vector<unsigned char> view_data;
+    bool view_checked;
 };
 
 } // namespace POLE
@@ -1180,6 +1188,7 @@ StorageIO::StorageIO(Storage *st, const char *fname)
 {
     storage = st;
     filename = fname;
+    mapped = nullptr;
     result = Storage::Ok;
     opened = false;
 
@@ -1222,19 +1231,21 @@ void StorageIO::load()
 
     // open the file, check for error
     result = Storage::OpenFailed;
-    file.open(filename.c_str(), std::ios::binary | std::ios::in);
-    if (!file.good())
+    file.setFileName(QFile::decodeName(filename.c_str()));
+    if (!file.open(QIODevice::ReadOnly))
         return;
 
     // find size of input file
-    file.seekg(0, std::ios::end);
-    filesize = file.tellg();
+    filesize = file.size();
+
+    // map the whole file, blocks are then copied straight out of memory
+    // instead of with one seek and read each; if mapping is not possible
+    // (e.g. some network file systems), fall back to reading the file
+    mapped = file.map(0, filesize);
 
     // load header
     buffer = new unsigned char[OLE_HEADER_SIZE];
-    file.seekg(0);
-    file.read((char *)buffer, OLE_HEADER_SIZE);
-    if (!file.good()) {
+    if (!file.seek(0) || file.read((char *)buffer, OLE_HEADER_SIZE) != OLE_HEADER_SIZE) {
         delete[] buffer;
         return;
     }
@@ -1369,8 +1380,8 @@ void StorageIO::create()
 {
     // std::cout << "Creating " << filename << std::endl;
 
-    file.open(filename.c_str(), std::ios::out | std::ios::binary);
-    if (!file.good()) {
+    file.setFileName(QFile::decodeName(filename.c_str()));
+    if (!file.open(QIODevice::WriteOnly)) {
         qCritical() << Q_FUNC_INFO << "Can't create file:" << filename.c_str();
         result = Storage::OpenFailed;
         return;
@@ -1395,6 +1406,10 @@ void StorageIO::close()
     if (!opened)
         return;
 
+    if (mapped) {
+        file.unmap(const_cast<unsigned char *>(mapped));
+        mapped = nullptr;
+    }
     file.close();
     opened = false;
 
@@ -1437,7 +1452,7 @@ unsigned long StorageIO::loadBigBlocks(const unsigned long *blocks, unsigned blo
     // sentinel
     if (!data)
         return 0;
-    if (!file.good())
+    if (!file.isOpen())
         return 0;
     if (!blocks)
         return 0;
@@ -1446,19 +1461,30 @@ unsigned long StorageIO::loadBigBlocks(const unsigned long *blocks, unsigned blo
     if (maxlen == 0)
         return 0;
 
-    // read block one by one, seems fast enough
+    // copy runs of consecutive blocks at once, streams are mostly stored contiguously
     unsigned long bytes = 0;
-    for (unsigned long i = 0; (i < blockCount) && (bytes < maxlen); i++) {
+    unsigned long i = 0;
+    while ((i < blockCount) && (bytes < maxlen)) {
         unsigned long block = blocks[i];
+        unsigned long run = 1;
+        while ((i + run < blockCount) && (blocks[i + run] == block + run) && (run * bbat->blockSize < maxlen - bytes))
+            run++;
         unsigned long pos = bbat->blockSize * (block + 1);
-        unsigned long p = (bbat->blockSize < maxlen - bytes) ? bbat->blockSize : maxlen - bytes;
+        if (pos > filesize)
+            return 0;
+        unsigned long p = (run * bbat->blockSize < maxlen - bytes) ? run * bbat->blockSize : maxlen - bytes;
         if (pos + p > filesize)
             p = filesize - pos;
-        file.seekg(pos);
-        file.read((char *)data + bytes, p);
-        if (!file.good())
-            return 0;
+        if (mapped) {
+            memcpy(data + bytes, mapped + pos, p);
+        } else {
+            if (!file.seek(pos))
+                return 0;
+            if (file.read((char *)data + bytes, p) != qint64(p))
+                return 0;
+        }
         bytes += p;
+        i += run;
     }
 
     return bytes;
@@ -1469,7 +1495,7 @@ unsigned long StorageIO::loadBigBlock(unsigned long block, unsigned char *data,
     // sentinel
     if (!data)
         return 0;
-    if (!file.good())
+    if (!file.isOpen())
         return 0;
 
     return loadBigBlocks(&block, 1, data, maxlen);
@@ -1486,7 +1512,7 @@ unsigned long StorageIO::loadSmallBlocks(const unsigned long *blocks, unsigned b
     // sentinel
     if (!data)
         return 0;
-    if (!file.good())
+    if (!file.isOpen())
         return 0;
     if (!blocks)
         return 0;
@@ -1495,6 +1521,28 @@ unsigned long StorageIO::loadSmallBlocks(const unsigned long *blocks, unsigned b
     if (maxlen == 0)
         return 0;
 
+    if (mapped) {
+        // copy straight out of the mapped file
+        unsigned long bytes = 0;
+        for (unsigned long i = 0; (i < blockCount) && (bytes < maxlen); i++) {
+            unsigned long pos = blocks[i] * sbat->blockSize;
+            unsigned long bbindex = pos / bbat->blockSize;
+            if (bbindex >= sb_blocks.size())
+                break;
+
+            unsigned long filepos = bbat->blockSize * (sb_blocks[bbindex] + 1);
+            if (filepos + bbat->blockSize > filesize)
+                return 0;
+
+            unsigned offset = pos % bbat->blockSize;
+            unsigned long p = (maxlen - bytes < bbat->blockSize - offset) ? maxlen - bytes : bbat->blockSize - offset;
+            p = (sbat->blockSize < p) ? sbat->blockSize : p;
+            memcpy(data + bytes, mapped + filepos + offset, p);
+            bytes += p;
+        }
+        return bytes;
+    }
+
     // our own local buffer
     unsigned char *buf = new unsigned char[bbat->blockSize];
 
@@ -1533,7 +1581,7 @@ unsigned long StorageIO::loadSmallBlock(unsigned long block, unsigned char *data
     // sentinel
     if (!data)
         return 0;
-    if (!file.good())
+    if (!file.isOpen())
         return 0;
 
     return loadSmallBlocks(&block, 1, data, maxlen);
@@ -1550,6 +1598,9 @@ StreamIO::StreamIO(StorageIO *s, DirEntry *e)
 
     m_pos = 0;
 
+    view = nullptr;
+    view_checked = false;
+
     if (entry->size >= io->header->threshold) {
         blocks = io->bbat->follow(entry->start, fail);
     } else {
@@ -1585,6 +1636,12 @@ int StreamIO::getch()
     if (m_pos > entry->size)
         return -1;
 
+    if (view) {
+        if (m_pos == entry->size)
+            return -1;
+        return view[m_pos++];
+    }
+
     // need to update cache ?
     if (!cache_size || (m_pos < cache_pos) || (m_pos >= cache_pos + cache_size))
         updateCache();
@@ -1607,6 +1664,22 @@ unsigned long StreamIO::read(unsigned char *data, unsigned long maxlen)
     if (maxlen == 0)
         return 0;
 
+    if (view) {
+        if (m_pos >= entry->size)
+            return 0;
+        const unsigned long count = std::min(entry->size - m_pos, maxlen);
+        memcpy(data, view + m_pos, count);
+        m_pos += count;
+        return count;
+    }
+
+    // large reads bypass the cache, so contiguous blocks are copied at once
+    if (maxlen >= base_cache_size && entry->size >= io->header->threshold) {
+        if (m_pos >= entry->size)
+            return 0;
+        return readInternal(data, std::min(entry->size - m_pos, maxlen));
+    }
+
     unsigned long totalbytes = 0;
 
     while (totalbytes < maxlen) {
@@ -1666,20 +1739,29 @@ unsigned long StreamIO::readInternal(unsigned long pos, unsigned char *data, uns
 
         unsigned char buf[4096];
         unsigned long offset = pos % io->bbat->blockSize;
-        while (totalbytes < maxlen) {
-            if (index >= blocks.size())
-                break;
+        if (offset) {
+            // the start of the first block is skipped
             unsigned long r = io->loadBigBlock(blocks[index], &buf[0], io->bbat->blockSize);
             if (r != io->bbat->blockSize) {
                 return 0;
             }
             unsigned long count = io->bbat->blockSize - offset;
-            if (count > maxlen - totalbytes)
-                count = maxlen - totalbytes;
-            memcpy(data + totalbytes, &buf[0] + offset, count);
+            if (count > maxlen)
+                count = maxlen;
+            memcpy(data, &buf[0] + offset, count);
             totalbytes += count;
             index++;
-            offset = 0;
+        }
+        if (totalbytes < maxlen && index < blocks.size()) {
+            // the remaining blocks are loaded directly into the destination
+            unsigned long remaining = maxlen - totalbytes;
+            unsigned long count = std::min<unsigned long>(blocks.size() - index, (remaining + io->bbat->blockSize - 1) / io->bbat->blockSize);
+            unsigned long r = io->loadBigBlocks(&blocks[index], count, data + totalbytes, remaining);
+            unsigned long expected = std::min(remaining, count * io->bbat->blockSize);
+            if (r != expected) {
+                return 0;
+            }
+            totalbytes += r;
         }
     }
 
@@ -1693,6 +1775,38 @@ unsigned long StreamIO::readInternal(unsigned char *data, unsigned long maxlen)
     return bytes;
 }
 
+const unsigned char *StreamIO::data()
+{
+    if (view_checked)
+        return view;
+    view_checked = true;
+
+    if (fail || entry->size == 0)
+        return nullptr;
+
+    if (io->mapped && entry->size >= io->header->threshold) {
+        // a stream stored in consecutive blocks can be used right from the mapped file
+        const unsigned long blockSize = io->bbat->blockSize;
+        unsigned long count = (entry->size + blockSize - 1) / blockSize;
+        bool contiguous = count <= blocks.size();
+        for (unsigned long i = 1; contiguous && i < count; i++)
+            contiguous = blocks[i] == blocks[0] + i;
+        if (contiguous && blockSize * (blocks[0] + 1) + entry->size <= io->filesize) {
+            view = io->mapped + blockSize * (blocks[0] + 1);
+            return view;
+        }
+    }
+
+    // otherwise read the whole stream once
+    view_data.resize(entry->size);
+    if (readInternal(0, &view_data[0], entry->size) != entry->size) {
+        std::vector<unsigned char>().swap(view_data);
+        return nullptr;
+    }
+    view = &view_data[0];
+    return view;
+}
+
 void StreamIO::updateCache()
 {
     // sanity check
@@ -1803,6 +1917,11 @@ unsigned long Stream::read(unsigned char *data, unsigned long maxlen)
     return io ? io->read(data, maxlen) : 0;
 }
 
+const unsigned char *Stream::data()
+{
+    return io ? io->data() : nullptr;
+}
+
 bool Stream::eof()
 {
     return io ? io->eof : false;
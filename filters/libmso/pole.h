@@ -144,6 +144,16 @@ public:
      **/
     unsigned long read(unsigned char *data, unsigned long maxlen);
 
+    /**
+     * Returns the whole content of the stream, size() bytes, or null on error.
+     *
+     * If the stream is stored in consecutive blocks of the memory mapped file
+     * nothing is copied, otherwise the stream is read once. Subsequent calls to
+     * read() and getch() are served from this data as well. It stays valid until
+     * the stream is destroyed or the storage is closed.
+     **/
+    const unsigned char *data();
+
     /**
      * Returns true if the read/write position is past the file.
      **/
@@ -72,7 +72,13 @@ KoFilter::ConversionStatus KoOdfExporter::convert(const QByteArray &from, const
         return KoFilter::FileNotFound;
     }
     debugMsooXml << "created outputStore.";
-    KoOdfWriteStore oasisStore(outputStore.get());
+
+    return writeOdfDocument(outputStore.get(), to);
+}
+
+KoFilter::ConversionStatus KoOdfExporter::writeOdfDocument(KoStore *outputStore, const QByteArray &to)
+{
+    KoOdfWriteStore oasisStore(outputStore);
 
     debugMsooXml << "created oasisStore.";
 
@@ -107,7 +113,7 @@ KoFilter::ConversionStatus KoOdfExporter::convert(const QByteArray &from, const
     bodyWriter.startElement("office:body");
     bodyWriter.startElement(d->bodyContentElement.constData());
 
-    RETURN_IF_ERROR(createDocument(outputStore.get(), &writers))
+    RETURN_IF_ERROR(createDocument(outputStore, &writers))
 
     // save the office:automatic-styles & and fonts in content.xml
     mainStyles.saveOdfStyles(KoGenStyles::FontFaceDecls, &contentWriter);
@@ -143,7 +149,7 @@ KoFilter::ConversionStatus KoOdfExporter::convert(const QByteArray &from, const
     // create the manifest file
     KoXmlWriter *realManifestWriter = oasisStore.manifestWriter(to);
     // create the styles.xml file
-    mainStyles.saveOdfStylesDotXml(outputStore.get(), realManifestWriter);
+    mainStyles.saveOdfStylesDotXml(outputStore, realManifestWriter);
     realManifestWriter->addManifestEntry("content.xml", "text/xml");
     realManifestWriter->addCompleteElement(&manifestBuf);
 
@@ -155,7 +161,7 @@ KoFilter::ConversionStatus KoOdfExporter::convert(const QByteArray &from, const
         return KoFilter::CreationError;
     }
 
-    KoStoreDevice settingsDev(outputStore.get());
+    KoStoreDevice settingsDev(outputStore);
     KoXmlWriter *settings = KoOdfWriteStore::createOasisXmlWriter(&settingsDev, "office:document-settings");
     settings->startElement("office:settings");
     settings->startElement("config:config-item-set");
@@ -175,7 +181,7 @@ KoFilter::ConversionStatus KoOdfExporter::convert(const QByteArray &from, const
     if (!outputStore->open("meta.xml")) {
         return KoFilter::CreationError;
     }
-    KoStoreDevice metaDev(outputStore.get());
+    KoStoreDevice metaDev(outputStore);
     KoXmlWriter *meta = KoOdfWriteStore::createOasisXmlWriter(&metaDev, "office:document-meta");
     meta->startElement("office:meta");
     meta->addCompleteElement(&buf);
@@ -79,6 +79,13 @@ protected:
      */
     virtual void writeConfigurationSettings(KoXmlWriter *settings) const = 0;
 
+    /**
+     * Writes the complete ODF document of mime type @a to into @a outputStore.
+     * Called by convert() for the output file of the filter chain; filters which
+     * fill the output document themselves can use it to create an intermediate store.
+     */
+    KoFilter::ConversionStatus writeOdfDocument(KoStore *outputStore, const QByteArray &to);
+
 private:
     class Private;
     Private *d;
@@ -78,6 +78,11 @@ void MsooXmlImport::writeConfigurationSettings(KoXmlWriter *settings) const
     settings->endElement();
 }
 
+QString MsooXmlImport::inputFile() const
+{
+    return m_chain->inputFile();
+}
+
 KoFilter::ConversionStatus MsooXmlImport::createDocument(KoStore *outputStore, KoOdfWriters *writers)
 {
     debugMsooXml << "######################## start ####################";
@@ -85,13 +90,13 @@ KoFilter::ConversionStatus MsooXmlImport::createDocument(KoStore *outputStore, K
     //! @todo show this message in error details in the GUI:
     QString errorMessage;
 
-    KZip *zip = new KZip(m_chain->inputFile());
+    KZip *zip = new KZip(inputFile());
     debugMsooXml << "Store created";
 
     QTemporaryFile *tempFile = nullptr;
 
     if (!zip->open(QIODevice::ReadOnly)) {
-        errorMessage = i18n("Could not open the requested file %1", m_chain->inputFile());
+        errorMessage = i18n("Could not open the requested file %1", inputFile());
         //! @todo transmit the error to the GUI...
         debugMsooXml << errorMessage;
         delete zip;
@@ -99,7 +104,7 @@ KoFilter::ConversionStatus MsooXmlImport::createDocument(KoStore *outputStore, K
         // If the file can't be opened by the zip, it may be a
         // password protected file.  In OOXML, this is stored as a
         // standard OLE file with some special streams.
-        QString inputFilename = m_chain->inputFile();
+        QString inputFilename = inputFile();
         if (isPasswordProtectedFile(inputFilename)) {
             if ((tempFile = tryDecryptFile(inputFilename))) {
                 zip = new KZip(tempFile->fileName());
@@ -114,7 +119,7 @@ KoFilter::ConversionStatus MsooXmlImport::createDocument(KoStore *outputStore, K
     }
 
     if (!zip->directory()) {
-        errorMessage = i18n("Could not read ZIP directory of the requested file %1", m_chain->inputFile());
+        errorMessage = i18n("Could not read ZIP directory of the requested file %1", inputFile());
         //! @todo transmit the error to the GUI...
         debugMsooXml << errorMessage;
         delete zip;
@@ -718,6 +723,20 @@ KoFilter::ConversionStatus MsooXmlImport::loadAndParseDocument(MsooXmlReader *re
     return status;
 }
 
+KoFilter::ConversionStatus MsooXmlImport::loadDocumentData(const QString &path, QByteArray &data, QString &errorMessage)
+{
+    if (!m_zip) {
+        return KoFilter::UsageError;
+    }
+    KoFilter::ConversionStatus status;
+    std::unique_ptr<QIODevice> device(Utils::openDeviceForFile(m_zip, errorMessage, path, status));
+    if (!device) {
+        return status;
+    }
+    data = device->readAll();
+    return KoFilter::OK;
+}
+
 KoFilter::ConversionStatus MsooXmlImport::loadAndParseFromDevice(MsooXmlReader *reader, QIODevice *device, MsooXmlReaderContext *context)
 {
     KoFilter::ConversionStatus status;
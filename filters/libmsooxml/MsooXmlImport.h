@@ -60,6 +60,12 @@ public:
     //! of the importing process, i.e. not from within parseParts().
     KoFilter::ConversionStatus loadAndParseDocument(MsooXmlReader *reader, const QString &path, QString &errorMessage, MsooXmlReaderContext *context = nullptr);
 
+    //! Reads the uncompressed content of the file @a path of the input archive into @a data,
+    //! e.g. to parse it more than once without inflating it again.
+    //! KoFilter::UsageError is returned if this method is called outside
+    //! of the importing process, i.e. not from within parseParts().
+    KoFilter::ConversionStatus loadDocumentData(const QString &path, QByteArray &data, QString &errorMessage);
+
     //! Loads a file from a device
     KoFilter::ConversionStatus loadAndParseFromDevice(MsooXmlReader *reader, QIODevice *device, MsooXmlReaderContext *context);
 
@@ -91,6 +97,10 @@ public:
 protected:
     KoFilter::ConversionStatus createDocument(KoStore *outputStore, KoOdfWriters *writers) override;
 
+    //! @return the name of the file to import, by default the input file of the filter chain.
+    //! Reimplemented to run the filter without a filter chain, e.g. in tests.
+    virtual QString inputFile() const;
+
     void writeConfigurationSettings(KoXmlWriter *settings) const override;
 
     bool isPasswordProtectedFile(QString &filename);
@@ -906,6 +906,7 @@ KoXmlWriter *Utils::XmlWriteBuffer::releaseWriter()
     if (!m_newWriter || !m_origWriter) {
         return nullptr;
     }
+    m_newWriter->flush();
     m_origWriter->addCompleteElement(&m_buffer);
     return releaseWriterInternal();
 }
@@ -916,6 +917,7 @@ KoXmlWriter *Utils::XmlWriteBuffer::releaseWriter(QString &bkpXmlSnippet)
     if (!m_newWriter || !m_origWriter) {
         return nullptr;
     }
+    m_newWriter->flush();
     bkpXmlSnippet = QString::fromUtf8(m_buffer.buffer(), m_buffer.buffer().size());
     return releaseWriterInternal();
 }
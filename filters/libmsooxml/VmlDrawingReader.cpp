@@ -121,6 +121,7 @@ KoFilter::ConversionStatus VmlDrawingReader::read_xml()
                 pushCurrentDrawStyle(new KoGenStyle(KoGenStyle::GraphicAutoStyle, "graphic"));
                 createFrameStart();
                 popCurrentDrawStyle();
+                frameWriter.flush();
                 m_frames[m_currentVMLProperties.currentShapeId] = QString::fromUtf8(frameBuf.buffer(), frameBuf.buffer().size()).append(">");
                 body = oldBody; // Body protection ends
                 ++index;
@@ -51,6 +51,7 @@
 #include <sheets/core/odf/SheetsOdf.h>
 #include <sheets/engine/CS_Time.h>
 #include <sheets/engine/CalculationSettings.h>
+#include <sheets/engine/Formula.h>
 #include <sheets/engine/Localization.h>
 #include <sheets/engine/NamedAreaManager.h>
 #include <sheets/engine/ValueConverter.h>
@@ -61,6 +62,7 @@
 
 #include <iostream>
 
+#include "FormulaTranslator.h"
 #include "ImportUtils.h"
 #include "ODrawClient.h"
 #include "conditionals.h"
@@ -105,7 +107,8 @@ class ExcelImport::Private
 {
 public:
     Private(ExcelImport *q)
-        : q(q)
+        : formulaTranslator(nullptr)
+        , q(q)
     {
     }
 
@@ -113,6 +116,7 @@ public:
     Calligra::Sheets::DocBase *outputDoc;
 
     Workbook *workbook;
+    FormulaTranslator *formulaTranslator;
 
     // for embedded shapes
     KoStore *storeout;
@@ -251,6 +255,7 @@ KoFilter::ConversionStatus ExcelImport::convert(const QByteArray &from, const QB
     d->shapesXml = d->beginMemoryXmlWriter("table:shapes");
 
     Calligra::Sheets::Map *map = d->outputDoc->map();
+    d->formulaTranslator = new FormulaTranslator(d->workbook, map->calculationSettings()->locale());
     for (unsigned i = 0; i < d->workbook->sheetCount(); ++i) {
         d->shapesXml->startElement("table:table");
         d->shapesXml->addAttribute("table:id", i);
@@ -263,6 +268,8 @@ KoFilter::ConversionStatus ExcelImport::convert(const QByteArray &from, const QB
         d->processSheet(sheet, ksheet);
         d->shapesXml->endElement();
     }
+    delete d->formulaTranslator;
+    d->formulaTranslator = nullptr;
 
     // named expressions
     const std::map<std::pair<unsigned, QString>, QString> &namedAreas = d->workbook->namedAreas();
@@ -874,9 +881,17 @@ void ExcelImport::Private::processCell(Cell *ic, Calligra::Sheets::Cell oc)
     const QString formula = ic->formula();
     const bool isFormula = !formula.isEmpty();
     if (isFormula) {
-        const QString nsPrefix = cellFormulaNamespace(formula);
-        const QString decodedFormula = Calligra::Sheets::Odf::decodeFormula('=' + formula, oc.locale(), nsPrefix);
-        oc.setRawUserInput(decodedFormula);
+        QString expression;
+        Calligra::Sheets::Tokens tokens;
+        if (formulaTranslator->translate(ic, &expression, &tokens)) {
+            Calligra::Sheets::Formula f(oc.sheet(), oc);
+            f.setExpression(expression, tokens);
+            oc.setFormula(f);
+        } else {
+            const QString nsPrefix = cellFormulaNamespace(formula);
+            const QString decodedFormula = Calligra::Sheets::Odf::decodeFormula('=' + formula, oc.locale(), nsPrefix);
+            oc.setRawUserInput(decodedFormula);
+        }
     }
 
     int styleId = convertStyle(&ic->format(), formula);
@@ -0,0 +1,432 @@
+/* This file is part of the KDE project
+   SPDX-FileCopyrightText: 2026 Calligra developers
+
+   SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include "FormulaTranslator.h"
+
+#include <QHash>
+#include <QList>
+#include <QLocale>
+
+#include <sheets/engine/Formula.h>
+#include <sheets/engine/Localization.h>
+
+#include "cell.h"
+#include "formulas.h"
+#include "sheet.h"
+#include "workbook.h"
+
+using namespace Swinder;
+using Calligra::Sheets::Token;
+using Calligra::Sheets::Tokens;
+
+namespace
+{
+
+// One token of a translated formula. References keep their decoded positions,
+// they are only turned into text for the cell the formula is set on.
+struct Item {
+    Token::Type type = Token::Unknown;
+    // the text of the token, for anything but references
+    QString text;
+    // the text in the expression, if it differs from the token text
+    QString expression;
+
+    // for references only, the sheet is empty for the sheet of the formula
+    QString sheet;
+    FormulaCellReference first = {};
+    FormulaCellReference last = {};
+    bool isArea = false;
+    // true if the relative parts of the reference are offsets to the formula cell
+    bool offsets = false;
+};
+
+typedef QList<Item> Items;
+
+struct Template {
+    bool valid = false;
+    Items items;
+};
+
+Item operatorItem(const QString &text)
+{
+    Item item;
+    item.type = Token::Operator;
+    item.text = text;
+    return item;
+}
+
+Item valueItem(Token::Type type, const QString &text, const QString &expression = QString())
+{
+    Item item;
+    item.type = type;
+    item.text = text;
+    item.expression = expression;
+    return item;
+}
+
+void appendCell(QString *text, const FormulaCellReference &ref, bool offsets, unsigned row, unsigned column)
+{
+    int r = ref.row;
+    int c = ref.column;
+    if (offsets && ref.rowRelative)
+        r += row;
+    if (offsets && ref.columnRelative)
+        c += column;
+
+    if (!ref.columnRelative)
+        text->append(QLatin1Char('$'));
+    text->append(Cell::columnLabel(qMax(0, c)));
+    if (!ref.rowRelative)
+        text->append(QLatin1Char('$'));
+    text->append(QString::number(qMax(0, r) + 1));
+}
+
+bool needsQuotes(const QString &sheetName)
+{
+    for (const QChar &c : sheetName) {
+        if (!c.isLetterOrNumber())
+            return true;
+    }
+    return false;
+}
+
+// Merge the topmost @p count entries of @p stack into function arguments.
+bool mergeArguments(QList<Items> *stack, unsigned count, Items *result)
+{
+    if (unsigned(stack->count()) < count)
+        return false;
+    const int first = stack->count() - count;
+    for (int i = first; i < stack->count(); ++i) {
+        if (i > first)
+            result->append(operatorItem(QStringLiteral(";")));
+        result->append(stack->at(i));
+    }
+    stack->erase(stack->begin() + first, stack->end());
+    return true;
+}
+
+bool binaryOperator(QList<Items> *stack, const QString &op)
+{
+    if (stack->count() < 2)
+        return false;
+    Items b = stack->takeLast();
+    Items &a = stack->last();
+    a.append(operatorItem(op));
+    a.append(b);
+    return true;
+}
+
+bool functionCall(QList<Items> *stack, const QString &name, unsigned params)
+{
+    Items args;
+    if (!mergeArguments(stack, params, &args))
+        return false;
+    Items call;
+    call.append(valueItem(Token::Identifier, name));
+    call.append(operatorItem(QStringLiteral("(")));
+    call.append(args);
+    call.append(operatorItem(QStringLiteral(")")));
+    stack->append(call);
+    return true;
+}
+
+} // namespace
+
+class FormulaTranslator::Private
+{
+public:
+    const Workbook *workbook;
+    QString decimalSymbol;
+    // translated shared formulas, by the tokens of the group
+    QHash<const FormulaTokens *, Template> sharedFormulas;
+
+    bool translateTokens(const FormulaTokens &tokens, Items *result) const;
+    bool referenceItem(const FormulaToken &token, Item *item) const;
+    void instantiate(const Items &items, unsigned row, unsigned column, QString *expression, Tokens *tokens) const;
+};
+
+bool FormulaTranslator::Private::referenceItem(const FormulaToken &token, Item *item) const
+{
+    const unsigned id = token.id();
+    item->type = Token::Cell;
+    item->isArea = id == FormulaToken::Area || id == FormulaToken::AreaN || id == FormulaToken::Area3d;
+    item->offsets = id == FormulaToken::RefN || id == FormulaToken::AreaN;
+
+    if (id == FormulaToken::Ref3d || id == FormulaToken::Area3d) {
+        if (token.version() != Excel97)
+            return false;
+        const std::vector<QString> &externSheets = workbook->externSheets();
+        const unsigned index = token.externSheetIndex();
+        if (index >= externSheets.size())
+            return false;
+        QString sheet = externSheets[index];
+        if (sheet.length() > 1 && sheet.startsWith(QLatin1Char('\'')) && sheet.endsWith(QLatin1Char('\''))) {
+            sheet = sheet.mid(1, sheet.length() - 2);
+            sheet.replace(QLatin1String("''"), QLatin1String("'"));
+        }
+        // the Sheets tokenizer does not support apostrophes within sheet names
+        if (sheet.contains(QLatin1Char('\'')))
+            return false;
+        item->sheet = sheet;
+    }
+
+    if (item->isArea) {
+        item->type = Token::Range;
+        const std::pair<FormulaCellReference, FormulaCellReference> area = token.areaReference();
+        item->first = area.first;
+        item->last = area.second;
+    } else {
+        item->first = token.cellReference();
+    }
+    return true;
+}
+
+bool FormulaTranslator::Private::translateTokens(const FormulaTokens &tokens, Items *result) const
+{
+    QList<Items> stack;
+
+    for (const FormulaToken &token : tokens) {
+        switch (token.id()) {
+        case FormulaToken::Add:
+            if (!binaryOperator(&stack, QStringLiteral("+")))
+                return false;
+            break;
+        case FormulaToken::Sub:
+            if (!binaryOperator(&stack, QStringLiteral("-")))
+                return false;
+            break;
+        case FormulaToken::Mul:
+            if (!binaryOperator(&stack, QStringLiteral("*")))
+                return false;
+            break;
+        case FormulaToken::Div:
+            if (!binaryOperator(&stack, QStringLiteral("/")))
+                return false;
+            break;
+        case FormulaToken::Power:
+            if (!binaryOperator(&stack, QStringLiteral("^")))
+                return false;
+            break;
+        case FormulaToken::Concat:
+            if (!binaryOperator(&stack, QStringLiteral("&")))
+                return false;
+            break;
+        case FormulaToken::LT:
+            if (!binaryOperator(&stack, QStringLiteral("<")))
+                return false;
+            break;
+        case FormulaToken::LE:
+            if (!binaryOperator(&stack, QStringLiteral("<=")))
+                return false;
+            break;
+        case FormulaToken::EQ:
+            if (!binaryOperator(&stack, QStringLiteral("=")))
+                return false;
+            break;
+        case FormulaToken::GE:
+            if (!binaryOperator(&stack, QStringLiteral(">=")))
+                return false;
+            break;
+        case FormulaToken::GT:
+            if (!binaryOperator(&stack, QStringLiteral(">")))
+                return false;
+            break;
+        case FormulaToken::NE:
+            if (!binaryOperator(&stack, QStringLiteral("<>")))
+                return false;
+            break;
+        case FormulaToken::Union:
+            if (!binaryOperator(&stack, QStringLiteral("~")))
+                return false;
+            break;
+
+        case FormulaToken::UPlus:
+        case FormulaToken::UMinus:
+            if (stack.isEmpty())
+                return false;
+            stack.last().prepend(operatorItem(token.id() == FormulaToken::UPlus ? QStringLiteral("+") : QStringLiteral("-")));
+            break;
+
+        case FormulaToken::Percent:
+            if (stack.isEmpty())
+                return false;
+            stack.last().append(operatorItem(QStringLiteral("%")));
+            break;
+
+        case FormulaToken::Paren:
+            if (stack.isEmpty())
+                return false;
+            stack.last().prepend(operatorItem(QStringLiteral("(")));
+            stack.last().append(operatorItem(QStringLiteral(")")));
+            break;
+
+        case FormulaToken::MissArg:
+            stack.append(Items());
+            break;
+
+        case FormulaToken::String: {
+            QString text = token.value().asString();
+            text.replace(QLatin1Char('"'), QLatin1String("\"\""));
+            stack.append(Items() << valueItem(Token::String, QLatin1Char('"') + text + QLatin1Char('"')));
+            break;
+        }
+
+        case FormulaToken::Bool:
+            // like the Sheets tokenizer, which has no boolean literals
+            stack.append(Items() << valueItem(Token::Identifier, token.value().asBoolean() ? QStringLiteral("TRUE") : QStringLiteral("FALSE")));
+            break;
+
+        case FormulaToken::Integer:
+            stack.append(Items() << valueItem(Token::Integer, QString::number(token.value().asInteger())));
+            break;
+
+        case FormulaToken::Float: {
+            const QString text = QString::number(token.value().asFloat(), 'g', QLocale::FloatingPointShortest).toUpper();
+            if (text.contains(QLatin1Char('.')) || text.contains(QLatin1Char('E'))) {
+                QString expression = text;
+                expression.replace(QLatin1Char('.'), decimalSymbol);
+                stack.append(Items() << valueItem(Token::Float, text, expression));
+            } else {
+                stack.append(Items() << valueItem(Token::Integer, text));
+            }
+            break;
+        }
+
+        case FormulaToken::ErrorCode:
+            stack.append(Items() << valueItem(Token::Error, token.value().asString()));
+            break;
+
+        case FormulaToken::RefErr:
+        case FormulaToken::AreaErr:
+        case FormulaToken::RefErr3d:
+        case FormulaToken::AreaErr3d:
+            stack.append(Items() << valueItem(Token::Error, QStringLiteral("#REF!")));
+            break;
+
+        case FormulaToken::Ref:
+        case FormulaToken::RefN:
+        case FormulaToken::Ref3d:
+        case FormulaToken::Area:
+        case FormulaToken::AreaN:
+        case FormulaToken::Area3d: {
+            Item item;
+            if (!referenceItem(token, &item))
+                return false;
+            stack.append(Items() << item);
+            break;
+        }
+
+        case FormulaToken::Function:
+        case FormulaToken::FunctionVar:
+            // external functions are called by name, see FormulaDecoder::decodeFormula()
+            if (token.functionIndex() == 255 || !token.functionName())
+                return false;
+            if (!functionCall(&stack, QString::fromLatin1(token.functionName()), token.functionParams()))
+                return false;
+            break;
+
+        case FormulaToken::Attr:
+            if (token.attr() & 0x10) { // SUM
+                if (!functionCall(&stack, QStringLiteral("SUM"), 1))
+                    return false;
+            }
+            break;
+
+        case 0:
+        case FormulaToken::MemArea:
+        case FormulaToken::MemErr:
+        case FormulaToken::MemFunc:
+            // only meta data, ignored like in FormulaDecoder::decodeFormula()
+            break;
+
+        default:
+            // defined names, array formulas, data tables, intersections, ...
+            return false;
+        }
+    }
+
+    if (stack.count() != 1)
+        return false;
+    *result = stack.first();
+    return true;
+}
+
+void FormulaTranslator::Private::instantiate(const Items &items, unsigned row, unsigned column, QString *expression, Tokens *tokens) const
+{
+    expression->clear();
+    expression->append(QLatin1Char('='));
+    tokens->reserve(items.count());
+
+    for (const Item &item : items) {
+        const int pos = expression->length() - 1;
+        if (item.type != Token::Cell && item.type != Token::Range) {
+            tokens->append(Token(item.type, item.text, pos));
+            expression->append(item.expression.isEmpty() ? item.text : item.expression);
+            continue;
+        }
+
+        QString text;
+        if (!item.sheet.isEmpty()) {
+            text = item.sheet + QLatin1Char('!');
+            if (needsQuotes(item.sheet))
+                expression->append(QLatin1Char('\'') + item.sheet + QLatin1String("'!"));
+            else
+                expression->append(text);
+        }
+        const int cellStart = text.length();
+        appendCell(&text, item.first, item.offsets, row, column);
+        if (item.isArea) {
+            text.append(QLatin1Char(':'));
+            appendCell(&text, item.last, item.offsets, row, column);
+        }
+        expression->append(QStringView(text).mid(cellStart));
+        tokens->append(Token(item.type, text, pos));
+    }
+}
+
+FormulaTranslator::FormulaTranslator(const Workbook *workbook, const Calligra::Sheets::Localization *locale)
+    : d(new Private)
+{
+    d->workbook = workbook;
+    d->decimalSymbol = locale ? locale->decimalSymbol() : QStringLiteral(".");
+}
+
+FormulaTranslator::~FormulaTranslator()
+{
+    delete d;
+}
+
+bool FormulaTranslator::translate(Cell *cell, QString *expression, Tokens *tokens)
+{
+    const FormulaTokens *cellTokens = cell->formulaTokens();
+    if (!cellTokens)
+        return false;
+
+    // a shared formula is referred to by a single token with the position of its first cell
+    if (cellTokens->size() == 1 && cellTokens->front().id() == FormulaToken::Matrix) {
+        const std::pair<unsigned, unsigned> base = cellTokens->front().baseFormulaRecord();
+        const FormulaTokens *sharedTokens = cell->sheet()->sharedFormula(base.second, base.first);
+        if (!sharedTokens)
+            return false; // an array formula
+
+        QHash<const FormulaTokens *, Template>::iterator it = d->sharedFormulas.find(sharedTokens);
+        if (it == d->sharedFormulas.end()) {
+            Template sharedTemplate;
+            sharedTemplate.valid = d->translateTokens(*sharedTokens, &sharedTemplate.items);
+            it = d->sharedFormulas.insert(sharedTokens, sharedTemplate);
+        }
+        if (!it->valid)
+            return false;
+        d->instantiate(it->items, cell->row(), cell->column(), expression, tokens);
+        return true;
+    }
+
+    Items items;
+    if (!d->translateTokens(*cellTokens, &items))
+        return false;
+    d->instantiate(items, cell->row(), cell->column(), expression, tokens);
+    return true;
+}
@@ -0,0 +1,56 @@
+/* This file is part of the KDE project
+   SPDX-FileCopyrightText: 2026 Calligra developers
+
+   SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+#ifndef FORMULATRANSLATOR_H
+#define FORMULATRANSLATOR_H
+
+#include <QString>
+
+namespace Swinder
+{
+class Cell;
+class Workbook;
+}
+
+namespace Calligra
+{
+namespace Sheets
+{
+class Localization;
+class Tokens;
+}
+}
+
+/**
+ * Translates the parsed formula tokens of sidewinder cells into the expression and the
+ * tokens of a Calligra Sheets formula, so neither the OpenDocument formula text nor the
+ * Sheets expression has to be parsed again.
+ *
+ * Shared formulas are translated once per group, the cells of the group only fill in
+ * their position.
+ */
+class FormulaTranslator
+{
+public:
+    FormulaTranslator(const Swinder::Workbook *workbook, const Calligra::Sheets::Localization *locale);
+    ~FormulaTranslator();
+
+    /**
+     * Translate the formula of @p cell into @p expression and @p tokens.
+     *
+     * Returns false if the formula uses something that is not handled here, e.g. defined
+     * names, array formulas or data tables. The text of the formula has to be used then.
+     */
+    bool translate(Swinder::Cell *cell, QString *expression, Calligra::Sheets::Tokens *tokens);
+
+private:
+    FormulaTranslator(const FormulaTranslator &) = delete;
+    FormulaTranslator &operator=(const FormulaTranslator &) = delete;
+
+    class Private;
+    Private *const d;
+};
+
+#endif // FORMULATRANSLATOR_H
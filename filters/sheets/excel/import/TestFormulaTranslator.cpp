@@ -0,0 +1,316 @@
+/* This file is part of the KDE project
+   SPDX-FileCopyrightText: 2026 Calligra developers
+
+   SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+#include "TestFormulaTranslator.h"
+
+#include <QPoint>
+#include <QTest>
+#include <QtEndian>
+
+#include <cstring>
+
+#include <sheets/core/odf/SheetsOdf.h>
+#include <sheets/engine/Formula.h>
+
+#include "FormulaTranslator.h"
+#include "cell.h"
+#include "formulas.h"
+#include "sheet.h"
+#include "utils.h"
+#include "workbook.h"
+
+using namespace Swinder;
+
+namespace
+{
+
+// The tokens are written as BIFF8 stores them, see [MS-XLS] 2.5.198.
+
+QByteArray u16(int value)
+{
+    QByteArray result;
+    result.append(char(value & 0xff));
+    result.append(char((value >> 8) & 0xff));
+    return result;
+}
+
+QByteArray column(int column, bool rowRelative, bool columnRelative)
+{
+    return u16((column & 0x3fff) | (rowRelative ? 0x8000 : 0) | (columnRelative ? 0x4000 : 0));
+}
+
+QByteArray ptg(unsigned id)
+{
+    return QByteArray(1, char(id));
+}
+
+// For RefN and AreaN, relative rows and columns are offsets to the cell of the formula.
+QByteArray ref(int row, int col, bool rowRelative = true, bool columnRelative = true)
+{
+    return ptg(FormulaToken::Ref) + u16(row) + column(col, rowRelative, columnRelative);
+}
+
+QByteArray refN(int row, int col, bool rowRelative = true, bool columnRelative = true)
+{
+    return ptg(FormulaToken::RefN) + u16(row) + column(col, rowRelative, columnRelative);
+}
+
+QByteArray areaFields(int row1, int col1, int row2, int col2, bool relative)
+{
+    return u16(row1) + u16(row2) + column(col1, relative, relative) + column(col2, relative, relative);
+}
+
+QByteArray area(int row1, int col1, int row2, int col2, bool relative = true)
+{
+    return ptg(FormulaToken::Area) + areaFields(row1, col1, row2, col2, relative);
+}
+
+QByteArray areaN(int row1, int col1, int row2, int col2)
+{
+    return ptg(FormulaToken::AreaN) + areaFields(row1, col1, row2, col2, true);
+}
+
+QByteArray ref3d(int sheet, int row, int col, bool relative = true)
+{
+    return ptg(FormulaToken::Ref3d) + u16(sheet) + u16(row) + column(col, relative, relative);
+}
+
+QByteArray area3d(int sheet, int row1, int col1, int row2, int col2, bool relative = true)
+{
+    return ptg(FormulaToken::Area3d) + u16(sheet) + areaFields(row1, col1, row2, col2, relative);
+}
+
+QByteArray integer(int value)
+{
+    return ptg(FormulaToken::Integer) + u16(value);
+}
+
+QByteArray number(double value)
+{
+    quint64 bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    QByteArray result = ptg(FormulaToken::Float);
+    result.resize(1 + sizeof(bits));
+    qToLittleEndian(bits, result.data() + 1);
+    return result;
+}
+
+QByteArray string(const QByteArray &text)
+{
+    // a short string with 8 bit characters
+    return ptg(FormulaToken::String) + char(text.size()) + char(0) + text;
+}
+
+QByteArray boolean(bool value)
+{
+    return ptg(FormulaToken::Bool) + char(value ? 1 : 0);
+}
+
+QByteArray error(int code)
+{
+    return ptg(FormulaToken::ErrorCode) + char(code);
+}
+
+QByteArray function(const char *name)
+{
+    return ptg(FormulaToken::Function) + u16(FormulaToken::functionIndex(QString::fromLatin1(name)));
+}
+
+QByteArray functionVar(const char *name, int params)
+{
+    return ptg(FormulaToken::FunctionVar) + char(params) + u16(FormulaToken::functionIndex(QString::fromLatin1(name)));
+}
+
+QByteArray attrSum()
+{
+    return ptg(FormulaToken::Attr) + char(0x10) + u16(0);
+}
+
+// a reference to the first cell of a shared or array formula
+QByteArray baseFormula(int row, int col)
+{
+    return ptg(FormulaToken::Matrix) + u16(row) + u16(col);
+}
+
+QByteArray name(int index)
+{
+    return ptg(FormulaToken::Name) + u16(index) + u16(0);
+}
+
+FormulaTokens decode(const QByteArray &bytes)
+{
+    const QByteArray data = u16(bytes.size()) + bytes;
+    return FormulaDecoder().decodeFormula(data.size(), 0, reinterpret_cast<const unsigned char *>(data.constData()), Excel97);
+}
+
+// Decodes formulas to text like the worksheet substream handler does.
+class TextDecoder : public FormulaDecoder
+{
+public:
+    explicit TextDecoder(Sheet *sheet)
+        : m_sheet(sheet)
+    {
+    }
+
+    const std::vector<QString> &externSheets() const override
+    {
+        return m_sheet->workbook()->externSheets();
+    }
+
+    FormulaTokens sharedFormulas(const std::pair<unsigned, unsigned> &formulaCellPos) const override
+    {
+        const FormulaTokens *tokens = m_sheet->sharedFormula(formulaCellPos.second, formulaCellPos.first);
+        return tokens ? *tokens : FormulaTokens();
+    }
+
+private:
+    Sheet *m_sheet;
+};
+
+Sheet *createSheet(Workbook *workbook)
+{
+    // names with spaces or apostrophes are quoted by the globals substream handler
+    workbook->setExternSheets({QStringLiteral("Sheet1"), QStringLiteral("'Other Sheet'"), QStringLiteral("'Q3 Sales'"), QStringLiteral("'It''s'")});
+    Sheet *sheet = new Sheet(workbook);
+    sheet->setName(QStringLiteral("Sheet1"));
+    workbook->appendSheet(sheet);
+    return sheet;
+}
+
+// Compares the translation of the formula of @p cell with the text route of ExcelImport,
+// which decodes the formula to OpenDocument text and that to a Sheets expression.
+void compareTranslation(FormulaTranslator *translator, Cell *cell, bool isShared)
+{
+    TextDecoder decoder(cell->sheet());
+    const QString formula = decoder.decodeFormula(cell->row(), cell->column(), isShared, *cell->formulaTokens());
+    const QString expected = Calligra::Sheets::Odf::decodeFormula(QLatin1Char('=') + formula, nullptr, QStringLiteral("of:"));
+
+    QString expression;
+    Calligra::Sheets::Tokens tokens;
+    QVERIFY(translator->translate(cell, &expression, &tokens));
+    QCOMPARE(expression, expected);
+
+    const Calligra::Sheets::Tokens scanned = Calligra::Sheets::Formula().scan(expected);
+    QVERIFY(scanned.valid());
+    QCOMPARE(tokens.count(), scanned.count());
+    for (int i = 0; i < tokens.count(); ++i) {
+        QCOMPARE(int(tokens[i].type()), int(scanned[i].type()));
+        QCOMPARE(tokens[i].text(), scanned[i].text());
+        QCOMPARE(tokens[i].pos(), scanned[i].pos());
+    }
+}
+
+} // namespace
+
+void TestFormulaTranslator::testTranslate_data()
+{
+    QTest::addColumn<QByteArray>("formula");
+
+    QTest::newRow("integers") << integer(1) + integer(2) + ptg(FormulaToken::Add) + ptg(FormulaToken::Paren) + integer(3) + ptg(FormulaToken::Mul)
+                                     + integer(4) + ptg(FormulaToken::Power) + integer(5) + ptg(FormulaToken::GE);
+    QTest::newRow("numbers") << number(2.5) + number(0.125) + ptg(FormulaToken::Mul) + number(1234.5) + ptg(FormulaToken::UMinus) + ptg(FormulaToken::Sub)
+                                    + integer(50) + ptg(FormulaToken::Percent) + ptg(FormulaToken::Add);
+    QTest::newRow("strings") << string("some text") + string("more") + ptg(FormulaToken::Concat) + string("") + ptg(FormulaToken::NE);
+    QTest::newRow("booleans") << boolean(true) + boolean(false) + functionVar("AND", 2) + boolean(false) + ptg(FormulaToken::EQ);
+    QTest::newRow("errors") << integer(1) + error(0x07) + error(0x2A) + error(0x24) + functionVar("CHOOSE", 4);
+    QTest::newRow("more errors") << error(0x0F) + error(0x17) + ptg(FormulaToken::Add) + error(0x00) + error(0x1D) + ptg(FormulaToken::Div)
+                                        + ptg(FormulaToken::Sub);
+    QTest::newRow("references") << ref(0, 0) + ref(9, 3, false, false) + ptg(FormulaToken::Add) + ref(2, 1, true, false) + ptg(FormulaToken::Sub)
+                                       + ref(7, 27, false, true) + ptg(FormulaToken::LT);
+    QTest::newRow("attr sum") << area(0, 0, 9, 0) + attrSum();
+    QTest::newRow("absolute area") << area(0, 0, 2, 2, false) + functionVar("AVERAGE", 1) + area(3, 1, 5, 1) + functionVar("MAX", 1)
+                                          + ptg(FormulaToken::Add);
+    QTest::newRow("functions") << function("PI") + function("ABS") + ref(0, 1) + integer(2) + functionVar("MAX", 2) + ptg(FormulaToken::Mul);
+    QTest::newRow("nested functions") << ref(0, 0) + integer(0) + ptg(FormulaToken::GT) + string("positive") + area(0, 1, 3, 1) + attrSum()
+                                             + functionVar("IF", 3);
+    QTest::newRow("3d references") << ref3d(0, 0, 0) + ref3d(1, 4, 1, false) + ptg(FormulaToken::Add);
+    QTest::newRow("3d areas") << area3d(2, 0, 0, 4, 1) + attrSum() + area3d(1, 2, 2, 3, 3, false) + functionVar("COUNT", 1) + ptg(FormulaToken::Div);
+}
+
+void TestFormulaTranslator::testTranslate()
+{
+    QFETCH(QByteArray, formula);
+
+    Workbook workbook;
+    Sheet *sheet = createSheet(&workbook);
+    Cell *cell = sheet->cell(2, 4);
+    cell->setFormulaTokens(decode(formula));
+
+    FormulaTranslator translator(&workbook, nullptr);
+    compareTranslation(&translator, cell, false);
+}
+
+void TestFormulaTranslator::testSharedFormula_data()
+{
+    QTest::addColumn<QByteArray>("formula");
+    QTest::addColumn<int>("anchorRow");
+    QTest::addColumn<int>("anchorColumn");
+
+    QTest::newRow("left and above") << refN(0, -1) + refN(-1, 0) + ptg(FormulaToken::Add) << 4 << 2;
+    QTest::newRow("below and right") << refN(2, 0) + refN(0, 3) + ptg(FormulaToken::Mul) << 0 << 0;
+    QTest::newRow("absolute parts") << refN(2, -2, false, true) + refN(-3, 1, true, false) + ptg(FormulaToken::Mul) << 6 << 4;
+    QTest::newRow("area sum") << areaN(-3, -2, 0, -1) + attrSum() << 5 << 3;
+    QTest::newRow("area function") << areaN(-1, 0, 1, 2) + functionVar("AVERAGE", 1) + refN(0, -3) + ptg(FormulaToken::Sub) << 4 << 3;
+    QTest::newRow("3d and relative") << ref3d(1, 0, 0, false) + refN(0, -1) + ptg(FormulaToken::Add) + area3d(2, 1, 1, 2, 2) + attrSum()
+                                            + ptg(FormulaToken::Mul)
+                                     << 1 << 1;
+    QTest::newRow("values") << refN(-1, 0) + number(0.5) + ptg(FormulaToken::Mul) + string("x") + ptg(FormulaToken::Concat) << 10 << 5;
+}
+
+void TestFormulaTranslator::testSharedFormula()
+{
+    QFETCH(QByteArray, formula);
+    QFETCH(int, anchorRow);
+    QFETCH(int, anchorColumn);
+
+    Workbook workbook;
+    Sheet *sheet = createSheet(&workbook);
+    sheet->setSharedFormula(anchorColumn, anchorRow, decode(formula));
+
+    // all cells refer to the first cell of the group, the translation of the group is reused
+    FormulaTranslator translator(&workbook, nullptr);
+    const QList<QPoint> offsets = {QPoint(0, 0), QPoint(0, 3), QPoint(4, 2), QPoint(1, 0), QPoint(0, 0)};
+    for (const QPoint &offset : offsets) {
+        Cell *cell = sheet->cell(anchorColumn + offset.x(), anchorRow + offset.y());
+        cell->setFormulaTokens(decode(baseFormula(anchorRow, anchorColumn)));
+        compareTranslation(&translator, cell, true);
+        if (QTest::currentTestFailed())
+            return;
+    }
+}
+
+void TestFormulaTranslator::testUnsupported()
+{
+    Workbook workbook;
+    Sheet *sheet = createSheet(&workbook);
+    FormulaTranslator translator(&workbook, nullptr);
+    QString expression;
+    Calligra::Sheets::Tokens tokens;
+
+    // defined names
+    Cell *cell = sheet->cell(0, 0);
+    cell->setFormulaTokens(decode(integer(1) + name(1) + ptg(FormulaToken::Add)));
+    QVERIFY(!translator.translate(cell, &expression, &tokens));
+
+    // an array formula refers to its first cell, but there is no shared formula
+    cell = sheet->cell(1, 0);
+    cell->setFormulaTokens(decode(baseFormula(0, 1)));
+    QVERIFY(!translator.translate(cell, &expression, &tokens));
+
+    // the Sheets tokenizer does not support apostrophes within sheet names
+    cell = sheet->cell(2, 0);
+    cell->setFormulaTokens(decode(ref3d(3, 0, 0)));
+    QVERIFY(!translator.translate(cell, &expression, &tokens));
+
+    // a sheet index which is out of range
+    cell = sheet->cell(3, 0);
+    cell->setFormulaTokens(decode(ref3d(7, 0, 0)));
+    QVERIFY(!translator.translate(cell, &expression, &tokens));
+
+    // a formula without a cell formula
+    QVERIFY(!translator.translate(sheet->cell(4, 0), &expression, &tokens));
+}
+
+QTEST_GUILESS_MAIN(TestFormulaTranslator)
@@ -0,0 +1,22 @@
+/* This file is part of the KDE project
+   SPDX-FileCopyrightText: 2026 Calligra developers
+
+   SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+#ifndef TEST_FORMULATRANSLATOR_H
+#define TEST_FORMULATRANSLATOR_H
+
+#include <QObject>
+
+class TestFormulaTranslator : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testTranslate_data();
+    void testTranslate();
+    void testSharedFormula_data();
+    void testSharedFormula();
+    void testUnsupported();
+};
+
+#endif // TEST_FORMULATRANSLATOR_H
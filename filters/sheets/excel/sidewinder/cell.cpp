@@ -18,6 +18,7 @@ Cell::Cell(Sheet *sheet, unsigned column, unsigned row)
     : m_sheet(sheet)
     , m_value(nullptr)
     , m_formula(nullptr)
+    , m_formulaTokens(nullptr)
     , m_note(nullptr)
     , m_format(nullptr)
     , m_row(row)
@@ -33,6 +34,7 @@ Cell::~Cell()
 {
     delete m_value;
     delete m_formula;
+    delete m_formulaTokens;
     delete m_note;
     // m_format is owned and destroyed by the Workbook
 }
@@ -125,6 +127,24 @@ void Cell::setFormula(const QString &formula)
     }
 }
 
+const FormulaTokens *Cell::formulaTokens() const
+{
+    return m_formulaTokens;
+}
+
+void Cell::setFormulaTokens(const FormulaTokens &tokens)
+{
+    if (tokens.empty()) {
+        delete m_formulaTokens;
+        m_formulaTokens = nullptr;
+    } else {
+        if (m_formulaTokens)
+            *m_formulaTokens = tokens;
+        else
+            m_formulaTokens = new FormulaTokens(tokens);
+    }
+}
+
 const Format &Cell::format() const
 {
     static const Format null;
@@ -8,6 +8,7 @@
 #define SWINDER_CELL_H
 
 #include "format.h"
+#include "formulas.h"
 #include "value.h"
 
 #include "generated/simpleParser.h"
@@ -89,6 +90,11 @@ public:
     QString formula() const;
     void setFormula(const QString &formula);
 
+    // Returns the parsed tokens of the formula of this cell, or NULL if there are none. For a cell
+    // which is part of a shared formula they only refer to the tokens in Sheet::sharedFormula().
+    const FormulaTokens *formulaTokens() const;
+    void setFormulaTokens(const FormulaTokens &tokens);
+
     // Returns the format of this cell.
     const Format &format() const;
     void setFormat(const Format *format);
@@ -139,6 +145,7 @@ private:
     Sheet *m_sheet;
     Value *m_value;
     QString *m_formula;
+    FormulaTokens *m_formulaTokens;
     QString *m_note;
     const Format *m_format;
 
@@ -2356,6 +2356,9 @@ bool ExcelReader::load(Workbook *workbook, const char *filename)
         return false;
     }
 
+    // the records are read one by one, let them be copied out of the whole stream
+    stream->data();
+
     unsigned int buffer_size = 65536; // current size of the buffer
     unsigned char *buffer = (unsigned char *)malloc(buffer_size);
     unsigned char small_buffer[128]; // small, fixed size buffer
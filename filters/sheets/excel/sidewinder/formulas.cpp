@@ -1334,6 +1334,61 @@ std::pair<unsigned, QRect> FormulaToken::filterArea3d() const
     return std::make_pair(sheetRef, range);
 }
 
+// Excel97 stores the relative flags in the column, row and column offsets are signed
+static FormulaCellReference readCellReference97(const unsigned char *rowData, const unsigned char *columnData, bool offsets)
+{
+    FormulaCellReference ref;
+    const unsigned column = readU16(columnData);
+    ref.rowRelative = column & 0x8000;
+    ref.columnRelative = column & 0x4000;
+    ref.row = (offsets && ref.rowRelative) ? readS16(rowData) : readU16(rowData);
+    ref.column = (offsets && ref.columnRelative) ? readS8(columnData) : (column & 0x3fff);
+    return ref;
+}
+
+// older versions store the relative flags in the row and use a single byte for the column
+static FormulaCellReference readCellReference95(const unsigned char *rowData, const unsigned char *columnData, bool offsets)
+{
+    FormulaCellReference ref;
+    const unsigned row = readU16(rowData);
+    ref.rowRelative = row & 0x8000;
+    ref.columnRelative = row & 0x4000;
+    ref.row = row & 0x3fff;
+    if (offsets && ref.rowRelative && (ref.row & 0x2000))
+        ref.row -= 0x4000;
+    ref.column = (offsets && ref.columnRelative) ? readS8(columnData) : readU8(columnData);
+    return ref;
+}
+
+FormulaCellReference FormulaToken::cellReference() const
+{
+    const bool offsets = id() == RefN;
+    const unsigned char *data = &d->data[0];
+    if (id() == Ref3d)
+        data += 2;
+
+    if (version() == Excel97)
+        return readCellReference97(data, data + 2, offsets);
+    return readCellReference95(data, data + 2, offsets);
+}
+
+std::pair<FormulaCellReference, FormulaCellReference> FormulaToken::areaReference() const
+{
+    const bool offsets = id() == AreaN;
+    const unsigned char *data = &d->data[0];
+    if (id() == Area3d)
+        data += 2;
+
+    if (version() == Excel97)
+        return std::make_pair(readCellReference97(data, data + 4, offsets), readCellReference97(data + 2, data + 6, offsets));
+    return std::make_pair(readCellReference95(data, data + 4, offsets), readCellReference95(data + 2, data + 5, offsets));
+}
+
+unsigned FormulaToken::externSheetIndex() const
+{
+    return readU16(&d->data[0]);
+}
+
 QString FormulaToken::areaMap(unsigned row, unsigned col)
 {
     unsigned char buf[4];
@@ -18,6 +18,15 @@
 namespace Swinder
 {
 
+// A cell position as stored in a reference token. For RefN and AreaN tokens a row or
+// column that is marked relative holds an offset to the cell of the formula instead.
+struct FormulaCellReference {
+    int row;
+    int column;
+    bool rowRelative;
+    bool columnRelative;
+};
+
 class FormulaToken
 {
 public:
@@ -135,6 +144,13 @@ public:
     QString area3d(const std::vector<QString> &externSheets, unsigned row, unsigned col) const;
     // only when id is Area3d, assumes all references to be absolute
     std::pair<unsigned, QRect> filterArea3d() const;
+
+    // only when id is Ref, RefN or Ref3d, the latter only for Excel97
+    FormulaCellReference cellReference() const;
+    // only when id is Area, AreaN or Area3d, the latter only for Excel97
+    std::pair<FormulaCellReference, FormulaCellReference> areaReference() const;
+    // only when id is Ref3d or Area3d, the index into the extern sheets
+    unsigned externSheetIndex() const;
     // only when id is MemArea
     QString areaMap(unsigned row, unsigned col);
 
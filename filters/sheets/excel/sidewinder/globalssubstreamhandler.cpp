@@ -725,6 +725,7 @@ void GlobalsSubStreamHandler::handleExternSheet(ExternSheetRecord *record)
 
         d->externSheetTable[i] = result;
     }
+    d->workbook->setExternSheets(d->externSheetTable);
 }
 
 void GlobalsSubStreamHandler::handleFilepass(FilepassRecord *record)
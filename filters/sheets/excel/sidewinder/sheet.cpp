@@ -87,6 +87,9 @@ public:
 
     QList<ConditionalFormat *> conditionalFormats;
 
+    // mapping from the position of the first cell to shared formulas
+    std::map<std::pair<unsigned, unsigned>, FormulaTokens> sharedFormulas;
+
     Calligra::Sheets::Filter *autoFilters;
 };
 
@@ -144,6 +147,7 @@ void Sheet::clear()
     // delete all conditional formats
     qDeleteAll(d->conditionalFormats);
     d->conditionalFormats.clear();
+    d->sharedFormulas.clear();
 
     d->name = "Sheet"; // FIXME better name ?
     d->maxRow = 0;
@@ -623,6 +627,17 @@ bool Sheet::isRightToLeft() const
     return d->rightToLeft;
 }
 
+const FormulaTokens *Sheet::sharedFormula(unsigned column, unsigned row) const
+{
+    std::map<std::pair<unsigned, unsigned>, FormulaTokens>::const_iterator it = d->sharedFormulas.find(std::make_pair(row, column));
+    return it != d->sharedFormulas.end() ? &it->second : nullptr;
+}
+
+void Sheet::setSharedFormula(unsigned column, unsigned row, const FormulaTokens &tokens)
+{
+    d->sharedFormulas[std::make_pair(row, column)] = tokens;
+}
+
 #ifdef SWINDER_XLS2RAW
 void Sheet::dumpStats()
 {
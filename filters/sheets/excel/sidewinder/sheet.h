@@ -179,6 +179,11 @@ public:
     void setRightToLeft(bool rtl);
     bool isRightToLeft() const;
 
+    // Returns the tokens of the shared formula whose first cell is at the given position,
+    // or NULL if there is none.
+    const FormulaTokens *sharedFormula(unsigned column, unsigned row) const;
+    void setSharedFormula(unsigned column, unsigned row, const FormulaTokens &tokens);
+
 #ifdef SWINDER_XLS2RAW
     void dumpStats();
 #endif
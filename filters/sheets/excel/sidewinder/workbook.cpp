@@ -23,6 +23,7 @@ public:
     std::vector<Sheet *> sheets;
     QHash<PropertyType, QVariant> properties;
     std::map<std::pair<unsigned, QString>, QString> namedAreas;
+    std::vector<QString> externSheets;
     std::map<unsigned, QList<QRect>> filterRanges;
     int activeTab;
     bool passwordProtected;
@@ -136,6 +137,16 @@ void Workbook::setNamedArea(unsigned sheet, const QString &name, const QString &
     d->namedAreas[std::make_pair(sheet, name)] = formula;
 }
 
+const std::vector<QString> &Workbook::externSheets() const
+{
+    return d->externSheets;
+}
+
+void Workbook::setExternSheets(const std::vector<QString> &externSheets)
+{
+    d->externSheets = externSheets;
+}
+
 QList<QRect> Workbook::filterRanges(unsigned sheet) const
 {
     return d->filterRanges[sheet];
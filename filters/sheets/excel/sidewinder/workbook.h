@@ -13,6 +13,7 @@
 #include <QVariant>
 #include <map>
 #include <string>
+#include <vector>
 
 class KoStore;
 
@@ -101,6 +102,10 @@ public:
     std::map<std::pair<unsigned, QString>, QString> &namedAreas();
     void setNamedArea(unsigned sheet, const QString &name, const QString &formula);
 
+    // the sheet names 3d references in formulas refer to, see FormulaToken::externSheetIndex()
+    const std::vector<QString> &externSheets() const;
+    void setExternSheets(const std::vector<QString> &externSheets);
+
     QList<QRect> filterRanges(unsigned sheet) const;
     QList<QRect> filterRanges(const Sheet *sheet) const;
     void addFilterRange(unsigned sheet, const QRect &range);
@@ -40,9 +40,6 @@ public:
     // mapping from cell position to data tables
     std::map<std::pair<unsigned, unsigned>, DataTableRecord *> dataTables;
 
-    // mapping from cell position to shared formulas
-    std::map<std::pair<unsigned, unsigned>, FormulaTokens> sharedFormulas;
-
     // mapping from object id's to object instances
     std::map<unsigned long, Object *> sharedObjects;
 
@@ -87,8 +84,6 @@ WorksheetSubStreamHandler::~WorksheetSubStreamHandler()
         delete (*it).second;
     // for(std::map<unsigned long, Object*>::iterator it = d->sharedObjects.begin(); it != d->sharedObjects.end(); ++it)
     //     delete (*it).second;
-    // for(std::map<std::pair<unsigned, unsigned>, FormulaTokens*>::iterator it = d->sharedFormulas.begin(); it != d->sharedFormulas.end(); ++it)
-    //     delete it.second.second;
     delete d->lastDrawingObject;
     delete d->lastGroupObject;
     delete d;
@@ -126,8 +121,8 @@ QString WorksheetSubStreamHandler::externNameFromIndex(unsigned index) const
 
 FormulaTokens WorksheetSubStreamHandler::sharedFormulas(const std::pair<unsigned, unsigned> &formulaCellPos) const
 {
-    std::map<std::pair<unsigned, unsigned>, FormulaTokens>::iterator sharedFormula = d->sharedFormulas.find(formulaCellPos);
-    return sharedFormula != d->sharedFormulas.end() ? sharedFormula->second : FormulaTokens();
+    const FormulaTokens *sharedFormula = d->sheet ? d->sheet->sharedFormula(formulaCellPos.second, formulaCellPos.first) : nullptr;
+    return sharedFormula ? *sharedFormula : FormulaTokens();
 }
 
 DataTableRecord *WorksheetSubStreamHandler::tableRecord(const std::pair<unsigned, unsigned> &formulaCellPos) const
@@ -380,6 +375,7 @@ void WorksheetSubStreamHandler::handleFormula(FormulaRecord *record)
         cell->setValue(value);
         if (!formula.isEmpty())
             cell->setFormula(formula);
+        cell->setFormulaTokens(record->tokens());
 
         cell->setFormat(d->globals->convertedFormat(xfIndex));
 
@@ -718,7 +714,7 @@ void WorksheetSubStreamHandler::handleSharedFormula(SharedFormulaRecord *record)
     unsigned row = d->lastFormulaCell->row();
     unsigned column = d->lastFormulaCell->column();
 
-    d->sharedFormulas[std::make_pair(row, column)] = record->tokens();
+    d->sheet->setSharedFormula(column, row, record->tokens());
 
     QString formula = decodeFormula(row, column, true, record->tokens());
     d->lastFormulaCell->setFormula(formula);
@@ -0,0 +1,57 @@
+/*
+ * This file is part of Office 2007 Filters for Calligra
+ *
+ * SPDX-License-Identifier: LGPL-2.1-only
+ *
+ */
+#include "BenchmarkXlsxImport.h"
+
+#include <QTest>
+
+#include "XlsxTestDocument.h"
+
+#include <KLocalizedString>
+
+#include <sheets/engine/FunctionModuleRegistry.h>
+#include <sheets/part/Doc.h>
+#include <sheets/part/Part.h>
+
+using namespace Calligra::Sheets;
+
+void BenchmarkXlsxImport::initTestCase()
+{
+    KLocalizedString::setApplicationDomain("calligrafilters");
+    FunctionModuleRegistry::instance()->loadFunctionModules();
+    QVERIFY(m_tempDir.isValid());
+    QVERIFY(writeXlsxTestDocument(m_tempDir.filePath(QStringLiteral("benchmark.xlsx")), 5000));
+}
+
+void BenchmarkXlsxImport::benchmarkImport_data()
+{
+    QTest::addColumn<bool>("viaOdf");
+
+    // "via ODF" is what CALLIGRA_XLSX_IMPORT_VIA_ODF does, minus writing and reading the
+    // temporary file of the filter chain
+    QTest::newRow("direct") << false;
+    QTest::newRow("via ODF") << true;
+}
+
+void BenchmarkXlsxImport::benchmarkImport()
+{
+    QFETCH(bool, viaOdf);
+
+    const QString fileName = m_tempDir.filePath(QStringLiteral("benchmark.xlsx"));
+    QBENCHMARK {
+        Part part;
+        Doc doc(&part);
+        part.setDocument(&doc);
+        XlsxTestImport import(fileName);
+        QCOMPARE(import.importDocument(&doc,
+                                       "application/vnd.openxmlformats-officedocument.spreadsheetml.sheet",
+                                       "application/vnd.oasis.opendocument.spreadsheet",
+                                       viaOdf),
+                 KoFilter::OK);
+    }
+}
+
+QTEST_MAIN(BenchmarkXlsxImport)
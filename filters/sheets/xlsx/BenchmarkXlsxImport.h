@@ -0,0 +1,25 @@
+/*
+ * This file is part of Office 2007 Filters for Calligra
+ *
+ * SPDX-License-Identifier: LGPL-2.1-only
+ *
+ */
+#ifndef BENCHMARK_XLSXIMPORT_H
+#define BENCHMARK_XLSXIMPORT_H
+
+#include <QObject>
+#include <QTemporaryDir>
+
+class BenchmarkXlsxImport : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void initTestCase();
+    void benchmarkImport_data();
+    void benchmarkImport();
+
+private:
+    QTemporaryDir m_tempDir;
+};
+
+#endif // BENCHMARK_XLSXIMPORT_H
@@ -0,0 +1,110 @@
+/*
+ * This file is part of Office 2007 Filters for Calligra
+ *
+ * SPDX-License-Identifier: LGPL-2.1-only
+ *
+ */
+#include "TestXlsxImport.h"
+
+#include <QTest>
+
+#include "XlsxTestDocument.h"
+
+#include <KLocalizedString>
+
+#include <sheets/core/Cell.h>
+#include <sheets/core/Map.h>
+#include <sheets/core/Sheet.h>
+#include <sheets/core/Style.h>
+#include <sheets/engine/Formula.h>
+#include <sheets/engine/FunctionModuleRegistry.h>
+#include <sheets/engine/Value.h>
+#include <sheets/part/Doc.h>
+#include <sheets/part/Part.h>
+
+using namespace Calligra::Sheets;
+
+static const char xlsxMimeType[] = "application/vnd.openxmlformats-officedocument.spreadsheetml.sheet";
+static const char odsMimeType[] = "application/vnd.oasis.opendocument.spreadsheet";
+
+static QString describe(const Value &value)
+{
+    QString text;
+    QDebug(&text) << value << "format" << int(value.format());
+    return text;
+}
+
+void TestXlsxImport::initTestCase()
+{
+    KLocalizedString::setApplicationDomain("calligrafilters");
+    FunctionModuleRegistry::instance()->loadFunctionModules();
+    QVERIFY(m_tempDir.isValid());
+}
+
+void TestXlsxImport::testDirectImport()
+{
+    const QString fileName = m_tempDir.filePath(QStringLiteral("direct.xlsx"));
+    QVERIFY(writeXlsxTestDocument(fileName, 40));
+
+    Part directPart;
+    Doc directDoc(&directPart);
+    directPart.setDocument(&directDoc);
+    XlsxTestImport directImport(fileName);
+    QCOMPARE(directImport.importDocument(&directDoc, xlsxMimeType, odsMimeType), KoFilter::OK);
+
+    Part odfPart;
+    Doc odfDoc(&odfPart);
+    odfPart.setDocument(&odfDoc);
+    XlsxTestImport odfImport(fileName);
+    QCOMPARE(odfImport.importDocument(&odfDoc, xlsxMimeType, odsMimeType, true), KoFilter::OK);
+
+    QCOMPARE(directDoc.map()->count(), 2);
+    QCOMPARE(odfDoc.map()->count(), 2);
+
+    // the direct cells really got set
+    Sheet *first = dynamic_cast<Sheet *>(directDoc.map()->sheet(0));
+    QVERIFY(first);
+    QCOMPARE(Cell(first, 1, 1).value(), Value(1.5));
+    QCOMPARE(Cell(first, 2, 1).value().asString(), QStringLiteral("Hello"));
+    QCOMPARE(Cell(first, 3, 1).value(), Value(true));
+    QVERIFY(Cell(first, 5, 1).value().isError());
+    QVERIFY(Cell(first, 6, 1).isFormula());
+    QVERIFY(Cell(first, 9, 2).isFormula());
+
+    int formulaCount = 0;
+    for (int index = 0; index < 2; ++index) {
+        Sheet *directSheet = dynamic_cast<Sheet *>(directDoc.map()->sheet(index));
+        Sheet *odfSheet = dynamic_cast<Sheet *>(odfDoc.map()->sheet(index));
+        QVERIFY(directSheet && odfSheet);
+        QCOMPARE(directSheet->sheetName(), odfSheet->sheetName());
+        QCOMPARE(directSheet->usedArea(), odfSheet->usedArea());
+
+        const QRect area = directSheet->usedArea();
+        for (int row = area.top(); row <= area.bottom(); ++row) {
+            for (int column = area.left(); column <= area.right(); ++column) {
+                const Cell direct(directSheet, column, row);
+                const Cell viaOdf(odfSheet, column, row);
+                const QByteArray location = direct.fullName().toUtf8();
+
+                QVERIFY2(direct.value().type() == viaOdf.value().type(), location.constData());
+                QVERIFY2(direct.value().format() == viaOdf.value().format(), location.constData());
+                QVERIFY2(direct.value() == viaOdf.value(),
+                         (location + ": " + describe(direct.value()).toUtf8() + " != " + describe(viaOdf.value()).toUtf8()).constData());
+                QVERIFY2(direct.value().isError() == viaOdf.value().isError(), location.constData());
+                if (direct.value().isError()) {
+                    QCOMPARE(direct.value().errorMessage(), viaOdf.value().errorMessage());
+                }
+                QCOMPARE(direct.userInput(), viaOdf.userInput());
+                QCOMPARE(direct.isFormula(), viaOdf.isFormula());
+                if (direct.isFormula()) {
+                    QCOMPARE(direct.formula().expression(), viaOdf.formula().expression());
+                    ++formulaCount;
+                }
+                QVERIFY2(direct.style() == viaOdf.style(), location.constData());
+            }
+        }
+    }
+    QVERIFY(formulaCount > 0);
+}
+
+QTEST_MAIN(TestXlsxImport)
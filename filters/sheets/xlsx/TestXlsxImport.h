@@ -0,0 +1,24 @@
+/*
+ * This file is part of Office 2007 Filters for Calligra
+ *
+ * SPDX-License-Identifier: LGPL-2.1-only
+ *
+ */
+#ifndef TEST_XLSXIMPORT_H
+#define TEST_XLSXIMPORT_H
+
+#include <QObject>
+#include <QTemporaryDir>
+
+class TestXlsxImport : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void initTestCase();
+    void testDirectImport();
+
+private:
+    QTemporaryDir m_tempDir;
+};
+
+#endif // TEST_XLSXIMPORT_H
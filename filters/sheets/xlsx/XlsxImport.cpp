@@ -17,6 +17,8 @@
 #include "XlsxXmlDocumentReader.h"
 #include "XlsxXmlSharedStringsReader.h"
 #include "XlsxXmlStylesReader.h"
+#include "XlsxXmlWorksheetReader_p.h"
+#include "FormulaParser.h"
 
 #include "MsooXmlThemesReader.h"
 #include <MsooXmlContentTypes.h>
@@ -26,6 +28,7 @@
 
 #include <memory>
 
+#include <QBuffer>
 #include <QColor>
 #include <QFile>
 #include <QFont>
@@ -38,9 +41,19 @@
 #include <KoDocumentInfo.h>
 #include <KoEmbeddedDocumentSaver.h>
 #include <KoFilterChain.h>
+#include <KoOdfReadStore.h>
 #include <KoPageLayout.h>
+#include <KoStore.h>
 #include <KoXmlWriter.h>
 
+#include <sheets/core/Cell.h>
+#include <sheets/core/DocBase.h>
+#include <sheets/core/Map.h>
+#include <sheets/core/Sheet.h>
+#include <sheets/core/odf/SheetsOdf.h>
+#include <sheets/engine/Value.h>
+#include <sheets/engine/ValueConverter.h>
+
 K_PLUGIN_FACTORY_WITH_JSON(XlsxImportFactory, "calligra_filter_xlsx2ods.json", registerPlugin<XlsxImport>();)
 
 Q_LOGGING_CATEGORY(lcXlsxImport, "calligra.filter.xlsx2ods")
@@ -57,9 +70,14 @@ public:
     Private()
         : type(XlsxDocument)
         , macrosEnabled(false)
+        , directSheets(nullptr)
     {
     }
 
+    static KoFilter::ConversionStatus loadDocument(Calligra::Sheets::DocBase *document, QIODevice *device, const QList<Sheet *> &directSheets);
+    static void setDirectCells(Calligra::Sheets::Map *map, const QList<Sheet *> &directSheets);
+    static void setDirectCell(Cell *cell, Calligra::Sheets::Sheet *outputSheet);
+
     const char *mainDocumentContentType() const
     {
         if (type == XlsxMacroDocument)
@@ -71,8 +89,119 @@ public:
 
     XlsxDocumentType type;
     bool macrosEnabled;
+    //! the sheets read for the direct import, nullptr when converting to an ODF file
+    QList<Sheet *> *directSheets;
 };
 
+KoFilter::ConversionStatus XlsxImport::Private::loadDocument(Calligra::Sheets::DocBase *document, QIODevice *device, const QList<Sheet *> &directSheets)
+{
+    std::unique_ptr<KoStore> store(KoStore::createStore(device, KoStore::Read));
+    if (!store || store->bad()) {
+        return KoFilter::StupidError;
+    }
+    KoOdfReadStore odfStore(store.get());
+    QString errorMessage;
+    if (!odfStore.loadAndParse(errorMessage)) {
+        qCWarning(lcXlsxImport) << "Could not parse the intermediate document:" << errorMessage;
+        return KoFilter::ParsingError;
+    }
+    if (!document->loadOdf(odfStore)) {
+        return KoFilter::ParsingError;
+    }
+    KoXmlDocument metaDoc;
+    if (odfStore.loadAndParse("meta.xml", metaDoc, errorMessage)) {
+        document->documentInfo()->loadOasis(metaDoc);
+    }
+
+    if (!directSheets.isEmpty()) {
+        setDirectCells(document->map(), directSheets);
+    }
+
+    document->map()->completeLoading(store.get());
+    return KoFilter::OK;
+}
+
+void XlsxImport::Private::setDirectCells(Calligra::Sheets::Map *map, const QList<Sheet *> &directSheets)
+{
+    // the same state as while the cells in the ODF document got loaded
+    map->setLoading(true);
+    for (int index = 0; index < directSheets.size() && index < map->count(); ++index) {
+        Calligra::Sheets::Sheet *outputSheet = dynamic_cast<Calligra::Sheets::Sheet *>(map->sheet(index));
+        if (!outputSheet) {
+            continue;
+        }
+        for (Cell *cell : directSheets.at(index)->cells()) {
+            if (cell && cell->isDirect) {
+                setDirectCell(cell, outputSheet);
+            }
+        }
+    }
+    map->setLoading(false);
+}
+
+// Does what Calligra::Sheets::Odf::loadCell() would do for the ODF cell the worksheet reader writes otherwise.
+void XlsxImport::Private::setDirectCell(Cell *cell, Calligra::Sheets::Sheet *outputSheet)
+{
+    static const QLatin1String formulaNSPrefixes[] = {QLatin1String("oooc:"), QLatin1String("kspr:"), QLatin1String("of:"), QLatin1String("msoxl:")};
+
+    Calligra::Sheets::Cell outputCell(outputSheet, cell->column + 1, cell->row + 1);
+
+    QString text;
+    if (cell->unescapedText(&text) && !text.isEmpty()) {
+        outputCell.setUserInput(text);
+    }
+
+    bool isFormula = false;
+    if (cell->formula) {
+        QString formula;
+        if (cell->formula->isShared()) {
+            formula = MSOOXML::convertFormulaReference(static_cast<SharedFormula *>(cell->formula)->m_referencedCell, cell);
+        } else {
+            formula = static_cast<FormulaImpl *>(cell->formula)->m_formula;
+        }
+        if (!formula.isEmpty()) {
+            isFormula = true;
+            QString namespacePrefix;
+            for (const QLatin1String &prefix : formulaNSPrefixes) {
+                if (formula.startsWith(prefix)) {
+                    formula.remove(0, prefix.size());
+                    namespacePrefix = prefix;
+                    break;
+                }
+            }
+            outputCell.setUserInput(Calligra::Sheets::Odf::decodeFormula(formula, outputCell.locale(), namespacePrefix));
+        }
+    }
+    if (!isFormula && outputCell.userInput().startsWith(QLatin1Char('='))) {
+        // prepend ' to the text to avoid = to be painted
+        outputCell.setUserInput(outputCell.userInput().prepend(QLatin1Char('\'')));
+    }
+
+    switch (cell->valueType) {
+    case Cell::ConstBoolean:
+        outputCell.setValue(Calligra::Sheets::Value(*cell->valueAttrValue != QLatin1String("0")));
+        break;
+    case Cell::ConstFloat: {
+        bool ok = false;
+        Calligra::Sheets::Value value(cell->valueAttrValue->toDouble(&ok));
+        if (ok) {
+            value.setFormat(Calligra::Sheets::Value::fmt_Number);
+            outputCell.setValue(value);
+        }
+        if (!isFormula) {
+            outputCell.setUserInput(outputSheet->map()->converter()->asString(value).asString());
+        }
+        break;
+    }
+    case Cell::ConstString:
+        outputCell.setValue(Calligra::Sheets::Value(outputCell.userInput()));
+        break;
+    default:
+        outputCell.parseUserInput(outputCell.userInput());
+        break;
+    }
+}
+
 XlsxImport::XlsxImport(QObject *parent, const QVariantList &)
     : MSOOXML::MsooXmlImport(QLatin1String("spreadsheet"), parent)
     , d(new Private)
@@ -84,6 +213,61 @@ XlsxImport::~XlsxImport()
     delete d;
 }
 
+KoFilter::ConversionStatus XlsxImport::convert(const QByteArray &from, const QByteArray &to)
+{
+    if (qEnvironmentVariableIsSet("CALLIGRA_XLSX_IMPORT_VIA_ODF")) {
+        return MSOOXML::MsooXmlImport::convert(from, to);
+    }
+
+    KoDocument *document = m_chain->outputDocument();
+    if (!document) {
+        return KoFilter::StupidError;
+    }
+    Calligra::Sheets::DocBase *outputDoc = qobject_cast<Calligra::Sheets::DocBase *>(document);
+    if (!outputDoc) {
+        qCWarning(lcXlsxImport) << "document isn't a Calligra::Sheets::DocBase but a" << document->metaObject()->className();
+        return KoFilter::WrongFormat;
+    }
+    return importDocument(outputDoc, from, to);
+}
+
+KoFilter::ConversionStatus XlsxImport::importDocument(Calligra::Sheets::DocBase *outputDoc, const QByteArray &from, const QByteArray &to, bool viaOdf)
+{
+    if (!acceptsSourceMimeType(from) || !acceptsDestinationMimeType(to)) {
+        return KoFilter::NotImplemented;
+    }
+    outputDoc->setOutputMimeType(to);
+
+    // The intermediate document is only read again, so compressing it would be wasted time
+    QBuffer storeBuffer;
+    std::unique_ptr<KoStore> store(KoStore::createStore(&storeBuffer, KoStore::Write, to, KoStore::Zip));
+    if (!store || store->bad()) {
+        return KoFilter::StupidError;
+    }
+    store->setCompressionEnabled(false);
+
+    QList<Sheet *> directSheets;
+    d->directSheets = viaOdf ? nullptr : &directSheets;
+    KoFilter::ConversionStatus status = writeOdfDocument(store.get(), to);
+    d->directSheets = nullptr;
+    store.reset();
+    storeBuffer.close();
+
+    if (status == KoFilter::OK) {
+        status = d->loadDocument(outputDoc, &storeBuffer, directSheets);
+    }
+    qDeleteAll(directSheets);
+
+    if (status == KoFilter::OK) {
+        // ensure at least one sheet
+        if (outputDoc->map()->count() == 0) {
+            outputDoc->map()->addNewSheet();
+        }
+        outputDoc->setModified(false);
+    }
+    return status;
+}
+
 bool XlsxImport::acceptsSourceMimeType(const QByteArray &mime) const
 {
     qCDebug(lcXlsxImport) << "Entering XLSX Import filter: from " << mime;
@@ -640,6 +824,7 @@ KoFilter::ConversionStatus XlsxImport::parseParts(KoOdfWriters *writers, MSOOXML
     // 5. parse document
     {
         XlsxXmlDocumentReaderContext context(*this, &themes, sharedStrings, comments, styles, *relationships, "workbook.xml", "xl");
+        context.directSheets = d->directSheets;
         XlsxXmlDocumentReader documentReader(writers);
         RETURN_IF_ERROR(loadAndParseDocument(d->mainDocumentContentType(), &documentReader, writers, errorMessage, &context))
     }
@@ -17,6 +17,14 @@
 #include <MsooXmlImport.h>
 #include <QVariantList>
 
+namespace Calligra
+{
+namespace Sheets
+{
+class DocBase;
+}
+}
+
 //! XLSX to ODS import filter
 class XlsxImport : public MSOOXML::MsooXmlImport
 {
@@ -25,6 +33,22 @@ public:
     XlsxImport(QObject *parent, const QVariantList &);
     ~XlsxImport() override;
 
+    /**
+     * Imports into the Calligra Sheets document of the filter chain. Everything but the
+     * plain cell contents goes through an intermediate ODF document which is loaded into it,
+     * the values and formulas of the cells are set directly.
+     * If the environment variable CALLIGRA_XLSX_IMPORT_VIA_ODF is set, the whole document
+     * is converted to an ODF file instead, e.g. to compare the import times.
+     */
+    KoFilter::ConversionStatus convert(const QByteArray &from, const QByteArray &to) override;
+
+    /**
+     * Imports the file returned by inputFile() into @p outputDoc, as convert() does.
+     * If @p viaOdf is true, the cell contents go through the intermediate ODF document
+     * as well, which is what the direct import is compared against.
+     */
+    KoFilter::ConversionStatus importDocument(Calligra::Sheets::DocBase *outputDoc, const QByteArray &from, const QByteArray &to, bool viaOdf = false);
+
 protected:
     bool acceptsSourceMimeType(const QByteArray &mime) const override;
 
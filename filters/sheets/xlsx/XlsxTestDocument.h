@@ -0,0 +1,152 @@
+/*
+ * This file is part of Office 2007 Filters for Calligra
+ *
+ * SPDX-License-Identifier: LGPL-2.1-only
+ *
+ */
+#ifndef XLSX_TEST_DOCUMENT_H
+#define XLSX_TEST_DOCUMENT_H
+
+#include "XlsxImport.h"
+
+#include <KZip>
+
+#include <QString>
+
+/**
+ * Writes an XLSX file for the import tests and benchmarks. The first sheet has @p rowCount
+ * rows of numbers, shared strings (plain and rich text), booleans, dates, errors, inline
+ * strings, styled cells and formulas, including a shared formula over all rows. The second
+ * sheet refers to the first one from a formula.
+ */
+inline bool writeXlsxTestDocument(const QString &fileName, int rowCount)
+{
+    static const char contentTypes[] =
+        "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\"?>"
+        "<Types xmlns=\"http://schemas.openxmlformats.org/package/2006/content-types\">"
+        "<Default Extension=\"rels\" ContentType=\"application/vnd.openxmlformats-package.relationships+xml\"/>"
+        "<Default Extension=\"xml\" ContentType=\"application/xml\"/>"
+        "<Override PartName=\"/xl/workbook.xml\" ContentType=\"application/vnd.openxmlformats-officedocument.spreadsheetml.sheet.main+xml\"/>"
+        "<Override PartName=\"/xl/worksheets/sheet1.xml\" ContentType=\"application/vnd.openxmlformats-officedocument.spreadsheetml.worksheet+xml\"/>"
+        "<Override PartName=\"/xl/worksheets/sheet2.xml\" ContentType=\"application/vnd.openxmlformats-officedocument.spreadsheetml.worksheet+xml\"/>"
+        "<Override PartName=\"/xl/styles.xml\" ContentType=\"application/vnd.openxmlformats-officedocument.spreadsheetml.styles+xml\"/>"
+        "<Override PartName=\"/xl/sharedStrings.xml\" ContentType=\"application/vnd.openxmlformats-officedocument.spreadsheetml.sharedStrings+xml\"/>"
+        "</Types>";
+    static const char rootRelationships[] =
+        "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\"?>"
+        "<Relationships xmlns=\"http://schemas.openxmlformats.org/package/2006/relationships\">"
+        "<Relationship Id=\"rId1\" Type=\"http://schemas.openxmlformats.org/officeDocument/2006/relationships/officeDocument\" Target=\"xl/workbook.xml\"/>"
+        "</Relationships>";
+    static const char workbook[] =
+        "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\"?>"
+        "<workbook xmlns=\"http://schemas.openxmlformats.org/spreadsheetml/2006/main\" "
+        "xmlns:r=\"http://schemas.openxmlformats.org/officeDocument/2006/relationships\">"
+        "<sheets><sheet name=\"Sheet1\" sheetId=\"1\" r:id=\"rId1\"/><sheet name=\"Other Sheet\" sheetId=\"2\" r:id=\"rId2\"/></sheets>"
+        "</workbook>";
+    static const char workbookRelationships[] =
+        "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\"?>"
+        "<Relationships xmlns=\"http://schemas.openxmlformats.org/package/2006/relationships\">"
+        "<Relationship Id=\"rId1\" Type=\"http://schemas.openxmlformats.org/officeDocument/2006/relationships/worksheet\" Target=\"worksheets/sheet1.xml\"/>"
+        "<Relationship Id=\"rId2\" Type=\"http://schemas.openxmlformats.org/officeDocument/2006/relationships/worksheet\" Target=\"worksheets/sheet2.xml\"/>"
+        "<Relationship Id=\"rId3\" Type=\"http://schemas.openxmlformats.org/officeDocument/2006/relationships/styles\" Target=\"styles.xml\"/>"
+        "<Relationship Id=\"rId4\" Type=\"http://schemas.openxmlformats.org/officeDocument/2006/relationships/sharedStrings\" Target=\"sharedStrings.xml\"/>"
+        "</Relationships>";
+    // 0: default, 1: built-in date format, 2: bold, 3: custom date format
+    static const char styles[] =
+        "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\"?>"
+        "<styleSheet xmlns=\"http://schemas.openxmlformats.org/spreadsheetml/2006/main\">"
+        "<numFmts count=\"1\"><numFmt numFmtId=\"164\" formatCode=\"yyyy\\-mm\\-dd\"/></numFmts>"
+        "<fonts count=\"2\"><font><sz val=\"11\"/><name val=\"Calibri\"/></font><font><b/><sz val=\"11\"/><name val=\"Calibri\"/></font></fonts>"
+        "<fills count=\"2\"><fill><patternFill patternType=\"none\"/></fill><fill><patternFill patternType=\"gray125\"/></fill></fills>"
+        "<borders count=\"1\"><border><left/><right/><top/><bottom/><diagonal/></border></borders>"
+        "<cellStyleXfs count=\"1\"><xf numFmtId=\"0\" fontId=\"0\" fillId=\"0\" borderId=\"0\"/></cellStyleXfs>"
+        "<cellXfs count=\"4\">"
+        "<xf numFmtId=\"0\" fontId=\"0\" fillId=\"0\" borderId=\"0\" xfId=\"0\"/>"
+        "<xf numFmtId=\"14\" fontId=\"0\" fillId=\"0\" borderId=\"0\" xfId=\"0\" applyNumberFormat=\"1\"/>"
+        "<xf numFmtId=\"0\" fontId=\"1\" fillId=\"0\" borderId=\"0\" xfId=\"0\" applyFont=\"1\"/>"
+        "<xf numFmtId=\"164\" fontId=\"0\" fillId=\"0\" borderId=\"0\" xfId=\"0\" applyNumberFormat=\"1\"/>"
+        "</cellXfs>"
+        "<cellStyles count=\"1\"><cellStyle name=\"Normal\" xfId=\"0\" builtinId=\"0\"/></cellStyles>"
+        "</styleSheet>";
+    static const char sharedStrings[] =
+        "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\"?>"
+        "<sst xmlns=\"http://schemas.openxmlformats.org/spreadsheetml/2006/main\" count=\"5\" uniqueCount=\"5\">"
+        "<si><t>Hello</t></si>"
+        "<si><t>=not a formula</t></si>"
+        "<si><t xml:space=\"preserve\">  leading spaces</t></si>"
+        "<si><t>'quoted</t></si>"
+        "<si><r><rPr><b/></rPr><t>bold</t></r><r><t xml:space=\"preserve\"> plain</t></r></si>"
+        "</sst>";
+    static const char otherSheet[] =
+        "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\"?>"
+        "<worksheet xmlns=\"http://schemas.openxmlformats.org/spreadsheetml/2006/main\"><sheetData>"
+        "<row r=\"1\"><c r=\"A1\"><f>Sheet1!A1+1</f><v>2.5</v></c><c r=\"B1\" t=\"s\"><v>0</v></c>"
+        "<c r=\"C1\"><f>SUM(Sheet1!A1:A3)</f><v>9</v></c></row>"
+        "</sheetData></worksheet>";
+
+    QByteArray sheet =
+        "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\"?>"
+        "<worksheet xmlns=\"http://schemas.openxmlformats.org/spreadsheetml/2006/main\"><sheetData>";
+    for (int row = 1; row <= rowCount; ++row) {
+        const QByteArray r = QByteArray::number(row);
+        const QByteArray number = QByteArray::number(row * 1.5);
+        sheet += "<row r=\"" + r + "\">";
+        sheet += "<c r=\"A" + r + "\"><v>" + number + "</v></c>";
+        sheet += "<c r=\"B" + r + "\" t=\"s\"><v>" + QByteArray::number(row % 5) + "</v></c>";
+        sheet += "<c r=\"C" + r + "\" t=\"b\"><v>" + QByteArray::number(row % 2) + "</v></c>";
+        sheet += "<c r=\"D" + r + "\" s=\"1\"><v>" + QByteArray::number(45000 + row) + "</v></c>";
+        sheet += "<c r=\"E" + r + "\" t=\"e\"><v>" + (row % 2 ? "#N/A" : "#DIV/0!") + "</v></c>";
+        sheet += "<c r=\"F" + r + "\"><f>A" + r + "*2</f><v>" + QByteArray::number(row * 3.0) + "</v></c>";
+        sheet += "<c r=\"G" + r + "\" t=\"str\"><f>CONCATENATE(B" + r + ",\"!\")</f><v>text!</v></c>";
+        sheet += "<c r=\"H" + r + "\" t=\"b\"><f>A" + r + "&gt;10</f><v>" + (row * 1.5 > 10 ? "1" : "0") + "</v></c>";
+        if (row == 1) {
+            sheet += "<c r=\"I1\"><f t=\"shared\" ref=\"I1:I" + QByteArray::number(rowCount) + "\" si=\"0\">A1+$A$1</f><v>3</v></c>";
+        } else {
+            sheet += "<c r=\"I" + r + "\"><f t=\"shared\" si=\"0\"/><v>" + QByteArray::number(row * 1.5 + 1.5) + "</v></c>";
+        }
+        sheet += "<c r=\"J" + r + "\" t=\"e\"><f>1/0</f><v>#DIV/0!</v></c>";
+        sheet += "<c r=\"K" + r + "\" s=\"2\"><v>" + r + "</v></c>";
+        sheet += "<c r=\"L" + r + "\" t=\"inlineStr\"><is><t>inline " + r + "</t></is></c>";
+        sheet += "<c r=\"M" + r + "\" s=\"3\"><v>" + QByteArray::number(40000 + row) + ".25</v></c>";
+        sheet += "<c r=\"N" + r + "\" t=\"s\" s=\"2\"><v>0</v></c>";
+        sheet += "</row>";
+    }
+    sheet += "</sheetData></worksheet>";
+
+    KZip zip(fileName);
+    if (!zip.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+    zip.setCompression(KZip::DeflateCompression);
+    const bool ok = zip.writeFile(QStringLiteral("[Content_Types].xml"), QByteArray(contentTypes))
+        && zip.writeFile(QStringLiteral("_rels/.rels"), QByteArray(rootRelationships))
+        && zip.writeFile(QStringLiteral("xl/workbook.xml"), QByteArray(workbook))
+        && zip.writeFile(QStringLiteral("xl/_rels/workbook.xml.rels"), QByteArray(workbookRelationships))
+        && zip.writeFile(QStringLiteral("xl/styles.xml"), QByteArray(styles))
+        && zip.writeFile(QStringLiteral("xl/sharedStrings.xml"), QByteArray(sharedStrings))
+        && zip.writeFile(QStringLiteral("xl/worksheets/sheet1.xml"), sheet)
+        && zip.writeFile(QStringLiteral("xl/worksheets/sheet2.xml"), QByteArray(otherSheet));
+    return zip.close() && ok;
+}
+
+//! Runs the import filter on a file without a filter chain
+class XlsxTestImport : public XlsxImport
+{
+public:
+    explicit XlsxTestImport(const QString &fileName)
+        : XlsxImport(nullptr, QVariantList())
+        , m_fileName(fileName)
+    {
+    }
+
+protected:
+    QString inputFile() const override
+    {
+        return m_fileName;
+    }
+
+private:
+    QString m_fileName;
+};
+
+#endif // XLSX_TEST_DOCUMENT_H
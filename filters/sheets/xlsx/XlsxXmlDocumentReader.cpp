@@ -25,6 +25,8 @@
 #include <MsooXmlUtils.h>
 #include <VmlDrawingReader.h>
 
+#include <QBuffer>
+
 #undef MSOOXML_CURRENT_NS
 #define MSOOXML_CURRENT_CLASS XlsxXmlDocumentReader
 #define BIND_READ_CLASS MSOOXML_CURRENT_CLASS
@@ -47,9 +49,47 @@ XlsxXmlDocumentReaderContext::XlsxXmlDocumentReaderContext(XlsxImport &_import,
     , styles(&_styles)
     , file(_file)
     , path(_path)
+    , directSheets(nullptr)
 {
 }
 
+/*! @return the worksheet part @a data without its sheetData element, or @a data itself
+ if there is none. Parsing this is enough to collect the sections which follow the cells
+ but are needed while reading them, without tokenizing the cells twice. */
+static QByteArray withoutSheetData(const QByteArray &data)
+{
+    const int nameIndex = data.indexOf("sheetData");
+    if (nameIndex < 0) {
+        return data;
+    }
+    // the element may be written with a namespace prefix, e.g. <x:sheetData>
+    const int startIndex = data.lastIndexOf('<', nameIndex);
+    if (startIndex < 0) {
+        return data;
+    }
+    const QByteArray prefix = data.mid(startIndex + 1, nameIndex - startIndex - 1);
+    if (!prefix.isEmpty() && (!prefix.endsWith(':') || prefix.contains('>') || prefix.contains(' '))) {
+        return data;
+    }
+    const int startTagEnd = data.indexOf('>', nameIndex);
+    if (startTagEnd < 0) {
+        return data;
+    }
+    int endIndex;
+    if (data.at(startTagEnd - 1) == '/') {
+        endIndex = startTagEnd + 1;
+    } else {
+        // '<' is always escaped in character data, so this is the end tag
+        const QByteArray endTag = "</" + prefix + "sheetData>";
+        endIndex = data.indexOf(endTag, startTagEnd);
+        if (endIndex < 0) {
+            return data;
+        }
+        endIndex += endTag.size();
+    }
+    return data.left(startIndex) + data.mid(endIndex);
+}
+
 class XlsxXmlDocumentReader::Private
 {
 public:
@@ -327,20 +367,46 @@ KoFilter::ConversionStatus XlsxXmlDocumentReader::read_sheet()
                                           vmlreader.content(),
                                           vmlreader.frames(),
                                           m_context->autoFilters);
-    // Due to some information being available only in the later part of the document, we have to read twice
-    // In the first round we get the later information and in 2nd round we read the rest and use the information
-    context.firstRoundOfReading = true;
-    KoFilter::ConversionStatus status = m_context->import->loadAndParseDocument(&worksheetReader, filepath, &context);
+    context.directCells = m_context->directSheets != nullptr;
+
+    // The part is inflated only once and kept in memory for both rounds of reading
+    QString errorMessage;
+    QByteArray worksheetData;
+    KoFilter::ConversionStatus status = m_context->import->loadDocumentData(filepath, worksheetData, errorMessage);
     if (status != KoFilter::OK) {
-        raiseError(worksheetReader.errorString());
+        raiseError(errorMessage);
         return status;
     }
+    // Due to some information being available only in the later part of the document, we have to read twice
+    // In the first round we get the later information and in 2nd round we read the rest and use the information.
+    // The first round does not need the cells, which make up nearly all of the part, so they are cut out.
+    {
+        QBuffer prescanBuffer;
+        prescanBuffer.setData(withoutSheetData(worksheetData));
+        prescanBuffer.open(QIODevice::ReadOnly);
+        context.firstRoundOfReading = true;
+        worksheetReader.setDevice(&prescanBuffer);
+        worksheetReader.setFileName(filepath); // for error reporting
+        status = worksheetReader.read(&context);
+        if (status != KoFilter::OK) {
+            raiseError(worksheetReader.errorString());
+            return status;
+        }
+    }
+    QBuffer worksheetBuffer(&worksheetData);
+    worksheetBuffer.open(QIODevice::ReadOnly);
     context.firstRoundOfReading = false;
-    status = m_context->import->loadAndParseDocument(&worksheetReader, filepath, &context);
+    worksheetReader.setDevice(&worksheetBuffer);
+    status = worksheetReader.read(&context);
+    worksheetReader.setDevice(nullptr);
     if (status != KoFilter::OK) {
         raiseError(worksheetReader.errorString());
         return status;
     }
+    if (m_context->directSheets) {
+        m_context->directSheets->append(context.sheet);
+        context.sheet = nullptr;
+    }
 
     readNext();
     READ_EPILOGUE
@@ -20,6 +20,7 @@
 class XlsxImport;
 class XlsxComments;
 class XlsxStyles;
+class Sheet;
 
 //! Context for XlsxXmlDocumentReader
 class XlsxXmlDocumentReaderContext : public MSOOXML::MsooXmlReaderContext
@@ -54,6 +55,10 @@ public:
     };
 
     QVector<XlsxXmlDocumentReaderContext::AutoFilter> autoFilters;
+
+    //! If set, the cells which can be set directly in the Calligra Sheets map are left out
+    //! of the ODF document, and the read sheets are appended here, in document order.
+    QList<Sheet *> *directSheets;
 };
 
 //! A class reading MSOOXML XLSX markup - workbook.xml part.
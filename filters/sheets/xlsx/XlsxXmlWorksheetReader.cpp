@@ -111,6 +111,7 @@ XlsxXmlWorksheetReaderContext::XlsxXmlWorksheetReaderContext(uint _worksheetNumb
     , oleReplacements(_oleReplacements)
     , oleFrameBegins(_oleBeginFrames)
     , autoFilters(autoFilters)
+    , directCells(false)
 {
 }
 
@@ -366,6 +367,27 @@ void XlsxXmlWorksheetReader::saveAnnotation(int col, int row)
     body->endElement(); // office:annotation
 }
 
+bool XlsxXmlWorksheetReader::canSetDirectly(const Cell *cell, int col, int row) const
+{
+    if (cell->embedded || !cell->charStyleName.isEmpty() || m_context->comments->value(encodeLabelText(col + 1, row + 1))) {
+        return false;
+    }
+    QString text;
+    switch (cell->valueType) {
+    case Cell::ConstNone:
+        return cell->text.isEmpty() && !cell->valueAttrValue;
+    case Cell::ConstString:
+        return cell->valueAttr == Cell::OfficeNone && cell->unescapedText(&text);
+    case Cell::ConstBoolean:
+        return cell->valueAttr == Cell::OfficeBooleanValue && cell->valueAttrValue && cell->unescapedText(&text);
+    case Cell::ConstFloat:
+        return cell->valueAttr == Cell::OfficeValue && cell->valueAttrValue && cell->text.isEmpty();
+    case Cell::ConstDate:
+        break;
+    }
+    return false;
+}
+
 #undef CURRENT_EL
 #define CURRENT_EL chartsheet
 KoFilter::ConversionStatus XlsxXmlWorksheetReader::read_chartsheet()
@@ -656,8 +678,10 @@ KoFilter::ConversionStatus XlsxXmlWorksheetReader::read_sheetHelper(const QStrin
                     if (!cell->styleName.isEmpty()) {
                         body->addAttribute("table:style-name", cell->styleName);
                     }
+                    // the content of these is set later on without the detour through ODF
+                    cell->isDirect = m_context->directCells && !hasHyperlink && canSetDirectly(cell, c, r);
                     // body->addAttribute("table:number-columns-repeated", QByteArray::number(cell->repeated));
-                    if (!hasHyperlink) {
+                    if (!hasHyperlink && !cell->isDirect) {
                         switch (cell->valueType) {
                         case Cell::ConstNone:
                             break;
@@ -676,7 +700,7 @@ KoFilter::ConversionStatus XlsxXmlWorksheetReader::read_sheetHelper(const QStrin
                         }
                     }
 
-                    if (cell->valueAttrValue) {
+                    if (cell->valueAttrValue && !cell->isDirect) {
                         switch (cell->valueAttr) {
                         case Cell::OfficeNone:
                             break;
@@ -697,7 +721,7 @@ KoFilter::ConversionStatus XlsxXmlWorksheetReader::read_sheetHelper(const QStrin
                         }
                     }
 
-                    if (cell->formula) {
+                    if (cell->formula && !cell->isDirect) {
                         QString formula;
                         if (cell->formula->isShared()) {
                             Cell *referencedCell = static_cast<SharedFormula *>(cell->formula)->m_referencedCell;
@@ -720,7 +744,7 @@ KoFilter::ConversionStatus XlsxXmlWorksheetReader::read_sheetHelper(const QStrin
 
                     saveAnnotation(c, r);
 
-                    if (!cell->text.isEmpty() || !cell->charStyleName.isEmpty() || hasHyperlink) {
+                    if (!cell->isDirect && (!cell->text.isEmpty() || !cell->charStyleName.isEmpty() || hasHyperlink)) {
                         body->startElement("text:p", false);
                         if (!cell->charStyleName.isEmpty()) {
                             body->startElement("text:span");
@@ -29,6 +29,7 @@ class XlsxComments;
 class XlsxStyles;
 class XlsxImport;
 class Sheet;
+class Cell;
 
 //! A class reading MSOOXML XLSX markup - xl/worksheets/sheet*.xml part.
 class XlsxXmlWorksheetReader : public MSOOXML::MsooXmlCommonReader
@@ -112,6 +113,9 @@ private:
     void appendTableCells(int cells);
     //! Saves annotation element (comments) for cell specified by @a col and @a row it there is any annotation defined.
     void saveAnnotation(int col, int row);
+    //! @return true if the content of @a cell can be set directly in the Calligra Sheets map
+    //! instead of being written into the ODF document
+    bool canSetDirectly(const Cell *cell, int col, int row) const;
 
     typedef QPair<int, QMap<QString, QString>> Condition;
     QList<Condition> m_conditionalIndices;
@@ -169,6 +173,8 @@ public:
     QVector<XlsxXmlDocumentReaderContext::AutoFilter> &autoFilters;
 
     bool firstRoundOfReading;
+    //! true if cells which can be set directly in the Calligra Sheets map are left out of the ODF document
+    bool directCells;
 
     QList<QMap<QString, QString>> conditionalStyleForPosition(const QString &positionLetter, int positionNumber);
 
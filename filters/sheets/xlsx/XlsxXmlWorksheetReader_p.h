@@ -156,6 +156,46 @@ public:
     ValueAttr valueAttr;
 
     bool isPlainText : 1;
+    //! true if the content is not written into the ODF document but set directly in the Calligra Sheets map
+    bool isDirect : 1;
+
+    /*! Sets @p result to the text without its XML escaping.
+     @return false if the text contains markup, entities other than the predefined ones
+             or white space a text:p element would not keep as it is. */
+    bool unescapedText(QString *result) const
+    {
+        if (text.contains(QLatin1Char('<')) || text.startsWith(QLatin1Char(' ')) || text.endsWith(QLatin1Char(' '))
+            || text.contains(QLatin1String("  ")) || text.contains(QLatin1Char('\t')) || text.contains(QLatin1Char('\n'))
+            || text.contains(QLatin1Char('\r'))) {
+            return false;
+        }
+        if (!text.contains(QLatin1Char('&'))) {
+            *result = text;
+            return true;
+        }
+        static const QLatin1String entities[] =
+            {QLatin1String("&amp;"), QLatin1String("&lt;"), QLatin1String("&gt;"), QLatin1String("&quot;"), QLatin1String("&apos;")};
+        static const QChar characters[] = {QLatin1Char('&'), QLatin1Char('<'), QLatin1Char('>'), QLatin1Char('"'), QLatin1Char('\'')};
+        result->clear();
+        result->reserve(text.size());
+        for (int i = 0; i < text.size(); ++i) {
+            if (text.at(i) != QLatin1Char('&')) {
+                result->append(text.at(i));
+                continue;
+            }
+            const QStringView rest = QStringView(text).mid(i);
+            int entity = 0;
+            while (entity < 5 && !rest.startsWith(entities[entity])) {
+                ++entity;
+            }
+            if (entity == 5) {
+                return false;
+            }
+            result->append(characters[entity]);
+            i += entities[entity].size() - 1;
+        }
+        return true;
+    }
 
     Cell(int columnIndex, int rowIndex)
         : valueAttrValue(nullptr)
@@ -168,6 +208,7 @@ public:
         , valueType(Cell::ConstNone)
         , valueAttr(OfficeNone)
         , isPlainText(true)
+        , isDirect(false)
     {
     }
     ~Cell()
@@ -273,6 +314,12 @@ public:
         return c;
     }
 
+    //! @return the cells of the sheet by their hashed position, may contain null pointers
+    const QHash<unsigned, Cell *> &cells() const
+    {
+        return m_cells;
+    }
+
     int maxRow() const
     {
         return m_maxRow;
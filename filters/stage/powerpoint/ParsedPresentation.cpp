@@ -14,26 +14,45 @@ using namespace MSO;
 namespace
 {
 
-bool readStream(POLE::Storage &storage, const char *streampath, QBuffer &buffer)
+inline quint32 readU32(const void *p)
+{
+    const unsigned char *ptr = (const unsigned char *)p;
+    return ptr[0] + (ptr[1] << 8) + (ptr[2] << 16) + (ptr[3] << 24);
+}
+
+std::string streamPath(POLE::Storage &storage, const char *streampath)
 {
     std::string path(streampath);
     if (storage.isDirectory("PP97_DUALSTORAGE")) {
         debugPpt << "PP97_DUALSTORAGE";
         path = "PP97_DUALSTORAGE" + path;
     }
-    POLE::Stream stream(&storage, path);
+    return path;
+}
+
+bool readStream(POLE::Storage &storage, const char *streampath, QByteArray &array)
+{
+    POLE::Stream stream(&storage, streamPath(storage, streampath));
     if (stream.fail()) {
         debugPpt << "Unable to construct " << streampath << "stream";
         return false;
     }
 
-    QByteArray array;
-    array.resize(stream.size());
-    unsigned long r = stream.read((unsigned char *)array.data(), stream.size());
-    if (r != stream.size()) {
+    const unsigned char *data = stream.data();
+    if (!data && stream.size()) {
         debugPpt << "Error while reading from " << streampath << "stream";
         return false;
     }
+    array = QByteArray(reinterpret_cast<const char *>(data), stream.size());
+    return true;
+}
+
+bool readStream(POLE::Storage &storage, const char *streampath, QBuffer &buffer)
+{
+    QByteArray array;
+    if (!readStream(storage, streampath, array)) {
+        return false;
+    }
     buffer.setData(array);
     buffer.open(QIODevice::ReadOnly);
     return true;
@@ -62,104 +81,149 @@ bool parseCurrentUserStream(POLE::Storage &storage, CurrentUserStream &cus)
     }
     return true;
 }
-bool parsePowerPointStructs(POLE::Storage &storage, PowerPointStructs &pps)
+/**
+ * Find the offsets of the records in @p data, which is a sequence of records
+ * that each start with a RecordHeader.
+ * return false if the last record is truncated.
+ **/
+bool scanRecords(const QByteArray &data, QSet<quint32> &offsets)
+{
+    const quint32 size = data.size();
+    quint32 pos = 0;
+    while (size - pos >= 8) {
+        const quint32 recLen = readU32(data.constData() + pos + 4);
+        if (recLen > size - pos - 8) {
+            return false;
+        }
+        offsets.insert(pos);
+        pos += 8 + recLen;
+    }
+    return pos == size;
+}
+
+bool parseSummaryInformationStream(POLE::Storage &storage, SummaryInformationPropertySetStream &sis)
 {
     QBuffer buffer;
-    if (!readStream(storage, "/PowerPoint Document", buffer)) {
-        return false;
+    if (!readStream(storage, "/SummaryInformation", buffer)) {
+        debugPpt << "Failed to open /SummaryInformation stream, no big deal (OPTIONAL).";
+        return true;
     }
     LEInputStream stream(&buffer);
     try {
-        parsePowerPointStructs(stream, pps);
+        parseSummaryInformationPropertySetStream(stream, sis);
     } catch (const IOException &e) {
-        debugPpt << "caught IOException while parsing PowerPointStructs "
+        debugPpt << "caught IOException while parsing SummaryInformation"
                  << " " << e.msg;
         debugPpt << "stream position: " << stream.getPosition();
         return false;
     } catch (...) {
-        debugPpt << "caught unknown exception while parsing PowerPointStructs";
-        return false;
-    }
-    if (stream.getPosition() != buffer.size()) {
-        debugPpt << (buffer.size() - stream.getPosition()) << "bytes left at the end of PowerPointStructs, so probably an error at position "
-                 << stream.getMaxPosition();
+        debugPpt << "caught unknown exception while parsing SummaryInformation";
         return false;
     }
     return true;
 }
-bool parsePictures(POLE::Storage &storage, PicturesStream &pps)
+
+} // anonymous namespace
+
+ParsedPresentation::~ParsedPresentation()
 {
-    QBuffer buffer;
-    if (!readStream(storage, "/Pictures", buffer)) {
-        debugPpt << "Failed to open /Pictures stream, no big deal (OPTIONAL).";
-        return true;
+    delete picturesStream;
+}
+
+bool ParsedPresentation::parsePicture(quint32 offset, MSO::OfficeArtBStoreContainerFileBlock &block) const
+{
+    if (!picturesStream) {
+        return false;
+    }
+    unsigned char header[8];
+    picturesStream->seek(offset);
+    if (picturesStream->read(header, 8) != 8) {
+        return false;
     }
+    QByteArray data(8 + readU32(header + 4), Qt::Uninitialized);
+    picturesStream->seek(offset);
+    if (picturesStream->read(reinterpret_cast<unsigned char *>(data.data()), data.size()) != (unsigned long)data.size()) {
+        debugPpt << "Error while reading from Pictures stream";
+        return false;
+    }
+    QBuffer buffer(&data);
+    buffer.open(QIODevice::ReadOnly);
     LEInputStream stream(&buffer);
     try {
-        parsePicturesStream(stream, pps);
+        parseOfficeArtBStoreContainerFileBlock(stream, block);
     } catch (const IOException &e) {
         debugPpt << "caught IOException while parsing Pictures "
                  << " " << e.msg;
-        debugPpt << "stream position: " << stream.getPosition();
+        debugPpt << "stream position: " << offset + stream.getPosition();
         return false;
     } catch (...) {
         debugPpt << "caught unknown exception while parsing Pictures";
         return false;
     }
-    if (stream.getPosition() != buffer.size()) {
-        debugPpt << (buffer.size() - stream.getPosition()) << "bytes left at the end of PicturesStream, so probably an error at position "
-                 << stream.getMaxPosition();
-        return false;
-    }
     return true;
 }
 
-bool parseSummaryInformationStream(POLE::Storage &storage, SummaryInformationPropertySetStream &sis)
+const PowerPointStruct *ParsedPresentation::getRecord(quint32 offset) const
 {
-    QBuffer buffer;
-    if (!readStream(storage, "/SummaryInformation", buffer)) {
-        debugPpt << "Failed to open /SummaryInformation stream, no big deal (OPTIONAL).";
-        return true;
+    QMap<quint32, QSharedPointer<PowerPointStruct>>::const_iterator it = records.constFind(offset);
+    if (it != records.constEnd()) {
+        return it->data();
     }
+    if (!recordOffsets.contains(offset) || documentStream.isEmpty()) {
+        return nullptr;
+    }
+    QSharedPointer<PowerPointStruct> record(new PowerPointStruct());
+    QBuffer buffer(const_cast<QByteArray *>(&documentStream));
+    buffer.open(QIODevice::ReadOnly);
+    buffer.seek(offset);
     LEInputStream stream(&buffer);
     try {
-        parseSummaryInformationPropertySetStream(stream, sis);
+        parsePowerPointStruct(stream, *record);
+        // the record has to end where its header says
+        if (stream.getPosition() != offset + 8 + readU32(documentStream.constData() + offset + 4)) {
+            debugPpt << "PowerPointStruct at" << offset << "does not end at the end of its record";
+            record.clear();
+        }
     } catch (const IOException &e) {
-        debugPpt << "caught IOException while parsing SummaryInformation"
+        debugPpt << "caught IOException while parsing PowerPointStruct "
                  << " " << e.msg;
         debugPpt << "stream position: " << stream.getPosition();
-        return false;
+        record.clear();
     } catch (...) {
-        debugPpt << "caught unknown exception while parsing SummaryInformation";
-        return false;
+        debugPpt << "caught unknown exception while parsing PowerPointStruct";
+        record.clear();
     }
-    return true;
+    records.insert(offset, record);
+    return record.data();
 }
 
 /**
- * get the UserEditAtom that is at position @offset in the stream.
+ * get the record of type T that is at position @offset in the stream.
  * return 0 if it is not present.
  **/
 template<typename T>
-const T *get(const PowerPointStructs &pps, quint32 offset)
+const T *ParsedPresentation::get(quint32 offset) const
 {
-    foreach (const PowerPointStruct &p, pps.anon) {
-        if (p.anon.is<T>() && p.anon.get<T>()->streamOffset == offset) {
-            return p.anon.get<T>();
-        } else if (p.anon.is<MasterOrSlideContainer>()) {
-            const MasterOrSlideContainer *m = p.anon.get<MasterOrSlideContainer>();
-            if (m->anon.is<T>() && m->anon.get<T>()->streamOffset == offset) {
-                return m->anon.get<T>();
-            }
+    const PowerPointStruct *p = getRecord(offset);
+    if (!p) {
+        return nullptr;
+    }
+    if (p->anon.is<T>()) {
+        return p->anon.get<T>();
+    } else if (p->anon.is<MasterOrSlideContainer>()) {
+        const MasterOrSlideContainer *m = p->anon.get<MasterOrSlideContainer>();
+        if (m->anon.is<T>()) {
+            return m->anon.get<T>();
         }
     }
     return nullptr;
 }
-void parsePersistDirectory(const PowerPointStructs &pps, const UserEditAtom *userEditAtom, QMap<quint32, quint32> &persistDirectory)
+
+void ParsedPresentation::parsePersistDirectory(const UserEditAtom *userEditAtom)
 {
     if (!userEditAtom)
         return;
-    const PersistDirectoryAtom *persistDirectoryAtom = get<PersistDirectoryAtom>(pps, userEditAtom->offsetPersistDirectory);
+    const PersistDirectoryAtom *persistDirectoryAtom = get<PersistDirectoryAtom>(userEditAtom->offsetPersistDirectory);
     if (!persistDirectoryAtom)
         return;
     foreach (const PersistDirectoryEntry &pde, persistDirectoryAtom->rgPersistDirEntry) {
@@ -172,29 +236,46 @@ void parsePersistDirectory(const PowerPointStructs &pps, const UserEditAtom *use
     quint32 offset = userEditAtom->offsetLastEdit;
     if (offset == 0)
         return;
-    userEditAtom = get<UserEditAtom>(pps, offset);
-    parsePersistDirectory(pps, userEditAtom, persistDirectory);
+    userEditAtom = get<UserEditAtom>(offset);
+    parsePersistDirectory(userEditAtom);
 }
 
-} // anonymous namespace
-
 bool ParsedPresentation::parse(POLE::Storage &storage)
 {
     handoutMaster = nullptr;
     notesMaster = nullptr;
 
-    // read the CurrentUserStream and PowerPointStructs
-    if (!parsePowerPointStructs(storage, presentation)) {
-        debugPpt << "error parsing PowerPointStructs";
+    // index the PowerPointStructs, they are parsed when referenced
+    if (!readStream(storage, "/PowerPoint Document", documentStream)) {
+        return false;
+    }
+    if (!scanRecords(documentStream, recordOffsets)) {
+        debugPpt << "error parsing PowerPointStructs: truncated record";
         return false;
     }
     if (!parseCurrentUserStream(storage, currentUserStream)) {
         debugPpt << "error parsing CurrentUserStream";
         return false;
     }
-    if (!parsePictures(storage, pictures)) {
-        debugPpt << "error parsing PicturesStream";
-        return false;
+    // the pictures are parsed one by one during the conversion
+    picturesStream = new POLE::Stream(&storage, streamPath(storage, "/Pictures"));
+    if (picturesStream->fail()) {
+        debugPpt << "Failed to open /Pictures stream, no big deal (OPTIONAL).";
+        delete picturesStream;
+        picturesStream = nullptr;
+    } else {
+        unsigned char header[8];
+        unsigned long pos = 0;
+        picturesStream->seek(0);
+        while (picturesStream->read(header, 8) == 8) {
+            const quint32 recLen = readU32(header + 4);
+            if (recLen > picturesStream->size() - pos - 8) {
+                break;
+            }
+            pictureOffsets.append(pos);
+            pos += 8 + recLen;
+            picturesStream->seek(pos);
+        }
     }
     if (!parseSummaryInformationStream(storage, summaryInfo)) {
         debugPpt << "error parsing SummaryInformationStream";
@@ -202,15 +283,15 @@ bool ParsedPresentation::parse(POLE::Storage &storage)
     }
 
     // Part 1: Construct the persist object directory
-    const UserEditAtom *userEditAtom = get<UserEditAtom>(presentation, currentUserStream.anon1.offsetToCurrentEdit);
+    const UserEditAtom *userEditAtom = get<UserEditAtom>(currentUserStream.anon1.offsetToCurrentEdit);
     if (!userEditAtom) {
         debugPpt << "no userEditAtom";
         return false;
     }
-    parsePersistDirectory(presentation, userEditAtom, persistDirectory);
+    parsePersistDirectory(userEditAtom);
     // Part 2: Identify the document persist object
     if (persistDirectory.contains(userEditAtom->docPersistIdRef)) {
-        documentContainer = get<DocumentContainer>(presentation, persistDirectory[userEditAtom->docPersistIdRef]);
+        documentContainer = get<DocumentContainer>(persistDirectory[userEditAtom->docPersistIdRef]);
     }
     if (!documentContainer) {
         debugPpt << "no documentContainer";
@@ -223,7 +304,7 @@ bool ParsedPresentation::parse(POLE::Storage &storage)
             debugPpt << "no notesMaster";
             return false;
         }
-        notesMaster = get<NotesContainer>(presentation, persistDirectory[persistId]);
+        notesMaster = get<NotesContainer>(persistDirectory[persistId]);
         if (!notesMaster) {
             debugPpt << "no notesMaster";
             return false;
@@ -236,7 +317,7 @@ bool ParsedPresentation::parse(POLE::Storage &storage)
             debugPpt << "no handoutMaster";
             return false;
         }
-        handoutMaster = get<HandoutContainer>(presentation, persistDirectory[persistId]);
+        handoutMaster = get<HandoutContainer>(persistDirectory[persistId]);
         if (!handoutMaster) {
             debugPpt << "no handoutMaster";
             return false;
@@ -255,7 +336,7 @@ bool ParsedPresentation::parse(POLE::Storage &storage)
             debugPpt << "cannot load master " << i;
             return false;
         }
-        masters[i] = get<MasterOrSlideContainer>(presentation, persistDirectory[persistId]);
+        masters[i] = get<MasterOrSlideContainer>(persistDirectory[persistId]);
         if (!masters[i]) {
             debugPpt << "cannot load master " << i;
             return false;
@@ -273,7 +354,7 @@ bool ParsedPresentation::parse(POLE::Storage &storage)
                 debugPpt << "cannot find persistId " << persistId << " for slide " << i;
                 return false;
             }
-            slides[i] = get<SlideContainer>(presentation, persistDirectory[persistId]);
+            slides[i] = get<SlideContainer>(persistDirectory[persistId]);
             if (!slides[i]) {
                 debugPpt << "cannot find slide " << i << " at offset " << persistDirectory[persistId];
                 return false;
@@ -294,7 +375,7 @@ bool ParsedPresentation::parse(POLE::Storage &storage)
                 debugPpt << "Invalid persistIdRef: cannot load notes";
                 continue;
             }
-            const NotesContainer *nc = get<NotesContainer>(presentation, persistDirectory[persistId]);
+            const NotesContainer *nc = get<NotesContainer>(persistDirectory[persistId]);
             if (!nc) {
                 debugPpt << "NotesContainer missing: cannot load notes" << i;
                 continue;
@@ -321,6 +402,9 @@ bool ParsedPresentation::parse(POLE::Storage &storage)
     // Part 9: Identify the embedded OLE object persist objects
     // Part 10: Identify the linked OLE object persist objects
     // Part 11: Identify the VBA project persist object
+
+    // everything that is needed has been parsed
+    documentStream.clear();
     return true;
 }
 const MSO::MasterOrSlideContainer *ParsedPresentation::getMaster(const SlideContainer *slide) const
@@ -332,7 +416,7 @@ const MSO::MasterOrSlideContainer *ParsedPresentation::getMaster(const SlideCont
     foreach (const MasterPersistAtom &m, documentContainer->masterList.rgMasterPersistAtom) {
         if (m.masterId == slide->slideAtom.masterIdRef) {
             quint32 offset = persistDirectory[m.persistIdRef];
-            return get<MasterOrSlideContainer>(presentation, offset);
+            return get<MasterOrSlideContainer>(offset);
         }
     }
     return nullptr;
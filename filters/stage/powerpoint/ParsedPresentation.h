@@ -9,14 +9,25 @@
 
 #include "generated/simpleParser.h"
 #include "pole.h"
+#include <QByteArray>
+#include <QList>
 #include <QMap>
+#include <QSet>
+#include <QSharedPointer>
 
+/**
+ * The records of a PowerPoint presentation that are needed for the conversion.
+ *
+ * The PowerPoint Document stream is only scanned for the offsets of its top
+ * level records. A record is parsed when it is referenced from the current
+ * persist directory, so superseded edits and embedded storages are never
+ * parsed. The pictures of the BLIP store are parsed one at a time by
+ * parsePicture() while the storage is still open.
+ */
 class ParsedPresentation
 {
 public:
     MSO::CurrentUserStream currentUserStream;
-    MSO::PowerPointStructs presentation;
-    MSO::PicturesStream pictures;
     MSO::SummaryInformationPropertySetStream summaryInfo;
     // map persistObjectIds to stream offsets
     QMap<quint32, quint32> persistDirectory;
@@ -26,16 +37,43 @@ public:
     QVector<const MSO::MasterOrSlideContainer *> masters;
     QVector<const MSO::SlideContainer *> slides;
     QVector<const MSO::NotesContainer *> notes;
+    // offsets of the records in the Pictures stream
+    QList<quint32> pictureOffsets;
 
     ParsedPresentation()
     {
         documentContainer = nullptr;
         notesMaster = nullptr;
         handoutMaster = nullptr;
+        picturesStream = nullptr;
     }
+    ~ParsedPresentation();
 
     const MSO::MasterOrSlideContainer *getMaster(const MSO::SlideContainer *slide) const;
     bool parse(POLE::Storage &storage);
+
+    /**
+     * Parse the record at @p offset in the Pictures stream into @p block.
+     * The storage passed to parse() has to be open still.
+     */
+    bool parsePicture(quint32 offset, MSO::OfficeArtBStoreContainerFileBlock &block) const;
+
+private:
+    const MSO::PowerPointStruct *getRecord(quint32 offset) const;
+    template<typename T>
+    const T *get(quint32 offset) const;
+    void parsePersistDirectory(const MSO::UserEditAtom *userEditAtom);
+
+    // the PowerPoint Document stream, only kept while parsing
+    QByteArray documentStream;
+    // offsets of the top level records in the PowerPoint Document stream
+    QSet<quint32> recordOffsets;
+    // the records parsed so far, null if parsing failed
+    mutable QMap<quint32, QSharedPointer<MSO::PowerPointStruct>> records;
+    POLE::Stream *picturesStream;
+
+    ParsedPresentation(const ParsedPresentation &) = delete;
+    ParsedPresentation &operator=(const ParsedPresentation &) = delete;
 };
 
 #endif // PARSEDPRESENTATION_H
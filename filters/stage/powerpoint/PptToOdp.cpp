@@ -945,7 +945,19 @@ KoFilter::ConversionStatus PptToOdp::doConversion(KoStore *storeout)
 
     // store the images from the 'Pictures' stream
     storeout->enterDirectory("Pictures");
-    pictureNames = createPictures(storeout, manifest, &p->pictures.anon1.rgfb);
+    // one at a time, so only a single picture is held in memory
+    pictureNames.clear();
+    pictureOffsetUids.clear();
+    foreach (quint32 offset, p->pictureOffsets) {
+        OfficeArtBStoreContainerFileBlock block;
+        if (!p->parsePicture(offset, block)) {
+            continue;
+        }
+        const QByteArray uid = createPicture(storeout, manifest, block, pictureNames);
+        if (!uid.isEmpty() && block.anon.is<OfficeArtBlip>()) {
+            pictureOffsetUids[offset] = uid;
+        }
+    }
     // read pictures from the PowerPoint Document structures
     bulletPictureNames = createBulletPictures(getPP<PP9DocBinaryTagExtension>(p->documentContainer), storeout, manifest);
     storeout->leaveDirectory();
@@ -1199,14 +1211,6 @@ void PptToOdp::defineDefaultGraphicProperties(KoGenStyle &style, KoGenStyles &st
     odrawtoodf.defineGraphicProperties(style, ds, styles);
 }
 
-template<class T>
-void setRgbUid(const T *a, QByteArray &rgbUid)
-{
-    if (!a)
-        return;
-    rgbUid = a->rgbUid1 + a->rgbUid2;
-}
-
 QString PptToOdp::getPicturePath(const quint32 pib) const
 {
     bool use_offset = false;
@@ -1225,27 +1229,10 @@ QString PptToOdp::getPicturePath(const quint32 pib) const
         }
     }
     if (use_offset) {
-        const OfficeArtBStoreDelay &d = p->pictures.anon1;
-        foreach (const OfficeArtBStoreContainerFileBlock &block, d.rgfb) {
-            if (block.anon.is<OfficeArtBlip>()) {
-                if (block.anon.get<OfficeArtBlip>()->streamOffset == offset) {
-                    const OfficeArtBlip *b = block.anon.get<OfficeArtBlip>();
-                    setRgbUid(b->anon.get<MSO::OfficeArtBlipEMF>(), rgbUid);
-                    setRgbUid(b->anon.get<MSO::OfficeArtBlipWMF>(), rgbUid);
-                    setRgbUid(b->anon.get<MSO::OfficeArtBlipPICT>(), rgbUid);
-                    setRgbUid(b->anon.get<MSO::OfficeArtBlipJPEG>(), rgbUid);
-                    setRgbUid(b->anon.get<MSO::OfficeArtBlipPNG>(), rgbUid);
-                    setRgbUid(b->anon.get<MSO::OfficeArtBlipDIB>(), rgbUid);
-                    setRgbUid(b->anon.get<MSO::OfficeArtBlipTIFF>(), rgbUid);
-
-                    if (!rgbUid.isEmpty()) {
-                        if (pictureNames.contains(rgbUid)) {
-                            debugPpt << "Reusing OfficeArtBlip offset:" << offset;
-                            return "Pictures/" + pictureNames[rgbUid];
-                        }
-                    }
-                }
-            }
+        rgbUid = pictureOffsetUids.value(offset);
+        if (!rgbUid.isEmpty() && pictureNames.contains(rgbUid)) {
+            debugPpt << "Reusing OfficeArtBlip offset:" << offset;
+            return "Pictures/" + pictureNames[rgbUid];
         }
     }
     return QString();
@@ -619,6 +619,8 @@ private:
     bool m_processingMasters; // false - processing presentation slides
 
     QMap<QByteArray, QString> pictureNames;
+    // map the offsets of the BLIPs in the Pictures stream to their MD4 digest
+    QMap<quint32, QByteArray> pictureOffsetUids;
     QMap<quint16, QString> bulletPictureNames;
     DateTimeFormat dateTime;
     QString declarationStyleName;
@@ -0,0 +1,28 @@
+/* This file is part of the KDE project
+ * SPDX-FileCopyrightText: 2026 Calligra developers
+ *
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ */
+
+#include "BenchmarkPPT.h"
+#include "PptToOdp.h"
+#include "pole.h"
+#include <KoOdf.h>
+#include <QBuffer>
+#include <QTest>
+
+void BenchmarkPPT::benchmarkImport()
+{
+    const QString inputFilePath = QFINDTESTDATA("data/diagram.ppt");
+    QBENCHMARK {
+        QBuffer buffer;
+        KoStore *output = KoStore::createStore(&buffer, KoStore::Write, KoOdf::mimeType(KoOdf::Presentation), KoStore::Tar);
+        POLE::Storage storage(inputFilePath.toLatin1());
+        QVERIFY(storage.open());
+        PptToOdp ppttoodp;
+        QCOMPARE(ppttoodp.convert(storage, output), KoFilter::OK);
+        delete output;
+    }
+}
+
+QTEST_MAIN(BenchmarkPPT)
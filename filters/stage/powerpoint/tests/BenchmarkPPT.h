@@ -0,0 +1,20 @@
+/* This file is part of the KDE project
+ * SPDX-FileCopyrightText: 2026 Calligra developers
+ *
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ */
+#ifndef BENCHMARKPPT_H
+#define BENCHMARKPPT_H
+
+#include <QObject>
+
+class BenchmarkPPT : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+
+    void benchmarkImport();
+};
+
+#endif
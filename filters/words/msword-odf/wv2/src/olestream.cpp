@@ -54,6 +54,10 @@ OLEStreamReader::OLEStreamReader(POLE::Stream *stream, OLEStorage *storage)
     , m_stream(stream)
     , m_pos(0)
 {
+    // The stream is read in small pieces, serve them from memory
+    if (m_stream) {
+        m_stream->data();
+    }
 }
 
 OLEStreamReader::~OLEStreamReader()
@@ -14,13 +14,23 @@
 #include <QCryptographicHash>
 
 #include <FlakeDebug.h>
+#include <QCache>
+#include <QImage>
 #include <QMap>
 #include <QMimeDatabase>
 #include <QMimeType>
 
+/// the memory budget of the mipmaps of all images in KiB
+#define MIPMAP_CACHE_SIZE (64 * 1024)
+
 class Q_DECL_HIDDEN KoImageCollection::Private
 {
 public:
+    Private()
+        : mipmaps(MIPMAP_CACHE_SIZE)
+    {
+    }
+
     ~Private()
     {
         foreach (KoImageDataPrivate *id, images)
@@ -30,6 +40,8 @@ public:
     QMap<qint64, KoImageDataPrivate *> images;
     // an extra map to find all dataObjects based on the key of a store.
     QMap<QByteArray, KoImageDataPrivate *> storeImages;
+    // reduced resolution versions of the images, shared by all users of the same key
+    QCache<QPair<qint64, int>, QImage> mipmaps;
 };
 
 KoImageCollection::KoImageCollection(QObject *parent)
@@ -179,6 +191,7 @@ void KoImageCollection::update(qint64 oldKey, qint64 newKey)
     if (oldKey == newKey) {
         return;
     }
+    removeMipmaps(oldKey);
     if (d->images.contains(oldKey)) {
         KoImageDataPrivate *imageData = d->images[oldKey];
         d->images.remove(oldKey);
@@ -189,4 +202,47 @@ void KoImageCollection::update(qint64 oldKey, qint64 newKey)
 void KoImageCollection::removeOnKey(qint64 imageDataKey)
 {
     d->images.remove(imageDataKey);
+    removeMipmaps(imageDataKey);
+}
+
+QImage KoImageCollection::mipmap(qint64 key, int level) const
+{
+    QImage *image = d->mipmaps.object(qMakePair(key, level));
+    return image ? *image : QImage();
+}
+
+bool KoImageCollection::insertMipmap(qint64 key, int level, const QImage &image)
+{
+    return d->mipmaps.insert(qMakePair(key, level), new QImage(image), qMax<qsizetype>(1, image.sizeInBytes() / 1024));
+}
+
+void KoImageCollection::mipmapDecoded(qint64 key, int level, const QImage &image)
+{
+    KoImageDataPrivate *imageData = d->images.value(key);
+    if (!imageData) // removed or changed in the meantime
+        return;
+    if (image.isNull()) {
+        // don't let the requesters try again and again
+        imageData->errorCode = KoImageData::LoadFailed;
+    } else if (!insertMipmap(key, level, image)) {
+        // too large for the cache, keep it with the image until it is not used anymore
+        imageData->decodedImage = image;
+        imageData->decodedLevel = level;
+        imageData->cleanCacheTimer.start();
+    }
+    const QList<QPointer<KoImageData>> requesters = imageData->pendingRequests.take(level);
+    for (const QPointer<KoImageData> &requester : requesters) {
+        if (requester)
+            Q_EMIT requester->imageLoaded();
+    }
+}
+
+void KoImageCollection::removeMipmaps(qint64 key)
+{
+    const QList<QPair<qint64, int>> keys = d->mipmaps.keys();
+    for (const QPair<qint64, int> &mipmapKey : keys) {
+        if (mipmapKey.first == key) {
+            d->mipmaps.remove(mipmapKey);
+        }
+    }
 }
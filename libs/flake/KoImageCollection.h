@@ -92,8 +92,20 @@ public:
     void update(qint64 oldKey, qint64 newKey);
 
 private:
+    friend class KoImageData;
+    friend class KoImageDataPrivate;
+
     KoImageData *cacheImage(KoImageData *data);
 
+    /// return the cached @p level of the mipmap pyramid of the image with @p key, or a null image
+    QImage mipmap(qint64 key, int level) const;
+    /// cache @p image as @p level of the mipmap pyramid of the image with @p key, false if it is too large
+    bool insertMipmap(qint64 key, int level, const QImage &image);
+    /// called when @p level of the image with @p key got decoded for KoImageData::requestImage()
+    void mipmapDecoded(qint64 key, int level, const QImage &image);
+    /// drop all cached mipmaps of the image with @p key
+    void removeMipmaps(qint64 key);
+
     class Private;
     Private *const d;
 };
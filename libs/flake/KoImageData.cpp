@@ -80,16 +80,20 @@ QPixmap KoImageData::pixmap(const QSize &size)
             return tmp;
         }
         case KoImageDataPrivate::StateNotLoaded:
-            image(); // forces load
-            // fall through
         case KoImageDataPrivate::StateImageLoaded:
-        case KoImageDataPrivate::StateImageOnly:
-            if (!d->image.isNull()) {
+        case KoImageDataPrivate::StateImageOnly: {
+            // only decode the image as large as needed for the pixmap
+            const QImage source = image(wantedSize);
+            if (!source.isNull()) {
                 // create pixmap from image.
                 // this is the highest quality and lowest memory usage way of doing the conversion.
-                d->pixmap = QPixmap::fromImage(d->image.scaled(wantedSize, Qt::IgnoreAspectRatio, Qt::SmoothTransformation));
+                if (source.size() == wantedSize)
+                    d->pixmap = QPixmap::fromImage(source);
+                else
+                    d->pixmap = QPixmap::fromImage(source.scaled(wantedSize, Qt::IgnoreAspectRatio, Qt::SmoothTransformation));
             }
         }
+        }
 
         if (d->dataStoreState == KoImageDataPrivate::StateImageLoaded) {
             if (d->cleanCacheTimer.isActive())
@@ -110,18 +114,29 @@ QSizeF KoImageData::imageSize()
 {
     if (!d->imageSize.isValid()) {
         // The imagesize have not yet been calculated
-        if (image().isNull()) // auto loads the image
-            return QSizeF(100, 100);
+        QSize size;
+        int dotsPerMeterX = 0;
+        int dotsPerMeterY = 0;
+        // common formats give their resolution in the header, so the size is known without decoding
+        if (d->image.isNull() && d->readResolution(&dotsPerMeterX, &dotsPerMeterY))
+            size = pixelSize();
+        if (size.isEmpty()) {
+            if (image().isNull()) // auto loads the image
+                return QSizeF(100, 100);
+            size = d->image.size();
+            dotsPerMeterX = d->image.dotsPerMeterX();
+            dotsPerMeterY = d->image.dotsPerMeterY();
+        }
 
-        if (d->image.dotsPerMeterX())
-            d->imageSize.setWidth(DM_TO_POINT(d->image.width() / (qreal)d->image.dotsPerMeterX() * 10.0));
+        if (dotsPerMeterX)
+            d->imageSize.setWidth(DM_TO_POINT(size.width() / (qreal)dotsPerMeterX * 10.0));
         else
-            d->imageSize.setWidth(d->image.width() / 72.0);
+            d->imageSize.setWidth(size.width() / 72.0);
 
-        if (d->image.dotsPerMeterY())
-            d->imageSize.setHeight(DM_TO_POINT(d->image.height() / (qreal)d->image.dotsPerMeterY() * 10.0));
+        if (dotsPerMeterY)
+            d->imageSize.setHeight(DM_TO_POINT(size.height() / (qreal)dotsPerMeterY * 10.0));
         else
-            d->imageSize.setHeight(d->image.height() / 72.0);
+            d->imageSize.setHeight(size.height() / 72.0);
     }
     return d->imageSize;
 }
@@ -151,6 +166,76 @@ QImage KoImageData::image() const
     return d->image;
 }
 
+QImage KoImageData::image(const QSize &minimumSize) const
+{
+    if (!d)
+        return QImage();
+    const QSize fullSize = pixelSize();
+    if (fullSize.isEmpty() || !minimumSize.isValid())
+        return image();
+
+    // find the smallest level of the pyramid that is still large enough
+    QSize levelSize;
+    const int level = KoImageDataPrivate::mipmapLevel(fullSize, minimumSize, &levelSize);
+    if (level == 0)
+        return image();
+
+    QImage result;
+    if (d->collection) {
+        result = d->collection->mipmap(d->key, level);
+        if (!result.isNull())
+            return result;
+    }
+    if (!d->image.isNull())
+        result = d->image.scaled(levelSize, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+    else
+        result = d->readImage(levelSize);
+    if (!result.isNull() && d->collection)
+        d->collection->insertMipmap(d->key, level, result);
+    return result;
+}
+
+QImage KoImageData::requestImage(const QSize &minimumSize, int priority)
+{
+    if (!d)
+        return QImage();
+    if (!d->collection || d->errorCode != Success || d->dataStoreState == KoImageDataPrivate::StateEmpty)
+        return image(minimumSize);
+    const QSize fullSize = pixelSize();
+    if (fullSize.isEmpty())
+        return image(minimumSize);
+
+    QSize levelSize = fullSize;
+    const int level = minimumSize.isValid() ? KoImageDataPrivate::mipmapLevel(fullSize, minimumSize, &levelSize) : 0;
+    if (level == 0 && !d->image.isNull())
+        return d->image;
+    if (d->decodedLevel == level)
+        return d->decodedImage;
+    const QImage cached = d->collection->mipmap(d->key, level);
+    if (!cached.isNull())
+        return cached;
+
+    QList<QPointer<KoImageData>> &requesters = d->pendingRequests[level];
+    if (requesters.isEmpty())
+        d->decodeAsync(level, levelSize, priority);
+    if (!requesters.contains(this))
+        requesters.append(this);
+    return QImage();
+}
+
+QSize KoImageData::pixelSize() const
+{
+    if (!d)
+        return QSize();
+    if (!d->pixelSize.isValid()) {
+        if (d->image.isNull())
+            d->pixelSize = d->readSize();
+        if (!d->pixelSize.isValid())
+            d->pixelSize = image().size();
+    }
+    return d->pixelSize;
+}
+
 bool KoImageData::hasCachedImage() const
 {
     return d && !d->image.isNull();
@@ -283,6 +368,7 @@ void KoImageData::setImage(const QByteArray &imageData, KoImageCollection *colle
         }
 
         d->suffix = "png"; // good default for non-lossy storage.
+        d->pixelSize = QSize();
 
         if (imageData.size() <= MAX_MEMORY_IMAGESIZE) {
             QImage image;
@@ -69,10 +69,35 @@ public:
 
     /**
      * Return the internal store of the image.
+     * This decodes the image at full resolution, which is only needed for printing or export.
      * @see isValid(), hasCachedImage()
      */
     QImage image() const;
 
+    /**
+     * Return a version of the image that is at least as large as @p minimumSize, for
+     * painting the image at that size.
+     *
+     * This is a level of a mipmap pyramid, each level half the size of the previous one.
+     * Levels are decoded at reduced resolution directly where the image format supports
+     * it and are shared by all users of the image in the collection.
+     */
+    QImage image(const QSize &minimumSize) const;
+
+    /**
+     * Return image(minimumSize) if it is available without decoding, otherwise return a
+     * null image and decode it on a worker thread; imageLoaded() is emitted when it is done.
+     * Requests with a higher @p priority are decoded first.
+     *
+     * Image data outside of a collection is decoded right away.
+     */
+    QImage requestImage(const QSize &minimumSize, int priority = 0);
+
+    /**
+     * The size of the image in pixels, read without decoding the image if possible
+     */
+    QSize pixelSize() const;
+
     /**
      * The size of the image in points
      */
@@ -105,6 +130,10 @@ public:
         return d;
     }
 
+Q_SIGNALS:
+    /// emitted when an image requested with requestImage() has been decoded
+    void imageLoaded();
+
 private:
     friend class KoImageCollection;
     friend class TestImageCollection;
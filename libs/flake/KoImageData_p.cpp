@@ -14,9 +14,16 @@
 #include <QApplication>
 #include <QBuffer>
 #include <QCryptographicHash>
+#include <QFile>
 #include <QFileInfo>
+#include <QImageReader>
 #include <QImageWriter>
+#include <QRunnable>
 #include <QTemporaryFile>
+#include <QThreadPool>
+#include <QtEndian>
+
+Q_GLOBAL_STATIC(QThreadPool, s_decoderPool)
 
 KoImageDataPrivate::KoImageDataPrivate(KoImageData *q)
     : collection(nullptr)
@@ -24,6 +31,7 @@ KoImageDataPrivate::KoImageDataPrivate(KoImageData *q)
     , key(0)
     , refCount(0)
     , dataStoreState(StateEmpty)
+    , decodedLevel(-1)
     , temporaryFile(nullptr)
 {
     cleanCacheTimer.setSingleShot(true);
@@ -126,21 +134,176 @@ void KoImageDataPrivate::copyToTemporary(QIODevice &device)
 
 void KoImageDataPrivate::cleanupImageCache()
 {
+    decodedImage = QImage();
+    decodedLevel = -1;
     if (dataStoreState == KoImageDataPrivate::StateImageLoaded) {
         image = QImage();
         dataStoreState = KoImageDataPrivate::StateNotLoaded;
     }
 }
 
+QImage KoImageDataPrivate::readImage(const QSize &scaledSize) const
+{
+    if (dataStoreState != StateNotLoaded || errorCode != KoImageData::Success)
+        return QImage();
+    if (temporaryFile)
+        return readImage(temporaryFile->fileName(), suffix.toLatin1(), scaledSize);
+    return readImage(imageLocation.toLocalFile(), QByteArray(), scaledSize);
+}
+
+QImage KoImageDataPrivate::readImage(const QString &fileName, const QByteArray &format, const QSize &scaledSize)
+{
+    QImage result;
+    QImageReader reader(fileName, format);
+    // codecs like jpeg decode at the reduced size right away, for the others
+    // the reader scales after decoding
+    if (scaledSize.isValid())
+        reader.setScaledSize(scaledSize);
+    if (!reader.read(&result))
+        warnFlake << "Failed to read image" << fileName << reader.errorString();
+    return result;
+}
+
+QSize KoImageDataPrivate::readSize() const
+{
+    if (dataStoreState != StateNotLoaded || errorCode != KoImageData::Success)
+        return QSize();
+    QImageReader reader;
+    if (temporaryFile) {
+        reader.setFileName(temporaryFile->fileName());
+        reader.setFormat(suffix.toLatin1());
+    } else {
+        reader.setFileName(imageLocation.toLocalFile());
+    }
+    return reader.size();
+}
+
+bool KoImageDataPrivate::readResolution(int *dotsPerMeterX, int *dotsPerMeterY) const
+{
+    if (dataStoreState != StateNotLoaded || errorCode != KoImageData::Success)
+        return false;
+    QFile file(temporaryFile ? temporaryFile->fileName() : imageLocation.toLocalFile());
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+    // the resolution is stored in front of the pixel data, exif data is at most 64 KiB
+    const QByteArray header = file.read(128 * 1024);
+    const uchar *data = reinterpret_cast<const uchar *>(header.constData());
+    const int size = header.size();
+
+    const QImage defaultImage(1, 1, QImage::Format_Mono);
+    *dotsPerMeterX = defaultImage.dotsPerMeterX();
+    *dotsPerMeterY = defaultImage.dotsPerMeterY();
+
+    if (header.startsWith("\x89PNG\r\n\x1a\n")) {
+        // chunks of length, type, data and crc; pHYs has to come before IDAT
+        int pos = 8;
+        while (pos + 8 <= size) {
+            const quint32 length = qFromBigEndian<quint32>(data + pos);
+            const QByteArray type = header.mid(pos + 4, 4);
+            if (type == "IDAT")
+                break;
+            if (type == "pHYs" && length == 9 && pos + 17 <= size) {
+                // only a unit of meters is used, as by the png reader of Qt
+                if (data[pos + 16] == 1) {
+                    *dotsPerMeterX = qFromBigEndian<quint32>(data + pos + 8);
+                    *dotsPerMeterY = qFromBigEndian<quint32>(data + pos + 12);
+                }
+                break;
+            }
+            if (length > quint32(size))
+                break;
+            pos += 12 + length;
+        }
+        return true;
+    }
+
+    if (size > 2 && data[0] == 0xff && data[1] == 0xd8) {
+        // segments of marker and length until the frame header
+        int pos = 2;
+        while (pos + 4 <= size && data[pos] == 0xff) {
+            const uchar marker = data[pos + 1];
+            if (marker == 0xff) {
+                ++pos;
+                continue;
+            }
+            if (marker == 0xda || (marker >= 0xc0 && marker <= 0xcf && marker != 0xc4 && marker != 0xc8 && marker != 0xcc))
+                break;
+            const int length = qFromBigEndian<quint16>(data + pos + 2);
+            if (marker == 0xe0 && length >= 14 && pos + 16 <= size && header.mid(pos + 4, 5) == QByteArray("JFIF", 5)) {
+                const int unit = data[pos + 11];
+                const int densityX = qFromBigEndian<quint16>(data + pos + 12);
+                const int densityY = qFromBigEndian<quint16>(data + pos + 14);
+                // the same conversion as the jpeg reader of Qt, the unit is either inch or centimeter
+                if (unit == 1) {
+                    *dotsPerMeterX = int(100. * densityX / 2.54);
+                    *dotsPerMeterY = int(100. * densityY / 2.54);
+                } else if (unit == 2) {
+                    *dotsPerMeterX = 100 * densityX;
+                    *dotsPerMeterY = 100 * densityY;
+                }
+                break;
+            }
+            pos += 2 + length;
+        }
+        return true;
+    }
+    return false;
+}
+
+int KoImageDataPrivate::mipmapLevel(const QSize &fullSize, const QSize &minimumSize, QSize *levelSize)
+{
+    int level = 0;
+    *levelSize = fullSize;
+    while (true) {
+        const QSize next((levelSize->width() + 1) / 2, (levelSize->height() + 1) / 2);
+        if (next == *levelSize || next.width() < minimumSize.width() || next.height() < minimumSize.height())
+            break;
+        *levelSize = next;
+        ++level;
+    }
+    return level;
+}
+
+void KoImageDataPrivate::decodeAsync(int level, const QSize &levelSize, int priority)
+{
+    // the job only gets copies, this object might be gone or changed when it runs
+    const QImage source = image;
+    const QString fileName = temporaryFile ? temporaryFile->fileName() : imageLocation.toLocalFile();
+    const QByteArray format = temporaryFile ? suffix.toLatin1() : QByteArray();
+    const QPointer<KoImageCollection> target = collection;
+    const qint64 imageKey = key;
+    QRunnable *job = QRunnable::create([=]() {
+        QImage result;
+        if (source.isNull())
+            result = KoImageDataPrivate::readImage(fileName, format, level > 0 ? levelSize : QSize());
+        else if (level > 0)
+            result = source.scaled(levelSize, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+        else
+            result = source;
+        QMetaObject::invokeMethod(
+            qApp,
+            [=]() {
+                if (target)
+                    target->mipmapDecoded(imageKey, level, result);
+            },
+            Qt::QueuedConnection);
+    });
+    s_decoderPool->start(job, priority);
+}
+
 void KoImageDataPrivate::clear()
 {
     errorCode = KoImageData::Success;
     dataStoreState = StateEmpty;
     imageLocation.clear();
     imageSize = QSizeF();
+    pixelSize = QSize();
     key = 0;
     image = QImage();
     pixmap = QPixmap();
+    decodedImage = QImage();
+    decodedLevel = -1;
+    pendingRequests.clear();
 }
 
 qint64 KoImageDataPrivate::generateKey(const QByteArray &bytes)
@@ -13,7 +13,10 @@
 #include <QByteArray>
 #include <QDir>
 #include <QImage>
+#include <QList>
+#include <QMap>
 #include <QPixmap>
+#include <QPointer>
 #include <QTimer>
 #include <QUrl>
 
@@ -45,6 +48,28 @@ public:
     /// clean the image cache.
     void cleanupImageCache();
 
+    /// decode the image data stored in the file scaled to @p scaledSize, or at full size if it is invalid
+    QImage readImage(const QSize &scaledSize) const;
+
+    /// decode the image in @p fileName, thread-safe
+    static QImage readImage(const QString &fileName, const QByteArray &format, const QSize &scaledSize);
+
+    /// return the size of the image data stored in the file as given in its header
+    QSize readSize() const;
+
+    /**
+     * Read the resolution of the image data stored in the file from its header, in dots per meter.
+     * Images without resolution get the default of QImage.
+     * @return false if the format is not known, the image has to be decoded to get it then.
+     */
+    bool readResolution(int *dotsPerMeterX, int *dotsPerMeterY) const;
+
+    /// return the smallest level of the mipmap pyramid of @p fullSize that is at least @p minimumSize
+    static int mipmapLevel(const QSize &fullSize, const QSize &minimumSize, QSize *levelSize);
+
+    /// decode @p level of size @p levelSize on the decoder thread pool, the result is passed to the collection
+    void decodeAsync(int level, const QSize &levelSize, int priority);
+
     void clear();
 
     static qint64 generateKey(const QByteArray &bytes);
@@ -59,6 +84,7 @@ public:
     KoImageCollection *collection;
     KoImageData::ErrorCode errorCode;
     QSizeF imageSize;
+    QSize pixelSize;
     qint64 key;
     QString suffix; // the suffix of the picture e.g. png  TODO use a QByteArray ?
     QTimer cleanCacheTimer;
@@ -71,6 +97,11 @@ public:
     QImage image;
     /// screen optimized cached version.
     QPixmap pixmap;
+    /// last asynchronously decoded level which did not fit into the mipmap cache of the collection.
+    QImage decodedImage;
+    int decodedLevel;
+    /// the users of requestImage() waiting for a level to be decoded, per level
+    QMap<int, QList<QPointer<KoImageData>>> pendingRequests;
 
     QTemporaryFile *temporaryFile;
 };
@@ -194,6 +194,8 @@ void KoPathPoint::setProperty(PointProperty property)
         d->properties &= ~IsSymmetric;
         d->properties &= ~IsSmooth;
     }
+    if (d->shape)
+        d->shape->notifyPointsChanged();
 }
 
 void KoPathPoint::unsetProperty(PointProperty property)
@@ -221,6 +223,8 @@ void KoPathPoint::unsetProperty(PointProperty property)
         return;
     }
     d->properties &= ~property;
+    if (d->shape)
+        d->shape->notifyPointsChanged();
 }
 
 bool KoPathPoint::activeControlPoint1() const
@@ -300,6 +304,8 @@ void KoPathPoint::setParent(KoPathShape *parent)
     // don't set to zero
     // Q_ASSERT(parent);
     d->shape = parent;
+    if (d->shape)
+        d->shape->notifyPointsChanged();
 }
 
 QRectF KoPathPoint::boundingRect(bool active) const
@@ -332,6 +338,8 @@ void KoPathPoint::reverse()
     newProps |= d->properties & StopSubpath;
     newProps |= d->properties & CloseSubpath;
     d->properties = newProps;
+    if (d->shape)
+        d->shape->notifyPointsChanged();
 }
 
 bool KoPathPoint::isSmooth(KoPathPoint *prev, KoPathPoint *next) const
@@ -51,6 +51,9 @@ KoPathShapePrivate::KoPathShapePrivate(KoPathShape *q)
     , fillRule(Qt::OddEvenFill)
     , startMarker(KoMarkerData::MarkerStart)
     , endMarker(KoMarkerData::MarkerEnd)
+    , outlineRevision(0)
+    , strokedOutlineWidth(0.0)
+    , strokedOutlineRevision(0)
 {
 }
 
@@ -355,6 +358,7 @@ void KoPathShape::clear()
         delete subpath;
     }
     m_subpaths.clear();
+    notifyPointsChanged();
 }
 
 void KoPathShape::paint(QPainter &painter, const KoViewConverter &converter, KoShapePaintingContext &paintContext)
@@ -434,8 +438,19 @@ void KoPathShape::paintPoints(QPainter &painter, const KoViewConverter &converte
 
 QPainterPath KoPathShape::outline() const
 {
+    Q_D(const KoPathShape);
+    if (d->outlineRevision != d->revision) {
+        d->outline = d->createOutline();
+        d->outlineRevision = d->revision;
+    }
+    return d->outline;
+}
+
+QPainterPath KoPathShapePrivate::createOutline() const
+{
+    Q_Q(const KoPathShape);
     QPainterPath path;
-    foreach (KoSubpath *subpath, m_subpaths) {
+    foreach (KoSubpath *subpath, q->m_subpaths) {
         KoPathPoint *lastPoint = subpath->first();
         bool activeCP = false;
         foreach (KoPathPoint *currPoint, *subpath) {
@@ -486,6 +501,7 @@ QPainterPath KoPathShape::outline() const
 
 QRectF KoPathShape::boundingRect() const
 {
+    Q_D(const KoPathShape);
     QTransform transform = absoluteTransformation(nullptr);
     // calculate the bounding rect of the transformed outline
     QRectF bb;
@@ -494,7 +510,18 @@ QRectF KoPathShape::boundingRect() const
     if (lineBorder) {
         pen.setWidthF(lineBorder->lineWidth());
     }
-    bb = transform.map(pathStroke(pen)).boundingRect();
+    // stroking the path is expensive, so reuse the last result as long as the path did not change
+    if (d->strokedOutlineRevision != d->revision || d->strokedOutlineWidth != pen.widthF()) {
+        d->strokedOutline = pathStroke(pen);
+        d->strokedOutlineWidth = pen.widthF();
+        d->strokedOutlineRevision = d->revision;
+        d->strokedBoundsTransform = transform;
+        d->strokedBounds = transform.map(d->strokedOutline).boundingRect();
+    } else if (d->strokedBoundsTransform != transform) {
+        d->strokedBoundsTransform = transform;
+        d->strokedBounds = transform.map(d->strokedOutline).boundingRect();
+    }
+    bb = d->strokedBounds;
 
     if (stroke()) {
         KoInsets inset;
@@ -565,6 +592,7 @@ KoPathPoint *KoPathShape::moveTo(const QPointF &p)
     KoSubpath *path = new KoSubpath;
     path->push_back(point);
     m_subpaths.push_back(path);
+    notifyPointsChanged();
     return point;
 }
 
@@ -578,6 +606,7 @@ KoPathPoint *KoPathShape::lineTo(const QPointF &p)
     KoPathPoint *lastPoint = m_subpaths.last()->last();
     d->updateLast(&lastPoint);
     m_subpaths.last()->push_back(point);
+    notifyPointsChanged();
     return point;
 }
 
@@ -593,6 +622,7 @@ KoPathPoint *KoPathShape::curveTo(const QPointF &c1, const QPointF &c2, const QP
     KoPathPoint *point = new KoPathPoint(this, p, KoPathPoint::StopSubpath);
     point->setControlPoint1(c2);
     m_subpaths.last()->push_back(point);
+    notifyPointsChanged();
     return point;
 }
 
@@ -607,6 +637,7 @@ KoPathPoint *KoPathShape::curveTo(const QPointF &c, const QPointF &p)
     lastPoint->setControlPoint2(c);
     KoPathPoint *point = new KoPathPoint(this, p, KoPathPoint::StopSubpath);
     m_subpaths.last()->push_back(point);
+    notifyPointsChanged();
 
     return point;
 }
@@ -711,6 +742,14 @@ void KoPathShape::closeMerge()
     d->closeMergeSubpath(m_subpaths.last());
 }
 
+void KoPathShape::notifyPointsChanged()
+{
+    Q_D(KoPathShape);
+    ++d->revision;
+    // the size changed, which the transformations of the children might depend on
+    KoShapePrivate::invalidateTransformations();
+}
+
 QPointF KoPathShape::normalize()
 {
     Q_D(KoPathShape);
@@ -931,6 +970,7 @@ bool KoPathShape::insertPoint(KoPathPoint *point, const KoPathPointIndex &pointI
     point->setProperties(properties);
     point->setParent(this);
     subpath->insert(pointIndex.second, point);
+    notifyPointsChanged();
     return true;
 }
 
@@ -943,6 +983,7 @@ KoPathPoint *KoPathShape::removePoint(const KoPathPointIndex &pointIndex)
         return nullptr;
 
     KoPathPoint *point = subpath->takeAt(pointIndex.second);
+    notifyPointsChanged();
 
     // don't do anything (not even crash), if there was only one point
     if (pointCount() == 0) {
@@ -993,6 +1034,7 @@ bool KoPathShape::breakAfter(const KoPathPointIndex &pointIndex)
 
     // insert the new subpath after the broken one
     m_subpaths.insert(pointIndex.first + 1, newSubpath);
+    notifyPointsChanged();
 
     return true;
 }
@@ -1020,6 +1062,7 @@ bool KoPathShape::join(int subpathIndex)
 
     // delete it as it is no longer possible to use it
     delete nextSubpath;
+    notifyPointsChanged();
 
     return true;
 }
@@ -1037,6 +1080,7 @@ bool KoPathShape::moveSubpath(int oldSubpathIndex, int newSubpathIndex)
 
     m_subpaths.removeAt(oldSubpathIndex);
     m_subpaths.insert(newSubpathIndex, subpath);
+    notifyPointsChanged();
 
     return true;
 }
@@ -1063,6 +1107,7 @@ KoPathPointIndex KoPathShape::openSubpath(const KoPathPointIndex &pointIndex)
     subpath->first()->setProperty(KoPathPoint::StartSubpath);
     // make the last point an end node
     subpath->last()->setProperty(KoPathPoint::StopSubpath);
+    notifyPointsChanged();
 
     return pathPointIndex(oldStartPoint);
 }
@@ -1089,6 +1134,7 @@ KoPathPointIndex KoPathShape::closeSubpath(const KoPathPointIndex &pointIndex)
     subpath->last()->setProperty(KoPathPoint::StopSubpath);
 
     d->closeSubpath(subpath);
+    notifyPointsChanged();
     return pathPointIndex(oldStartPoint);
 }
 
@@ -1124,6 +1170,7 @@ bool KoPathShape::reverseSubpath(int subpathIndex)
     }
     first->setProperties(firstProps);
     last->setProperties(lastProps);
+    notifyPointsChanged();
 
     return true;
 }
@@ -1133,8 +1180,10 @@ KoSubpath *KoPathShape::removeSubpath(int subpathIndex)
     Q_D(KoPathShape);
     KoSubpath *subpath = d->subPath(subpathIndex);
 
-    if (subpath != nullptr)
+    if (subpath != nullptr) {
         m_subpaths.removeAt(subpathIndex);
+        notifyPointsChanged();
+    }
 
     return subpath;
 }
@@ -1145,6 +1194,7 @@ bool KoPathShape::addSubpath(KoSubpath *subpath, int subpathIndex)
         return false;
 
     m_subpaths.insert(subpathIndex, subpath);
+    notifyPointsChanged();
 
     return true;
 }
@@ -1169,6 +1219,7 @@ bool KoPathShape::combine(KoPathShape *path)
         }
         m_subpaths.append(newSubpath);
     }
+    notifyPointsChanged();
     normalize();
     return true;
 }
@@ -1196,6 +1247,7 @@ bool KoPathShape::separate(QList<KoPathShape *> &separatedPaths)
             newSubpath->append(newPoint);
         }
         shape->m_subpaths.append(newSubpath);
+        shape->notifyPointsChanged();
         shape->normalize();
         separatedPaths.append(shape);
     }
@@ -1256,6 +1308,28 @@ QString KoPathShape::toString(const QTransform &matrix) const
 {
     QString d;
 
+    // append the curve from point a to point b, converted to a cubic one if needed
+    auto appendCurve = [&](const KoPathPoint *a, const KoPathPoint *b) {
+        QPointF cp1 = a->controlPoint2();
+        QPointF cp2 = b->controlPoint1();
+        if (!a->activeControlPoint2() || !b->activeControlPoint1()) {
+            /* quadric bezier (a0,a1,a2) to cubic bezier (b0,b1,b2,b3):
+             *
+             * b0 = a0
+             * b1 = a0 + 2/3 * (a1-a0)
+             * b2 = a1 + 1/3 * (a2-a1)
+             * b3 = a2
+             */
+            const QPointF a1 = a->activeControlPoint2() ? cp1 : cp2;
+            cp1 = a->point() + 2.0 / 3.0 * (a1 - a->point());
+            cp2 = a1 + 1.0 / 3.0 * (b->point() - a1);
+        }
+        cp1 = matrix.map(cp1);
+        cp2 = matrix.map(cp2);
+        const QPointF p = matrix.map(b->point());
+        d += QString("C%1 %2 %3 %4 %5 %6").arg(cp1.x()).arg(cp1.y()).arg(cp2.x()).arg(cp2.y()).arg(p.x()).arg(p.y());
+    };
+
     // iterate over all subpaths
     KoSubpathList::const_iterator pathIt(m_subpaths.constBegin());
     for (; pathIt != m_subpaths.constEnd(); ++pathIt) {
@@ -1280,13 +1354,7 @@ QString KoPathShape::toString(const QTransform &matrix) const
             }
             // end point of curve segment ?
             else if (activeControlPoint2 || currPoint->activeControlPoint1()) {
-                // check if we have a cubic or quadratic curve
-                const bool isCubic = activeControlPoint2 && currPoint->activeControlPoint1();
-                KoPathSegment cubicSeg = isCubic ? KoPathSegment(lastPoint, currPoint) : KoPathSegment(lastPoint, currPoint).toCubic();
-                const QPointF cp1 = matrix.map(cubicSeg.first()->controlPoint2());
-                const QPointF cp2 = matrix.map(cubicSeg.second()->controlPoint1());
-                const QPointF p = matrix.map(cubicSeg.second()->point());
-                d += QString("C%1 %2 %3 %4 %5 %6").arg(cp1.x()).arg(cp1.y()).arg(cp2.x()).arg(cp2.y()).arg(p.x()).arg(p.y());
+                appendCurve(lastPoint, currPoint);
             }
             // end point of line segment!
             else {
@@ -1297,13 +1365,7 @@ QString KoPathShape::toString(const QTransform &matrix) const
             if (currPoint->properties() & KoPathPoint::StopSubpath && currPoint->properties() & KoPathPoint::CloseSubpath) {
                 // add curve when there is a curve on the way to the first point
                 if (currPoint->activeControlPoint2() || firstPoint->activeControlPoint1()) {
-                    // check if we have a cubic or quadratic curve
-                    const bool isCubic = currPoint->activeControlPoint2() && firstPoint->activeControlPoint1();
-                    KoPathSegment cubicSeg = isCubic ? KoPathSegment(currPoint, firstPoint) : KoPathSegment(currPoint, firstPoint).toCubic();
-                    const QPointF cp1 = matrix.map(cubicSeg.first()->controlPoint2());
-                    const QPointF cp2 = matrix.map(cubicSeg.second()->controlPoint1());
-                    const QPointF p = matrix.map(cubicSeg.second()->point());
-                    d += QString("C%1 %2 %3 %4 %5 %6").arg(cp1.x()).arg(cp1.y()).arg(cp2.x()).arg(cp2.y()).arg(p.x()).arg(p.y());
+                    appendCurve(currPoint, firstPoint);
                 }
                 d += QString("Z");
             }
@@ -1467,6 +1529,7 @@ void KoPathShape::setMarker(const KoMarkerData &markerData)
     } else {
         d->endMarker = markerData;
     }
+    ++d->revision;
 }
 
 void KoPathShape::setMarker(KoMarker *marker, KoMarkerData::MarkerPosition position)
@@ -1484,6 +1547,7 @@ void KoPathShape::setMarker(KoMarker *marker, KoMarkerData::MarkerPosition posit
         }
         d->endMarker.setMarker(marker);
     }
+    ++d->revision;
 }
 
 KoMarker *KoPathShape::marker(KoMarkerData::MarkerPosition position) const
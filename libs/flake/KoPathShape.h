@@ -115,6 +115,15 @@ public:
 
     /// Removes all subpaths and their points from the path
     void clear();
+
+    /**
+     * Mark the cached outline of the path as outdated.
+     *
+     * Changing the points through the KoPathPoint and KoPathShape API does this already,
+     * it is only needed after modifying m_subpaths directly.
+     */
+    void notifyPointsChanged();
+
     /**
      * @brief Starts a new Subpath
      *
@@ -9,6 +9,8 @@
 #include "KoMarkerData.h"
 #include "KoTosContainer_p.h"
 
+#include <QPainterPath>
+
 class KoPathShapePrivate : public KoTosContainerPrivate
 {
 public:
@@ -22,6 +24,9 @@ public:
 
     void updateLast(KoPathPoint **lastPoint);
 
+    /// Create the outline of the path from its points
+    QPainterPath createOutline() const;
+
     /// closes specified subpath
     void closeSubpath(KoSubpath *subpath);
     /// close-merges specified subpath
@@ -78,6 +83,15 @@ public:
 
     KoMarkerData startMarker;
     KoMarkerData endMarker;
+
+    // caches of the geometry, valid as long as the revision of the shape did not change
+    mutable QPainterPath outline;
+    mutable quint64 outlineRevision;
+    mutable QPainterPath strokedOutline; ///< pathStroke() with strokedOutlineWidth
+    mutable qreal strokedOutlineWidth;
+    mutable quint64 strokedOutlineRevision;
+    mutable QTransform strokedBoundsTransform;
+    mutable QRectF strokedBounds; ///< bounding rect of strokedOutline mapped by strokedBoundsTransform
 };
 
 #endif
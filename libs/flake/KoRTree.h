@@ -14,10 +14,14 @@
 #include <QPair>
 #include <QPointF>
 #include <QRectF>
+#include <QSet>
 #include <QVarLengthArray>
 #include <QVector>
 
 #include <QDebug>
+#include <QtMath>
+
+#include <algorithm>
 
 // #define CALLIGRA_RTREE_DEBUG
 #ifdef CALLIGRA_RTREE_DEBUG
@@ -71,6 +75,28 @@ public:
      */
     void remove(const T &data);
 
+    /**
+     * @brief Replace all data items of the tree
+     *
+     * The tree is built bottom up using sort-tile-recursive packing, which is much
+     * faster than inserting the items one by one and results in fuller nodes with
+     * less overlap.
+     *
+     * @param items the bounding boxes and data items, in insertion order
+     */
+    void load(const QVector<QPair<QRectF, T>> &items);
+
+    /**
+     * @brief Move many data items to new bounding boxes at once
+     *
+     * The result is the same as removing and inserting each of the items, items which
+     * are not in the tree yet are inserted. If a large part of the tree changes it is
+     * rebuilt using sort-tile-recursive packing instead.
+     *
+     * @param items the new bounding boxes and the data items
+     */
+    void update(const QVector<QPair<QRectF, T>> &items);
+
     /**
      * @brief Find all data items which intersects rect
      * The items are sorted by insertion time in ascending order.
@@ -329,6 +355,17 @@ protected:
     void insert(Node *node);
     virtual void condenseTree(Node *node, QVector<Node *> &reinsert);
 
+    // methods for bulk loading
+    struct Entry {
+        QRectF bb;
+        T data;
+        int id;
+    };
+    static QRectF normalizedBoundingBox(const QRectF &bb);
+    void bulkLoad(QVector<Entry> &entries);
+    template<typename Item, typename BoundingBox>
+    static void sortTileRecursive(QVector<Item> &items, int capacity, BoundingBox boundingBox);
+
     int m_capacity;
     int m_minimum;
     Node *m_root;
@@ -359,7 +396,7 @@ void KoRTree<T>::insert(const QRectF &bb, const T &data)
 }
 
 template<typename T>
-void KoRTree<T>::insertHelper(const QRectF &bb, const T &data, int id)
+QRectF KoRTree<T>::normalizedBoundingBox(const QRectF &bb)
 {
     QRectF nbb(bb.normalized());
     // This has to be done as it is not possible to use QRectF::united() with a isNull()
@@ -377,6 +414,13 @@ void KoRTree<T>::insertHelper(const QRectF &bb, const T &data, int id)
             nbb.setHeight(0.0001);
         }
     }
+    return nbb;
+}
+
+template<typename T>
+void KoRTree<T>::insertHelper(const QRectF &bb, const T &data, int id)
+{
+    QRectF nbb(normalizedBoundingBox(bb));
 
     LeafNode *leaf = m_root->chooseLeaf(nbb);
     // qDebug() << " leaf" << leaf->nodeId() << nbb;
@@ -402,6 +446,126 @@ void KoRTree<T>::insertHelper(const QRectF &bb, const T &data, int id)
     }
 }
 
+template<typename T>
+void KoRTree<T>::load(const QVector<QPair<QRectF, T>> &items)
+{
+    QVector<Entry> entries;
+    entries.reserve(items.size());
+    for (const QPair<QRectF, T> &item : items) {
+        entries.append(Entry{normalizedBoundingBox(item.first), item.second, LeafNode::dataIdCounter++});
+    }
+    bulkLoad(entries);
+}
+
+template<typename T>
+void KoRTree<T>::update(const QVector<QPair<QRectF, T>> &items)
+{
+    // moving a few items is cheaper than rebuilding the whole tree
+    if (items.size() < 32 || items.size() * 8 < m_leafMap.size()) {
+        for (const QPair<QRectF, T> &item : items) {
+            if (m_leafMap.contains(item.second))
+                remove(item.second);
+            insert(item.first, item.second);
+        }
+        return;
+    }
+
+    QMap<T, QRectF> moved;
+    for (const QPair<QRectF, T> &item : items) {
+        moved.insert(item.second, item.first);
+    }
+
+    // collect the unchanged items from the leaves
+    QVector<Entry> entries;
+    entries.reserve(m_leafMap.size() + items.size());
+    QSet<LeafNode *> leaves;
+    for (LeafNode *leaf : std::as_const(m_leafMap)) {
+        leaves.insert(leaf);
+    }
+    for (LeafNode *leaf : std::as_const(leaves)) {
+        for (int i = 0; i < leaf->childCount(); ++i) {
+            if (!moved.contains(leaf->getData(i)))
+                entries.append(Entry{leaf->childBoundingBox(i), leaf->getData(i), leaf->getDataId(i)});
+        }
+    }
+    // the moved ones get new ids, as if they were inserted again
+    for (const QPair<QRectF, T> &item : items) {
+        if (moved.contains(item.second)) {
+            entries.append(Entry{normalizedBoundingBox(item.first), item.second, LeafNode::dataIdCounter++});
+            moved.remove(item.second);
+        }
+    }
+    bulkLoad(entries);
+}
+
+template<typename T>
+template<typename Item, typename BoundingBox>
+void KoRTree<T>::sortTileRecursive(QVector<Item> &items, int capacity, BoundingBox boundingBox)
+{
+    // sort by x into vertical slices of sliceCount nodes, then each slice by y
+    const int nodeCount = (items.size() + capacity - 1) / capacity;
+    const int sliceCount = qCeil(qSqrt(nodeCount));
+    const int sliceSize = sliceCount * capacity;
+    std::sort(items.begin(), items.end(), [&](const Item &a, const Item &b) {
+        return boundingBox(a).center().x() < boundingBox(b).center().x();
+    });
+    for (int start = 0; start < items.size(); start += sliceSize) {
+        const auto end = items.begin() + qMin<int>(start + sliceSize, items.size());
+        std::sort(items.begin() + start, end, [&](const Item &a, const Item &b) {
+            return boundingBox(a).center().y() < boundingBox(b).center().y();
+        });
+    }
+}
+
+template<typename T>
+void KoRTree<T>::bulkLoad(QVector<Entry> &entries)
+{
+    delete m_root;
+    m_leafMap.clear();
+
+    if (entries.isEmpty()) {
+        m_root = createLeafNode(m_capacity + 1, 0, nullptr);
+        return;
+    }
+
+    // pack the items into leaves
+    sortTileRecursive(entries, m_capacity, [](const Entry &entry) {
+        return entry.bb;
+    });
+    QVector<Node *> nodes;
+    nodes.reserve((entries.size() + m_capacity - 1) / m_capacity);
+    for (int start = 0; start < entries.size(); start += m_capacity) {
+        LeafNode *leaf = createLeafNode(m_capacity + 1, 0, nullptr);
+        const int end = qMin<int>(start + m_capacity, entries.size());
+        for (int i = start; i < end; ++i) {
+            leaf->insert(entries[i].bb, entries[i].data, entries[i].id);
+            m_leafMap[entries[i].data] = leaf;
+        }
+        nodes.append(leaf);
+    }
+
+    // and the nodes into parents, until a single root is left
+    int level = 0;
+    while (nodes.size() > 1) {
+        ++level;
+        sortTileRecursive(nodes, m_capacity, [](const Node *node) {
+            return node->boundingBox();
+        });
+        QVector<Node *> parents;
+        parents.reserve((nodes.size() + m_capacity - 1) / m_capacity);
+        for (int start = 0; start < nodes.size(); start += m_capacity) {
+            NonLeafNode *parent = createNonLeafNode(m_capacity + 1, level, nullptr);
+            const int end = qMin<int>(start + m_capacity, nodes.size());
+            for (int i = start; i < end; ++i) {
+                parent->insert(nodes[i]->boundingBox(), nodes[i]);
+            }
+            parents.append(parent);
+        }
+        nodes = parents;
+    }
+    m_root = nodes.first();
+}
+
 template<typename T>
 void KoRTree<T>::insert(Node *node)
 {
@@ -65,9 +65,12 @@
 
 // KoShapePrivate
 
+QAtomicInteger<quint64> KoShapePrivate::transformationRevision(1);
+
 KoShapePrivate::KoShapePrivate(KoShape *shape)
     : q_ptr(shape)
     , size(50, 50)
+    , absoluteMatrixRevision(0)
     , parent(nullptr)
     , userData(nullptr)
     , appData(nullptr)
@@ -77,12 +80,14 @@ KoShapePrivate::KoShapePrivate(KoShape *shape)
     , clipPath(nullptr)
     , filterEffectStack(nullptr)
     , transparency(0.0)
+    , revision(1)
     , zIndex(0)
     , runThrough(0)
     , visible(true)
     , printable(true)
     , keepAspect(false)
     , detectCollision(false)
+    , rasterCache(false)
     , textRunAroundSide(KoShape::BiggestRunAroundSide)
     , textRunAroundDistanceLeft(0.0)
     , textRunAroundDistanceTop(0.0)
@@ -154,6 +159,11 @@ void KoShapePrivate::updateStroke()
     q->update(QRectF(-insets.left, inner.height(), inner.width() + insets.left + insets.right, insets.bottom));
 }
 
+void KoShapePrivate::invalidateTransformations()
+{
+    transformationRevision.fetchAndAddRelaxed(1);
+}
+
 void KoShapePrivate::addShapeManager(KoShapeManager *manager)
 {
     shapeManagers.insert(manager);
@@ -400,6 +410,10 @@ QRectF KoShape::boundingRect() const
 QTransform KoShape::absoluteTransformation(const KoViewConverter *converter) const
 {
     Q_D(const KoShape);
+    const quint64 revision = KoShapePrivate::transformationRevision.loadRelaxed();
+    if (!converter && d->absoluteMatrixRevision == revision)
+        return d->absoluteMatrix;
+
     QTransform matrix;
     // apply parents matrix to inherit any transformations done there.
     KoShapeContainer *container = d->parent;
@@ -423,7 +437,12 @@ QTransform KoShape::absoluteTransformation(const KoViewConverter *converter) con
         matrix.translate(trans.x(), trans.y());
     }
 
-    return d->localMatrix * matrix;
+    if (converter)
+        return d->localMatrix * matrix;
+
+    d->absoluteMatrix = d->localMatrix * matrix;
+    d->absoluteMatrixRevision = revision;
+    return d->absoluteMatrix;
 }
 
 void KoShape::applyAbsoluteTransformation(const QTransform &matrix)
@@ -550,10 +569,12 @@ void KoShape::setParent(KoShapeContainer *parent)
         return;
     KoShapeContainer *oldParent = d->parent;
     d->parent = nullptr; // avoids recursive removing
+    KoShapePrivate::invalidateTransformations();
     if (oldParent)
         oldParent->removeShape(this);
     if (parent && parent != this) {
         d->parent = parent;
+        KoShapePrivate::invalidateTransformations();
         parent->addShape(this);
     }
     notifyChanged();
@@ -589,7 +610,7 @@ void KoShape::update(const QRectF &rect) const
     if (!d->shapeManagers.empty() && isVisible()) {
         QRectF rc(absoluteTransformation(nullptr).mapRect(rect));
         foreach (KoShapeManager *manager, d->shapeManagers) {
-            manager->update(rc);
+            manager->update(rc, this);
         }
     }
 }
@@ -670,11 +691,15 @@ void KoShape::copySettings(const KoShape *shape)
     d->allowedInteractions = shape->allowedInteractions();
     d->keepAspect = shape->keepAspectRatio();
     d->localMatrix = shape->d_ptr->localMatrix;
+    KoShapePrivate::invalidateTransformations();
 }
 
 void KoShape::notifyChanged()
 {
     Q_D(KoShape);
+    ++d->revision;
+    // any change might affect the transformations, e.g. of the children of a resized container
+    KoShapePrivate::invalidateTransformations();
     foreach (KoShapeManager *manager, d->shapeManagers) {
         manager->notifyShapeChanged(this);
     }
@@ -1085,6 +1110,19 @@ bool KoShape::isPrintable() const
         return false;
 }
 
+void KoShape::setRasterCacheEnabled(bool enabled)
+{
+    Q_D(KoShape);
+    d->rasterCache = enabled;
+    update();
+}
+
+bool KoShape::isRasterCacheEnabled() const
+{
+    Q_D(const KoShape);
+    return d->rasterCache;
+}
+
 void KoShape::setSelectable(bool selectable)
 {
     Q_D(KoShape);
@@ -1222,7 +1260,11 @@ void KoShape::setShapeId(const QString &id)
 void KoShape::setCollisionDetection(bool detect)
 {
     Q_D(KoShape);
+    if (d->detectCollision == detect)
+        return;
     d->detectCollision = detect;
+    // the shape managers only look for collisions if a shape is interested in them
+    notifyChanged();
 }
 
 bool KoShape::collisionDetection()
@@ -609,6 +609,19 @@ public:
      */
     bool isPrintable() const;
 
+    /**
+     * Lets the shape managers keep a rendering of this shape at device resolution, which
+     * is painted instead of the shape until the shape changes or it is shown at a different
+     * zoom or transformation. The default is false.
+     *
+     * Meant for shapes that are expensive to paint, like complex paths or artistic text;
+     * panning the view then only copies the rendering.
+     */
+    void setRasterCacheEnabled(bool enabled);
+
+    /// Returns if the shape managers cache a rendering of this shape
+    bool isRasterCacheEnabled() const;
+
     /**
      * Makes it possible for the user to select this shape.
      * This parameter defaults to true.
@@ -136,6 +136,7 @@ void KoShapeContainer::setInheritsTransform(const KoShape *shape, bool inherit)
     if (d->model == nullptr)
         return;
     d->model->setInheritsTransform(shape, inherit);
+    KoShapePrivate::invalidateTransformations();
 }
 
 bool KoShapeContainer::inheritsTransform(const KoShape *shape) const
@@ -31,8 +31,10 @@
 #include <KoRTree.h>
 
 #include <FlakeDebug.h>
+#include <QCoreApplication>
 #include <QPainter>
 #include <QPainterPath>
+#include <QThread>
 #include <QTimer>
 
 #include <algorithm>
@@ -40,26 +42,33 @@
 void KoShapeManager::Private::updateTree()
 {
     // for detecting collisions between shapes.
+    // only shapes which want to know about collisions are reported, so without any there is nothing to do
+    const bool detectCollisions = !collisionDetectionShapes.isEmpty();
     DetectCollision detector;
     bool selectionModified = false;
     bool anyModified = false;
     foreach (KoShape *shape, aggregate4update) {
-        if (shapeIndexesBeforeUpdate.contains(shape))
+        if (detectCollisions && shapeIndexesBeforeUpdate.contains(shape))
             detector.detect(tree, shape, shapeIndexesBeforeUpdate[shape]);
         selectionModified = selectionModified || selection->isSelected(shape);
         anyModified = true;
     }
 
+    QVector<QPair<QRectF, KoShape *>> boundingRects;
+    boundingRects.reserve(aggregate4update.size());
     foreach (KoShape *shape, aggregate4update) {
-        tree.remove(shape);
         QRectF br(shape->boundingRect());
         strategy->adapt(shape, br);
-        tree.insert(br, shape);
+        boundingRects.append(qMakePair(br, shape));
     }
+    // moves all shapes at once, which rebuilds the tree if many of them changed
+    tree.update(boundingRects);
 
     // do it again to see which shapes we intersect with _after_ moving.
-    foreach (KoShape *shape, aggregate4update)
-        detector.detect(tree, shape, shapeIndexesBeforeUpdate[shape]);
+    if (detectCollisions) {
+        foreach (KoShape *shape, aggregate4update)
+            detector.detect(tree, shape, shapeIndexesBeforeUpdate[shape]);
+    }
     aggregate4update.clear();
     shapeIndexesBeforeUpdate.clear();
 
@@ -92,6 +101,107 @@ void KoShapeManager::Private::paintGroup(KoShapeGroup *group, QPainter &painter,
     }
 }
 
+KoShape *KoShapeManager::Private::paintedShape(KoShape *shape)
+{
+    const auto it = paintedShapes.constFind(shape);
+    if (it != paintedShapes.constEnd())
+        return it.value();
+
+    KoShape *result = shape;
+    // check if one of the shapes ancestors have filter effects
+    for (KoShapeContainer *parent = shape->parent(); parent; parent = parent->parent()) {
+        // parent must be part of the shape manager to be taken into account
+        if (!shapeSet.contains(parent))
+            break;
+        if (parent->filterEffectStack() && !parent->filterEffectStack()->isEmpty()) {
+            result = parent;
+            break;
+        }
+    }
+    paintedShapes.insert(shape, result);
+    return result;
+}
+
+void KoShapeManager::Private::invalidateCaches(const KoShape *shape)
+{
+    if (filterEffectResults.isEmpty() && rasterCache.isEmpty())
+        return;
+    for (const KoShape *s = shape; s; s = s->parent()) {
+        filterEffectResults.remove(s);
+        const auto it = rasterCache.constFind(s);
+        if (it != rasterCache.constEnd()) {
+            QPixmapCache::remove(it->key);
+            rasterCache.erase(it);
+        }
+    }
+}
+
+bool KoShapeManager::Private::paintRasterCache(KoShape *shape, QPainter &painter, const KoViewConverter &converter, KoShapePaintingContext &paintContext)
+{
+    // pixmaps are only for the screen and the gui thread
+    const int deviceType = painter.device()->devType();
+    if (deviceType != QInternal::Widget && deviceType != QInternal::Pixmap && deviceType != QInternal::Image)
+        return false;
+    if (QThread::currentThread() != QCoreApplication::instance()->thread())
+        return false;
+
+    qreal zoomX = 0;
+    qreal zoomY = 0;
+    converter.zoom(&zoomX, &zoomY);
+    const QTransform transform = painter.transform();
+    const QTransform linear(transform.m11(), transform.m12(), transform.m13(), transform.m21(), transform.m22(), transform.m23(), 0, 0, transform.m33());
+    const qreal pixelRatio = painter.device()->devicePixelRatioF();
+
+    // panning only changes the translation, the rendering is moved then
+    QPixmap pixmap;
+    auto it = rasterCache.find(shape);
+    if (it == rasterCache.end() || it->transform != linear || it->zoomX != zoomX || it->zoomY != zoomY || it->pixelRatio != pixelRatio
+        || !QPixmapCache::find(it->key, &pixmap)) {
+        // the bounding rect in device coordinates, with room for antialiasing
+        const QTransform view = shape->absoluteTransformation(&converter).inverted() * transform;
+        const QRect deviceRect = view.mapRect(converter.documentToView(shape->boundingRect())).toAlignedRect().adjusted(-1, -1, 1, 1);
+        if (deviceRect.isEmpty() || qint64(deviceRect.width()) * deviceRect.height() > RASTER_CACHE_MAX_AREA)
+            return false;
+
+        pixmap = QPixmap(deviceRect.size() * pixelRatio);
+        pixmap.setDevicePixelRatio(pixelRatio);
+        pixmap.fill(Qt::transparent);
+        QPainter cachePainter(&pixmap);
+        cachePainter.setRenderHints(painter.renderHints());
+        cachePainter.setPen(Qt::NoPen);
+        cachePainter.setBrush(Qt::NoBrush);
+        cachePainter.setTransform(transform * QTransform::fromTranslate(-deviceRect.left(), -deviceRect.top()));
+        renderingRasterCache = true;
+        q->paintShape(shape, cachePainter, converter, paintContext);
+        renderingRasterCache = false;
+        cachePainter.end();
+
+        if (it != rasterCache.end())
+            QPixmapCache::remove(it->key);
+        RasterCacheEntry entry;
+        entry.key = QPixmapCache::insert(pixmap);
+        entry.transform = linear;
+        entry.zoomX = zoomX;
+        entry.zoomY = zoomY;
+        entry.pixelRatio = pixelRatio;
+        entry.origin = transform.map(QPointF()) - deviceRect.topLeft();
+        it = rasterCache.insert(shape, entry);
+    }
+
+    painter.save();
+    painter.setWorldTransform(QTransform());
+    painter.drawPixmap((transform.map(QPointF()) - it->origin).toPoint(), pixmap);
+    painter.restore();
+    return true;
+}
+
+void KoShapeManager::Private::clearRasterCache()
+{
+    for (const RasterCacheEntry &entry : std::as_const(rasterCache))
+        QPixmapCache::remove(entry.key);
+    rasterCache.clear();
+}
+
 KoShapeManager::KoShapeManager(KoCanvasBase *canvas, const QList<KoShape *> &shapes)
     : d(new Private(this, canvas))
 {
@@ -128,6 +238,11 @@ void KoShapeManager::setShapes(const QList<KoShape *> &shapes, Repaint repaint)
     d->aggregate4update.clear();
     d->tree.clear();
     d->shapes.clear();
+    d->shapeSet.clear();
+    d->collisionDetectionShapes.clear();
+    d->paintedShapes.clear();
+    d->filterEffectResults.clear();
+    d->clearRasterCache();
     foreach (KoShape *shape, shapes) {
         addShape(shape, repaint);
     }
@@ -135,10 +250,14 @@ void KoShapeManager::setShapes(const QList<KoShape *> &shapes, Repaint repaint)
 
 void KoShapeManager::addShape(KoShape *shape, Repaint repaint)
 {
-    if (d->shapes.contains(shape))
+    if (d->shapeSet.contains(shape))
         return;
     shape->priv()->addShapeManager(this);
     d->shapes.append(shape);
+    d->shapeSet.insert(shape);
+    d->paintedShapes.clear();
+    if (shape->collisionDetection())
+        d->collisionDetectionShapes.insert(shape);
     if (!dynamic_cast<KoShapeGroup *>(shape) && !dynamic_cast<KoShapeLayer *>(shape)) {
         QRectF br(shape->boundingRect());
         d->tree.insert(br, shape);
@@ -156,9 +275,11 @@ void KoShapeManager::addShape(KoShape *shape, Repaint repaint)
         }
     }
 
-    Private::DetectCollision detector;
-    detector.detect(d->tree, shape, shape->zIndex());
-    detector.fireSignals();
+    if (!d->collisionDetectionShapes.isEmpty()) {
+        Private::DetectCollision detector;
+        detector.detect(d->tree, shape, shape->zIndex());
+        detector.fireSignals();
+    }
 }
 
 void KoShapeManager::addAdditional(KoShape *shape)
@@ -182,8 +303,12 @@ void KoShapeManager::remove(KoShape *shape)
     shape->priv()->removeShapeManager(this);
     d->selection->deselect(shape);
     d->aggregate4update.remove(shape);
+    d->invalidateCaches(shape);
     d->tree.remove(shape);
     d->shapes.removeAll(shape);
+    d->shapeSet.remove(shape);
+    d->collisionDetectionShapes.remove(shape);
+    d->paintedShapes.clear();
 
     // remove the children of a KoShapeContainer
     KoShapeContainer *container = dynamic_cast<KoShapeContainer *>(shape);
@@ -222,28 +347,19 @@ void KoShapeManager::paint(QPainter &painter, const KoViewConverter &converter,
     }
 
     // filter all hidden shapes from the list
-    // also filter shapes with a parent which has filter effects applied
+    // also replace shapes with a parent which has filter effects applied by that parent
     QList<KoShape *> sortedShapes;
+    QSet<KoShape *> filteredParents;
     foreach (KoShape *shape, unsortedShapes) {
         if (!shape->isVisible(true))
             continue;
-        bool addShapeToList = true;
-        // check if one of the shapes ancestors have filter effects
-        KoShapeContainer *parent = shape->parent();
-        while (parent) {
-            // parent must be part of the shape manager to be taken into account
-            if (!d->shapes.contains(parent))
-                break;
-            if (parent->filterEffectStack() && !parent->filterEffectStack()->isEmpty()) {
-                addShapeToList = false;
-                break;
-            }
-            parent = parent->parent();
-        }
-        if (addShapeToList) {
+        KoShape *paintedShape = d->paintedShape(shape);
+        if (paintedShape == shape) {
             sortedShapes.append(shape);
-        } else if (parent) {
-            sortedShapes.append(parent);
+        } else if (!filteredParents.contains(paintedShape)) {
+            // the parent paints all of its children at once
+            filteredParents.insert(paintedShape);
+            sortedShapes.append(paintedShape);
         }
     }
 
@@ -284,6 +400,9 @@ void KoShapeManager::paint(QPainter &painter, const KoViewConverter &converter,
 
 void KoShapeManager::paintShape(KoShape *shape, QPainter &painter, const KoViewConverter &converter, KoShapePaintingContext &paintContext)
 {
+    if (shape->isRasterCacheEnabled() && !d->renderingRasterCache && d->paintRasterCache(shape, painter, converter, paintContext))
+        return;
+
     qreal transparency = shape->transparency(true);
     if (transparency > 0.0) {
         painter.setOpacity(1.0 - transparency);
@@ -313,103 +432,126 @@ void KoShapeManager::paintShape(KoShape *shape, QPainter &painter, const KoViewC
         // determine the offset of the clipping rect from the shapes origin
         QPointF clippingOffset = zoomedClipRegion.topLeft();
 
-        // Initialize the buffer image
-        QImage sourceGraphic(zoomedClipRegion.size().toSize(), QImage::Format_ARGB32_Premultiplied);
-        sourceGraphic.fill(qRgba(0, 0, 0, 0));
-
-        QHash<QString, QImage> imageBuffers;
-
-        QSet<QString> requiredStdInputs = shape->filterEffectStack()->requiredStandarsInputs();
-
-        if (requiredStdInputs.contains("SourceGraphic") || requiredStdInputs.contains("SourceAlpha")) {
-            // Init the buffer painter
-            QPainter imagePainter(&sourceGraphic);
-            imagePainter.translate(-1.0f * clippingOffset);
-            imagePainter.setPen(Qt::NoPen);
-            imagePainter.setBrush(Qt::NoBrush);
-            imagePainter.setRenderHint(QPainter::Antialiasing, painter.testRenderHint(QPainter::Antialiasing));
-
-            // Paint the shape on the image
-            KoShapeGroup *group = dynamic_cast<KoShapeGroup *>(shape);
-            if (group) {
-                // the childrens matrix contains the groups matrix as well
-                // so we have to compensate for that before painting the children
-                imagePainter.setTransform(group->absoluteTransformation(&converter).inverted(), true);
-                d->paintGroup(group, imagePainter, converter, paintContext);
-            } else {
-                imagePainter.save();
-                shape->paint(imagePainter, converter, paintContext);
-                imagePainter.restore();
-                if (shape->stroke()) {
+        qreal zoomX = 0;
+        qreal zoomY = 0;
+        converter.zoom(&zoomX, &zoomY);
+        const bool antialiasing = painter.testRenderHint(QPainter::Antialiasing);
+        QList<KoFilterEffect *> filterEffects = shape->filterEffectStack()->filterEffects();
+
+        // Reuse the result of the last painting if neither the shape nor the filter effects
+        // changed in between; any change of the shape invalidates it with the update
+        QImage filtered;
+        Private::FilterEffectResult *cached = d->filterEffectResults.object(shape);
+        if (cached && cached->zoomX == zoomX && cached->zoomY == zoomY && cached->antialiasing == antialiasing
+            && cached->stack == shape->filterEffectStack() && cached->effects == filterEffects) {
+            filtered = cached->image;
+        } else {
+            // Initialize the buffer image
+            QImage sourceGraphic(zoomedClipRegion.size().toSize(), QImage::Format_ARGB32_Premultiplied);
+            sourceGraphic.fill(qRgba(0, 0, 0, 0));
+
+            QHash<QString, QImage> imageBuffers;
+
+            QSet<QString> requiredStdInputs = shape->filterEffectStack()->requiredStandarsInputs();
+
+            if (requiredStdInputs.contains("SourceGraphic") || requiredStdInputs.contains("SourceAlpha")) {
+                // Init the buffer painter
+                QPainter imagePainter(&sourceGraphic);
+                imagePainter.translate(-1.0f * clippingOffset);
+                imagePainter.setPen(Qt::NoPen);
+                imagePainter.setBrush(Qt::NoBrush);
+                imagePainter.setRenderHint(QPainter::Antialiasing, antialiasing);
+
+                // Paint the shape on the image
+                KoShapeGroup *group = dynamic_cast<KoShapeGroup *>(shape);
+                if (group) {
+                    // the childrens matrix contains the groups matrix as well
+                    // so we have to compensate for that before painting the children
+                    imagePainter.setTransform(group->absoluteTransformation(&converter).inverted(), true);
+                    d->paintGroup(group, imagePainter, converter, paintContext);
+                } else {
                     imagePainter.save();
-                    shape->stroke()->paint(shape, imagePainter, converter);
+                    shape->paint(imagePainter, converter, paintContext);
                     imagePainter.restore();
+                    if (shape->stroke()) {
+                        imagePainter.save();
+                        shape->stroke()->paint(shape, imagePainter, converter);
+                        imagePainter.restore();
+                    }
+                    imagePainter.end();
                 }
-                imagePainter.end();
             }
-        }
-        if (requiredStdInputs.contains("SourceAlpha")) {
-            QImage sourceAlpha = sourceGraphic.convertToFormat(QImage::Format_Alpha8);
-            sourceAlpha.fill(qRgba(0, 0, 0, 255));
-            imageBuffers.insert("SourceAlpha", sourceAlpha);
-        }
-        if (requiredStdInputs.contains("FillPaint")) {
-            QImage fillPaint = sourceGraphic;
-            if (shape->background()) {
-                QPainter fillPainter(&fillPaint);
-                QPainterPath fillPath;
-                fillPath.addRect(fillPaint.rect().adjusted(-1, -1, 1, 1));
-                shape->background()->paint(fillPainter, converter, paintContext, fillPath);
-            } else {
-                fillPaint.fill(qRgba(0, 0, 0, 0));
+            if (requiredStdInputs.contains("SourceAlpha")) {
+                QImage sourceAlpha = sourceGraphic.convertToFormat(QImage::Format_Alpha8);
+                sourceAlpha.fill(qRgba(0, 0, 0, 255));
+                imageBuffers.insert("SourceAlpha", sourceAlpha);
             }
-            imageBuffers.insert("FillPaint", fillPaint);
-        }
-
-        imageBuffers.insert("SourceGraphic", sourceGraphic);
-        imageBuffers.insert(QString(), sourceGraphic);
-
-        KoFilterEffectRenderContext renderContext(converter);
-        renderContext.setShapeBoundingBox(shapeBound);
-
-        QImage result;
-        QList<KoFilterEffect *> filterEffects = shape->filterEffectStack()->filterEffects();
-        // Filter
-        foreach (KoFilterEffect *filterEffect, filterEffects) {
-            QRectF filterRegion = filterEffect->filterRectForBoundingRect(shapeBound);
-            filterRegion = converter.documentToView(filterRegion);
-            QRect subRegion = filterRegion.translated(-clippingOffset).toRect();
-            // set current filter region
-            renderContext.setFilterRegion(subRegion & sourceGraphic.rect());
-
-            if (filterEffect->maximalInputCount() <= 1) {
-                QList<QString> inputs = filterEffect->inputs();
-                QString input = inputs.count() ? inputs.first() : QString();
-                // get input image from image buffers and apply the filter effect
-                QImage image = imageBuffers.value(input);
-                if (!image.isNull()) {
-                    result = filterEffect->processImage(imageBuffers.value(input), renderContext);
+            if (requiredStdInputs.contains("FillPaint")) {
+                QImage fillPaint = sourceGraphic;
+                if (shape->background()) {
+                    QPainter fillPainter(&fillPaint);
+                    QPainterPath fillPath;
+                    fillPath.addRect(fillPaint.rect().adjusted(-1, -1, 1, 1));
+                    shape->background()->paint(fillPainter, converter, paintContext, fillPath);
+                } else {
+                    fillPaint.fill(qRgba(0, 0, 0, 0));
                 }
-            } else {
-                QVector<QImage> inputImages;
-                foreach (const QString &input, filterEffect->inputs()) {
+                imageBuffers.insert("FillPaint", fillPaint);
+            }
+
+            imageBuffers.insert("SourceGraphic", sourceGraphic);
+            imageBuffers.insert(QString(), sourceGraphic);
+
+            KoFilterEffectRenderContext renderContext(converter);
+            renderContext.setShapeBoundingBox(shapeBound);
+
+            QImage result;
+            // Filter
+            foreach (KoFilterEffect *filterEffect, filterEffects) {
+                QRectF filterRegion = filterEffect->filterRectForBoundingRect(shapeBound);
+                filterRegion = converter.documentToView(filterRegion);
+                QRect subRegion = filterRegion.translated(-clippingOffset).toRect();
+                // set current filter region
+                renderContext.setFilterRegion(subRegion & sourceGraphic.rect());
+
+                if (filterEffect->maximalInputCount() <= 1) {
+                    QList<QString> inputs = filterEffect->inputs();
+                    QString input = inputs.count() ? inputs.first() : QString();
+                    // get input image from image buffers and apply the filter effect
                     QImage image = imageBuffers.value(input);
-                    if (!image.isNull())
-                        inputImages.append(imageBuffers.value(input));
+                    if (!image.isNull()) {
+                        result = filterEffect->processImage(imageBuffers.value(input), renderContext);
+                    }
+                } else {
+                    QVector<QImage> inputImages;
+                    foreach (const QString &input, filterEffect->inputs()) {
+                        QImage image = imageBuffers.value(input);
+                        if (!image.isNull())
+                            inputImages.append(imageBuffers.value(input));
+                    }
+                    // apply the filter effect
+                    if (filterEffect->inputs().count() == inputImages.count())
+                        result = filterEffect->processImages(inputImages, renderContext);
                 }
-                // apply the filter effect
-                if (filterEffect->inputs().count() == inputImages.count())
-                    result = filterEffect->processImages(inputImages, renderContext);
+                // store result of effect
+                imageBuffers.insert(filterEffect->output(), result);
             }
-            // store result of effect
-            imageBuffers.insert(filterEffect->output(), result);
-        }
 
-        KoFilterEffect *lastEffect = filterEffects.last();
+            filtered = imageBuffers.value(filterEffects.last()->output());
+
+            Private::FilterEffectResult *entry = new Private::FilterEffectResult;
+            entry->image = filtered;
+            entry->zoomX = zoomX;
+            entry->zoomY = zoomY;
+            entry->antialiasing = antialiasing;
+            entry->stack = shape->filterEffectStack();
+            entry->effects = filterEffects;
+            d->filterEffectResults.insert(shape, entry, qMax<qsizetype>(1, filtered.sizeInBytes() / 1024));
+        }
 
         // Paint the result
         painter.save();
-        painter.drawImage(clippingOffset, imageBuffers.value(lastEffect->output()));
+        painter.drawImage(clippingOffset, filtered);
         painter.restore();
     }
 }
@@ -486,6 +628,12 @@ QList<KoShape *> KoShapeManager::shapesAt(const QRectF &rect, bool omitHiddenSha
 
 void KoShapeManager::update(QRectF &rect, const KoShape *shape, bool selectionHandles)
 {
+    if (shape) {
+        d->invalidateCaches(shape);
+        // the filter effects of a container might have been changed in place
+        if (!d->paintedShapes.isEmpty() && dynamic_cast<const KoShapeContainer *>(shape))
+            d->paintedShapes.clear();
+    }
     d->canvas->updateCanvas(rect);
     if (selectionHandles && d->selection->isSelected(shape)) {
         if (d->canvas->toolProxy())
@@ -496,6 +644,13 @@ void KoShapeManager::update(QRectF &rect, const KoShape *shape, bool selectionHa
 void KoShapeManager::notifyShapeChanged(KoShape *shape)
 {
     Q_ASSERT(shape);
+    d->invalidateCaches(shape);
+    // reparenting or new filter effects change which shape paints which
+    d->paintedShapes.clear();
+    if (shape->collisionDetection())
+        d->collisionDetectionShapes.insert(shape);
+    else
+        d->collisionDetectionShapes.remove(shape);
     if (d->aggregate4update.contains(shape) || d->additionalShapes.contains(shape)) {
         return;
     }
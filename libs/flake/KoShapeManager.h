@@ -142,7 +142,8 @@ public:
      * <p>This method will return immediately and only request a repaint. Successive calls
      * will be merged into an appropriate repaint action.
      * @param rect the rectangle (in pt) to queue for repaint.
-     * @param shape the shape that is going to be redrawn; only needed when selectionHandles=true
+     * @param shape the shape that is going to be redrawn; its cached filter effect result is
+     *   dropped. Needed when selectionHandles=true
      * @param selectionHandles if true; find out if the shape is selected and repaint its
      *   selection handles at the same time.
      */
@@ -31,9 +31,19 @@
 #include <KoRTree.h>
 
 #include <FlakeDebug.h>
+#include <QCache>
+#include <QHash>
 #include <QPainter>
+#include <QPixmapCache>
+#include <QSet>
 #include <QTimer>
 
+/// the memory budget of the cached filter effect results in KiB
+#define FILTER_EFFECT_CACHE_SIZE (32 * 1024)
+
+/// the maximal size of the raster cache of one shape in device pixels
+#define RASTER_CACHE_MAX_AREA (2048 * 2048)
+
 class Q_DECL_HIDDEN KoShapeManager::Private
 {
 public:
@@ -42,12 +52,15 @@ public:
         , canvas(c)
         , tree(4, 2)
         , strategy(new KoShapeManagerPaintingStrategy(shapeManager))
+        , filterEffectResults(FILTER_EFFECT_CACHE_SIZE)
+        , renderingRasterCache(false)
         , q(shapeManager)
     {
     }
 
     ~Private()
     {
+        clearRasterCache();
         delete selection;
         delete strategy;
     }
@@ -65,6 +78,50 @@ public:
      */
     void paintGroup(KoShapeGroup *group, QPainter &painter, const KoViewConverter &converter, KoShapePaintingContext &paintContext);
 
+    /**
+     * Return the shape that paints @p shape: the nearest ancestor which has filter effects,
+     * as those apply to all of its children at once, or @p shape itself.
+     */
+    KoShape *paintedShape(KoShape *shape);
+
+    /**
+     * Drop the cached filter effect results and renderings of @p shape and of the groups
+     * containing it, as theirs include the painting of @p shape.
+     */
+    void invalidateCaches(const KoShape *shape);
+
+    /**
+     * Paint @p shape from its raster cache, rendering that first if it is missing or out of
+     * date. Returns false if the shape has to be painted directly instead, e.g. because
+     * @p painter is not painting on screen.
+     */
+    bool paintRasterCache(KoShape *shape, QPainter &painter, const KoViewConverter &converter, KoShapePaintingContext &paintContext);
+
+    /// remove all renderings of the shapes from the raster cache
+    void clearRasterCache();
+
+    /// The filtered image of a shape, reused until the shape changes or is painted differently
+    struct FilterEffectResult {
+        QImage image;
+        qreal zoomX;
+        qreal zoomY;
+        bool antialiasing;
+        const KoFilterEffectStack *stack;
+        QList<KoFilterEffect *> effects;
+    };
+
+    /// A rendering of a shape at device resolution, the pixmap itself is in QPixmapCache
+    struct RasterCacheEntry {
+        QPixmapCache::Key key;
+        /// the transformation of the painter without the translation
+        QTransform transform;
+        qreal zoomX;
+        qreal zoomY;
+        qreal pixelRatio;
+        /// the position of the shape origin in the pixmap
+        QPointF origin;
+    };
+
     class DetectCollision
     {
     public:
@@ -100,6 +157,10 @@ public:
     };
 
     QList<KoShape *> shapes;
+    QSet<KoShape *> shapeSet; // the same as shapes, for fast lookups
+    // cache of paintedShape(), cleared whenever the shapes or their hierarchy change
+    QHash<const KoShape *, KoShape *> paintedShapes;
+    QSet<KoShape *> collisionDetectionShapes; ///< the shapes which have collision detection enabled
     QList<KoShape *> additionalShapes; // these are shapes that are only handled for updates
     KoSelection *selection;
     KoCanvasBase *canvas;
@@ -107,6 +168,9 @@ public:
     QSet<KoShape *> aggregate4update;
     QHash<KoShape *, int> shapeIndexesBeforeUpdate;
     KoShapeManagerPaintingStrategy *strategy;
+    QCache<const KoShape *, FilterEffectResult> filterEffectResults;
+    QHash<const KoShape *, RasterCacheEntry> rasterCache;
+    bool renderingRasterCache;
     KoShapeManager *q;
 };
 
@@ -9,6 +9,7 @@
 
 #include "KoShape.h"
 
+#include <QAtomicInteger>
 #include <QPaintDevice>
 #include <QPoint>
 #include <QTransform>
@@ -45,6 +46,15 @@ public:
     /// calls update on the shape where the stroke is.
     void updateStroke();
 
+    /**
+     * Mark the cached absolute transformations of all shapes as outdated.
+     *
+     * As the transformation of a shape depends on the ones of all its ancestors this is
+     * done with a single global revision, which is much cheaper than visiting all
+     * descendants of a changed shape.
+     */
+    static void invalidateTransformations();
+
     // Members
 
     KoShape *q_ptr; // Points the shape that owns this class.
@@ -54,6 +64,10 @@ public:
     QString name; ///< the shapes names
 
     QTransform localMatrix; ///< the shapes local transformation matrix
+    mutable QTransform absoluteMatrix; ///< cached absoluteTransformation() without a view converter
+    mutable quint64 absoluteMatrixRevision; ///< the transformationRevision absoluteMatrix is valid for
+    /// increased whenever the transformation of any shape changes
+    static QAtomicInteger<quint64> transformationRevision;
 
     KoConnectionPoints connectors; ///< glue point id to data mapping
 
@@ -74,6 +88,7 @@ public:
     KoFilterEffectStack *filterEffectStack; ///< stack of filter effects applied to the shape
     qreal transparency; ///< the shapes transparency
     QString hyperLink; // hyperlink for this shape
+    quint64 revision; ///< increased with every change of the shape, used to validate caches of its geometry
 
     static const int MaxZIndex = 32767;
     int zIndex : 16; // keep maxZIndex in sync!
@@ -82,6 +97,7 @@ public:
     int printable : 1;
     int keepAspect : 1;
     int detectCollision : 1;
+    int rasterCache : 1;
 
     KoShape::TextRunAroundSide textRunAroundSide;
     qreal textRunAroundDistanceLeft;
@@ -0,0 +1,105 @@
+/* This file is part of the KDE project
+ * SPDX-FileCopyrightText: 2026 Calligra developers
+ *
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#include "KoShapeManagerBenchmark.h"
+
+#include <KoShapeGroup.h>
+#include <KoShapeManager.h>
+#include <KoViewConverter.h>
+
+#include <MockShapes.h>
+
+#include <QImage>
+#include <QPainter>
+#include <QTest>
+
+namespace
+{
+/**
+ * Create a tree of nested groups, @p depth levels deep with @p fanOut children per group,
+ * and with the leaves laid out in a grid, like the drawings imported from CAD applications.
+ */
+KoShape *createTree(int depth, int fanOut, int *leafCount)
+{
+    if (depth == 0) {
+        MockShape *shape = new MockShape();
+        const int index = (*leafCount)++;
+        shape->setPosition(QPointF((index % 256) * 4, (index / 256) * 4));
+        shape->setSize(QSizeF(3, 3));
+        return shape;
+    }
+
+    KoShapeGroup *group = new KoShapeGroup();
+    for (int i = 0; i < fanOut; ++i) {
+        group->addShape(createTree(depth - 1, fanOut, leafCount));
+    }
+    return group;
+}
+
+void addTrees()
+{
+    QTest::addColumn<int>("depth");
+    QTest::addColumn<int>("fanOut");
+    QTest::newRow("flat 4096") << 1 << 4096;
+    QTest::newRow("depth 4, 4096 leaves") << 4 << 8;
+    QTest::newRow("depth 8, 6561 leaves") << 8 << 3;
+    QTest::newRow("depth 12, 4096 leaves") << 12 << 2;
+}
+}
+
+void KoShapeManagerBenchmark::benchmarkAddShapes_data()
+{
+    addTrees();
+}
+
+void KoShapeManagerBenchmark::benchmarkAddShapes()
+{
+    QFETCH(int, depth);
+    QFETCH(int, fanOut);
+
+    int leafCount = 0;
+    KoShape *root = createTree(depth, fanOut, &leafCount);
+
+    MockCanvas canvas;
+    QBENCHMARK {
+        KoShapeManager manager(&canvas);
+        manager.addShape(root, KoShapeManager::AddWithoutRepaint);
+    }
+
+    delete root;
+}
+
+void KoShapeManagerBenchmark::benchmarkPaint_data()
+{
+    addTrees();
+}
+
+void KoShapeManagerBenchmark::benchmarkPaint()
+{
+    QFETCH(int, depth);
+    QFETCH(int, fanOut);
+
+    int leafCount = 0;
+    KoShape *root = createTree(depth, fanOut, &leafCount);
+
+    MockCanvas canvas;
+    KoShapeManager manager(&canvas);
+    manager.addShape(root, KoShapeManager::AddWithoutRepaint);
+
+    // the leaves cover 1024 x rows * 4 points, 1 point is painted as 1 pixel
+    QImage image(1024, (leafCount / 256 + 1) * 4, QImage::Format_ARGB32_Premultiplied);
+    KoViewConverter converter;
+
+    QBENCHMARK {
+        QPainter painter(&image);
+        painter.setClipRect(image.rect());
+        manager.paint(painter, converter, false);
+    }
+
+    delete root;
+}
+
+QTEST_MAIN(KoShapeManagerBenchmark)
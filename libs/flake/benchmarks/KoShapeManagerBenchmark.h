@@ -0,0 +1,22 @@
+/* This file is part of the KDE project
+ * SPDX-FileCopyrightText: 2026 Calligra developers
+ *
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#ifndef KOSHAPEMANAGERBENCHMARK_H
+#define KOSHAPEMANAGERBENCHMARK_H
+
+#include <QObject>
+
+class KoShapeManagerBenchmark : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void benchmarkAddShapes_data();
+    void benchmarkAddShapes();
+    void benchmarkPaint_data();
+    void benchmarkPaint();
+};
+
+#endif
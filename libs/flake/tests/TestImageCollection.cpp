@@ -10,11 +10,13 @@
 #include <KoImageCollection.h>
 #include <KoImageData.h>
 #include <KoStore.h>
+#include <KoUnit.h>
 
 #include <FlakeDebug.h>
 #include <QBuffer>
 #include <QImage>
 #include <QPixmap>
+#include <QSignalSpy>
 #include <QUrl>
 
 #include <QTest>
@@ -234,4 +236,71 @@ void TestImageCollection::testIsValid()
     QCOMPARE(data.isValid(), false);
 }
 
+void TestImageCollection::testMipmaps()
+{
+    KoImageCollection collection;
+    KoStore *store = KoStore::createStore(QFINDTESTDATA("store.zip"), KoStore::Read);
+    KoImageData *data = collection.createImageData(QString("logo-calligra.jpg"), store);
+    delete store;
+    QCOMPARE(data->hasCachedImage(), false);
+
+    const QSize fullSize = QImage(QFINDTESTDATA("logo-calligra.jpg")).size();
+    QCOMPARE(data->pixelSize(), fullSize);
+    QCOMPARE(data->hasCachedImage(), false);
+
+    // a level of the pyramid just large enough, without decoding the full image
+    const QSize small(fullSize.width() / 5, fullSize.height() / 5);
+    QImage mipmap = data->image(small);
+    QVERIFY(mipmap.width() >= small.width());
+    QVERIFY(mipmap.height() >= small.height());
+    QVERIFY(mipmap.width() < fullSize.width() / 2);
+    QCOMPARE(data->hasCachedImage(), false);
+
+    // shared by other users of the same image
+    KoImageData *data2 = new KoImageData(*data);
+    QCOMPARE(data2->image(small).cacheKey(), mipmap.cacheKey());
+
+    QPixmap pixmap = data->pixmap(small);
+    QCOMPARE(pixmap.size(), small);
+    QCOMPARE(data->hasCachedImage(), false);
+
+    // larger than the first level, so the full image
+    QCOMPARE(data->image(fullSize).size(), fullSize);
+
+    delete data2;
+    delete data;
+}
+
+void TestImageCollection::testRequestImage()
+{
+    KoImageCollection collection;
+    KoStore *store = KoStore::createStore(QFINDTESTDATA("store.zip"), KoStore::Read);
+    KoImageData *data = collection.createImageData(QString("logo-calligra.jpg"), store);
+    delete store;
+
+    // the size in points is read from the header
+    const QImage reference(QFINDTESTDATA("logo-calligra.jpg"));
+    const QSizeF imageSize = data->imageSize();
+    QCOMPARE(data->hasCachedImage(), false);
+    QCOMPARE(imageSize.width(), DM_TO_POINT(reference.width() / (qreal)reference.dotsPerMeterX() * 10.0));
+    QCOMPARE(imageSize.height(), DM_TO_POINT(reference.height() / (qreal)reference.dotsPerMeterY() * 10.0));
+
+    // returns right away and decodes in the background
+    const QSize small(reference.width() / 5, reference.height() / 5);
+    QSignalSpy spy(data, &KoImageData::imageLoaded);
+    QVERIFY(data->requestImage(small).isNull());
+    QVERIFY(data->requestImage(small).isNull());
+    QVERIFY(spy.wait());
+    QCOMPARE(spy.count(), 1);
+
+    const QImage image = data->requestImage(small);
+    QVERIFY(!image.isNull());
+    QVERIFY(image.width() >= small.width());
+    QVERIFY(image.width() < reference.width() / 2);
+    QCOMPARE(image.cacheKey(), data->image(small).cacheKey());
+    QCOMPARE(data->hasCachedImage(), false);
+
+    delete data;
+}
+
 QTEST_MAIN(TestImageCollection)
@@ -25,6 +25,8 @@ private Q_SLOTS:
     void testPreload3();
     void testSameKey();
     void testIsValid();
+    void testMipmaps();
+    void testRequestImage();
 };
 
 #endif /* TESTIMAGECOLLECTION_H */
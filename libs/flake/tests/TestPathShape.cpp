@@ -10,6 +10,7 @@
 #include "KoPathSegment.h"
 #include "KoPathShape.h"
 #include <QPainterPath>
+#include <QPen>
 
 #include <QTest>
 
@@ -771,4 +772,56 @@ void TestPathShape::closeMerge()
     QVERIFY(path.outline() == ppath);
 }
 
+void TestPathShape::outlineCache()
+{
+    KoPathShape path;
+    path.moveTo(QPointF(0, 0));
+    KoPathPoint *p2 = path.lineTo(QPointF(10, 0));
+    QCOMPARE(path.outline().boundingRect(), QRectF(0, 0, 10, 0));
+    QCOMPARE(path.boundingRect(), path.pathStroke(QPen()).boundingRect());
+
+    // changes of the points have to be visible in the outline and the bounding rect
+    p2->setPoint(QPointF(20, 0));
+    QCOMPARE(path.outline().boundingRect(), QRectF(0, 0, 20, 0));
+    QCOMPARE(path.boundingRect(), path.pathStroke(QPen()).boundingRect());
+
+    KoPathPoint *p3 = path.lineTo(QPointF(20, 20));
+    QCOMPARE(path.size(), QSizeF(20, 20));
+
+    QPainterPath ppath(QPointF(0, 0));
+    ppath.lineTo(20, 0);
+    ppath.lineTo(20, 20);
+    path.close();
+    ppath.closeSubpath();
+    QVERIFY(path.outline() == ppath);
+
+    p3->unsetProperty(KoPathPoint::CloseSubpath);
+    ppath = QPainterPath(QPointF(0, 0));
+    ppath.lineTo(20, 0);
+    ppath.lineTo(20, 20);
+    QVERIFY(path.outline() == ppath);
+
+    delete path.removePoint(KoPathPointIndex(0, 2));
+    QCOMPARE(path.outline().boundingRect(), QRectF(0, 0, 20, 0));
+
+    // the bounding rect has to follow the transformation of the shape
+    path.setPosition(QPointF(100, 100));
+    QCOMPARE(path.boundingRect(), path.absoluteTransformation(nullptr).map(path.pathStroke(QPen())).boundingRect());
+}
+
+void TestPathShape::toString()
+{
+    KoPathShape path;
+    path.moveTo(QPointF(0, 0));
+    // quadratic curves are saved as cubic ones
+    path.curveTo(QPointF(30, 30), QPointF(60, 0));
+    path.lineTo(QPointF(60, 30));
+    path.close();
+    path.moveTo(QPointF(100, 0));
+    path.curveTo(QPointF(100, 10), QPointF(110, 20), QPointF(120, 20));
+
+    QCOMPARE(path.toString(), QString("M0 0C20 20 40 20 60 0L60 30ZM100 0C100 10 110 20 120 20"));
+    QCOMPARE(path.toString(QTransform::fromTranslate(10, 0)), QString("M10 0C30 20 50 20 70 0L70 30ZM110 0C110 10 120 20 130 20"));
+}
+
 QTEST_MAIN(TestPathShape)
@@ -35,6 +35,8 @@ private Q_SLOTS:
     void removeSubpath();
     void addSubpath();
     void closeMerge();
+    void outlineCache();
+    void toString();
 
     void koPathPointDataLess();
 };
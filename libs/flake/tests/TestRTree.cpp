@@ -0,0 +1,135 @@
+/* This file is part of the KDE project
+ * SPDX-FileCopyrightText: 2026 Calligra developers
+ *
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ */
+
+#include "TestRTree.h"
+
+#include <KoRTree.h>
+
+#include <QRandomGenerator>
+#include <QTest>
+
+#include <algorithm>
+
+namespace
+{
+QRectF randomRect(QRandomGenerator &random)
+{
+    return QRectF(random.bounded(1000), random.bounded(1000), random.bounded(50) + 1, random.bounded(50) + 1);
+}
+
+// the items of @p rects intersecting @p rect, in the order intersects() is expected to return them
+QList<int> brute(const QVector<QPair<QRectF, int>> &rects, const QRectF &rect)
+{
+    QList<int> result;
+    for (const QPair<QRectF, int> &item : rects) {
+        if (item.first.intersects(rect))
+            result.append(item.second);
+    }
+    return result;
+}
+
+void compare(const KoRTree<int> &tree, const QVector<QPair<QRectF, int>> &rects, QRandomGenerator &random)
+{
+    QCOMPARE(tree.values().size(), rects.size());
+    for (int i = 0; i < 100; ++i) {
+        const QRectF rect(random.bounded(1000), random.bounded(1000), random.bounded(200) + 1, random.bounded(200) + 1);
+        QCOMPARE(tree.intersects(rect), brute(rects, rect));
+    }
+}
+}
+
+void TestRTree::load()
+{
+    QRandomGenerator random(1);
+    QVector<QPair<QRectF, int>> rects;
+    for (int i = 0; i < 1000; ++i) {
+        rects.append(qMakePair(randomRect(random), i));
+    }
+
+    KoRTree<int> tree(4, 2);
+    tree.insert(QRectF(0, 0, 10, 10), -1);
+    tree.load(rects);
+    compare(tree, rects, random);
+
+    tree.load(QVector<QPair<QRectF, int>>());
+    QVERIFY(tree.values().isEmpty());
+    tree.insert(QRectF(0, 0, 10, 10), 1);
+    QCOMPARE(tree.intersects(QRectF(5, 5, 1, 1)), QList<int>() << 1);
+}
+
+void TestRTree::update()
+{
+    QRandomGenerator random(2);
+    QVector<QPair<QRectF, int>> rects;
+    for (int i = 0; i < 1000; ++i) {
+        rects.append(qMakePair(randomRect(random), i));
+    }
+    KoRTree<int> tree(4, 2);
+    for (const QPair<QRectF, int> &item : std::as_const(rects)) {
+        tree.insert(item.first, item.second);
+    }
+
+    // move every second item and add some new ones, moved items count as inserted last
+    QVector<QPair<QRectF, int>> changes;
+    QVector<QPair<QRectF, int>> expected;
+    for (const QPair<QRectF, int> &item : std::as_const(rects)) {
+        if (item.second % 2)
+            changes.append(qMakePair(randomRect(random), item.second));
+        else
+            expected.append(item);
+    }
+    for (int i = 1000; i < 1100; ++i) {
+        changes.append(qMakePair(randomRect(random), i));
+    }
+    expected += changes;
+
+    tree.update(changes);
+    compare(tree, expected, random);
+}
+
+void TestRTree::updateFew()
+{
+    QRandomGenerator random(3);
+    QVector<QPair<QRectF, int>> rects;
+    for (int i = 0; i < 500; ++i) {
+        rects.append(qMakePair(randomRect(random), i));
+    }
+    KoRTree<int> tree(4, 2);
+    tree.load(rects);
+
+    QVector<QPair<QRectF, int>> changes;
+    changes.append(qMakePair(QRectF(2000, 2000, 10, 10), 7));
+    changes.append(qMakePair(QRectF(2005, 2005, 10, 10), 500));
+    tree.update(changes);
+
+    rects.removeAt(7);
+    rects += changes;
+    compare(tree, rects, random);
+    QCOMPARE(tree.intersects(QRectF(2000, 2000, 100, 100)), QList<int>() << 7 << 500);
+}
+
+void TestRTree::removeAfterLoad()
+{
+    QRandomGenerator random(4);
+    QVector<QPair<QRectF, int>> rects;
+    for (int i = 0; i < 300; ++i) {
+        rects.append(qMakePair(randomRect(random), i));
+    }
+    KoRTree<int> tree(4, 2);
+    tree.load(rects);
+
+    // removing many items has to condense the packed nodes correctly
+    for (int i = 0; i < 300; i += 3) {
+        tree.remove(i);
+    }
+    rects.erase(std::remove_if(rects.begin(), rects.end(), [](const QPair<QRectF, int> &item) {
+                    return item.second % 3 == 0;
+                }),
+                rects.end());
+    compare(tree, rects, random);
+}
+
+QTEST_MAIN(TestRTree)
@@ -0,0 +1,22 @@
+/* This file is part of the KDE project
+ * SPDX-FileCopyrightText: 2026 Calligra developers
+ *
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ */
+
+#ifndef TESTRTREE_H
+#define TESTRTREE_H
+
+#include <QObject>
+
+class TestRTree : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void load();
+    void update();
+    void updateFew();
+    void removeAfterLoad();
+};
+
+#endif // TESTRTREE_H
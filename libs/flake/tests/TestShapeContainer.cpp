@@ -208,4 +208,29 @@ void TestShapeContainer::testScaling2()
     QCOMPARE(works, true);
 }
 
+void TestShapeContainer::testAbsoluteTransformation()
+{
+    MockShape *shape = new MockShape();
+    shape->setPosition(QPointF(10, 10));
+    MockContainer container;
+    container.setPosition(QPointF(100, 100));
+    container.addShape(shape);
+    container.setInheritsTransform(shape, true);
+
+    QCOMPARE(shape->absolutePosition(KoFlake::TopLeftCorner), QPointF(110, 110));
+
+    // the cached transformation of the child has to follow its ancestors
+    container.setPosition(QPointF(200, 100));
+    QCOMPARE(shape->absolutePosition(KoFlake::TopLeftCorner), QPointF(210, 110));
+    container.rotate(90);
+    QCOMPARE(shape->absoluteTransformation(nullptr), shape->transformation() * container.transformation());
+
+    container.setInheritsTransform(shape, false);
+    QCOMPARE(shape->absoluteTransformation(nullptr).m11(), qreal(1));
+
+    container.removeShape(shape);
+    QCOMPARE(shape->absolutePosition(KoFlake::TopLeftCorner), QPointF(10, 10));
+    delete shape;
+}
+
 QTEST_MAIN(TestShapeContainer)
@@ -20,6 +20,7 @@ private Q_SLOTS:
     void testSetParent2();
     void testScaling();
     void testScaling2();
+    void testAbsoluteTransformation();
 };
 
 #endif
@@ -8,15 +8,20 @@
 
 #include "TestShapePainting.h"
 
+#include "KoFilterEffect.h"
+#include "KoFilterEffectStack.h"
 #include "KoShapeContainer.h"
 #include "KoShapeManager.h"
+#include "KoShapeManager_p.h"
 #include "KoShapePaintingContext.h"
 
 #include <MockShapes.h>
 
+#include <QPicture>
 #include <QTest>
 
 #include <algorithm>
+#include <cmath>
 
 void TestShapePainting::testPaintShape()
 {
@@ -244,4 +249,152 @@ void TestShapePainting::testPaintOrder()
     delete root;
 }
 
+void TestShapePainting::testPaintFilterEffectCache()
+{
+    MockShape *shape = new MockShape();
+    shape->setSize(QSizeF(50, 50));
+    KoFilterEffectStack *effectStack = new KoFilterEffectStack();
+    effectStack->appendFilterEffect(new KoFilterEffect("NoOpFilterEffect", "NoOpFilterEffect"));
+    shape->setFilterEffectStack(effectStack);
+
+    MockCanvas canvas;
+    KoShapeManager manager(&canvas);
+    manager.addShape(shape);
+
+    QImage image(100, 100, QImage::Format_ARGB32_Premultiplied);
+    QPainter painter(&image);
+    KoViewConverter vc;
+    manager.paint(painter, vc, false);
+    QCOMPARE(shape->paintedCount, 1);
+
+    // the filtered result is reused while nothing changed
+    manager.paint(painter, vc, false);
+    QCOMPARE(shape->paintedCount, 1);
+
+    // an update of the shape invalidates it
+    shape->update();
+    manager.paint(painter, vc, false);
+    QCOMPARE(shape->paintedCount, 2);
+
+    // as does a different zoom
+    vc.setZoom(2.0);
+    manager.paint(painter, vc, false);
+    QCOMPARE(shape->paintedCount, 3);
+    manager.paint(painter, vc, false);
+    QCOMPARE(shape->paintedCount, 3);
+
+    manager.remove(shape);
+    delete shape;
+}
+
+namespace
+{
+// fills its area, so the cached rendering can be seen
+class FilledShape : public MockShape
+{
+public:
+    void paint(QPainter &painter, const KoViewConverter &converter, KoShapePaintingContext &paintContext) override
+    {
+        painter.fillRect(converter.documentToView(QRectF(QPointF(), size())), Qt::red);
+        MockShape::paint(painter, converter, paintContext);
+    }
+};
+
+const QRgb red = qRgb(255, 0, 0);
+const QRgb white = qRgb(255, 255, 255);
+}
+
+void TestShapePainting::testPaintRasterCache()
+{
+    FilledShape *shape = new FilledShape();
+    shape->setRasterCacheEnabled(true);
+    shape->setPosition(QPointF(10, 10));
+    shape->setSize(QSizeF(20, 20));
+
+    MockCanvas canvas;
+    KoShapeManager manager(&canvas);
+    manager.addShape(shape);
+    KoViewConverter vc;
+
+    QImage image(100, 100, QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::white);
+    QPainter painter(&image);
+    manager.paint(painter, vc, false);
+    QCOMPARE(shape->paintedCount, 1);
+    QCOMPARE(image.pixel(15, 15), red);
+
+    // a hit at the same transform
+    image.fill(Qt::white);
+    manager.paint(painter, vc, false);
+    QCOMPARE(shape->paintedCount, 1);
+    QCOMPARE(image.pixel(15, 15), red);
+
+    // panning only moves the rendering
+    image.fill(Qt::white);
+    painter.translate(30, 5);
+    manager.paint(painter, vc, false);
+    QCOMPARE(shape->paintedCount, 1);
+    QCOMPARE(image.pixel(15, 15), white);
+    QCOMPARE(image.pixel(45, 20), red);
+
+    // an update of the shape invalidates it
+    shape->update();
+    manager.paint(painter, vc, false);
+    QCOMPARE(shape->paintedCount, 2);
+    manager.paint(painter, vc, false);
+    QCOMPARE(shape->paintedCount, 2);
+
+    // a miss on a zoom change, the new rendering is used from then on
+    vc.setZoom(2.0);
+    image.fill(Qt::white);
+    manager.paint(painter, vc, false);
+    QCOMPARE(shape->paintedCount, 3);
+    QCOMPARE(image.pixel(75, 55), red);
+    manager.paint(painter, vc, false);
+    QCOMPARE(shape->paintedCount, 3);
+
+    // as does a scaled or rotated painter
+    painter.scale(0.5, 0.5);
+    manager.paint(painter, vc, false);
+    QCOMPARE(shape->paintedCount, 4);
+    manager.paint(painter, vc, false);
+    QCOMPARE(shape->paintedCount, 4);
+    painter.end();
+
+    // a miss on a device pixel ratio change
+    QImage hiDpiImage(200, 200, QImage::Format_ARGB32_Premultiplied);
+    hiDpiImage.setDevicePixelRatio(2.0);
+    hiDpiImage.fill(Qt::white);
+    painter.begin(&hiDpiImage);
+    manager.paint(painter, vc, false);
+    QCOMPARE(shape->paintedCount, 5);
+    QCOMPARE(hiDpiImage.pixel(90, 90), red);
+    manager.paint(painter, vc, false);
+    QCOMPARE(shape->paintedCount, 5);
+    painter.end();
+
+    // devices which are not for the screen, like pictures and printers, bypass the cache
+    QPicture picture;
+    painter.begin(&picture);
+    manager.paint(painter, vc, false);
+    QCOMPARE(shape->paintedCount, 6);
+    manager.paint(painter, vc, false);
+    QCOMPARE(shape->paintedCount, 7);
+    painter.end();
+
+    // as do shapes larger than RASTER_CACHE_MAX_AREA
+    vc.setZoom(1.0);
+    const qreal side = std::sqrt(qreal(RASTER_CACHE_MAX_AREA)) + 1;
+    shape->setSize(QSizeF(side, side));
+    painter.begin(&image);
+    manager.paint(painter, vc, false);
+    QCOMPARE(shape->paintedCount, 8);
+    manager.paint(painter, vc, false);
+    QCOMPARE(shape->paintedCount, 9);
+    painter.end();
+
+    manager.remove(shape);
+    delete shape;
+}
+
 QTEST_MAIN(TestShapePainting)
@@ -18,6 +18,8 @@ private Q_SLOTS:
     void testPaintShape();
     void testPaintHiddenShape();
     void testPaintOrder();
+    void testPaintFilterEffectCache();
+    void testPaintRasterCache();
 };
 
 #endif
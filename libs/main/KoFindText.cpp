@@ -7,6 +7,7 @@
  */
 
 #include "KoFindText.h"
+#include "KoFindTextIndex_p.h"
 #include "KoFindText_p.h"
 
 #include <QAbstractTextDocumentLayout>
@@ -52,6 +53,7 @@ KoFindText::KoFindText(QObject *parent)
 
 KoFindText::~KoFindText()
 {
+    qDeleteAll(d->indexes);
     delete d;
 }
 
@@ -76,17 +78,12 @@ void KoFindText::findImplementation(const QString &pattern, QList<KoFindMatch> &
     }
 
     bool before = opts->option("fromCursor")->value().toBool() && !d->currentCursor.isNull();
+    // long enough patterns are looked up in the index and only searched for in the blocks containing them
+    const bool useIndex = d->indexEnabled && !findInSelection && pattern.length() >= KoFindTextIndex::MinimumPatternLength;
     QList<KoFindMatch> matchBefore;
     foreach (QTextDocument *document, d->documents) {
-        QTextCursor cursor = document->find(pattern, start, flags);
-        cursor.setKeepPositionOnInsert(true);
-
         QVector<QAbstractTextDocumentLayout::Selection> selections;
-        while (!cursor.isNull()) {
-            if (findInSelection && d->selectionEnd <= cursor.position()) {
-                break;
-            }
-
+        auto addMatch = [&](const QTextCursor &cursor) {
             if (before && document == d->currentCursor.document() && d->currentCursor < cursor) {
                 before = false;
             }
@@ -104,9 +101,28 @@ void KoFindText::findImplementation(const QString &pattern, QList<KoFindMatch> &
             } else {
                 matchList.append(match);
             }
+        };
 
-            cursor = document->find(pattern, cursor, flags);
+        if (useIndex) {
+            KoFindTextIndex *&index = d->indexes[document];
+            if (!index) {
+                index = new KoFindTextIndex(document);
+            }
+            foreach (const QTextBlock &block, index->candidates(pattern)) {
+                Private::findInBlock(block, pattern, flags, addMatch);
+            }
+        } else {
+            QTextCursor cursor = document->find(pattern, start, flags);
             cursor.setKeepPositionOnInsert(true);
+            while (!cursor.isNull()) {
+                if (findInSelection && d->selectionEnd <= cursor.position()) {
+                    break;
+                }
+                addMatch(cursor);
+
+                cursor = document->find(pattern, cursor, flags);
+                cursor.setKeepPositionOnInsert(true);
+            }
         }
         if (before && document == d->currentCursor.document()) {
             before = false;
@@ -207,6 +223,20 @@ void KoFindText::setDocuments(const QList<QTextDocument *> &documents)
     d->updateDocumentList();
 }
 
+void KoFindText::setIndexEnabled(bool enabled)
+{
+    d->indexEnabled = enabled;
+    if (!enabled) {
+        qDeleteAll(d->indexes);
+        d->indexes.clear();
+    }
+}
+
+bool KoFindText::isIndexEnabled() const
+{
+    return d->indexEnabled;
+}
+
 void KoFindText::findTextInShapes(const QList<KoShape *> &shapes, QList<QTextDocument *> &append)
 {
     foreach (KoShape *shape, shapes) {
@@ -241,14 +271,52 @@ void KoFindText::Private::updateDocumentList()
     foreach (QTextDocument *document, documents) {
         connect(document, SIGNAL(destroyed(QObject *)), q, SLOT(documentDestroyed(QObject *)), Qt::UniqueConnection);
     }
+    // the indexes of documents no longer searched would only need to be kept up to date
+    for (auto it = indexes.begin(); it != indexes.end();) {
+        if (!documents.contains(it.key())) {
+            delete it.value();
+            it = indexes.erase(it);
+        } else {
+            ++it;
+        }
+    }
 }
 
 void KoFindText::Private::documentDestroyed(QObject *document)
 {
-    QTextDocument *doc = qobject_cast<QTextDocument *>(document);
-    if (doc) {
-        selections.remove(doc);
-        documents.removeOne(doc);
+    // qobject_cast does not work anymore for a destroyed object
+    QTextDocument *doc = static_cast<QTextDocument *>(document);
+    selections.remove(doc);
+    documents.removeOne(doc);
+    delete indexes.take(doc);
+}
+
+template<typename Callback>
+void KoFindText::Private::findInBlock(const QTextBlock &block, const QString &pattern, QTextDocument::FindFlags flags, Callback callback)
+{
+    // the same as QTextDocument::find() does within a block
+    QString text = block.text();
+    text.replace(QChar::Nbsp, u' ');
+    const Qt::CaseSensitivity sensitivity = flags & QTextDocument::FindCaseSensitively ? Qt::CaseSensitive : Qt::CaseInsensitive;
+    int offset = 0;
+    while (offset <= text.size()) {
+        const int index = text.indexOf(pattern, offset, sensitivity);
+        if (index == -1) {
+            return;
+        }
+        const int end = index + pattern.size();
+        if (flags & QTextDocument::FindWholeWords) {
+            if ((index != 0 && text.at(index - 1).isLetterOrNumber()) || (end != text.size() && text.at(end).isLetterOrNumber())) {
+                offset = end + 1;
+                continue;
+            }
+        }
+        QTextCursor cursor(block);
+        cursor.setPosition(block.position() + index);
+        cursor.setPosition(block.position() + end, QTextCursor::KeepAnchor);
+        cursor.setKeepPositionOnInsert(true);
+        callback(cursor);
+        offset = end;
     }
 }
 
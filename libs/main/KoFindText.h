@@ -32,6 +32,11 @@ class KoShape;
  *          set through setCurrentCursor().</li>
  * </ul>
  *
+ * Patterns of three or more characters are looked up in a trigram index of each
+ * document, which is built on the first search and kept up to date while the
+ * document is edited. Only the paragraphs containing all trigrams of the pattern
+ * are searched then, see setIndexEnabled().
+ *
  * \note Before you can use this class, be sure to set a list of QTextDocuments
  * using setDocuments().
  *
@@ -84,6 +89,19 @@ public:
      */
     static void setFormat(FormatType formatType, const QTextCharFormat &format);
 
+    /**
+     * Enable or disable the text index of the documents. Enabled by default.
+     *
+     * Disabling it saves the memory used by the index and the time for updating
+     * it on every change, but every search has to look at all of the text.
+     */
+    void setIndexEnabled(bool enabled);
+
+    /**
+     * \return true if the text index is used for searching.
+     */
+    bool isIndexEnabled() const;
+
     /**
      * Helper function to retrieve all QTextDocument objects from a list of shapes.
      *
@@ -0,0 +1,161 @@
+/* This file is part of the KDE project
+ *
+ * SPDX-FileCopyrightText: 2026 Calligra developers
+ *
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ */
+
+#include "KoFindTextIndex_p.h"
+
+#include <QTextDocument>
+
+#include <algorithm>
+
+KoFindTextIndex::KoFindTextIndex(QTextDocument *document)
+    : m_document(document)
+{
+    m_connection = QObject::connect(document, &QTextDocument::contentsChange, [this](int position, int charsRemoved, int charsAdded) {
+        contentsChange(position, charsRemoved, charsAdded);
+    });
+    rebuild();
+}
+
+KoFindTextIndex::~KoFindTextIndex()
+{
+    QObject::disconnect(m_connection);
+}
+
+QList<QTextBlock> KoFindTextIndex::candidates(const QString &pattern) const
+{
+    Q_ASSERT(pattern.length() >= MinimumPatternLength);
+    const QVector<Trigram> patternTrigrams = trigrams(pattern);
+
+    // start with the rarest trigram and check the others for its blocks only
+    QVector<const QSet<int> *> postings;
+    postings.reserve(patternTrigrams.size());
+    for (Trigram trigram : patternTrigrams) {
+        auto it = m_postings.constFind(trigram);
+        if (it == m_postings.constEnd()) {
+            return QList<QTextBlock>();
+        }
+        postings.append(&it.value());
+    }
+    std::sort(postings.begin(), postings.end(), [](const QSet<int> *a, const QSet<int> *b) {
+        return a->size() < b->size();
+    });
+
+    QList<QTextBlock> result;
+    for (int slot : *postings.first()) {
+        bool found = true;
+        for (int i = 1; i < postings.size() && found; ++i) {
+            found = postings[i]->contains(slot);
+        }
+        if (found) {
+            result.append(m_blocks[slot]);
+        }
+    }
+    std::sort(result.begin(), result.end(), [](const QTextBlock &a, const QTextBlock &b) {
+        return a.position() < b.position();
+    });
+    return result;
+}
+
+void KoFindTextIndex::rebuild()
+{
+    m_slots.clear();
+    m_blocks.clear();
+    m_blockTrigrams.clear();
+    m_freeSlots.clear();
+    m_postings.clear();
+
+    int blockNumber = 0;
+    for (QTextBlock block = m_document->begin(); block.isValid(); block = block.next()) {
+        indexBlock(blockNumber++, block);
+    }
+}
+
+void KoFindTextIndex::contentsChange(int position, int charsRemoved, int charsAdded)
+{
+    Q_UNUSED(charsRemoved);
+    // the changed blocks now are first..last, before the change there were delta blocks less
+    const int delta = m_document->blockCount() - m_slots.size();
+    const QTextBlock firstBlock = m_document->findBlock(position);
+    QTextBlock lastBlock = m_document->findBlock(position + charsAdded);
+    if (!lastBlock.isValid()) {
+        lastBlock = m_document->lastBlock();
+    }
+    if (!firstBlock.isValid()) {
+        rebuild();
+        return;
+    }
+    const int first = firstBlock.blockNumber();
+    const int last = lastBlock.blockNumber();
+    const int removedLast = last - delta;
+    if (removedLast < first - 1 || removedLast >= m_slots.size()) {
+        rebuild();
+        return;
+    }
+
+    for (int i = removedLast; i >= first; --i) {
+        unindexBlock(i);
+    }
+    QTextBlock block = firstBlock;
+    for (int i = first; i <= last && block.isValid(); ++i, block = block.next()) {
+        indexBlock(i, block);
+    }
+}
+
+void KoFindTextIndex::indexBlock(int blockNumber, const QTextBlock &block)
+{
+    int slot;
+    if (m_freeSlots.isEmpty()) {
+        slot = m_blocks.size();
+        m_blocks.append(block);
+        m_blockTrigrams.append(trigrams(block.text()));
+    } else {
+        slot = m_freeSlots.takeLast();
+        m_blocks[slot] = block;
+        m_blockTrigrams[slot] = trigrams(block.text());
+    }
+    m_slots.insert(blockNumber, slot);
+    for (Trigram trigram : std::as_const(m_blockTrigrams[slot])) {
+        m_postings[trigram].insert(slot);
+    }
+}
+
+void KoFindTextIndex::unindexBlock(int blockNumber)
+{
+    const int slot = m_slots.takeAt(blockNumber);
+    for (Trigram trigram : std::as_const(m_blockTrigrams[slot])) {
+        auto it = m_postings.find(trigram);
+        it->remove(slot);
+        if (it->isEmpty()) {
+            m_postings.erase(it);
+        }
+    }
+    m_blocks[slot] = QTextBlock();
+    m_blockTrigrams[slot].clear();
+    m_freeSlots.append(slot);
+}
+
+QVector<KoFindTextIndex::Trigram> KoFindTextIndex::trigrams(const QString &text)
+{
+    QVector<Trigram> result;
+    if (text.length() < MinimumPatternLength) {
+        return result;
+    }
+    // QTextDocument::find() treats non-breaking spaces as spaces and compares case folded characters
+    auto character = [&text](int i) -> Trigram {
+        const QChar c = text.at(i);
+        return c == QChar::Nbsp ? u' ' : c.toCaseFolded().unicode();
+    };
+    result.reserve(text.length() - MinimumPatternLength + 1);
+    Trigram trigram = (character(0) << 16) | character(1);
+    for (int i = MinimumPatternLength - 1; i < text.length(); ++i) {
+        trigram = ((trigram << 16) | character(i)) & Q_UINT64_C(0xffffffffffff);
+        result.append(trigram);
+    }
+    std::sort(result.begin(), result.end());
+    result.erase(std::unique(result.begin(), result.end()), result.end());
+    return result;
+}
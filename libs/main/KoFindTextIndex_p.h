@@ -0,0 +1,70 @@
+/* This file is part of the KDE project
+ *
+ * SPDX-FileCopyrightText: 2026 Calligra developers
+ *
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ */
+#ifndef KoFindTextIndex_p_h
+#define KoFindTextIndex_p_h
+
+#include <QHash>
+#include <QList>
+#include <QMetaObject>
+#include <QSet>
+#include <QTextBlock>
+#include <QVector>
+
+class QTextDocument;
+
+/**
+ * \internal
+ * Trigram index of the paragraphs of a QTextDocument.
+ *
+ * The index maps every sequence of three case folded characters to the blocks
+ * containing it, so the blocks which might contain a pattern can be found
+ * without looking at the text of the document. It is kept up to date with
+ * QTextDocument::contentsChange(), only the changed blocks are indexed again.
+ */
+class KoFindTextIndex
+{
+public:
+    explicit KoFindTextIndex(QTextDocument *document);
+    ~KoFindTextIndex();
+
+    /// Patterns need at least this many characters to be looked up in the index.
+    static const int MinimumPatternLength = 3;
+
+    /**
+     * Return the blocks which might contain @p pattern, in document order.
+     *
+     * This is a superset of the blocks with a match; case sensitivity and whole
+     * words still have to be checked. @p pattern must not be shorter than
+     * MinimumPatternLength.
+     */
+    QList<QTextBlock> candidates(const QString &pattern) const;
+
+private:
+    typedef quint64 Trigram;
+
+    void rebuild();
+    void contentsChange(int position, int charsRemoved, int charsAdded);
+    /// Insert @p block as block @p blockNumber into the index
+    void indexBlock(int blockNumber, const QTextBlock &block);
+    /// Remove block @p blockNumber from the index
+    void unindexBlock(int blockNumber);
+    /// Return the sorted, unique trigrams of @p text
+    static QVector<Trigram> trigrams(const QString &text);
+
+    QTextDocument *m_document;
+    QMetaObject::Connection m_connection;
+    /// the slot of every block, by block number
+    QVector<int> m_slots;
+    /// the block and its trigrams, by slot
+    QVector<QTextBlock> m_blocks;
+    QVector<QVector<Trigram>> m_blockTrigrams;
+    QVector<int> m_freeSlots;
+    /// the slots of the blocks containing a trigram
+    QHash<Trigram, QSet<int>> m_postings;
+};
+
+#endif
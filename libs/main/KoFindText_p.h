@@ -30,6 +30,8 @@
 #include "KoFindOption.h"
 #include "KoFindOptionSet.h"
 
+class KoFindTextIndex;
+
 class Q_DECL_HIDDEN KoFindText::Private
 {
 public:
@@ -37,6 +39,7 @@ public:
         : q(qq)
         , selectionStart(-1)
         , selectionEnd(-1)
+        , indexEnabled(true)
     {
     }
 
@@ -45,6 +48,9 @@ public:
     void documentDestroyed(QObject *document);
     void updateCurrentMatch(int position);
     static void initializeFormats();
+    /// Call @p callback with a cursor for every match of @p pattern in @p block
+    template<typename Callback>
+    static void findInBlock(const QTextBlock &block, const QString &pattern, QTextDocument::FindFlags flags, Callback callback);
 
     KoFindText *q;
 
@@ -57,6 +63,9 @@ public:
     int selectionStart;
     int selectionEnd;
 
+    bool indexEnabled;
+    QHash<QTextDocument *, KoFindTextIndex *> indexes;
+
     static QTextCharFormat highlightFormat;
     static QTextCharFormat currentMatchFormat;
     static QTextCharFormat currentSelectionFormat;
@@ -0,0 +1,104 @@
+/* This file is part of the KDE project
+ *
+ * SPDX-FileCopyrightText: 2026 Calligra developers
+ *
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ */
+
+#include "testfindtext.h"
+
+#include <KoFindOptionSet.h>
+#include <KoFindText.h>
+
+#include <QTest>
+#include <QTextCursor>
+#include <QTextDocument>
+
+namespace
+{
+// the positions of all matches of @p pattern, with or without using the index
+QList<QPair<int, int>> find(QTextDocument *document, const QString &pattern, bool indexed, bool caseSensitive = false, bool wholeWords = false)
+{
+    KoFindText finder;
+    finder.setIndexEnabled(indexed);
+    finder.options()->setOptionValue("caseSensitive", caseSensitive);
+    finder.options()->setOptionValue("wholeWords", wholeWords);
+    finder.options()->setOptionValue("fromCursor", false);
+    finder.setDocuments(QList<QTextDocument *>() << document);
+    finder.find(pattern);
+
+    QList<QPair<int, int>> result;
+    foreach (const KoFindMatch &match, finder.matches()) {
+        const QTextCursor cursor = match.location().value<QTextCursor>();
+        result.append(qMakePair(cursor.selectionStart(), cursor.selectionEnd()));
+    }
+    return result;
+}
+}
+
+void TestFindText::testIndex_data()
+{
+    QTest::addColumn<QString>("pattern");
+    QTest::addColumn<bool>("caseSensitive");
+    QTest::addColumn<bool>("wholeWords");
+    QTest::addColumn<int>("count");
+
+    QTest::newRow("word") << "the" << false << false << 5;
+    QTest::newRow("case sensitive") << "The" << true << false << 2;
+    QTest::newRow("whole words") << "the" << false << true << 3;
+    QTest::newRow("overlapping") << "aaa" << false << false << 2;
+    QTest::newRow("non-breaking space") << "two words" << false << false << 1;
+    QTest::newRow("missing") << "calligra" << false << false << 0;
+}
+
+void TestFindText::testIndex()
+{
+    QFETCH(QString, pattern);
+    QFETCH(bool, caseSensitive);
+    QFETCH(bool, wholeWords);
+    QFETCH(int, count);
+
+    QTextDocument document;
+    document.setPlainText(QString("The quick brown fox\njumps over the lazy dog.\nTheir aaaaaaa\ntwo") + QChar(QChar::Nbsp)
+                          + "words, then THE end");
+
+    const QList<QPair<int, int>> expected = find(&document, pattern, false, caseSensitive, wholeWords);
+    QCOMPARE(expected.count(), count);
+    QCOMPARE(find(&document, pattern, true, caseSensitive, wholeWords), expected);
+}
+
+void TestFindText::testIndexUpdate()
+{
+    QTextDocument document;
+    document.setPlainText("first paragraph\nsecond paragraph\nthird paragraph");
+
+    KoFindText finder;
+    finder.options()->setOptionValue("fromCursor", false);
+    finder.setDocuments(QList<QTextDocument *>() << &document);
+    finder.find("paragraph");
+    QCOMPARE(finder.matches().count(), 3);
+
+    // the index is updated while the document is edited
+    QTextCursor cursor(document.findBlockByNumber(1));
+    cursor.insertText("new paragraph\nand ");
+    cursor.movePosition(QTextCursor::End);
+    cursor.movePosition(QTextCursor::StartOfBlock, QTextCursor::KeepAnchor);
+    cursor.removeSelectedText();
+    cursor.deletePreviousChar();
+    cursor = QTextCursor(&document);
+    cursor.insertText("Para");
+
+    finder.find("paragraph");
+    QCOMPARE(finder.matches().count(), 3);
+    finder.find("parafirst");
+    QCOMPARE(finder.matches().count(), 1);
+    QCOMPARE(find(&document, "paragraph", true), find(&document, "paragraph", false));
+
+    document.setPlainText("something else");
+    finder.find("paragraph");
+    QCOMPARE(finder.matches().count(), 0);
+    finder.find("thing");
+    QCOMPARE(finder.matches().count(), 1);
+}
+
+QTEST_MAIN(TestFindText)
@@ -0,0 +1,22 @@
+/* This file is part of the KDE project
+ *
+ * SPDX-FileCopyrightText: 2026 Calligra developers
+ *
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ */
+
+#ifndef TESTFINDTEXT_H
+#define TESTFINDTEXT_H
+
+#include <QObject>
+
+class TestFindText : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testIndex_data();
+    void testIndex();
+    void testIndexUpdate();
+};
+
+#endif // TESTFINDTEXT_H
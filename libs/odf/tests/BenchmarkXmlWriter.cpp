@@ -0,0 +1,126 @@
+/* This file is part of the KDE project
+ * SPDX-FileCopyrightText: 2026 Calligra developers
+ *
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ */
+#include <KoXmlWriter.h>
+
+#include <QElapsedTimer>
+#include <QString>
+#include <QTemporaryFile>
+#include <QTest>
+
+// Measures the write throughput of KoXmlWriter for typical ODF content.
+// Files are written like store members are, through the internal buffer.
+class BenchmarkXmlWriter : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void benchmarkParagraphs();
+    void benchmarkCells();
+    void benchmarkEscaping();
+
+private:
+    void reportThroughput(const char *name, qint64 bytes, int iterations, qint64 nsecs);
+};
+
+static const int NumParagraphs = 30000;
+static const int NumRows = 5000;
+static const int NumColumns = 20;
+
+void BenchmarkXmlWriter::reportThroughput(const char *name, qint64 bytes, int iterations, qint64 nsecs)
+{
+    if (nsecs > 0)
+        qInfo() << name << ":" << bytes << "bytes," << (bytes * iterations * 1000.0 / nsecs) << "MB/s";
+}
+
+void BenchmarkXmlWriter::benchmarkParagraphs()
+{
+    const QString paragText = QString::fromUtf8("This is the text of the paragraph. I'm including a euro sign to test encoding issues: €");
+    const QString styleName = QString::fromLatin1("Heading 1");
+
+    qint64 bytes = 0;
+    int iterations = 0;
+    QElapsedTimer timer;
+    timer.start();
+    QBENCHMARK {
+        ++iterations;
+        QTemporaryFile file;
+        file.open();
+        KoXmlWriter writer(&file);
+        writer.startDocument("office:document-content");
+        writer.startElement("office:document-content");
+        for (int i = 0; i < NumParagraphs; ++i) {
+            writer.startElement("text:p");
+            writer.addAttribute("text:style-name", styleName);
+            writer.addTextNode(paragText);
+            writer.endElement();
+        }
+        writer.endElement();
+        writer.endDocument();
+        bytes = file.size();
+    }
+    reportThroughput("paragraphs", bytes, iterations, timer.nsecsElapsed());
+}
+
+void BenchmarkXmlWriter::benchmarkCells()
+{
+    qint64 bytes = 0;
+    int iterations = 0;
+    QElapsedTimer timer;
+    timer.start();
+    QBENCHMARK {
+        ++iterations;
+        QTemporaryFile file;
+        file.open();
+        KoXmlWriter writer(&file);
+        writer.startDocument("office:document-content");
+        writer.startElement("office:document-content");
+        for (int row = 0; row < NumRows; ++row) {
+            writer.startElement("table:table-row");
+            writer.addAttribute("table:style-name", "ro1", 3);
+            for (int column = 0; column < NumColumns; ++column) {
+                writer.startElement("table:table-cell");
+                writer.addAttribute("office:value-type", "float", 5);
+                writer.addAttribute("office:value", row * 0.25 + column);
+                writer.addAttribute("table:number-columns-repeated", column + 1);
+                writer.startElement("text:p", false);
+                writer.addTextNode(QString::number(row * NumColumns + column));
+                writer.endElement();
+                writer.endElement();
+            }
+            writer.endElement();
+        }
+        writer.endElement();
+        writer.endDocument();
+        bytes = file.size();
+    }
+    reportThroughput("cells", bytes, iterations, timer.nsecsElapsed());
+}
+
+void BenchmarkXmlWriter::benchmarkEscaping()
+{
+    QByteArray text;
+    for (int i = 0; i < 1000; ++i)
+        text += "M10 10L20 20 <a href=\"x&y\">";
+
+    qint64 bytes = 0;
+    int iterations = 0;
+    QElapsedTimer timer;
+    timer.start();
+    QBENCHMARK {
+        ++iterations;
+        QTemporaryFile file;
+        file.open();
+        KoXmlWriter writer(&file);
+        writer.startElement("svg:path");
+        for (int i = 0; i < 100; ++i)
+            writer.addTextNode(text);
+        writer.endElement();
+        bytes = file.size();
+    }
+    reportThroughput("escaping", bytes, iterations, timer.nsecsElapsed());
+}
+
+QTEST_GUILESS_MAIN(BenchmarkXmlWriter)
+#include <BenchmarkXmlWriter.moc>
@@ -9,6 +9,7 @@
 #include <QBuffer>
 #include <QLoggingCategory>
 #include <QString>
+#include <QTemporaryFile>
 #include <QTest>
 
 class TestXmlWriter : public QObject
@@ -28,6 +29,10 @@ private Q_SLOTS:
     void testEscapingLongString();
     void testEscalingLongString2();
     void testConfig();
+    void testNumbers();
+    void testUtf8Attribute();
+    void testLargeOutput();
+    void testReadBufferWhileOpen();
 
     void speedTest();
 
@@ -218,6 +223,71 @@ void TestXmlWriter::testConfig()
                      " <config:config-item config:name=\"TestConfigDouble\" config:type=\"double\">5</config:config-item>"));
 }
 
+void TestXmlWriter::testNumbers()
+{
+    setup();
+    writer->startElement("test");
+    writer->addAttribute("a", qint64(-9007199254740993LL));
+    writer->addAttribute("b", quint64(18446744073709551615ULL));
+    writer->addAttribute("c", uint(4294967295U));
+    writer->addAttribute("d", 0.5f);
+    writer->addAttributePt("e", -2.0);
+    writer->endElement();
+    QCOMPARE(content(),
+             QString("<test a=\"-9007199254740993\" b=\"18446744073709551615\" c=\"4294967295\" d=\"0.500000\" e=\"-2.00000000000pt\"/>"));
+}
+
+void TestXmlWriter::testUtf8Attribute()
+{
+    setup();
+    const QByteArray value = QString::fromUtf8("f\"ö€𝄞").toUtf8();
+    writer->startElement("test");
+    writer->addAttribute("a", value.constData(), value.size());
+    writer->addAttribute("b", QString::fromUtf8("f\"ö€𝄞"));
+    writer->endElement();
+    QCOMPARE(content(), QString::fromUtf8("<test a=\"f&quot;ö€𝄞\" b=\"f&quot;ö€𝄞\"/>"));
+}
+
+void TestXmlWriter::testLargeOutput()
+{
+    // More than the internal buffer of writers to files, which is written out in between
+    QTemporaryFile file;
+    QVERIFY(file.open());
+    KoXmlWriter *fileWriter = new KoXmlWriter(&file);
+    fileWriter->startElement("dummy");
+    QByteArray expected("<dummy>");
+    for (int i = 0; i < 20000; ++i) {
+        fileWriter->startElement("p", false);
+        fileWriter->addAttribute("n", i);
+        fileWriter->addTextNode(QString::fromLatin1("a<b"));
+        fileWriter->endElement();
+        expected += QByteArray("\n <p n=\"") + QByteArray::number(i) + "\">a&lt;b</p>";
+    }
+    QVERIFY(file.size() > 0);
+    QVERIFY(file.size() < expected.size());
+    fileWriter->flush();
+    QCOMPARE(file.size(), qint64(expected.size()));
+    fileWriter->endElement();
+    delete fileWriter;
+    expected += "\n</dummy>";
+    file.seek(0);
+    QCOMPARE(file.readAll(), expected);
+}
+
+void TestXmlWriter::testReadBufferWhileOpen()
+{
+    // Writers to memory buffers are often read back before the element is closed
+    QBuffer memory;
+    memory.open(QIODevice::WriteOnly);
+    KoXmlWriter memoryWriter(&memory);
+    memoryWriter.startElement("draw:frame");
+    memoryWriter.addAttribute("draw:name", "frame");
+    QCOMPARE(memory.data(), QByteArray("<draw:frame draw:name=\"frame\""));
+    memoryWriter.addTextNode("text");
+    QCOMPARE(memory.data(), QByteArray("<draw:frame draw:name=\"frame\">text"));
+    memoryWriter.endElement();
+}
+
 static const int NumParagraphs = 30000;
 
 void TestXmlWriter::speedTest()
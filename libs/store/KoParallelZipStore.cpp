@@ -0,0 +1,458 @@
+/* This file is part of the KDE project
+   SPDX-FileCopyrightText: 2026 Calligra developers
+
+   SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include "KoParallelZipStore.h"
+#include "KoStore_p.h"
+
+#include <QBuffer>
+#include <QDateTime>
+#include <QRunnable>
+#include <QSaveFile>
+#include <QSemaphore>
+#include <QThreadPool>
+
+#include <StoreDebug.h>
+
+#include <zlib.h>
+
+namespace
+{
+/// Amount of uncompressed data we allow to be queued before closeWrite() blocks
+const qint64 MaxPendingBytes = 64 * 1024 * 1024;
+/// Size of the deflate window, used as dictionary from the preceding chunk
+const int DictionarySize = 32 * 1024;
+
+const quint16 MethodStored = 0;
+const quint16 MethodDeflated = 8;
+const quint16 FlagUtf8 = 0x0800;
+
+void putShort(QByteArray &buffer, quint16 value)
+{
+    buffer.append(char(value & 0xff));
+    buffer.append(char((value >> 8) & 0xff));
+}
+
+void putLong(QByteArray &buffer, quint32 value)
+{
+    putShort(buffer, quint16(value & 0xffff));
+    putShort(buffer, quint16((value >> 16) & 0xffff));
+}
+
+void dosDateTime(const QDateTime &dateTime, quint16 &dosTime, quint16 &dosDate)
+{
+    const QDate date = dateTime.date();
+    const QTime time = dateTime.time();
+    dosTime = quint16((time.hour() << 11) | (time.minute() << 5) | (time.second() >> 1));
+    dosDate = quint16(((qMax(date.year(), 1980) - 1980) << 9) | (date.month() << 5) | date.day());
+}
+}
+
+class KoParallelZipStore::Chunk
+{
+public:
+    const char *data = nullptr;
+    int length = 0;
+    /// Number of bytes before data usable as preset dictionary
+    int dictionaryLength = 0;
+    bool last = false;
+
+    QByteArray compressed;
+    quint32 crc = 0;
+    bool ok = false;
+
+    void compress()
+    {
+        crc = crc32(0, reinterpret_cast<const Bytef *>(data), length);
+
+        z_stream zs = {};
+        if (deflateInit2(&zs, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+            return;
+        }
+        if (dictionaryLength > 0) {
+            deflateSetDictionary(&zs, reinterpret_cast<const Bytef *>(data - dictionaryLength), dictionaryLength);
+        }
+
+        // A sync flush appends an empty stored block, so leave some room beyond deflateBound
+        compressed.resize(deflateBound(&zs, length) + 16);
+        zs.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(data));
+        zs.avail_in = length;
+        zs.next_out = reinterpret_cast<Bytef *>(compressed.data());
+        zs.avail_out = compressed.size();
+
+        const int flush = last ? Z_FINISH : Z_SYNC_FLUSH;
+        int ret;
+        forever {
+            ret = deflate(&zs, flush);
+            if (ret == Z_STREAM_END || ret == Z_STREAM_ERROR) {
+                break;
+            }
+            if (zs.avail_out == 0) {
+                const int done = compressed.size();
+                compressed.resize(done * 2);
+                zs.next_out = reinterpret_cast<Bytef *>(compressed.data() + done);
+                zs.avail_out = compressed.size() - done;
+                continue;
+            }
+            // With Z_SYNC_FLUSH everything is flushed once output space is left over
+            if (!last && zs.avail_in == 0) {
+                break;
+            }
+        }
+        ok = last ? ret == Z_STREAM_END : ret == Z_OK;
+        compressed.resize(zs.total_out);
+        deflateEnd(&zs);
+    }
+};
+
+class KoParallelZipStore::Entry
+{
+public:
+    QByteArray name;
+    QByteArray data;
+    quint16 method = MethodDeflated;
+    QList<Chunk *> chunks;
+    /// Released once for every compressed chunk
+    QSemaphore compressedChunks;
+
+    quint32 crc = 0;
+    quint32 compressedSize = 0;
+    quint32 uncompressedSize = 0;
+    quint32 offset = 0;
+
+    ~Entry()
+    {
+        qDeleteAll(chunks);
+    }
+};
+
+namespace
+{
+class ChunkCompressor : public QRunnable
+{
+public:
+    ChunkCompressor(KoParallelZipStore::Chunk *chunk, QSemaphore *done)
+        : m_chunk(chunk)
+        , m_done(done)
+    {
+    }
+
+    void run() override
+    {
+        m_chunk->compress();
+        m_done->release();
+    }
+
+private:
+    KoParallelZipStore::Chunk *m_chunk;
+    QSemaphore *m_done;
+};
+}
+
+KoParallelZipStore::KoParallelZipStore(const QString &_filename, Mode mode, const QByteArray &appIdentification, bool writeMimetype)
+    : KoStore(mode, writeMimetype)
+    , m_device(nullptr)
+    , m_ownsDevice(true)
+    , m_compressionEnabled(true)
+    , m_offset(0)
+    , m_pool(new QThreadPool())
+{
+    debugStore << "KoParallelZipStore Constructor filename =" << _filename << " mode = " << int(mode) << " mimetype = " << appIdentification;
+    Q_D(KoStore);
+
+    d->localFileName = _filename;
+
+    m_device = new QSaveFile(_filename);
+
+    init(appIdentification);
+}
+
+KoParallelZipStore::KoParallelZipStore(QIODevice *dev, Mode mode, const QByteArray &appIdentification, bool writeMimetype)
+    : KoStore(mode, writeMimetype)
+    , m_device(dev)
+    , m_ownsDevice(false)
+    , m_compressionEnabled(true)
+    , m_offset(0)
+    , m_pool(new QThreadPool())
+{
+    init(appIdentification);
+}
+
+KoParallelZipStore::~KoParallelZipStore()
+{
+    Q_D(KoStore);
+    debugStore << "KoParallelZipStore::~KoParallelZipStore";
+    if (!d->finalized)
+        finalize(); // ### no error checking when the app forgot to call finalize itself
+
+    m_pool->waitForDone();
+    delete m_pool;
+    qDeleteAll(m_pending);
+    qDeleteAll(m_written);
+    if (m_ownsDevice) {
+        // a QSaveFile which has not been committed discards its data
+        delete m_device;
+    }
+}
+
+void KoParallelZipStore::init(const QByteArray &appIdentification)
+{
+    Q_D(KoStore);
+
+    if (d->mode != Write) {
+        errorStore << "KoParallelZipStore only supports writing" << Qt::endl;
+        d->good = false;
+        return;
+    }
+
+    d->good = m_device->isOpen() || m_device->open(QIODevice::WriteOnly);
+    if (!d->good)
+        return;
+
+    // Write identification; it has to be the first file and must not be compressed
+    if (d->writeMimetype) {
+        Entry *entry = new Entry;
+        entry->name = "mimetype";
+        entry->data = appIdentification;
+        entry->method = MethodStored;
+        m_pending.append(entry);
+        d->good = writeFinishedEntries(true);
+    }
+}
+
+void KoParallelZipStore::setCompressionEnabled(bool e)
+{
+    m_compressionEnabled = e;
+}
+
+bool KoParallelZipStore::doFinalize()
+{
+    Q_D(KoStore);
+    if (!d->good)
+        return false;
+    if (!writeFinishedEntries(true) || !writeCentralDirectory())
+        return false;
+    if (m_ownsDevice)
+        return static_cast<QSaveFile *>(m_device)->commit();
+    m_device->close();
+    return true;
+}
+
+// d->stream buffers the data into m_byteArray until closeWrite()
+
+bool KoParallelZipStore::openWrite(const QString & /*name*/)
+{
+    Q_D(KoStore);
+    m_byteArray.resize(0);
+    d->stream = new QBuffer(&m_byteArray);
+    d->stream->open(QIODevice::WriteOnly);
+    return true;
+}
+
+bool KoParallelZipStore::openRead(const QString & /*name*/)
+{
+    errorStore << "KoParallelZipStore: Can not read from a write-only store" << Qt::endl;
+    return false;
+}
+
+bool KoParallelZipStore::closeWrite()
+{
+    Q_D(KoStore);
+    debugStore << "Queued file" << d->fileName << " for ZIP archive. size" << d->size;
+
+    Entry *entry = new Entry;
+    entry->name = d->fileName.toUtf8();
+    entry->method = m_compressionEnabled ? MethodDeflated : MethodStored;
+    // d->stream still refers to m_byteArray, but is deleted right after closeWrite()
+    m_byteArray.resize(d->size);
+    entry->data = std::move(m_byteArray);
+    m_byteArray = QByteArray();
+
+    enqueue(entry);
+
+    // Limit the memory held by queued files by waiting for the oldest ones
+    forever {
+        if (!writeFinishedEntries(false))
+            return false;
+        qint64 pendingBytes = 0;
+        for (const Entry *pending : std::as_const(m_pending)) {
+            pendingBytes += pending->data.size();
+        }
+        if (pendingBytes <= MaxPendingBytes)
+            return true;
+        Entry *oldest = m_pending.first();
+        oldest->compressedChunks.acquire(oldest->chunks.count());
+        oldest->compressedChunks.release(oldest->chunks.count());
+    }
+}
+
+void KoParallelZipStore::enqueue(Entry *entry)
+{
+    m_pending.append(entry);
+    if (entry->method == MethodStored) {
+        return;
+    }
+
+    const char *data = entry->data.constData();
+    const int size = entry->data.size();
+    int pos = 0;
+    do {
+        Chunk *chunk = new Chunk;
+        chunk->data = data + pos;
+        chunk->length = qMin(ChunkSize, size - pos);
+        chunk->dictionaryLength = qMin(DictionarySize, pos);
+        pos += chunk->length;
+        chunk->last = pos >= size;
+        entry->chunks.append(chunk);
+        m_pool->start(new ChunkCompressor(chunk, &entry->compressedChunks));
+    } while (pos < size);
+}
+
+bool KoParallelZipStore::writeFinishedEntries(bool wait)
+{
+    while (!m_pending.isEmpty()) {
+        Entry *entry = m_pending.first();
+        if (wait) {
+            entry->compressedChunks.acquire(entry->chunks.count());
+        } else if (!entry->compressedChunks.tryAcquire(entry->chunks.count())) {
+            return true;
+        }
+        m_pending.removeFirst();
+        m_written.append(entry);
+        if (!writeEntry(entry))
+            return false;
+    }
+    return true;
+}
+
+bool KoParallelZipStore::writeEntry(Entry *entry)
+{
+    const qint64 uncompressedSize = entry->data.size();
+    entry->uncompressedSize = uncompressedSize;
+    if (entry->method == MethodStored) {
+        entry->crc = crc32(0, reinterpret_cast<const Bytef *>(entry->data.constData()), uncompressedSize);
+        entry->compressedSize = uncompressedSize;
+    } else {
+        quint32 crc = 0;
+        qint64 compressedSize = 0;
+        for (const Chunk *chunk : std::as_const(entry->chunks)) {
+            if (!chunk->ok) {
+                errorStore << "Failed to compress" << entry->name << Qt::endl;
+                return false;
+            }
+            crc = crc32_combine(crc, chunk->crc, chunk->length);
+            compressedSize += chunk->compressed.size();
+        }
+        if (compressedSize > 0xffffffffLL) {
+            errorStore << entry->name << "is too big for a ZIP archive" << Qt::endl;
+            return false;
+        }
+        entry->crc = crc;
+        entry->compressedSize = compressedSize;
+    }
+    if (uncompressedSize > 0xffffffffLL || m_offset > 0xffffffffLL) {
+        errorStore << entry->name << "is too big for a ZIP archive" << Qt::endl;
+        return false;
+    }
+    entry->offset = m_offset;
+
+    quint16 dosTime, dosDate;
+    dosDateTime(QDateTime::currentDateTime(), dosTime, dosDate);
+
+    QByteArray header;
+    putLong(header, 0x04034b50);
+    putShort(header, 20); // version needed to extract
+    putShort(header, FlagUtf8);
+    putShort(header, entry->method);
+    putShort(header, dosTime);
+    putShort(header, dosDate);
+    putLong(header, entry->crc);
+    putLong(header, entry->compressedSize);
+    putLong(header, uncompressedSize);
+    putShort(header, entry->name.size());
+    putShort(header, 0); // extra field length
+    header.append(entry->name);
+
+    bool ok = m_device->write(header) == header.size();
+    if (entry->method == MethodStored) {
+        ok = ok && m_device->write(entry->data) == uncompressedSize;
+    } else {
+        for (const Chunk *chunk : std::as_const(entry->chunks)) {
+            ok = ok && m_device->write(chunk->compressed) == chunk->compressed.size();
+        }
+    }
+    m_offset += header.size() + entry->compressedSize;
+
+    // Only the metadata is needed for the central directory
+    qDeleteAll(entry->chunks);
+    entry->chunks.clear();
+    entry->data = QByteArray();
+
+    if (!ok)
+        errorStore << "Failed to write" << entry->name << ":" << m_device->errorString() << Qt::endl;
+    return ok;
+}
+
+bool KoParallelZipStore::writeCentralDirectory()
+{
+    if (m_written.count() > 0xffff) {
+        errorStore << "Too many files for a ZIP archive" << Qt::endl;
+        return false;
+    }
+
+    quint16 dosTime, dosDate;
+    dosDateTime(QDateTime::currentDateTime(), dosTime, dosDate);
+
+    QByteArray directory;
+    for (const Entry *entry : std::as_const(m_written)) {
+        putLong(directory, 0x02014b50);
+        putShort(directory, 20); // version made by
+        putShort(directory, 20); // version needed to extract
+        putShort(directory, FlagUtf8);
+        putShort(directory, entry->method);
+        putShort(directory, dosTime);
+        putShort(directory, dosDate);
+        putLong(directory, entry->crc);
+        putLong(directory, entry->compressedSize);
+        putLong(directory, entry->uncompressedSize);
+        putShort(directory, entry->name.size());
+        putShort(directory, 0); // extra field length
+        putShort(directory, 0); // comment length
+        putShort(directory, 0); // disk number start
+        putShort(directory, 0); // internal attributes
+        putLong(directory, 0); // external attributes
+        putLong(directory, entry->offset);
+        directory.append(entry->name);
+    }
+
+    QByteArray end;
+    putLong(end, 0x06054b50);
+    putShort(end, 0); // number of this disk
+    putShort(end, 0); // disk where the central directory starts
+    putShort(end, m_written.count());
+    putShort(end, m_written.count());
+    putLong(end, directory.size());
+    putLong(end, m_offset);
+    putShort(end, 0); // comment length
+
+    return m_device->write(directory) == directory.size() && m_device->write(end) == end.size();
+}
+
+bool KoParallelZipStore::enterRelativeDirectory(const QString & /*dirName*/)
+{
+    // Write, no checking here
+    return true;
+}
+
+bool KoParallelZipStore::enterAbsoluteDirectory(const QString & /*path*/)
+{
+    return true;
+}
+
+bool KoParallelZipStore::fileExists(const QString &absPath) const
+{
+    Q_D(const KoStore);
+    return d->filesList.contains(absPath);
+}
@@ -0,0 +1,82 @@
+/* This file is part of the KDE project
+   SPDX-FileCopyrightText: 2026 Calligra developers
+
+   SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#ifndef koParallelZipStore_h
+#define koParallelZipStore_h
+
+#include "KoStore.h"
+
+#include <QByteArray>
+#include <QList>
+
+class QThreadPool;
+
+/**
+ * Write-only ZIP backend that deflates the files of the store on worker threads.
+ *
+ * Every file written into the store is buffered until close(). Its data is then
+ * split into independent chunks which are deflated in parallel, and the finished
+ * members are appended to the archive strictly in the order they were closed.
+ * The "mimetype" file is always written first and uncompressed, so the result
+ * is a valid ODF package.
+ *
+ * Reading is not supported; use KoZipStore for that.
+ */
+class KoParallelZipStore : public KoStore
+{
+public:
+    KoParallelZipStore(const QString &_filename, Mode _mode, const QByteArray &appIdentification, bool writeMimetype = true);
+    KoParallelZipStore(QIODevice *dev, Mode mode, const QByteArray &appIdentification, bool writeMimetype = true);
+    ~KoParallelZipStore() override;
+
+    void setCompressionEnabled(bool e) override;
+
+    /// Size of the chunks a single file is split into for compression.
+    static const int ChunkSize = 128 * 1024;
+
+    class Entry;
+    class Chunk;
+
+protected:
+    void init(const QByteArray &appIdentification);
+    bool doFinalize() override;
+    bool openWrite(const QString &name) override;
+    bool openRead(const QString &name) override;
+    bool closeWrite() override;
+    bool closeRead() override
+    {
+        return false;
+    }
+    bool enterRelativeDirectory(const QString &dirName) override;
+    bool enterAbsoluteDirectory(const QString &path) override;
+    bool fileExists(const QString &absPath) const override;
+
+private:
+    /// Queue @p entry for compression on the thread pool
+    void enqueue(Entry *entry);
+    /// Write the leading entries of the queue whose compression is done; if @p wait is true, wait for all of them
+    bool writeFinishedEntries(bool wait);
+    bool writeEntry(Entry *entry);
+    bool writeCentralDirectory();
+
+    /// The device the archive is written to
+    QIODevice *m_device;
+    /// true if m_device was created by us (and is a QSaveFile)
+    bool m_ownsDevice;
+    /// Buffer for the file which is currently open
+    QByteArray m_byteArray;
+    bool m_compressionEnabled;
+    /// Entries not yet written to m_device, in order
+    QList<Entry *> m_pending;
+    /// Entries already written, needed for the central directory
+    QList<Entry *> m_written;
+    qint64 m_offset;
+    QThreadPool *m_pool;
+
+    Q_DECLARE_PRIVATE(KoStore)
+};
+
+#endif
@@ -11,6 +11,7 @@
 
 #include "KoDirectoryStore.h"
 #include "KoEncryptedStore.h"
+#include "KoParallelZipStore.h"
 #include "KoTarStore.h"
 #include "KoZipStore.h"
 
@@ -67,6 +68,10 @@ KoStore *KoStore::createStore(const QString &fileName, Mode mode, const QByteArr
             // When automatically detecting, this might as well be an encrypted file. We'll need to check anyway, so we'll just use the encrypted store.
             return new KoEncryptedStore(fileName, Read, appIdentification, writeMimetype);
         }
+        if (mode == Write) {
+            // Compresses the files on worker threads
+            return new KoParallelZipStore(fileName, mode, appIdentification, writeMimetype);
+        }
         return new KoZipStore(fileName, mode, appIdentification, writeMimetype);
     case Directory:
         return new KoDirectoryStore(fileName /* should be a dir name.... */, mode, writeMimetype);
@@ -103,6 +108,9 @@ KoStore *KoStore::createStore(QIODevice *device, Mode mode, const QByteArray &ap
             // When automatically detecting, this might as well be an encrypted file. We'll need to check anyway, so we'll just use the encrypted store.
             return new KoEncryptedStore(device, Read, appIdentification, writeMimetype);
         }
+        if (mode == Write) {
+            return new KoParallelZipStore(device, mode, appIdentification, writeMimetype);
+        }
         return new KoZipStore(device, mode, appIdentification, writeMimetype);
     case Encrypted:
         return new KoEncryptedStore(device, mode, appIdentification, writeMimetype);
@@ -7,13 +7,22 @@
 
 #include "KoXmlWriter.h"
 
+#include <QBuffer>
 #include <QByteArray>
 #include <QStack>
+#include <QtAlgorithms>
 #include <StoreDebug.h>
+
+#include <charconv>
 #include <float.h>
 
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
 static const int s_indentBufferLength = 100;
-static const int s_escapeBufferLen = 10000;
+/// Size at which the output buffer is written to the device
+static const int s_outputBufferLength = 64 * 1024;
 
 class Q_DECL_HIDDEN KoXmlWriter::Private
 {
@@ -21,22 +30,25 @@ public:
     Private(QIODevice *dev_, int indentLevel = 0)
         : dev(dev_)
         , baseIndentLevel(indentLevel)
+        // Memory buffers are cheap to write to, and are often read back
+        // directly by the caller while elements are still open
+        , writeThrough(qobject_cast<QBuffer *>(dev_) != nullptr)
     {
     }
     ~Private()
     {
         delete[] indentBuffer;
-        delete[] escapeBuffer;
         // TODO: look at if we must delete "dev". For me we must delete it otherwise we will leak it
     }
 
     QIODevice *dev;
     QStack<Tag> tags;
     int baseIndentLevel;
+    bool writeThrough;
 
     char *indentBuffer; // maybe make it static, but then it needs a K_GLOBAL_STATIC
     // and would eat 1K all the time... Maybe refcount it :)
-    char *escapeBuffer; // can't really be static if we want to be thread-safe
+    QByteArray output; // not yet written to dev; can't really be static if we want to be thread-safe
 };
 
 KoXmlWriter::KoXmlWriter(QIODevice *dev, int indentLevel)
@@ -51,16 +63,47 @@ void KoXmlWriter::init()
     memset(d->indentBuffer, ' ', s_indentBufferLength);
     *d->indentBuffer = '\n'; // write newline before indentation, in one go
 
-    d->escapeBuffer = new char[s_escapeBufferLen];
     if (!d->dev->isOpen())
         d->dev->open(QIODevice::WriteOnly);
 }
 
 KoXmlWriter::~KoXmlWriter()
 {
+    flush();
     delete d;
 }
 
+void KoXmlWriter::flush()
+{
+    if (d->output.isEmpty())
+        return;
+    // TODO check return value!!!
+    d->dev->write(d->output.constData(), d->output.size());
+    d->output.resize(0); // keeps the capacity
+}
+
+void KoXmlWriter::writeData(const char *data, int length)
+{
+    if (d->writeThrough) {
+        d->dev->write(data, length);
+        return;
+    }
+    d->output.append(data, length);
+    if (d->output.size() >= s_outputBufferLength)
+        flush();
+}
+
+void KoXmlWriter::writeChar(char c)
+{
+    if (d->writeThrough) {
+        d->dev->putChar(c);
+        return;
+    }
+    d->output.append(c);
+    if (d->output.size() >= s_outputBufferLength)
+        flush();
+}
+
 void KoXmlWriter::startDocument(const char *rootElemName, const char *publicId, const char *systemId)
 {
     Q_ASSERT(d->tags.isEmpty());
@@ -84,6 +127,7 @@ void KoXmlWriter::endDocument()
     // just to do exactly like QDom does (newline at end of file).
     writeChar('\n');
     Q_ASSERT(d->tags.isEmpty());
+    flush();
 }
 
 // returns the value of indentInside of the parent
@@ -148,7 +192,9 @@ void KoXmlWriter::addCompleteElement(QIODevice *indev)
         return;
     }
 
-    static const int MAX_CHUNK_SIZE = 8 * 1024; // 8 KB
+    // Keep the order of the output; the rest goes directly to the device in big chunks
+    flush();
+    static const int MAX_CHUNK_SIZE = 64 * 1024; // 64 KB
     QByteArray buffer;
     buffer.resize(MAX_CHUNK_SIZE);
     while (!indev->atEnd()) {
@@ -184,25 +230,29 @@ void KoXmlWriter::endElement()
         writeCString(tag.tagName);
         writeChar('>');
     }
+
+    // Writers for single elements are often read back right away through the device
+    if (d->tags.isEmpty())
+        flush();
+}
+
+void KoXmlWriter::addTextNode(const QString &str)
+{
+    prepareForTextNode();
+    writeEscaped(str);
 }
 
 void KoXmlWriter::addTextNode(const QByteArray &cstr)
 {
     // Same as the const char* version below, but here we know the size
     prepareForTextNode();
-    char *escaped = escapeForXML(cstr.constData(), cstr.size());
-    writeCString(escaped);
-    if (escaped != d->escapeBuffer)
-        delete[] escaped;
+    writeEscaped(cstr.constData(), cstr.size());
 }
 
 void KoXmlWriter::addTextNode(const char *cstr)
 {
     prepareForTextNode();
-    char *escaped = escapeForXML(cstr, -1);
-    writeCString(escaped);
-    if (escaped != d->escapeBuffer)
-        delete[] escaped;
+    writeEscaped(cstr, -1);
 }
 
 void KoXmlWriter::addProcessingInstruction(const char *cstr)
@@ -213,145 +263,249 @@ void KoXmlWriter::addProcessingInstruction(const char *cstr)
     writeCString("?>");
 }
 
-void KoXmlWriter::addAttribute(const char *attrName, const QByteArray &value)
+void KoXmlWriter::writeAttributeStart(const char *attrName)
 {
-    // Same as the const char* one, but here we know the size
     writeChar(' ');
     writeCString(attrName);
-    writeCString("=\"");
-    char *escaped = escapeForXML(value.constData(), value.size());
-    writeCString(escaped);
-    if (escaped != d->escapeBuffer)
-        delete[] escaped;
+    writeData("=\"", 2);
+}
+
+void KoXmlWriter::addAttribute(const char *attrName, const QString &value)
+{
+    writeAttributeStart(attrName);
+    writeEscaped(value);
+    writeChar('"');
+}
+
+void KoXmlWriter::addAttribute(const char *attrName, const QByteArray &value)
+{
+    // Same as the const char* one, but here we know the size
+    writeAttributeStart(attrName);
+    writeEscaped(value.constData(), value.size());
     writeChar('"');
 }
 
 void KoXmlWriter::addAttribute(const char *attrName, const char *value)
 {
-    writeChar(' ');
-    writeCString(attrName);
-    writeCString("=\"");
-    char *escaped = escapeForXML(value, -1);
-    writeCString(escaped);
-    if (escaped != d->escapeBuffer)
-        delete[] escaped;
+    writeAttributeStart(attrName);
+    writeEscaped(value, -1);
     writeChar('"');
 }
 
+void KoXmlWriter::addAttribute(const char *attrName, const char *utf8Value, int length)
+{
+    writeAttributeStart(attrName);
+    writeEscaped(utf8Value, length);
+    writeChar('"');
+}
+
+// Numbers never need escaping, and are formatted on the stack without allocating
+template<typename T>
+static inline int formatNumber(char *buffer, int size, T value)
+{
+    return std::to_chars(buffer, buffer + size, value).ptr - buffer;
+}
+
+template<typename T>
+static inline int formatNumber(char *buffer, int size, T value, int precision)
+{
+    return std::to_chars(buffer, buffer + size, value, std::chars_format::fixed, precision).ptr - buffer;
+}
+
+void KoXmlWriter::addAttribute(const char *attrName, int value)
+{
+    char buffer[16];
+    addAttribute(attrName, buffer, formatNumber(buffer, sizeof(buffer), value));
+}
+
+void KoXmlWriter::addAttribute(const char *attrName, uint value)
+{
+    char buffer[16];
+    addAttribute(attrName, buffer, formatNumber(buffer, sizeof(buffer), value));
+}
+
+void KoXmlWriter::addAttribute(const char *attrName, qint64 value)
+{
+    char buffer[24];
+    addAttribute(attrName, buffer, formatNumber(buffer, sizeof(buffer), value));
+}
+
+void KoXmlWriter::addAttribute(const char *attrName, quint64 value)
+{
+    char buffer[24];
+    addAttribute(attrName, buffer, formatNumber(buffer, sizeof(buffer), value));
+}
+
+// -DBL_MAX has a sign and 309 digits before the decimal point, plus up to 11 decimals and "pt"
+static const int s_numberBufferLength = 1 + 309 + 1 + 11 + 2;
+
 void KoXmlWriter::addAttribute(const char *attrName, double value)
 {
-    QByteArray str;
-    str.setNum(value, 'f', 11);
-    addAttribute(attrName, str.data());
+    char buffer[s_numberBufferLength];
+    addAttribute(attrName, buffer, formatNumber(buffer, sizeof(buffer), value, 11));
 }
 
 void KoXmlWriter::addAttribute(const char *attrName, float value)
 {
-    QByteArray str;
-    str.setNum(value, 'f', FLT_DIG);
-    addAttribute(attrName, str.data());
+    char buffer[s_numberBufferLength];
+    addAttribute(attrName, buffer, formatNumber(buffer, sizeof(buffer), value, FLT_DIG));
 }
 
 void KoXmlWriter::addAttributePt(const char *attrName, double value)
 {
-    QByteArray str;
-    str.setNum(value, 'f', 11);
-    str += "pt";
-    addAttribute(attrName, str.data());
+    char buffer[s_numberBufferLength];
+    int length = formatNumber(buffer, sizeof(buffer) - 2, value, 11);
+    memcpy(buffer + length, "pt", 2);
+    addAttribute(attrName, buffer, length + 2);
 }
 
 void KoXmlWriter::addAttributePt(const char *attrName, float value)
 {
-    QByteArray str;
-    str.setNum(value, 'f', FLT_DIG);
-    str += "pt";
-    addAttribute(attrName, str.data());
+    char buffer[s_numberBufferLength];
+    int length = formatNumber(buffer, sizeof(buffer) - 2, value, FLT_DIG);
+    memcpy(buffer + length, "pt", 2);
+    addAttribute(attrName, buffer, length + 2);
 }
 
 void KoXmlWriter::writeIndent()
 {
     // +1 because of the leading '\n'
-    d->dev->write(d->indentBuffer, qMin(indentLevel() + 1, s_indentBufferLength));
+    writeData(d->indentBuffer, qMin(indentLevel() + 1, s_indentBufferLength));
 }
 
 void KoXmlWriter::writeString(const QString &str)
 {
     // cachegrind says .utf8() is where most of the time is spent
     const QByteArray cstr = str.toUtf8();
-    d->dev->write(cstr);
+    writeData(cstr.constData(), cstr.size());
+}
+
+// Characters which can't be copied verbatim: the ones to be escaped, the end of
+// the string, and control codes (the ones accepted in XML 1.0 are copied later on).
+static inline bool needsEscaping(char c)
+{
+    return c == '<' || c == '>' || c == '"' || c == '&' || (c >= 0 && c < 32);
+}
+
+// Returns the number of leading chars of @p source which can be copied verbatim
+static inline int verbatimLength(const char *source, int length)
+{
+    int i = 0;
+#ifdef __SSE2__
+    const __m128i lt = _mm_set1_epi8('<');
+    const __m128i gt = _mm_set1_epi8('>');
+    const __m128i quot = _mm_set1_epi8('"');
+    const __m128i amp = _mm_set1_epi8('&');
+    const __m128i lastControlCode = _mm_set1_epi8(31);
+    for (; i + 16 <= length; i += 16) {
+        const __m128i chars = _mm_loadu_si128(reinterpret_cast<const __m128i *>(source + i));
+        __m128i special = _mm_or_si128(_mm_cmpeq_epi8(chars, lt), _mm_cmpeq_epi8(chars, gt));
+        special = _mm_or_si128(special, _mm_or_si128(_mm_cmpeq_epi8(chars, quot), _mm_cmpeq_epi8(chars, amp)));
+        // unsigned chars <= 31; utf8 sequences are all >= 0x80
+        special = _mm_or_si128(special, _mm_cmpeq_epi8(_mm_min_epu8(chars, lastControlCode), chars));
+        const int mask = _mm_movemask_epi8(special);
+        if (mask)
+            return i + qCountTrailingZeroBits(uint(mask));
+    }
+#endif
+    while (i < length && !needsEscaping(source[i]))
+        ++i;
+    return i;
 }
 
-// In case of a reallocation (ret value != d->buffer), the caller owns the return value,
-// it must delete it (with [])
-char *KoXmlWriter::escapeForXML(const char *source, int length = -1) const
+void KoXmlWriter::writeEscaped(const char *source, int length)
 {
-    // we're going to be pessimistic on char length; so lets make the outputLength less
-    // the amount one char can take: 6
-    char *destBoundary = d->escapeBuffer + s_escapeBufferLen - 6;
-    char *destination = d->escapeBuffer;
-    char *output = d->escapeBuffer;
+    if (length == -1)
+        length = qstrlen(source);
     const char *src = source; // src moves, source remains
-    for (;;) {
-        if (destination >= destBoundary) {
-            // When we come to realize that our escaped string is going to
-            // be bigger than the escape buffer (this shouldn't happen very often...),
-            // we drop the idea of using it, and we allocate a bigger buffer.
-            // Note that this if() can only be hit once per call to the method.
-            if (length == -1)
-                length = qstrlen(source); // expensive...
-            uint newLength = length * 6 + 1; // worst case. 6 is due to &quot; and &apos;
-            char *buffer = new char[newLength];
-            destBoundary = buffer + newLength;
-            uint amountOfCharsAlreadyCopied = destination - d->escapeBuffer;
-            memcpy(buffer, d->escapeBuffer, amountOfCharsAlreadyCopied);
-            output = buffer;
-            destination = buffer + amountOfCharsAlreadyCopied;
+    const char *end = source + length;
+    while (src < end) {
+        const int verbatim = verbatimLength(src, end - src);
+        if (verbatim > 0) {
+            writeData(src, verbatim);
+            src += verbatim;
+            if (src == end)
+                break;
         }
         switch (*src) {
         case 60: // <
-            memcpy(destination, "&lt;", 4);
-            destination += 4;
+            writeData("&lt;", 4);
             break;
         case 62: // >
-            memcpy(destination, "&gt;", 4);
-            destination += 4;
+            writeData("&gt;", 4);
             break;
         case 34: // "
-            memcpy(destination, "&quot;", 6);
-            destination += 6;
+            writeData("&quot;", 6);
             break;
 #if 0 // needed?
         case 39: // '
-            memcpy(destination, "&apos;", 6);
-            destination += 6;
+            writeData("&apos;", 6);
             break;
 #endif
         case 38: // &
-            memcpy(destination, "&amp;", 5);
-            destination += 5;
+            writeData("&amp;", 5);
             break;
         case 0:
-            *destination = '\0';
-            return output;
+            return;
         // Control codes accepted in XML 1.0 documents.
         case 9:
         case 10:
         case 13:
-            *destination++ = *src++;
-            continue;
+            writeChar(*src);
+            break;
         default:
             // Don't add control codes not accepted in XML 1.0 documents.
-            if (*src > 0 && *src < 32) {
-                ++src;
+            break;
+        }
+        ++src;
+    }
+}
+
+void KoXmlWriter::writeEscaped(const QString &source)
+{
+    // Convert to utf8 in chunks on the stack, to avoid a temporary QByteArray
+    static const int s_chunkLength = 1024;
+    char chunk[(s_chunkLength + 1) * 3]; // +1 for a surrogate pair at the end
+    const QChar *src = source.constData();
+    const QChar *end = src + source.length();
+    while (src < end) {
+        char *dest = chunk;
+        const QChar *chunkEnd = src + qMin<qsizetype>(s_chunkLength, end - src);
+        // don't split surrogate pairs
+        if (chunkEnd < end && chunkEnd[-1].isHighSurrogate())
+            ++chunkEnd;
+        for (; src < chunkEnd; ++src) {
+            uint ucs = src->unicode();
+            if (ucs < 0x80) {
+                if (ucs == 0) {
+                    // the char* version ends at the null character as well
+                    writeEscaped(chunk, dest - chunk);
+                    return;
+                }
+                *dest++ = char(ucs);
+                continue;
+            }
+            if (ucs < 0x800) {
+                *dest++ = char(0xc0 | (ucs >> 6));
             } else {
-                *destination++ = *src++;
+                if (QChar::isSurrogate(ucs)) {
+                    if (QChar::isHighSurrogate(ucs) && src + 1 < end && src[1].isLowSurrogate()) {
+                        ucs = QChar::surrogateToUcs4(ucs, (++src)->unicode());
+                        *dest++ = char(0xf0 | (ucs >> 18));
+                        *dest++ = char(0x80 | ((ucs >> 12) & 0x3f));
+                    } else {
+                        ucs = QChar::ReplacementCharacter;
+                        *dest++ = char(0xe0 | (ucs >> 12));
+                    }
+                } else {
+                    *dest++ = char(0xe0 | (ucs >> 12));
+                }
+                *dest++ = char(0x80 | ((ucs >> 6) & 0x3f));
             }
-            continue;
+            *dest++ = char(0x80 | (ucs & 0x3f));
         }
-        ++src;
+        writeEscaped(chunk, dest - chunk);
     }
-    // NOTREACHED (see case 0)
-    return output;
 }
 
 void KoXmlWriter::addManifestEntry(const QString &fullPath, const QString &mediaType)
@@ -519,6 +673,8 @@ void KoXmlWriter::addTextSpan(const QString &text, const QMap<int, int> &tabCach
 
 QIODevice *KoXmlWriter::device() const
 {
+    // The caller might write to or read from the device directly
+    const_cast<KoXmlWriter *>(this)->flush();
     return d->dev;
 }
 
@@ -538,6 +694,7 @@ QList<const char *> KoXmlWriter::tagHierarchy() const
 
 QString KoXmlWriter::toString() const
 {
+    const_cast<KoXmlWriter *>(this)->flush();
     Q_ASSERT(!d->dev->isSequential());
     if (d->dev->isSequential())
         return QString();
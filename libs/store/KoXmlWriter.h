@@ -58,25 +58,25 @@ public:
     /**
      * Overloaded version of addAttribute( const char*, const char* ),
      * which is a bit slower because it needs to convert @p value to utf8 first.
+     * The conversion is done straight into the output buffer, without temporary allocations.
      */
-    inline void addAttribute(const char *attrName, const QString &value)
-    {
-        addAttribute(attrName, value.toUtf8());
-    }
+    void addAttribute(const char *attrName, const QString &value);
     /**
      * Add an attribute whose value is an integer
      */
-    inline void addAttribute(const char *attrName, int value)
-    {
-        addAttribute(attrName, QByteArray::number(value));
-    }
+    void addAttribute(const char *attrName, int value);
     /**
      * Add an attribute whose value is an unsigned integer
      */
-    inline void addAttribute(const char *attrName, uint value)
-    {
-        addAttribute(attrName, QByteArray::number(value));
-    }
+    void addAttribute(const char *attrName, uint value);
+    /**
+     * Add an attribute whose value is a 64 bit integer
+     */
+    void addAttribute(const char *attrName, qint64 value);
+    /**
+     * Add an attribute whose value is an unsigned 64 bit integer
+     */
+    void addAttribute(const char *attrName, quint64 value);
     /**
      * Add an attribute whose value is an bool
      * It is written as "true" or "false" based on value
@@ -119,6 +119,13 @@ public:
      * Add an attribute to the current element.
      */
     void addAttribute(const char *attrName, const char *value);
+
+    /**
+     * Add an attribute whose value is already encoded in utf8, and whose length is known.
+     * This is the fastest way to add a string attribute, as neither a conversion
+     * nor a strlen is needed. The value is still escaped for XML.
+     */
+    void addAttribute(const char *attrName, const char *utf8Value, int length);
     /**
      * Terminate the current element. After this you should start a new one (sibling),
      * add a sibling text node, or close another one (end of siblings).
@@ -128,10 +135,7 @@ public:
      * Overloaded version of addTextNode( const char* ),
      * which is a bit slower because it needs to convert @p str to utf8 first.
      */
-    inline void addTextNode(const QString &str)
-    {
-        addTextNode(str.toUtf8());
-    }
+    void addTextNode(const QString &str);
     /// Overloaded version of the one taking a const char* argument
     void addTextNode(const QByteArray &cstr);
     /**
@@ -220,6 +224,17 @@ public:
      */
     void addTextSpan(const QString &text, const QMap<int, int> &tabCache);
 
+    /**
+     * Write out everything which is still buffered to the device.
+     *
+     * Unless the device is a QBuffer, the output is buffered internally and
+     * written to the device in bulk. This happens automatically when the
+     * buffer is full, when the outermost element is closed, in endDocument(),
+     * in device() and on destruction, so calling this is only needed when
+     * accessing the device by other means while elements are still open.
+     */
+    void flush();
+
     /**
      * @return the current indentation level.
      * Useful when creating a sub-KoXmlWriter (see addCompleteElement)
@@ -261,15 +276,13 @@ private:
     // Try to use it as much as possible, especially with constants.
     void writeString(const QString &str);
 
-    // TODO check return value!!!
+    /// Append @p length bytes to the output buffer, flushing it when full
+    void writeData(const char *data, int length);
     inline void writeCString(const char *cstr)
     {
-        device()->write(cstr, qstrlen(cstr));
-    }
-    inline void writeChar(char c)
-    {
-        device()->putChar(c);
+        writeData(cstr, qstrlen(cstr));
     }
+    void writeChar(char c);
     inline void closeStartElement(Tag &tag)
     {
         if (!tag.openingTagClosed) {
@@ -277,7 +290,11 @@ private:
             writeChar('>');
         }
     }
-    char *escapeForXML(const char *source, int length) const;
+    /// Append @p source escaped for XML to the output buffer, @p length -1 means null-terminated
+    void writeEscaped(const char *source, int length);
+    /// Append @p source encoded in utf8 and escaped for XML to the output buffer
+    void writeEscaped(const QString &source);
+    void writeAttributeStart(const char *attrName);
     bool prepareForChild();
     void prepareForTextNode();
     void init();
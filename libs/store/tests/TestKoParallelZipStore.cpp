@@ -0,0 +1,119 @@
+/* This file is part of the KDE project
+ * SPDX-FileCopyrightText: 2026 Calligra developers
+ *
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ */
+
+#include "TestKoParallelZipStore.h"
+
+#include <KoStore.h>
+
+#include <QBuffer>
+#include <QTest>
+
+static const QByteArray mimetype("application/vnd.oasis.opendocument.text");
+
+static QByteArray generateData(int size)
+{
+    QByteArray data;
+    data.reserve(size);
+    for (int i = 0; data.size() < size; ++i) {
+        data += "<text:p text:style-name=\"P" + QByteArray::number(i % 17) + "\">" + QByteArray::number(i * 7919) + "</text:p>";
+    }
+    data.truncate(size);
+    return data;
+}
+
+void TestKoParallelZipStore::testMimetypeFirst()
+{
+    QByteArray archive;
+    QBuffer buffer(&archive);
+    KoStore *store = KoStore::createStore(&buffer, KoStore::Write, mimetype, KoStore::Zip);
+    QVERIFY(!store->bad());
+    QVERIFY(store->open("content.xml"));
+    QVERIFY(store->write(generateData(1000)) == 1000);
+    QVERIFY(store->close());
+    QVERIFY(store->finalize());
+    delete store;
+
+    // ODF requires "mimetype" as first, uncompressed file without extra field
+    QVERIFY(archive.startsWith("PK\x03\x04"));
+    QCOMPARE(archive.at(8), '\0'); // compression method
+    QCOMPARE(archive.at(9), '\0');
+    QCOMPARE(archive.at(28), '\0'); // extra field length
+    QCOMPARE(archive.at(29), '\0');
+    QCOMPARE(archive.mid(30, 8), QByteArray("mimetype"));
+    QCOMPARE(archive.mid(38, mimetype.size()), mimetype);
+}
+
+void TestKoParallelZipStore::testRoundtrip_data()
+{
+    QTest::addColumn<int>("size");
+    QTest::newRow("empty") << 0;
+    QTest::newRow("small") << 100;
+    QTest::newRow("one chunk") << 128 * 1024;
+    QTest::newRow("several chunks") << 1000 * 1000 + 17;
+}
+
+void TestKoParallelZipStore::testRoundtrip()
+{
+    QFETCH(int, size);
+
+    const QByteArray content = generateData(size);
+    const QByteArray styles = generateData(size / 3);
+
+    QByteArray archive;
+    QBuffer buffer(&archive);
+    KoStore *store = KoStore::createStore(&buffer, KoStore::Write, mimetype, KoStore::Zip);
+    QVERIFY(store->open("content.xml"));
+    QCOMPARE(store->write(content), qint64(content.size()));
+    QVERIFY(store->close());
+    QVERIFY(store->open("styles.xml"));
+    QCOMPARE(store->write(styles), qint64(styles.size()));
+    QVERIFY(store->close());
+    QVERIFY(store->open("Pictures/image.xml"));
+    QCOMPARE(store->write(content), qint64(content.size()));
+    QVERIFY(store->close());
+    QVERIFY(store->finalize());
+    delete store;
+
+    QBuffer readBuffer(&archive);
+    store = KoStore::createStore(&readBuffer, KoStore::Read, QByteArray(), KoStore::Zip);
+    QVERIFY(!store->bad());
+    QByteArray data;
+    QVERIFY(store->extractFile("mimetype", data));
+    QCOMPARE(data, mimetype);
+    QVERIFY(store->extractFile("content.xml", data));
+    QCOMPARE(data, content);
+    QVERIFY(store->extractFile("styles.xml", data));
+    QCOMPARE(data, styles);
+    QVERIFY(store->extractFile("Pictures/image.xml", data));
+    QCOMPARE(data, content);
+    delete store;
+}
+
+void TestKoParallelZipStore::testUncompressed()
+{
+    const QByteArray content = generateData(300 * 1000);
+
+    QByteArray archive;
+    QBuffer buffer(&archive);
+    KoStore *store = KoStore::createStore(&buffer, KoStore::Write, mimetype, KoStore::Zip);
+    store->setCompressionEnabled(false);
+    QVERIFY(store->open("content.xml"));
+    QCOMPARE(store->write(content), qint64(content.size()));
+    QVERIFY(store->close());
+    QVERIFY(store->finalize());
+    delete store;
+
+    QVERIFY(archive.contains(content));
+
+    QBuffer readBuffer(&archive);
+    store = KoStore::createStore(&readBuffer, KoStore::Read, QByteArray(), KoStore::Zip);
+    QByteArray data;
+    QVERIFY(store->extractFile("content.xml", data));
+    QCOMPARE(data, content);
+    delete store;
+}
+
+QTEST_GUILESS_MAIN(TestKoParallelZipStore)
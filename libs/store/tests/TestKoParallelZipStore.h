@@ -0,0 +1,24 @@
+/* This file is part of the KDE project
+ * SPDX-FileCopyrightText: 2026 Calligra developers
+ *
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ */
+
+#ifndef TESTKOPARALLELZIPSTORE_H
+#define TESTKOPARALLELZIPSTORE_H
+
+// Qt
+#include <QObject>
+
+class TestKoParallelZipStore : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void testMimetypeFirst();
+    void testRoundtrip_data();
+    void testRoundtrip();
+    void testUncompressed();
+};
+
+#endif
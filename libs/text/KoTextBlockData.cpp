@@ -21,6 +21,7 @@ public:
         , counterIndex(1)
         , border(nullptr)
         , paintStrategy(nullptr)
+        , layoutKey(0)
     {
         layoutedMarkupRanges[KoTextBlockData::Misspell] = false;
         layoutedMarkupRanges[KoTextBlockData::Grammar] = false;
@@ -46,6 +47,7 @@ public:
     KoTextBlockPaintStrategyBase *paintStrategy;
     QMap<KoTextBlockData::MarkupType, QVector<MarkupRange>> markupRangesMap;
     QMap<KoTextBlockData::MarkupType, bool> layoutedMarkupRanges;
+    size_t layoutKey;
 };
 
 KoTextBlockData::KoTextBlockData(QTextBlock &block)
@@ -296,3 +298,13 @@ bool KoTextBlockData::saveXmlID() const
     // as suggested by boemann, http://lists.kde.org/?l=calligra-devel&m=132396354701553&w=2
     return d->paintStrategy != nullptr;
 }
+
+void KoTextBlockData::setLayoutKey(size_t key)
+{
+    d->layoutKey = key;
+}
+
+size_t KoTextBlockData::layoutKey() const
+{
+    return d->layoutKey;
+}
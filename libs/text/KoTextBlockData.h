@@ -203,6 +203,16 @@ public:
      */
     bool saveXmlID() const;
 
+    /**
+     * Set the key describing everything the line-breaking of this paragraph depended on
+     * when its lines were last created in one go, or 0 if they can not be reused.
+     * Used by the text layout to only move the lines of unchanged paragraphs.
+     */
+    void setLayoutKey(size_t key);
+
+    /// return the key set with setLayoutKey(), 0 by default
+    size_t layoutKey() const;
+
 private:
     class Private;
     Private *const d;
@@ -113,6 +113,9 @@ bool KoTextRange::positionOnlyMode() const
 void KoTextRange::setPositionOnlyMode(bool b)
 {
     d->positionOnlyMode = b;
+    if (d->manager) {
+        d->manager->rangeChanged(this);
+    }
 }
 
 bool KoTextRange::hasRange() const
@@ -134,6 +137,9 @@ void KoTextRange::setRangeStart(int position)
 {
     d->positionOnlyMode = true;
     d->cursor.setPosition(position);
+    if (d->manager) {
+        d->manager->rangeChanged(this);
+    }
 }
 
 void KoTextRange::setRangeEnd(int position)
@@ -145,6 +151,9 @@ void KoTextRange::setRangeEnd(int position)
         d->cursor.setPosition(d->cursor.selectionStart());
         d->cursor.setPosition(position, QTextCursor::KeepAnchor);
     }
+    if (d->manager) {
+        d->manager->rangeChanged(this);
+    }
 }
 
 QString KoTextRange::text() const
@@ -9,51 +9,160 @@
 
 #include "KoAnnotation.h"
 #include "KoBookmark.h"
+#include <QTextDocument>
 #include <algorithm>
 
 #include "TextDebug.h"
 
+/**
+ * Interval tree of the text ranges of one type in one document.
+ *
+ * The ranges are kept sorted by their start position in an array, over which an implicit
+ * binary tree holds the range with the furthest end of every subtree. The positions are
+ * not stored but read from the cursors of the ranges. Edits mostly shift the ranges along
+ * with their text, but not always in order: the start of a ranged item is the anchor of its
+ * cursor, which moves on inserts, while a position keeps its place. So every change of the
+ * document invalidates the index, which is checked and if needed sorted again on the next
+ * lookup.
+ */
 struct KoTextRangeManagerIndex {
-    QList<KoTextRange *> singlePoints;
-    QList<KoTextRange *> nonOverlapping;
-    QList<KoTextRange *> overlapping;
-
     void addToIndex(KoTextRange *r)
     {
-        if (!r->hasRange()) {
-            if (addInList(r, singlePoints))
-                return;
+        if (!m_unsorted) {
+            auto it = std::upper_bound(m_ranges.begin(), m_ranges.end(), r->rangeStart(), [](int start, KoTextRange *range) {
+                return start < range->rangeStart();
+            });
+            m_ranges.insert(it, r);
+        } else {
+            m_ranges.append(r);
         }
-        if (r->rangeEnd() != r->rangeStart()) {
-            if (addInList(r, nonOverlapping))
+        m_tree.clear();
+    }
+
+    void removeFromIndex(KoTextRange *r)
+    {
+        if (!m_unsorted) {
+            auto range = std::equal_range(m_ranges.begin(), m_ranges.end(), r, [](KoTextRange *a, KoTextRange *b) {
+                return a->rangeStart() < b->rangeStart();
+            });
+            auto it = std::find(range.first, range.second, r);
+            if (it != range.second) {
+                m_ranges.erase(it);
+                m_tree.clear();
                 return;
+            }
         }
-        addInList(r, overlapping, true);
+        m_ranges.removeOne(r);
+        m_tree.clear();
     }
 
-    void removeFromIndex(KoTextRange *r)
+    /// To be called when the positions of ranges changed
+    void invalidate()
+    {
+        m_unsorted = true;
+        m_tree.clear();
+    }
+
+    /// Call @p function for every range that ends at or after @p first and starts at or before @p last
+    template<typename Function>
+    void overlapping(int first, int last, Function function)
     {
-        if (!r->hasRange())
-            singlePoints.removeOne(r);
-        else
-            nonOverlapping.removeOne(r);
-        overlapping.removeOne(r);
+        if (m_ranges.isEmpty()) {
+            return;
+        }
+        if (m_tree.isEmpty()) {
+            rebuild();
+        }
+        // only the ranges in front of this one start at or before last
+        const int count = std::upper_bound(m_ranges.constBegin(),
+                                           m_ranges.constEnd(),
+                                           last,
+                                           [](int position, KoTextRange *range) {
+                                               return position < range->rangeStart();
+                                           })
+            - m_ranges.constBegin();
+        overlapping(1, 0, m_ranges.size(), count, first, function);
     }
 
 private:
-    bool addInList(KoTextRange *r, QList<KoTextRange *> &list, bool force = false)
+    void rebuild()
+    {
+        // edits rarely reorder anything, so don't pay for sorting then
+        if (m_unsorted && !std::is_sorted(m_ranges.constBegin(), m_ranges.constEnd(), [](KoTextRange *a, KoTextRange *b) {
+                return a->rangeStart() < b->rangeStart();
+            })) {
+            std::stable_sort(m_ranges.begin(), m_ranges.end(), [](KoTextRange *a, KoTextRange *b) {
+                return a->rangeStart() < b->rangeStart();
+            });
+        }
+        m_unsorted = false;
+        m_tree.resize(4 * m_ranges.size());
+        build(1, 0, m_ranges.size());
+    }
+
+    KoTextRange *build(int node, int begin, int end)
+    {
+        if (end - begin == 1) {
+            return m_tree[node] = m_ranges[begin];
+        }
+        const int middle = (begin + end) / 2;
+        KoTextRange *left = build(2 * node, begin, middle);
+        KoTextRange *right = build(2 * node + 1, middle, end);
+        return m_tree[node] = left->rangeEnd() >= right->rangeEnd() ? left : right;
+    }
+
+    template<typename Function>
+    void overlapping(int node, int begin, int end, int count, int first, Function &function) const
     {
-        auto it = list.begin();
-        while (it != list.end() && (*it)->rangeStart() < r->rangeStart())
-            ++it;
-        if (force || it == list.end() || ((*it)->rangeStart() > r->rangeStart())) {
-            list.insert(it, r);
-            return true;
+        if (begin >= count || m_tree[node]->rangeEnd() < first) {
+            return;
+        }
+        if (end - begin == 1) {
+            function(m_ranges[begin]);
+            return;
         }
-        return false;
+        const int middle = (begin + end) / 2;
+        overlapping(2 * node, begin, middle, count, first, function);
+        overlapping(2 * node + 1, middle, end, count, first, function);
     }
+
+    QVector<KoTextRange *> m_ranges; // sorted by start position
+    QVector<KoTextRange *> m_tree; // the range with the furthest end below each node, empty if outdated
+    bool m_unsorted = false;
 };
 
+/// Add @p range to @p ranges if it has a start or end point between first and last, see textRangesChangingWithin()
+static void addIfChangingWithin(QMultiHash<int, KoTextRange *> &ranges, KoTextRange *range, int first, int last, int matchFirst, int matchLast)
+{
+    if (!range->hasRange()) {
+        if (range->rangeStart() >= first && range->rangeStart() <= last) {
+            ranges.insert(range->rangeStart(), range);
+        }
+    } else {
+        if (range->rangeStart() >= first && range->rangeStart() <= last) {
+            if (matchLast == -1 || range->rangeEnd() <= matchLast) {
+                if (range->rangeEnd() >= matchFirst) {
+                    ranges.insert(range->rangeStart(), range);
+                }
+            }
+        }
+        if (range->rangeEnd() >= first && range->rangeEnd() <= last) {
+            if (matchLast == -1 || range->rangeStart() <= matchLast) {
+                if (range->rangeStart() >= matchFirst) {
+                    ranges.insert(range->rangeEnd(), range);
+                }
+            }
+        }
+        if (range->rangeStart() >= first && range->rangeStart() <= last) {
+            if (matchLast == -1 || range->rangeEnd() >= matchLast) {
+                if (range->rangeEnd() >= matchFirst) {
+                    ranges.replace(range->rangeStart(), range);
+                }
+            }
+        }
+    }
+}
+
 class KoTextRangeManager::KoTextRangeManagerPrivate
 {
 public:
@@ -64,17 +173,19 @@ public:
 
     QHash<const QTextDocument *, QList<KoTextRange *>> unfinalizedRanges;
 
-    void addDocument(const QTextDocument *doc)
+    void addDocument(const QTextDocument *doc, KoTextRangeManager *q)
     {
-        // Should we connect to the QTextDocument::cursorPositionChanged signal to make sure
-        // the indexes remain sorted? I still don't see how we could end up with a cursor being
-        // moved before another with the current object interfaces, but any mistake in this perception
-        // could end up with completely broken layout, crashes...
         if (!m_textRanges.contains(doc)) {
             m_textRanges.insert(doc, {});
             m_deletedTextRanges.insert(doc, {});
             indexes.insert(doc, {});
             unfinalizedRanges.insert(doc, {});
+            // inserting text where a range and a position start moves only the range
+            QObject::connect(doc, &QTextDocument::contentsChange, q, [this, doc]() {
+                for (KoTextRangeManagerIndex &index : indexes[doc]) {
+                    index.invalidate();
+                }
+            });
         }
     }
 };
@@ -113,7 +224,7 @@ void KoTextRangeManager::insert(KoTextRange *textRange)
     }
 
     auto doc = textRange->document();
-    d->addDocument(doc);
+    d->addDocument(doc, this);
 
     if (!textRange->isFinalized()) {
         d->unfinalizedRanges[doc].append(textRange);
@@ -190,133 +301,29 @@ QList<KoTextRange *> KoTextRangeManager::textRanges() const
     return allRanges;
 }
 
+void KoTextRangeManager::rangeChanged(KoTextRange *range)
+{
+    auto docIndexes = d->indexes.find(range->document());
+    if (docIndexes == d->indexes.end()) {
+        return;
+    }
+    auto index = docIndexes->find(range->metaObject());
+    if (index != docIndexes->end()) {
+        index->invalidate();
+    }
+}
+
 QMultiHash<int, KoTextRange *> KoTextRangeManager::textRangesChangingWithin(const QTextDocument *doc, int first, int last, int matchFirst, int matchLast) const
 {
     QMultiHash<int, KoTextRange *> ranges;
-    if (!d->m_textRanges.contains(doc))
+    auto docIndexes = d->indexes.find(doc);
+    if (docIndexes == d->indexes.end())
         return ranges;
 
-    // TODO: this constant is kind of magic. It's the trade-of between comparing each item, and the cost of going through several lists, with varying
-    // ordering rules
-#define INDEX_USAGE_THRESHOLD 10
-    if (d->m_textRanges[doc].size() < INDEX_USAGE_THRESHOLD) {
-        const QSet<KoTextRange *> &docRanges = d->m_textRanges.value(doc);
-        // qDebug() << "KoTextRangeManager => going to skip the index";
-        // On a small set of items, going through the set is going to be faster
-        for (KoTextRange *range : docRanges) {
-            if (!range->hasRange()) {
-                if (range->rangeStart() >= first && range->rangeStart() <= last) {
-                    ranges.insert(range->rangeStart(), range);
-                }
-            } else {
-                if (range->rangeStart() >= first && range->rangeStart() <= last) {
-                    if (matchLast == -1 || range->rangeEnd() <= matchLast) {
-                        if (range->rangeEnd() >= matchFirst) {
-                            ranges.insert(range->rangeStart(), range);
-                        }
-                    }
-                }
-                if (range->rangeEnd() >= first && range->rangeEnd() <= last) {
-                    if (matchLast == -1 || range->rangeStart() <= matchLast) {
-                        if (range->rangeStart() >= matchFirst) {
-                            ranges.insert(range->rangeEnd(), range);
-                        }
-                    }
-                }
-                if (range->rangeStart() >= first && range->rangeStart() <= last) {
-                    if (matchLast == -1 || range->rangeEnd() >= matchLast) {
-                        if (range->rangeEnd() >= matchFirst) {
-                            ranges.replace(range->rangeStart(), range);
-                        }
-                    }
-                }
-            }
-        }
-    } else {
-        for (const auto &docIndex : d->indexes.value(doc).values()) {
-            auto comp = [](KoTextRange *r, int value) {
-                return r->rangeStart() <= value;
-            };
-
-            // First, singlePoints
-            auto it = std::lower_bound(docIndex.singlePoints.constBegin(), docIndex.singlePoints.constEnd(), first, comp);
-            for (; it != docIndex.singlePoints.constEnd(); ++it) {
-                if ((*it)->rangeStart() < first)
-                    continue;
-                if ((*it)->rangeStart() > last)
-                    break;
-                ranges.insert((*it)->rangeStart(), (*it));
-            }
-
-            // Second, non-overlapping
-            it = std::lower_bound(docIndex.nonOverlapping.constBegin(), docIndex.nonOverlapping.constEnd(), first, comp);
-            for (; it != docIndex.nonOverlapping.constEnd(); ++it) {
-                KoTextRange *range = *it;
-                if (range->rangeEnd() < first)
-                    continue;
-                if (range->rangeStart() > last)
-                    break;
-                // We have excluded what is completely out of scope.
-                // Now for the few remaining ranges…
-                if (range->rangeStart() >= first && range->rangeStart() <= last) {
-                    if (matchLast == -1 || range->rangeEnd() <= matchLast) {
-                        if (range->rangeEnd() >= matchFirst) {
-                            ranges.insert(range->rangeStart(), range);
-                        }
-                    }
-                }
-                if (range->rangeEnd() >= first && range->rangeEnd() <= last) {
-                    if (matchLast == -1 || range->rangeStart() <= matchLast) {
-                        if (range->rangeStart() >= matchFirst) {
-                            ranges.insert(range->rangeEnd(), range);
-                        }
-                    }
-                }
-                if (range->rangeStart() >= first && range->rangeStart() <= last) {
-                    if (matchLast == -1 || range->rangeEnd() >= matchLast) {
-                        if (range->rangeEnd() >= matchFirst) {
-                            ranges.replace(range->rangeStart(), range);
-                        }
-                    }
-                }
-            }
-
-            // Last, overlapppings
-            for (KoTextRange *range : docIndex.overlapping) {
-                if (range->rangeStart() < first)
-                    continue;
-                if (range->rangeStart() > last)
-                    break;
-
-                if (!range->hasRange()) {
-                    if (range->rangeStart() >= first && range->rangeStart() <= last) {
-                        ranges.insert(range->rangeStart(), range);
-                    }
-                } else {
-                    if (range->rangeStart() >= first && range->rangeStart() <= last) {
-                        if (matchLast == -1 || range->rangeEnd() <= matchLast) {
-                            if (range->rangeEnd() >= matchFirst) {
-                                ranges.insert(range->rangeStart(), range);
-                            }
-                        }
-                    }
-                    if (range->rangeEnd() >= first && range->rangeEnd() <= last) {
-                        if (matchLast == -1 || range->rangeStart() <= matchLast) {
-                            if (range->rangeStart() >= matchFirst) {
-                                ranges.insert(range->rangeEnd(), range);
-                            }
-                        }
-                    }
-                    if (range->rangeStart() >= first && range->rangeStart() <= last) {
-                        if (matchLast == -1 || range->rangeEnd() >= matchLast) {
-                            if (range->rangeEnd() >= matchFirst) {
-                                ranges.replace(range->rangeStart(), range);
-                            }
-                        }
-                    }
-                }
-            }
-        }
+    for (KoTextRangeManagerIndex &docIndex : *docIndexes) {
+        docIndex.overlapping(first, last, [&](KoTextRange *range) {
+            addIfChangingWithin(ranges, range, first, last, matchFirst, matchLast);
+        });
     }
 
     return ranges;
@@ -330,10 +337,12 @@ QMultiHash<int, KoTextRange *> KoTextRangeManager::textRangesChangingWithin(cons
                                                                             int matchLast) const
 {
     QMultiHash<int, KoTextRange *> ranges;
-    if (!d->m_textRanges.contains(doc))
+    auto docIndexes = d->indexes.find(doc);
+    if (docIndexes == d->indexes.end())
         return ranges;
 
-    for (const QMetaObject *type : d->indexes.value(doc).keys()) {
+    for (auto it = docIndexes->begin(); it != docIndexes->end(); ++it) {
+        const QMetaObject *type = it.key();
         bool found = false;
         for (const QMetaObject *requestedType : types) {
             if (type->inherits(requestedType)) {
@@ -343,91 +352,11 @@ QMultiHash<int, KoTextRange *> KoTextRangeManager::textRangesChangingWithin(cons
         }
         if (!found)
             continue;
-        const auto &docIndex = d->indexes.value(doc).value(type);
-
-        auto comp = [](KoTextRange *r, int value) {
-            return r->rangeStart() <= value;
-        };
-
-        // First, singlePoints
-        auto it = std::lower_bound(docIndex.singlePoints.constBegin(), docIndex.singlePoints.constEnd(), first, comp);
-        for (; it != docIndex.singlePoints.constEnd(); ++it) {
-            if ((*it)->rangeStart() < first)
-                continue;
-            if ((*it)->rangeStart() > last)
-                break;
-            ranges.insert((*it)->rangeStart(), (*it));
-        }
-
-        // Second, non-overlapping
-        it = std::lower_bound(docIndex.nonOverlapping.constBegin(), docIndex.nonOverlapping.constEnd(), first, comp);
-        for (; it != docIndex.nonOverlapping.constEnd(); ++it) {
-            KoTextRange *range = *it;
-            if (range->rangeEnd() < first)
-                continue;
-            if (range->rangeStart() > last)
-                break;
-            // We have excluded what is completely out of scope.
-            // Now for the few remaining ranges…
-            if (range->rangeStart() >= first && range->rangeStart() <= last) {
-                if (matchLast == -1 || range->rangeEnd() <= matchLast) {
-                    if (range->rangeEnd() >= matchFirst) {
-                        ranges.insert(range->rangeStart(), range);
-                    }
-                }
-            }
-            if (range->rangeEnd() >= first && range->rangeEnd() <= last) {
-                if (matchLast == -1 || range->rangeStart() <= matchLast) {
-                    if (range->rangeStart() >= matchFirst) {
-                        ranges.insert(range->rangeEnd(), range);
-                    }
-                }
-            }
-            if (range->rangeStart() >= first && range->rangeStart() <= last) {
-                if (matchLast == -1 || range->rangeEnd() >= matchLast) {
-                    if (range->rangeEnd() >= matchFirst) {
-                        ranges.replace(range->rangeStart(), range);
-                    }
-                }
-            }
-        }
 
-        // Last, overlapppings
-        for (KoTextRange *range : docIndex.overlapping) {
-            if (range->rangeStart() < first)
-                continue;
-            if (range->rangeStart() > last)
-                break;
-
-            if (!range->hasRange()) {
-                if (range->rangeStart() >= first && range->rangeStart() <= last) {
-                    ranges.insert(range->rangeStart(), range);
-                }
-            } else {
-                if (range->rangeStart() >= first && range->rangeStart() <= last) {
-                    if (matchLast == -1 || range->rangeEnd() <= matchLast) {
-                        if (range->rangeEnd() >= matchFirst) {
-                            ranges.insert(range->rangeStart(), range);
-                        }
-                    }
-                }
-                if (range->rangeEnd() >= first && range->rangeEnd() <= last) {
-                    if (matchLast == -1 || range->rangeStart() <= matchLast) {
-                        if (range->rangeStart() >= matchFirst) {
-                            ranges.insert(range->rangeEnd(), range);
-                        }
-                    }
-                }
-                if (range->rangeStart() >= first && range->rangeStart() <= last) {
-                    if (matchLast == -1 || range->rangeEnd() >= matchLast) {
-                        if (range->rangeEnd() >= matchFirst) {
-                            ranges.replace(range->rangeStart(), range);
-                        }
-                    }
-                }
-            }
-        }
+        it->overlapping(first, last, [&](KoTextRange *range) {
+            addIfChangingWithin(ranges, range, first, last, matchFirst, matchLast);
+        });
     }
 
     return ranges;
-}
\ No newline at end of file
+}
@@ -47,6 +47,12 @@ public:
      */
     void remove(KoTextRange *range);
 
+    /**
+     * Tell the manager that the start or end of @p range was moved directly.
+     * Moves due to editing the document are tracked without this.
+     */
+    void rangeChanged(KoTextRange *range);
+
     /**
      * Return the bookmark manager.
      */
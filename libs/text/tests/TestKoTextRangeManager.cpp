@@ -0,0 +1,141 @@
+/* This file is part of the KDE project
+ *
+ * SPDX-FileCopyrightText: 2026 Calligra developers
+ *
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ */
+#include "TestKoTextRangeManager.h"
+
+#include <QTest>
+#include <QTextCursor>
+#include <QTextDocument>
+
+#include <KoBookmark.h>
+#include <KoTextRangeManager.h>
+
+// the result textRangesChangingWithin() is expected to give, by looking at every range
+static QMultiHash<int, KoTextRange *> changingWithin(const KoTextRangeManager &manager, int first, int last)
+{
+    QMultiHash<int, KoTextRange *> ranges;
+    const QList<KoTextRange *> textRanges = manager.textRanges();
+    for (KoTextRange *range : textRanges) {
+        if (range->rangeStart() >= first && range->rangeStart() <= last) {
+            ranges.insert(range->rangeStart(), range);
+        }
+        if (range->hasRange() && range->rangeEnd() >= first && range->rangeEnd() <= last) {
+            ranges.insert(range->rangeEnd(), range);
+        }
+    }
+    return ranges;
+}
+
+static void compare(const QMultiHash<int, KoTextRange *> &actual, const QMultiHash<int, KoTextRange *> &expected)
+{
+    QCOMPARE(actual.size(), expected.size());
+    for (auto it = expected.constBegin(); it != expected.constEnd(); ++it) {
+        QVERIFY(actual.contains(it.key(), it.value()));
+    }
+}
+
+// fills the document with text and bookmarks of varying length, each starting at a distinct position
+static void createBookmarks(QTextDocument &doc, KoTextRangeManager &manager)
+{
+    QTextCursor cursor(&doc);
+    cursor.insertText(QString(2000, 'x'));
+    for (int i = 0; i < 200; ++i) {
+        const int start = i * 9;
+        cursor.setPosition(start);
+        if (i % 3 != 0) {
+            cursor.setPosition(qMin(start + (i * 37) % 300 + 1, 2000), QTextCursor::KeepAnchor);
+        }
+        KoBookmark *bookmark = new KoBookmark(cursor);
+        bookmark->setName(QString::number(i));
+        bookmark->setPositionOnlyMode(i % 3 == 0);
+        manager.insert(bookmark);
+    }
+}
+
+void TestKoTextRangeManager::testChangingWithin()
+{
+    QTextDocument doc;
+    KoTextRangeManager manager;
+    createBookmarks(doc, manager);
+
+    for (int first = 0; first < 2000; first += 97) {
+        const int last = first + 50;
+        compare(manager.textRangesChangingWithin(&doc, first, last, 0, -1), changingWithin(manager, first, last));
+    }
+    compare(manager.textRangesChangingWithin(&doc, {&KoBookmark::staticMetaObject}, 400, 500, 0, -1), changingWithin(manager, 400, 500));
+    QVERIFY(manager.textRangesChangingWithin(&doc, {&QObject::staticMetaObject}, 400, 500, 0, -1).size() > 0);
+}
+
+void TestKoTextRangeManager::testChangingWithinAfterEdit()
+{
+    QTextDocument doc;
+    KoTextRangeManager manager;
+    createBookmarks(doc, manager);
+    // build the index before editing
+    manager.textRangesChangingWithin(&doc, 0, 100, 0, -1);
+
+    QTextCursor cursor(&doc);
+    cursor.setPosition(500);
+    cursor.insertText(QString(100, 'y'));
+    cursor.setPosition(1000);
+    cursor.setPosition(1200, QTextCursor::KeepAnchor);
+    cursor.removeSelectedText();
+
+    for (int first = 0; first < 2000; first += 61) {
+        const int last = first + 80;
+        compare(manager.textRangesChangingWithin(&doc, first, last, 0, -1), changingWithin(manager, first, last));
+    }
+}
+
+void TestKoTextRangeManager::testRangeEndChanged()
+{
+    QTextDocument doc;
+    KoTextRangeManager manager;
+    createBookmarks(doc, manager);
+    manager.textRangesChangingWithin(&doc, 0, 100, 0, -1);
+
+    KoBookmark *bookmark = manager.bookmarkManager()->bookmark(QStringLiteral("1"));
+    QVERIFY(bookmark);
+    bookmark->setRangeEnd(1990);
+
+    compare(manager.textRangesChangingWithin(&doc, 1980, 2000, 0, -1), changingWithin(manager, 1980, 2000));
+    QVERIFY(manager.textRangesChangingWithin(&doc, 1980, 2000, 0, -1).contains(1990, bookmark));
+}
+
+void TestKoTextRangeManager::testInsertAtSharedStart()
+{
+    QTextDocument doc;
+    doc.documentLayout(); // the document only reports changes with a layout
+    KoTextRangeManager manager;
+    createBookmarks(doc, manager);
+
+    // a range and a position starting at the same place, in this order in the index
+    QTextCursor cursor(&doc);
+    cursor.setPosition(1000);
+    cursor.setPosition(1100, QTextCursor::KeepAnchor);
+    KoBookmark *range = new KoBookmark(cursor);
+    range->setName(QStringLiteral("range"));
+    manager.insert(range);
+    cursor.setPosition(1000);
+    KoBookmark *position = new KoBookmark(cursor);
+    position->setName(QStringLiteral("position"));
+    position->setPositionOnlyMode(true);
+    manager.insert(position);
+    QVERIFY(manager.textRangesChangingWithin(&doc, 1000, 1000, 0, -1).contains(1000, position));
+
+    // the start of the range is the anchor of its cursor, which moves on inserts
+    cursor.insertText(QStringLiteral("typed"));
+    QCOMPARE(position->rangeStart(), 1000);
+    QCOMPARE(range->rangeStart(), 1005);
+
+    QVERIFY(manager.textRangesChangingWithin(&doc, 1000, 1000, 0, -1).contains(1000, position));
+    for (int first = 900; first < 1200; first += 7) {
+        const int last = first + 10;
+        compare(manager.textRangesChangingWithin(&doc, first, last, 0, -1), changingWithin(manager, first, last));
+    }
+}
+
+QTEST_MAIN(TestKoTextRangeManager)
@@ -0,0 +1,25 @@
+/* This file is part of the KDE project
+ *
+ * SPDX-FileCopyrightText: 2026 Calligra developers
+ *
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ */
+
+#ifndef TEST_KO_TEXT_RANGE_MANAGER_H
+#define TEST_KO_TEXT_RANGE_MANAGER_H
+
+#include <QObject>
+
+class TestKoTextRangeManager : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+
+    void testChangingWithin();
+    void testChangingWithinAfterEdit();
+    void testRangeEndChanged();
+    void testInsertAtSharedStart();
+};
+
+#endif // TEST_KO_TEXT_RANGE_MANAGER_H
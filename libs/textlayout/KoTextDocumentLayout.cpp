@@ -36,14 +36,20 @@
 #include <KoTextRangeManager.h>
 #include <KoUnit.h>
 
+#include <QElapsedTimer>
 #include <QList>
 #include <QTextBlock>
 #include <QTextTable>
 #include <QTimer>
 #include <TextLayoutDebug.h>
 
+#include <algorithm>
+
 extern int qt_defaultDpiY();
 
+/// Time in milliseconds a background layout run may take before giving the event loop a chance
+static const int BackgroundLayoutSlice = 20;
+
 KoInlineObjectExtent::KoInlineObjectExtent(qreal ascent, qreal descent)
     : m_ascent(ascent)
     , m_descent(descent)
@@ -75,6 +81,8 @@ public:
         , continuousLayout(true)
         , layoutBlocked(false)
         , changesBlocked(false)
+        , backgroundLayout(false)
+        , synchronousLayoutLimit(3)
         , restartLayout(false)
         , wordprocessingMode(false)
         , showInlineObjectVisualization(false)
@@ -122,6 +130,8 @@ public:
     bool continuousLayout;
     bool layoutBlocked;
     bool changesBlocked;
+    bool backgroundLayout;
+    int synchronousLayoutLimit;
     bool restartLayout;
     bool wordprocessingMode;
     bool showInlineObjectVisualization;
@@ -300,13 +310,8 @@ void KoTextDocumentLayout::documentChanged(int position, int charsRemoved, int c
     // Mark the to the position corresponding root-areas as dirty. If there is no root-area for the position then we
     // don't need to mark anything dirty but still need to go on to force a scheduled relayout.
     if (!d->rootAreaList.isEmpty()) {
-        KoTextLayoutRootArea *fromArea;
-        if (position) {
-            fromArea = rootAreaForPosition(position - 1);
-        } else {
-            fromArea = d->rootAreaList.at(0);
-        }
-        int startIndex = fromArea ? qMax(0, d->rootAreaList.indexOf(fromArea)) : 0;
+        const int fromIndex = position ? rootAreaIndexForPosition(position - 1) : 0;
+        int startIndex = qMax(0, fromIndex);
         int endIndex = startIndex;
         if (charsRemoved != 0 || charsAdded != 0) {
             // If any characters got removed or added make sure to also catch other root-areas that may be
@@ -314,13 +319,9 @@ void KoTextDocumentLayout::documentChanged(int position, int charsRemoved, int c
             // and charsAdded>0 cause they are changing a range of characters. One case where both is zero is if
             // the content of a variable changed (see KoVariable::setValue which calls publicDocumentChanged). In
             // those cases we only need to relayout the root-area dirty where the variable is on.
-            KoTextLayoutRootArea *toArea = fromArea ? rootAreaForPosition(position + qMax(charsRemoved, charsAdded) + 1) : nullptr;
-            if (toArea) {
-                if (toArea != fromArea) {
-                    endIndex = qMax(startIndex, d->rootAreaList.indexOf(toArea));
-                } else {
-                    endIndex = startIndex;
-                }
+            const int toIndex = fromIndex >= 0 ? rootAreaIndexForPosition(position + qMax(charsRemoved, charsAdded) + 1) : -1;
+            if (toIndex >= 0) {
+                endIndex = qMax(startIndex, toIndex);
             } else {
                 endIndex = d->rootAreaList.count() - 1;
             }
@@ -345,28 +346,55 @@ void KoTextDocumentLayout::documentChanged(int position, int charsRemoved, int c
 }
 
 KoTextLayoutRootArea *KoTextDocumentLayout::rootAreaForPosition(int position) const
+{
+    const int index = rootAreaIndexForPosition(position);
+    return index >= 0 ? d->rootAreaList.at(index) : nullptr;
+}
+
+int KoTextDocumentLayout::rootAreaIndexForPosition(int position) const
 {
     QTextBlock block = document()->findBlock(position);
     if (!block.isValid())
-        return nullptr;
+        return -1;
     QTextLine line = block.layout()->lineForTextPosition(position - block.position());
     if (!line.isValid())
-        return nullptr;
+        return -1;
 
-    foreach (KoTextLayoutRootArea *rootArea, d->rootAreaList) {
-        QRectF rect = rootArea->boundingRect(); // should already be normalized()
+    QPointF pos = line.position();
+    qreal x = pos.x();
+    qreal y = pos.y();
+
+    auto contains = [&](const QRectF &rect) {
+        // 0.125 needed since Qt Scribe works with fixed point
+        return x + 0.125 >= rect.x() && x <= rect.right() && y + line.height() + 0.125 >= rect.y() && y <= rect.bottom();
+    };
+
+    // Once layouted, the root-areas are stacked below each other in document coordinates (see doLayout),
+    // so skip all which end before the line, rather than checking each of them.
+    const auto first = std::lower_bound(d->rootAreaList.constBegin(), d->rootAreaList.constEnd(), y, [](KoTextLayoutRootArea *rootArea, qreal y) {
+        return rootArea->boundingRect().bottom() < y;
+    });
+    for (auto it = first; it != d->rootAreaList.constEnd(); ++it) {
+        QRectF rect = (*it)->boundingRect(); // should already be normalized()
         if (rect.width() <= 0.0 && rect.height() <= 0.0) // ignore the rootArea if it has a size of QSizeF(0,0)
             continue;
-        QPointF pos = line.position();
-        qreal x = pos.x();
-        qreal y = pos.y();
+        if (rect.y() > y + line.height() + 0.125)
+            break;
+        if (contains(rect)) {
+            return it - d->rootAreaList.constBegin();
+        }
+    }
 
-        // 0.125 needed since Qt Scribe works with fixed point
-        if (x + 0.125 >= rect.x() && x <= rect.right() && y + line.height() + 0.125 >= rect.y() && y <= rect.bottom()) {
-            return rootArea;
+    // While a layout is still in progress not all root-areas are at their final place yet
+    for (int i = 0; i < d->rootAreaList.count(); ++i) {
+        QRectF rect = d->rootAreaList.at(i)->boundingRect();
+        if (rect.width() <= 0.0 && rect.height() <= 0.0)
+            continue;
+        if (contains(rect)) {
+            return i;
         }
     }
-    return nullptr;
+    return -1;
 }
 
 KoTextLayoutRootArea *KoTextDocumentLayout::rootAreaForPoint(const QPointF &point) const
@@ -750,8 +778,14 @@ bool KoTextDocumentLayout::doLayout()
     int footNoteAutoCount = 0;
     KoTextLayoutRootArea *rootArea = nullptr;
 
+    const QList<KoTextLayoutRootArea *> previousRootAreas = d->rootAreaList;
+    // Set to false once the provider hands out new root-areas, as it may have released previous ones
+    bool previousRootAreasValid = true;
     d->rootAreaList.clear();
 
+    QElapsedTimer sliceTimer;
+    sliceTimer.start();
+
     int currentAreaNumber = 0;
     do {
         if (d->restartLayout) {
@@ -770,6 +804,7 @@ bool KoTextDocumentLayout::doLayout()
         }
 
         d->rootAreaList.append(rootArea);
+        previousRootAreasValid = previousRootAreasValid && !newRootArea;
         bool shouldLayout = false;
 
         if (rootArea->top() != d->y) {
@@ -842,6 +877,12 @@ bool KoTextDocumentLayout::doLayout()
             if (!continuousLayout()) {
                 return false; // Let's take a break. We are not finished layouting yet.
             }
+
+            if (d->backgroundLayout && currentAreaNumber + 1 >= d->synchronousLayoutLimit && sliceTimer.elapsed() >= BackgroundLayoutSlice) {
+                // Let the event loop run and continue with the remaining root-areas later
+                scheduleLayout();
+                return false;
+            }
         } else {
             // Drop following rootAreas
             delete d->layoutPosition;
@@ -855,6 +896,18 @@ bool KoTextDocumentLayout::doLayout()
                 }
                 return true; // Finished layouting
             }
+
+            // This root-area starts where it did before and was not changed, so its height is unchanged
+            // as well. If none of the following ones are dirty then none of them would be layouted,
+            // and we can stop here instead of requesting and checking each of them.
+            if (previousRootAreasValid && canSkipRootAreasAfter(currentAreaNumber, previousRootAreas)) {
+                d->rootAreaList.append(previousRootAreas.mid(currentAreaNumber + 1));
+                KoTextLayoutRootArea *lastRootArea = d->rootAreaList.last();
+                delete d->layoutPosition;
+                d->layoutPosition = new FrameIterator(lastRootArea->nextStartOfArea());
+                d->y = lastRootArea->bottom() + qreal(50);
+                return true; // Finished layouting
+            }
         }
         transferedFootNoteCursor = rootArea->footNoteCursorToNext();
         transferedContinuedNote = rootArea->continuedNoteToNext();
@@ -868,6 +921,24 @@ bool KoTextDocumentLayout::doLayout()
     return true; // Finished layouting
 }
 
+bool KoTextDocumentLayout::canSkipRootAreasAfter(int index, const QList<KoTextLayoutRootArea *> &previousRootAreas) const
+{
+    if (index + 1 >= previousRootAreas.count() || previousRootAreas.at(index) != d->rootAreaList.at(index)) {
+        return false;
+    }
+    if (d->rootAreaList.at(index)->footNoteCursorToNext()) {
+        return false;
+    }
+    for (int i = index + 1; i < previousRootAreas.count(); ++i) {
+        if (previousRootAreas.at(i)->isDirty()) {
+            return false;
+        }
+    }
+    // The previous run must have been a complete one
+    KoTextLayoutRootArea *lastRootArea = previousRootAreas.last();
+    return lastRootArea->nextStartOfArea() && lastRootArea->nextStartOfArea()->it == document()->rootFrame()->end() && !lastRootArea->footNoteCursorToNext();
+}
+
 void KoTextDocumentLayout::scheduleLayout()
 {
     // Compress multiple scheduleLayout calls into one executeScheduledLayout.
@@ -914,6 +985,26 @@ bool KoTextDocumentLayout::layoutBlocked() const
     return d->layoutBlocked;
 }
 
+void KoTextDocumentLayout::setBackgroundLayout(bool background)
+{
+    d->backgroundLayout = background;
+}
+
+bool KoTextDocumentLayout::backgroundLayout() const
+{
+    return d->backgroundLayout;
+}
+
+void KoTextDocumentLayout::setSynchronousLayoutLimit(int rootAreaCount)
+{
+    d->synchronousLayoutLimit = rootAreaCount;
+}
+
+int KoTextDocumentLayout::synchronousLayoutLimit() const
+{
+    return d->synchronousLayoutLimit;
+}
+
 void KoTextDocumentLayout::setBlockChanges(bool block)
 {
     d->changesBlocked = block;
@@ -227,6 +227,20 @@ public:
     void setBlockLayout(bool block);
     bool layoutBlocked() const;
 
+    /**
+     * Set if root-areas after the \a synchronousLayoutLimit() should be layouted in the background.
+     *
+     * When enabled, \a layout() only layouts the first root-areas right away and returns after
+     * short time slices for the rest, continuing through \a scheduleLayout so events are
+     * processed in between. \a finishedLayout is only emitted once all of the text is positioned.
+     */
+    void setBackgroundLayout(bool background);
+    bool backgroundLayout() const;
+
+    /// Set the number of root-areas which are always layouted right away in background layout mode
+    void setSynchronousLayoutLimit(int rootAreaCount);
+    int synchronousLayoutLimit() const;
+
     /// Set \a documentChanged() to be blocked (changes will not result in root-areas being marked dirty)
     void setBlockChanges(bool block);
     bool changesBlocked() const;
@@ -308,6 +322,10 @@ private:
 
     bool doLayout();
     void updateProgress(const QTextFrame::iterator &it);
+    /// Same as \a rootAreaForPosition, but returns the index in \a rootAreas() or -1
+    int rootAreaIndexForPosition(int position) const;
+    /// Returns true if the root-areas after \p index of the previous layout run are still valid
+    bool canSkipRootAreasAfter(int index, const QList<KoTextLayoutRootArea *> &previousRootAreas) const;
 };
 
 #endif
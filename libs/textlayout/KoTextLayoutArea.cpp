@@ -43,6 +43,7 @@
 #include <TextLayoutDebug.h>
 
 #include <QFontMetrics>
+#include <QHashFunctions>
 #include <QRegularExpression>
 #include <QStyle>
 #include <QTextCursor>
@@ -53,6 +54,7 @@
 #include <QTextTable>
 
 #include <algorithm>
+#include <iterator>
 
 extern int qt_defaultDpiY();
 Q_DECLARE_METATYPE(QTextDocument *)
@@ -792,6 +794,32 @@ static bool compareTab(const QTextOption::Tab &tab1, const QTextOption::Tab &tab
     return tab1.position < tab2.position;
 }
 
+// Returns a key for everything the line-breaking of a whole paragraph depends on. If it is the same
+// as for the previous layout then the existing lines of the block can be reused as they are.
+static size_t lineBreakingKey(const QTextBlock &block, const QString &text, const QTextOption &option, QPaintDevice *paintDevice, const qreal (&geometry)[6])
+{
+    QTextLayout *layout = block.layout();
+    size_t key = qHashMulti(0,
+                            block.revision(),
+                            text,
+                            block.blockFormatIndex(),
+                            block.charFormatIndex(),
+                            block.document()->defaultFont(),
+                            quintptr(paintDevice),
+                            layout->preeditAreaPosition(),
+                            layout->preeditAreaText());
+    for (QTextBlock::iterator it = block.begin(); !it.atEnd(); ++it) {
+        const QTextFragment fragment = it.fragment();
+        key = qHashMulti(key, fragment.charFormatIndex(), fragment.length());
+    }
+    key = qHashMulti(key, int(option.alignment()), int(option.flags()), int(option.textDirection()), option.tabStopDistance());
+    foreach (const QTextOption::Tab &tab, option.tabs()) {
+        key = qHashMulti(key, tab.position, int(tab.type), tab.delimiter);
+    }
+    key = qHashRange(std::begin(geometry), std::end(geometry), key);
+    return key ? key : 1;
+}
+
 // layoutBlock() method is structured like this:
 //
 // 1) Setup various helper values
@@ -1218,11 +1246,32 @@ bool KoTextLayoutArea::layoutBlock(FrameIterator *cursor)
         d->stashRemainingLayout(block, d->copyEndOfArea->lineTextStart, stashedLines, stashedCounterPosition);
     }
 
+    // ==============
+    // Check if the lines of the previous layout can be reused
+    // ==============
+    // This is limited to paragraphs which are layouted in one go without anything special like
+    // run-around, inline objects, counters or drop caps, so only the vertical position changes.
+    const bool cacheable = cursor->lineTextStart == -1 && !lastOfPreviousRun && !textList && !pStyle.dropCaps() && d->dropCapsWidth == 0
+        && documentLayout()->currentObstructions().isEmpty();
+    const QString blockText = cacheable ? block.text() : QString();
+    size_t layoutKey = 0;
+    if (cacheable && !blockText.contains(QChar::ObjectReplacementCharacter)) {
+        const qreal firstLineIndent = block.blockFormat().boolProperty(KoParagraphStyle::UnnumberedListItem) ? 0 : d->indent;
+        const qreal geometry[6] = {d->x, d->width, firstLineIndent, d->right - d->left, d->maximumAllowedWidth, d->dropCapsDistance};
+        layoutKey = lineBreakingKey(block, blockText, option, d->documentLayout->paintDevice(), geometry);
+    }
+    bool reuseLines = layoutKey != 0 && layout->lineCount() > 0 && blockData.layoutKey() == layoutKey;
+    blockData.setLayoutKey(0);
+
     // ==============
     // Setup line and possibly restart paragraph continuing from previous other area
     // ==============
     QTextLine line;
-    if (cursor->lineTextStart == -1) {
+    int lineIndex = 0;
+    if (reuseLines) {
+        line = layout->lineAt(0);
+        cursor->fragmentIterator = block.begin();
+    } else if (cursor->lineTextStart == -1) {
         layout->beginLayout();
         line = layout->createLine();
         cursor->fragmentIterator = block.begin();
@@ -1323,7 +1372,20 @@ bool KoTextLayoutArea::layoutBlock(FrameIterator *cursor)
         anchoringRect.setTop(d->anchoringParagraphTop);
         documentLayout()->setAnchoringParagraphRect(anchoringRect);
         documentLayout()->setAnchoringLayoutEnvironmentRect(layoutEnvironmentRect());
-        runAroundHelper.fit(/* resetHorizontalPosition */ false, /* rightToLeft */ d->isRtl, QPointF(x(), d->y));
+        if (reuseLines) {
+            // Without obstructions fit() places the line exactly there
+            line.setPosition(QPointF(x(), d->y));
+            if (line.y() + line.height() > maximumAllowedBottom()
+                || documentLayout()->anchoringSoftBreak() <= block.position() + line.textStart() + line.textLength()) {
+                // The paragraph needs to be split, so redo the line-breaking from this line on
+                reuseLines = false;
+                line = d->restartLayout(block, line.textStart());
+                runAroundHelper.setLine(this, line);
+            }
+        }
+        if (!reuseLines) {
+            runAroundHelper.fit(/* resetHorizontalPosition */ false, /* rightToLeft */ d->isRtl, QPointF(x(), d->y));
+        }
 
         documentLayout()->positionAnchorTextRanges(block.position() + line.textStart(), line.textLength(), block.document());
         qreal bottomOfText = line.y() + line.height();
@@ -1441,7 +1503,11 @@ bool KoTextLayoutArea::layoutBlock(FrameIterator *cursor)
         documentLayout()->positionAnchoredObstructions();
 
         // line fitted so try and do the next one
-        line = layout->createLine();
+        if (reuseLines) {
+            line = ++lineIndex < layout->lineCount() ? layout->lineAt(lineIndex) : QTextLine();
+        } else {
+            line = layout->createLine();
+        }
         if (!line.isValid()) {
             break; // no more line means our job is done
         }
@@ -1456,7 +1522,12 @@ bool KoTextLayoutArea::layoutBlock(FrameIterator *cursor)
 
     d->bottomSpacing = pStyle.bottomMargin();
 
-    layout->endLayout();
+    if (!reuseLines) {
+        layout->endLayout();
+    }
+    if (documentLayout()->currentObstructions().isEmpty()) {
+        blockData.setLayoutKey(layoutKey);
+    }
     setVirginPage(false);
     cursor->lineTextStart = -1; // set lineTextStart to -1 and returning true indicate new block
     block.setLineCount(layout->lineCount());
@@ -85,6 +85,49 @@ void TestBlockLayout::testLineBreaking()
     QCOMPARE(blockLayout->lineForTextPosition(1).width(), 200.0);
 }
 
+void TestBlockLayout::testReuseUnchangedLines()
+{
+    setupTest(m_loremIpsum + '\n' + m_loremIpsum);
+    m_layout->layout();
+
+    QTextBlock second = m_block.next();
+    QVERIFY(second.isValid());
+    QVERIFY(KoTextBlockData(second).layoutKey() != 0);
+    QTextLayout *secondLayout = second.layout();
+    const int lineCount = secondLayout->lineCount();
+    QVERIFY(lineCount > 1);
+    QList<QPair<int, int>> ranges;
+    QList<QPointF> positions;
+    for (int i = 0; i < lineCount; ++i) {
+        ranges.append(qMakePair(secondLayout->lineAt(i).textStart(), secondLayout->lineAt(i).textLength()));
+        positions.append(secondLayout->lineAt(i).position());
+    }
+
+    // make the first paragraph longer, the second one only moves down
+    QTextCursor cursor(m_block);
+    cursor.insertText(m_loremIpsum);
+    m_layout->layout();
+
+    QCOMPARE(secondLayout->lineCount(), lineCount);
+    const qreal dy = secondLayout->lineAt(0).y() - positions.first().y();
+    QVERIFY(dy > 0);
+    for (int i = 0; i < lineCount; ++i) {
+        QTextLine line = secondLayout->lineAt(i);
+        QCOMPARE(line.textStart(), ranges[i].first);
+        QCOMPARE(line.textLength(), ranges[i].second);
+        QCOMPARE(line.x(), positions[i].x());
+        QVERIFY(qAbs(line.y() - positions[i].y() - dy) < ROUNDING);
+    }
+
+    // a narrower area needs new line-breaking
+    MockRootAreaProvider *provider = dynamic_cast<MockRootAreaProvider *>(m_layout->provider());
+    provider->setSuggestedRect(QRectF(100, 100, 100, 100000));
+    provider->area()->setDirty();
+    m_layout->layout();
+    QVERIFY(secondLayout->lineCount() > lineCount);
+    QVERIFY(secondLayout->lineAt(0).width() <= 100.0);
+}
+
 void TestBlockLayout::testBasicLineSpacing()
 {
     /// Tests incrementing Y pos based on the font size
@@ -39,6 +39,9 @@ private Q_SLOTS:
     /// Test breaking lines based on the width of the reference rect.
     void testLineBreaking();
 
+    /// Test that the lines of unchanged paragraphs are reused and only moved.
+    void testReuseUnchangedLines();
+
     /// Tests incrementing Y pos based on the font size
     void testBasicLineSpacing();
     /// Tests incrementing Y pos based on the font size
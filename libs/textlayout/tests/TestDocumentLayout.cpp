@@ -8,6 +8,7 @@
  */
 #include "TestDocumentLayout.h"
 #include "MockRootAreaProvider.h"
+#include <QSignalSpy>
 #include <QTest>
 
 #include <TextLayoutDebug.h>
@@ -183,4 +184,44 @@ void TestDocumentLayout::testRootAreaZeroWidthAndHeight()
     QCOMPARE(provider->area()->referenceRect(), QRectF(10., 10., 0., 0.));
 }
 
+void TestDocumentLayout::testBackgroundLayout()
+{
+    QString text;
+    for (int i = 0; i < 200; ++i) {
+        text += QStringLiteral("Lorem ipsum dolor sit amet, consectetur adipiscing elit, sed do eiusmod tempor incididunt.\n");
+    }
+
+    setupTest(text);
+    MockRootAreaProvider *provider = dynamic_cast<MockRootAreaProvider *>(m_layout->provider());
+    provider->setSuggestedRect(QRectF(10., 10., 200., 100.));
+    m_layout->layout();
+    const int rootAreaCount = m_layout->rootAreas().count();
+    QVERIFY(rootAreaCount > 1);
+
+    setupTest(text);
+    provider = dynamic_cast<MockRootAreaProvider *>(m_layout->provider());
+    provider->setSuggestedRect(QRectF(10., 10., 200., 100.));
+    m_layout->setBackgroundLayout(true);
+    m_layout->setSynchronousLayoutLimit(1);
+    QVERIFY(m_layout->backgroundLayout());
+    QCOMPARE(m_layout->synchronousLayoutLimit(), 1);
+
+    QSignalSpy finishedSpy(m_layout, &KoTextDocumentLayout::finishedLayout);
+    m_layout->layout();
+    QVERIFY(m_layout->rootAreas().count() >= 1);
+    QTRY_COMPARE(finishedSpy.count(), 1);
+    QCOMPARE(m_layout->rootAreas().count(), rootAreaCount);
+
+    // the root-areas are found in document order
+    int previousIndex = 0;
+    for (QTextBlock block = m_doc->begin(); block.isValid(); block = block.next()) {
+        KoTextLayoutRootArea *rootArea = m_layout->rootAreaForPosition(block.position());
+        QVERIFY(rootArea);
+        const int index = m_layout->rootAreas().indexOf(rootArea);
+        QVERIFY(index >= previousIndex);
+        previousIndex = index;
+    }
+    QCOMPARE(previousIndex, rootAreaCount - 1);
+}
+
 QTEST_MAIN(TestDocumentLayout)
@@ -45,6 +45,11 @@ private Q_SLOTS:
      */
     void testRootAreaZeroWidthAndHeight();
 
+    /**
+     * Test that a background layout ends up with the same root-areas as a synchronous one.
+     */
+    void testBackgroundLayout();
+
 private:
     void setupTest(const QString &initText = QString());
 
@@ -42,6 +42,8 @@ ArtisticTextShape::ArtisticTextShape()
     , m_drawBoundaryLines(false)
 {
     setShapeId(ArtisticTextShapeID);
+    // laying out and filling the glyph outlines is expensive, so keep a rendering
+    setRasterCacheEnabled(true);
     updateSizeAndPosition();
 }
 
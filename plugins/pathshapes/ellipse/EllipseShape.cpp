@@ -282,6 +282,7 @@ void EllipseShape::createPoints(int requiredPointCount)
             m_subpaths[0]->append(new KoPathPoint(this, QPointF()));
         }
     }
+    notifyPointsChanged();
 }
 
 void EllipseShape::updateKindHandle()
@@ -251,6 +251,7 @@ void RectangleShape::createPoints(int requiredPointCount)
             m_subpaths[0]->append(new KoPathPoint(this, QPointF()));
         }
     }
+    notifyPointsChanged();
 }
 
 qreal RectangleShape::cornerRadiusX() const
@@ -52,10 +52,10 @@ QString generate_key(qint64 key, const QSize &size)
 
 // ----------------------------------------------------------------- //
 
-_Private::PixmapScaler::PixmapScaler(PictureShape *pictureShape, const QSize &pixmapSize)
+_Private::PixmapScaler::PixmapScaler(PictureShape *pictureShape, const QImage &image, const QSize &pixmapSize)
     : m_size(pixmapSize)
+    , m_image(image)
 {
-    m_image = pictureShape->imageData()->image();
     m_imageKey = pictureShape->imageData()->key();
     connect(this, &PixmapScaler::finished, &pictureShape->m_proxy, &PictureShapeProxy::setImage);
 }
@@ -77,6 +77,11 @@ void _Private::PictureShapeProxy::setImage(const QString &key, const QImage &ima
     m_pictureShape->update();
 }
 
+void _Private::PictureShapeProxy::imageLoaded()
+{
+    m_pictureShape->update();
+}
+
 // ----------------------------------------------------------------- //
 
 QPainterPath _Private::generateOutline(const QImage &imageIn, int threshold)
@@ -261,7 +266,7 @@ void PictureShape::paint(QPainter &painter, const KoViewConverter &converter, Ko
     paintBorder(painter, converter);
     painter.restore();
 
-    QSize pixmapSize = calcOptimalPixmapSize(viewRect.size(), imageData()->image().size());
+    QSize pixmapSize = calcOptimalPixmapSize(viewRect.size(), imageData()->pixelSize());
 
     // Normalize the clipping rect if it isn't already done.
     m_clippingRect.normalize(imageData()->imageSize());
@@ -317,11 +322,15 @@ void PictureShape::paint(QPainter &painter, const KoViewConverter &converter, Ko
         QPixmap pixmap;
         QString key(generate_key(imageData()->key(), pixmapSize));
 
-        // If the required pixmap is not in the cache
-        // launch a task in a background thread that scales
-        // the source image to the required size
+        // If the required pixmap is not in the cache launch a task in a background
+        // thread that scales the source image to the required size. The source image
+        // itself is decoded in the background too if needed; only pictures that are
+        // painted request it, larger ones first.
         if (!QPixmapCache::find(key, &pixmap)) {
-            QThreadPool::globalInstance()->start(new _Private::PixmapScaler(this, pixmapSize));
+            QObject::connect(imageData(), &KoImageData::imageLoaded, &m_proxy, &_Private::PictureShapeProxy::imageLoaded, Qt::UniqueConnection);
+            const QImage image = imageData()->requestImage(pixmapSize, pixmapSize.width() / 32 * pixmapSize.height() / 32);
+            if (!image.isNull())
+                QThreadPool::globalInstance()->start(new _Private::PixmapScaler(this, image, pixmapSize));
             painter.fillRect(viewRect, QColor(Qt::gray)); // just paint a gray rect as long as we don't have the required pixmap
         } else {
             QRectF cropRect(pixmapSize.width() * m_clippingRect.left,
@@ -354,7 +363,7 @@ void PictureShape::waitUntilReady(const KoViewConverter &converter, bool asynchr
         }
         m_printQualityImage = image.scaled(pixels, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
     } else {
-        QSize pixmapSize = calcOptimalPixmapSize(converter.documentToView(QRectF(QPointF(0, 0), size())).size(), imageData->image().size());
+        QSize pixmapSize = calcOptimalPixmapSize(converter.documentToView(QRectF(QPointF(0, 0), size())).size(), imageData->pixelSize());
         QString key(generate_key(imageData->key(), pixmapSize));
         if (QPixmapCache::find(key, nullptr) == 0) {
             QPixmap pixmap = imageData->pixmap(pixmapSize);
@@ -711,7 +720,7 @@ void PictureShape::setGamma(qreal gamma)
 
 KoClipPath *PictureShape::generateClipPath()
 {
-    QPainterPath path = _Private::generateOutline(imageData()->image());
+    QPainterPath path = _Private::generateOutline(imageData()->image(QSize(100, 100)));
     path = path * QTransform().scale(size().width(), size().height());
 
     KoPathShape *pathShape = KoPathShape::createShapeFromPainterPath(path);
@@ -46,6 +46,8 @@ public:
 
 public Q_SLOTS:
     void setImage(const QString &key, const QImage &image);
+    /// repaint the shape once its image data got decoded
+    void imageLoaded();
 
 private:
     PictureShape *m_pictureShape;
@@ -60,7 +62,7 @@ class PixmapScaler : public QObject, public QRunnable
 {
     Q_OBJECT
 public:
-    PixmapScaler(PictureShape *pictureShape, const QSize &pixmapSize);
+    PixmapScaler(PictureShape *pictureShape, const QImage &image, const QSize &pixmapSize);
     void run() override;
 
 Q_SIGNALS:
@@ -5,6 +5,7 @@
  */
 
 #include "BlurEffect.h"
+#include "FilterEffectKernels.h"
 #include "KoFilterEffectLoadingContext.h"
 #include "KoFilterEffectRenderContext.h"
 #include "KoViewConverter.h"
@@ -13,244 +14,187 @@
 #include <KLocalizedString>
 #include <QColor>
 #include <QImage>
+#include <QVector>
+#include <QtMath>
 
-// Stack Blur Algorithm by Mario Klingemann <mario@quasimondo.com>
-// fixed to handle alpha channel correctly by Zack Rusin
-void fastbluralpha(QImage &img, int radius)
+#include <cmath>
+
+namespace
 {
-    if (radius < 1) {
-        return;
+#ifdef __SSE2__
+void boxBlurRowSse2(const quint32 *src, quint32 *dst, int width, int size, int offset)
+{
+    const __m128 scale = _mm_set1_ps(1.0f / size);
+    __m128i sum = _mm_setzero_si128();
+    for (int i = qMax(0, -offset); i < qMin(width, size - 1 - offset); ++i)
+        sum = _mm_add_epi32(sum, FilterEffectKernels::unpackPixel(src[i]));
+    for (int x = 0; x < width; ++x) {
+        const int in = x - offset + size - 1;
+        if (in >= 0 && in < width)
+            sum = _mm_add_epi32(sum, FilterEffectKernels::unpackPixel(src[in]));
+        dst[x] = FilterEffectKernels::packPixel(_mm_cvtps_epi32(_mm_mul_ps(_mm_cvtepi32_ps(sum), scale)));
+        const int out = x - offset;
+        if (out >= 0 && out < width)
+            sum = _mm_sub_epi32(sum, FilterEffectKernels::unpackPixel(src[out]));
     }
+}
 
-    QRgb *pix = (QRgb *)img.bits();
-    int w = img.width();
-    int h = img.height();
-    int wm = w - 1;
-    int hm = h - 1;
-    int wh = w * h;
-    int div = radius + radius + 1;
-
-    int *r = new int[wh];
-    int *g = new int[wh];
-    int *b = new int[wh];
-    int *a = new int[wh];
-    int rsum, gsum, bsum, asum, x, y, i, yp, yi, yw;
-    QRgb p;
-    int *vmin = new int[qMax(w, h)];
-
-    int divsum = (div + 1) >> 1;
-    divsum *= divsum;
-    int *dv = new int[256 * divsum];
-    for (i = 0; i < 256 * divsum; ++i) {
-        dv[i] = (i / divsum);
+void kernelBlurRowSse2(const quint32 *src, quint32 *dst, int width, const float *kernel, int radius)
+{
+    for (int x = 0; x < width; ++x) {
+        const int first = qMax(0, x - radius);
+        const int last = qMin(width - 1, x + radius);
+        __m128 sum = _mm_setzero_ps();
+        for (int i = first; i <= last; ++i) {
+            const __m128 channels = _mm_cvtepi32_ps(FilterEffectKernels::unpackPixel(src[i]));
+            sum = _mm_add_ps(sum, _mm_mul_ps(channels, _mm_set1_ps(kernel[i - x + radius])));
+        }
+        dst[x] = FilterEffectKernels::packPixel(_mm_cvtps_epi32(sum));
     }
+}
+#endif
 
-    yw = yi = 0;
+/// round like the SSE2 code does, to nearest with ties to even, and saturate
+inline quint32 toChannel(float value)
+{
+    return quint32(qBound(0L, std::lrintf(value), 255L));
+}
 
-    int **stack = new int *[div];
-    for (int i = 0; i < div; ++i) {
-        stack[i] = new int[4];
+/**
+ * Set @p dst[x] to the average of @p src[x - offset .. x - offset + size - 1], with
+ * transparent pixels outside of the row.
+ */
+void boxBlurRow(const quint32 *src, quint32 *dst, int width, int size, int offset)
+{
+#ifdef __SSE2__
+    if (FilterEffectKernels::simdEnabled()) {
+        boxBlurRowSse2(src, dst, width, size, offset);
+        return;
     }
-
-    int stackpointer;
-    int stackstart;
-    int *sir;
-    int rbs;
-    int r1 = radius + 1;
-    int routsum, goutsum, boutsum, aoutsum;
-    int rinsum, ginsum, binsum, ainsum;
-
-    for (y = 0; y < h; ++y) {
-        rinsum = ginsum = binsum = ainsum = routsum = goutsum = boutsum = aoutsum = rsum = gsum = bsum = asum = 0;
-        for (i = -radius; i <= radius; ++i) {
-            p = pix[yi + qMin(wm, qMax(i, 0))];
-            sir = stack[i + radius];
-            sir[0] = qRed(p);
-            sir[1] = qGreen(p);
-            sir[2] = qBlue(p);
-            sir[3] = qAlpha(p);
-
-            rbs = r1 - abs(i);
-            rsum += sir[0] * rbs;
-            gsum += sir[1] * rbs;
-            bsum += sir[2] * rbs;
-            asum += sir[3] * rbs;
-
-            if (i > 0) {
-                rinsum += sir[0];
-                ginsum += sir[1];
-                binsum += sir[2];
-                ainsum += sir[3];
-            } else {
-                routsum += sir[0];
-                goutsum += sir[1];
-                boutsum += sir[2];
-                aoutsum += sir[3];
-            }
+#endif
+    const float scale = 1.0f / size;
+    int sum[4] = {0, 0, 0, 0};
+    for (int i = qMax(0, -offset); i < qMin(width, size - 1 - offset); ++i) {
+        for (int c = 0; c < 4; ++c)
+            sum[c] += (src[i] >> (8 * c)) & 0xff;
+    }
+    for (int x = 0; x < width; ++x) {
+        const int in = x - offset + size - 1;
+        if (in >= 0 && in < width) {
+            for (int c = 0; c < 4; ++c)
+                sum[c] += (src[in] >> (8 * c)) & 0xff;
         }
-        stackpointer = radius;
-
-        for (x = 0; x < w; ++x) {
-            r[yi] = dv[rsum];
-            g[yi] = dv[gsum];
-            b[yi] = dv[bsum];
-            a[yi] = dv[asum];
-
-            rsum -= routsum;
-            gsum -= goutsum;
-            bsum -= boutsum;
-            asum -= aoutsum;
-
-            stackstart = stackpointer - radius + div;
-            sir = stack[stackstart % div];
-
-            routsum -= sir[0];
-            goutsum -= sir[1];
-            boutsum -= sir[2];
-            aoutsum -= sir[3];
-
-            if (y == 0) {
-                vmin[x] = qMin(x + radius + 1, wm);
-            }
-            p = pix[yw + vmin[x]];
-
-            sir[0] = qRed(p);
-            sir[1] = qGreen(p);
-            sir[2] = qBlue(p);
-            sir[3] = qAlpha(p);
-
-            rinsum += sir[0];
-            ginsum += sir[1];
-            binsum += sir[2];
-            ainsum += sir[3];
-
-            rsum += rinsum;
-            gsum += ginsum;
-            bsum += binsum;
-            asum += ainsum;
-
-            stackpointer = (stackpointer + 1) % div;
-            sir = stack[(stackpointer) % div];
-
-            routsum += sir[0];
-            goutsum += sir[1];
-            boutsum += sir[2];
-            aoutsum += sir[3];
-
-            rinsum -= sir[0];
-            ginsum -= sir[1];
-            binsum -= sir[2];
-            ainsum -= sir[3];
-
-            ++yi;
+        quint32 pixel = 0;
+        for (int c = 0; c < 4; ++c)
+            pixel |= toChannel(float(sum[c]) * scale) << (8 * c);
+        dst[x] = pixel;
+        const int out = x - offset;
+        if (out >= 0 && out < width) {
+            for (int c = 0; c < 4; ++c)
+                sum[c] -= (src[out] >> (8 * c)) & 0xff;
         }
-        yw += w;
     }
-    for (x = 0; x < w; ++x) {
-        rinsum = ginsum = binsum = ainsum = routsum = goutsum = boutsum = aoutsum = rsum = gsum = bsum = asum = 0;
-
-        yp = -radius * w;
-
-        for (i = -radius; i <= radius; ++i) {
-            yi = qMax(0, yp) + x;
-
-            sir = stack[i + radius];
+}
 
-            sir[0] = r[yi];
-            sir[1] = g[yi];
-            sir[2] = b[yi];
-            sir[3] = a[yi];
+/// Convolve @p src with the symmetric @p kernel of the given @p radius into @p dst
+void kernelBlurRow(const quint32 *src, quint32 *dst, int width, const float *kernel, int radius)
+{
+#ifdef __SSE2__
+    if (FilterEffectKernels::simdEnabled()) {
+        kernelBlurRowSse2(src, dst, width, kernel, radius);
+        return;
+    }
+#endif
+    for (int x = 0; x < width; ++x) {
+        const int first = qMax(0, x - radius);
+        const int last = qMin(width - 1, x + radius);
+        float sum[4] = {0, 0, 0, 0};
+        for (int i = first; i <= last; ++i) {
+            for (int c = 0; c < 4; ++c)
+                sum[c] += float((src[i] >> (8 * c)) & 0xff) * kernel[i - x + radius];
+        }
+        quint32 pixel = 0;
+        for (int c = 0; c < 4; ++c)
+            pixel |= toChannel(sum[c]) << (8 * c);
+        dst[x] = pixel;
+    }
+}
 
-            rbs = r1 - abs(i);
+/**
+ * Blur the rows of @p image with a gaussian of the standard @p deviation in pixels.
+ *
+ * As suggested by the SVG specification, large deviations are approximated with three
+ * successive box blurs, which cost the same for any deviation.
+ */
+void blurRows(QImage &image, qreal deviation)
+{
+    if (deviation <= 0.0)
+        return;
 
-            rsum += r[yi] * rbs;
-            gsum += g[yi] * rbs;
-            bsum += b[yi] * rbs;
-            asum += a[yi] * rbs;
+    const int width = image.width();
+    const qsizetype stride = image.bytesPerLine();
+    uchar *bits = image.bits(); // detach before going parallel
+
+    QVector<float> kernel;
+    int radius = 0;
+    int boxSize = 0;
+    if (deviation < 2.0) {
+        radius = qCeil(3.0 * deviation);
+        kernel.resize(2 * radius + 1);
+        float sum = 0.0f;
+        for (int i = -radius; i <= radius; ++i) {
+            kernel[i + radius] = std::exp(-i * i / (2.0 * deviation * deviation));
+            sum += kernel[i + radius];
+        }
+        for (float &weight : kernel)
+            weight /= sum;
+    } else {
+        boxSize = qFloor(deviation * 3.0 * std::sqrt(2.0 * M_PI) / 4.0 + 0.5);
+    }
 
-            if (i > 0) {
-                rinsum += sir[0];
-                ginsum += sir[1];
-                binsum += sir[2];
-                ainsum += sir[3];
+    FilterEffectKernels::forEachBand(image.height(), [&](int begin, int end) {
+        QVector<quint32> line(width);
+        for (int y = begin; y < end; ++y) {
+            quint32 *row = reinterpret_cast<quint32 *>(bits + y * stride);
+            if (!kernel.isEmpty()) {
+                kernelBlurRow(row, line.data(), width, kernel.constData(), radius);
+                std::copy(line.constBegin(), line.constEnd(), row);
+            } else if (boxSize % 2) {
+                boxBlurRow(row, line.data(), width, boxSize, boxSize / 2);
+                boxBlurRow(line.constData(), row, width, boxSize, boxSize / 2);
+                boxBlurRow(row, line.data(), width, boxSize, boxSize / 2);
+                std::copy(line.constBegin(), line.constEnd(), row);
             } else {
-                routsum += sir[0];
-                goutsum += sir[1];
-                boutsum += sir[2];
-                aoutsum += sir[3];
-            }
-
-            if (i < hm) {
-                yp += w;
+                // two boxes centered left and right of the pixel, then one of size + 1 centered on it
+                boxBlurRow(row, line.data(), width, boxSize, boxSize / 2);
+                boxBlurRow(line.constData(), row, width, boxSize, boxSize / 2 - 1);
+                boxBlurRow(row, line.data(), width, boxSize + 1, boxSize / 2);
+                std::copy(line.constBegin(), line.constEnd(), row);
             }
         }
+    });
+}
 
-        yi = x;
-        stackpointer = radius;
-
-        for (y = 0; y < h; ++y) {
-            pix[yi] = qRgba(dv[rsum], dv[gsum], dv[bsum], dv[asum]);
-
-            rsum -= routsum;
-            gsum -= goutsum;
-            bsum -= boutsum;
-            asum -= aoutsum;
-
-            stackstart = stackpointer - radius + div;
-            sir = stack[stackstart % div];
-
-            routsum -= sir[0];
-            goutsum -= sir[1];
-            boutsum -= sir[2];
-            aoutsum -= sir[3];
-
-            if (x == 0) {
-                vmin[y] = qMin(y + r1, hm) * w;
-            }
-            p = x + vmin[y];
-
-            sir[0] = r[p];
-            sir[1] = g[p];
-            sir[2] = b[p];
-            sir[3] = a[p];
-
-            rinsum += sir[0];
-            ginsum += sir[1];
-            binsum += sir[2];
-            ainsum += sir[3];
-
-            rsum += rinsum;
-            gsum += ginsum;
-            bsum += binsum;
-            asum += ainsum;
-
-            stackpointer = (stackpointer + 1) % div;
-            sir = stack[stackpointer];
-
-            routsum += sir[0];
-            goutsum += sir[1];
-            boutsum += sir[2];
-            aoutsum += sir[3];
-
-            rinsum -= sir[0];
-            ginsum -= sir[1];
-            binsum -= sir[2];
-            ainsum -= sir[3];
-
-            yi += w;
+/// return @p image with rows and columns swapped
+QImage transposed(const QImage &image)
+{
+    QImage result(image.height(), image.width(), image.format());
+    const uchar *srcBits = image.constBits();
+    const qsizetype srcStride = image.bytesPerLine();
+    uchar *dstBits = result.bits();
+    const qsizetype dstStride = result.bytesPerLine();
+    const int height = image.height();
+
+    FilterEffectKernels::forEachBand(result.height(), [&](int begin, int end) {
+        // the source rows are read sequentially, the band of destination rows stays in the cache
+        for (int x = 0; x < height; ++x) {
+            const quint32 *src = reinterpret_cast<const quint32 *>(srcBits + x * srcStride);
+            for (int y = begin; y < end; ++y)
+                reinterpret_cast<quint32 *>(dstBits + y * dstStride)[x] = src[y];
         }
-    }
-    delete[] r;
-    delete[] g;
-    delete[] b;
-    delete[] a;
-    delete[] vmin;
-    delete[] dv;
-
-    for (int i = 0; i < div; ++i) {
-        delete[] stack[i];
-    }
-    delete[] stack;
+    });
+    return result;
+}
 }
 
 BlurEffect::BlurEffect()
@@ -276,16 +220,17 @@ QImage BlurEffect::processImage(const QImage &image, const KoFilterEffectRenderC
         return image;
 
     // TODO: take filter region into account
-    // TODO: blur with different kernels in x and y
     // convert from bounding box coordinates
     QPointF dev = context.toUserSpace(m_deviation);
     // transform to view coordinates
     dev = context.viewConverter()->documentToView(dev);
 
-    QImage result = image;
-    fastbluralpha(result, dev.x());
-
-    return result;
+    QImage result = image.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+    // the gaussian is separable, the columns are blurred as rows of the transposed image
+    blurRows(result, dev.x());
+    result = transposed(result);
+    blurRows(result, dev.y());
+    return transposed(result);
 }
 
 bool BlurEffect::load(const KoXmlElement &element, const KoFilterEffectLoadingContext &context)
@@ -5,7 +5,7 @@
  */
 
 #include "ColorMatrixEffect.h"
-#include "ColorChannelConversion.h"
+#include "FilterEffectKernels.h"
 #include <KLocalizedString>
 #include <KoFilterEffectRenderContext.h>
 #include <KoXmlReader.h>
@@ -15,6 +15,7 @@
 #include <QRect>
 #include <QRegularExpression>
 
+#include <algorithm>
 #include <cmath>
 
 const int MatrixSize = 20;
@@ -152,41 +153,67 @@ QImage ColorMatrixEffect::processImage(const QImage &image, const KoFilterEffect
     int w = result.width();
 
     const qreal *m = m_matrix.data();
-    qreal sa, sr, sg, sb;
-    qreal da, dr, dg, db;
 
     QRect roi = context.filterRegion().toRect();
-    for (int row = roi.top(); row < roi.bottom(); ++row) {
-        for (int col = roi.left(); col < roi.right(); ++col) {
-            const QRgb &s = src[row * w + col];
-            sa = fromIntColor[qAlpha(s)];
-            sr = fromIntColor[qRed(s)];
-            sg = fromIntColor[qGreen(s)];
-            sb = fromIntColor[qBlue(s)];
-            // the matrix is applied to non-premultiplied color values
-            // so we have to convert colors by dividing by alpha value
-            if (sa > 0.0 && sa < 1.0) {
-                sr /= sa;
-                sb /= sa;
-                sg /= sa;
+    // the scalar code computes in single precision as well, so both give the same results
+    float matrix[MatrixSize];
+    std::copy(m, m + MatrixSize, matrix);
+#ifdef __SSE2__
+    const bool simd = FilterEffectKernels::simdEnabled();
+    // the columns of the matrix, in the channel order of the pixels
+    const __m128 red = _mm_set_ps(matrix[15], matrix[0], matrix[5], matrix[10]);
+    const __m128 green = _mm_set_ps(matrix[16], matrix[1], matrix[6], matrix[11]);
+    const __m128 blue = _mm_set_ps(matrix[17], matrix[2], matrix[7], matrix[12]);
+    const __m128 alpha = _mm_set_ps(matrix[18], matrix[3], matrix[8], matrix[13]);
+    const __m128 offset = _mm_set_ps(matrix[19], matrix[4], matrix[9], matrix[14]);
+    const __m128 colorMask = _mm_castsi128_ps(_mm_set_epi32(0, -1, -1, -1));
+#endif
+    FilterEffectKernels::forEachBand(qMax(0, roi.bottom() - roi.top()), [&](int begin, int end) {
+        for (int row = roi.top() + begin; row < roi.top() + end; ++row) {
+            for (int col = roi.left(); col < roi.right(); ++col) {
+                const QRgb &s = src[row * w + col];
+                // the matrix is applied to non-premultiplied color values
+                // so we have to convert colors by dividing by alpha value
+                const int a = qAlpha(s);
+                const float unpremultiply = a > 0 && a < 255 ? 1.0f / a : 1.0f / 255.0f;
+#ifdef __SSE2__
+                if (simd) {
+                    const __m128 c = _mm_mul_ps(_mm_cvtepi32_ps(FilterEffectKernels::unpackPixel(s)),
+                                                _mm_set_ps(1.0f / 255.0f, unpremultiply, unpremultiply, unpremultiply));
+
+                    // apply matrix to color values
+                    __m128 d = _mm_add_ps(offset, _mm_mul_ps(red, _mm_shuffle_ps(c, c, _MM_SHUFFLE(2, 2, 2, 2))));
+                    d = _mm_add_ps(d, _mm_mul_ps(green, _mm_shuffle_ps(c, c, _MM_SHUFFLE(1, 1, 1, 1))));
+                    d = _mm_add_ps(d, _mm_mul_ps(blue, _mm_shuffle_ps(c, c, _MM_SHUFFLE(0, 0, 0, 0))));
+                    d = _mm_add_ps(d, _mm_mul_ps(alpha, _mm_shuffle_ps(c, c, _MM_SHUFFLE(3, 3, 3, 3))));
+
+                    // the new alpha value, and the pre-multiplied color values
+                    const __m128 da = _mm_mul_ps(_mm_shuffle_ps(d, d, _MM_SHUFFLE(3, 3, 3, 3)), _mm_set1_ps(255.0f));
+                    d = _mm_or_ps(_mm_and_ps(colorMask, _mm_mul_ps(d, da)), _mm_andnot_ps(colorMask, da));
+                    dst[row * w + col] = FilterEffectKernels::packPixel(_mm_cvttps_epi32(_mm_max_ps(d, _mm_setzero_ps())));
+                    continue;
+                }
+#endif
+                const float sa = a * (1.0f / 255.0f);
+                const float sr = qRed(s) * unpremultiply;
+                const float sg = qGreen(s) * unpremultiply;
+                const float sb = qBlue(s) * unpremultiply;
+
+                // apply matrix to color values
+                const float dr = (((matrix[4] + matrix[0] * sr) + matrix[1] * sg) + matrix[2] * sb) + matrix[3] * sa;
+                const float dg = (((matrix[9] + matrix[5] * sr) + matrix[6] * sg) + matrix[7] * sb) + matrix[8] * sa;
+                const float db = (((matrix[14] + matrix[10] * sr) + matrix[11] * sg) + matrix[12] * sb) + matrix[13] * sa;
+                // the new alpha value
+                const float da = ((((matrix[19] + matrix[15] * sr) + matrix[16] * sg) + matrix[17] * sb) + matrix[18] * sa) * 255.0f;
+
+                // set pre-multiplied color values on destination image
+                dst[row * w + col] = qRgba(static_cast<quint8>(qBound(0.0f, dr * da, 255.0f)),
+                                           static_cast<quint8>(qBound(0.0f, dg * da, 255.0f)),
+                                           static_cast<quint8>(qBound(0.0f, db * da, 255.0f)),
+                                           static_cast<quint8>(qBound(0.0f, da, 255.0f)));
             }
-
-            // apply matrix to color values
-            dr = m[0] * sr + m[1] * sg + m[2] * sb + m[3] * sa + m[4];
-            dg = m[5] * sr + m[6] * sg + m[7] * sb + m[8] * sa + m[9];
-            db = m[10] * sr + m[11] * sg + m[12] * sb + m[13] * sa + m[14];
-            da = m[15] * sr + m[16] * sg + m[17] * sb + m[18] * sa + m[19];
-
-            // the new alpha value
-            da *= 255.0;
-
-            // set pre-multiplied color values on destination image
-            dst[row * w + col] = qRgba(static_cast<quint8>(qBound(qreal(0.0), dr * da, qreal(255.0))),
-                                       static_cast<quint8>(qBound(qreal(0.0), dg * da, qreal(255.0))),
-                                       static_cast<quint8>(qBound(qreal(0.0), db * da, qreal(255.0))),
-                                       static_cast<quint8>(qBound(qreal(0.0), da, qreal(255.0))));
         }
-    }
+    });
 
     return result;
 }
@@ -5,6 +5,7 @@
  */
 
 #include "ConvolveMatrixEffect.h"
+#include "FilterEffectKernels.h"
 #include "KoFilterEffectLoadingContext.h"
 #include "KoFilterEffectRenderContext.h"
 #include "KoViewConverter.h"
@@ -148,8 +149,16 @@ QImage ConvolveMatrixEffect::processImage(const QImage &image, const KoFilterEff
             divisor = 1.0;
     }
 
-    int dstPixel, srcPixel;
-    qreal sumA, sumR, sumG, sumB;
+    // the scalar code computes in single precision as well, so both give the same results
+    QVector<float> kernel(maskSize);
+    for (int i = 0; i < maskSize; ++i)
+        kernel[i] = m_kernel.value(i);
+    const float scale = 1.0f / divisor;
+    const float bias = m_bias;
+#ifdef __SSE2__
+    const bool simd = FilterEffectKernels::simdEnabled();
+#endif
+
     const QRgb *src = (const QRgb *)image.constBits();
     QRgb *dst = (QRgb *)result.bits();
 
@@ -159,66 +168,80 @@ QImage ConvolveMatrixEffect::processImage(const QImage &image, const KoFilterEff
     const int minY = roi.top();
     const int maxY = roi.bottom();
 
-    int srcRow, srcCol;
-    for (int row = minY; row <= maxY; ++row) {
-        for (int col = minX; col <= maxX; ++col) {
-            dstPixel = row * w + col;
-            sumA = sumR = sumG = sumB = 0;
-            for (int i = 0; i < maskSize; ++i) {
-                srcRow = row + offset[i].y();
-                srcCol = col + offset[i].x();
-                // handle top and bottom edge
-                if (srcRow < 0 || srcRow >= h) {
-                    switch (m_edgeMode) {
-                    case Duplicate:
-                        srcRow = srcRow >= h ? h - 1 : 0;
-                        break;
-                    case Wrap:
-                        srcRow = (srcRow + h) % h;
-                        break;
-                    case None:
-                        // zero for all color channels
-                        continue;
-                        break;
+    FilterEffectKernels::forEachBand(qMax(0, maxY - minY + 1), [&](int begin, int end) {
+        int dstPixel, srcPixel;
+        int srcRow, srcCol;
+        for (int row = minY + begin; row < minY + end; ++row) {
+            for (int col = minX; col <= maxX; ++col) {
+                dstPixel = row * w + col;
+#ifdef __SSE2__
+                __m128 sum4 = _mm_setzero_ps();
+#endif
+                // in the order of the channels in memory, blue first
+                float sum[4] = {0, 0, 0, 0};
+                for (int i = 0; i < maskSize; ++i) {
+                    srcRow = row + offset.at(i).y();
+                    srcCol = col + offset.at(i).x();
+                    // handle top and bottom edge
+                    if (srcRow < 0 || srcRow >= h) {
+                        switch (m_edgeMode) {
+                        case Duplicate:
+                            srcRow = srcRow >= h ? h - 1 : 0;
+                            break;
+                        case Wrap:
+                            srcRow = (srcRow + h) % h;
+                            break;
+                        case None:
+                            // zero for all color channels
+                            continue;
+                            break;
+                        }
                     }
-                }
-                // handle left and right edge
-                if (srcCol < 0 || srcCol >= w) {
-                    switch (m_edgeMode) {
-                    case Duplicate:
-                        srcCol = srcCol >= w ? w - 1 : 0;
-                        break;
-                    case Wrap:
-                        srcCol = (srcCol + w) % w;
-                        break;
-                    case None:
-                        // zero for all color channels
+                    // handle left and right edge
+                    if (srcCol < 0 || srcCol >= w) {
+                        switch (m_edgeMode) {
+                        case Duplicate:
+                            srcCol = srcCol >= w ? w - 1 : 0;
+                            break;
+                        case Wrap:
+                            srcCol = (srcCol + w) % w;
+                            break;
+                        case None:
+                            // zero for all color channels
+                            continue;
+                            break;
+                        }
+                    }
+                    srcPixel = srcRow * w + srcCol;
+                    const QRgb &s = src[srcPixel];
+#ifdef __SSE2__
+                    if (simd) {
+                        // all four channels at once, the alpha sum is dropped below if not needed
+                        sum4 = _mm_add_ps(sum4, _mm_mul_ps(_mm_cvtepi32_ps(FilterEffectKernels::unpackPixel(s)), _mm_set1_ps(kernel.at(i))));
                         continue;
-                        break;
                     }
+#endif
+                    for (int c = 0; c < 4; ++c)
+                        sum[c] += float((s >> (8 * c)) & 0xff) * kernel.at(i);
                 }
-                srcPixel = srcRow * w + srcCol;
-                const QRgb &s = src[srcPixel];
-                const qreal &k = m_kernel[i];
-                if (!m_preserveAlpha)
-                    sumA += qAlpha(s) * k;
-                sumR += qRed(s) * k;
-                sumG += qGreen(s) * k;
-                sumB += qBlue(s) * k;
-            }
-            if (m_preserveAlpha) {
-                dst[dstPixel] = qRgba(qBound(0, static_cast<int>(sumR / divisor + m_bias), 255),
-                                      qBound(0, static_cast<int>(sumG / divisor + m_bias), 255),
-                                      qBound(0, static_cast<int>(sumB / divisor + m_bias), 255),
-                                      qAlpha(dst[dstPixel]));
-            } else {
-                dst[dstPixel] = qRgba(qBound(0, static_cast<int>(sumR / divisor + m_bias), 255),
-                                      qBound(0, static_cast<int>(sumG / divisor + m_bias), 255),
-                                      qBound(0, static_cast<int>(sumB / divisor + m_bias), 255),
-                                      qBound(0, static_cast<int>(sumA / divisor + m_bias), 255));
+                QRgb pixel = 0;
+#ifdef __SSE2__
+                if (simd) {
+                    const __m128 value = _mm_add_ps(_mm_mul_ps(sum4, _mm_set1_ps(scale)), _mm_set1_ps(bias));
+                    pixel = FilterEffectKernels::packPixel(_mm_cvttps_epi32(value));
+                } else
+#endif
+                {
+                    for (int c = 0; c < 4; ++c)
+                        pixel |= quint32(qBound(0, static_cast<int>(sum[c] * scale + bias), 255)) << (8 * c);
+                }
+                if (m_preserveAlpha)
+                    dst[dstPixel] = (pixel & RGB_MASK) | (dst[dstPixel] & ~RGB_MASK);
+                else
+                    dst[dstPixel] = pixel;
             }
         }
-    }
+    });
 
     return result;
 }
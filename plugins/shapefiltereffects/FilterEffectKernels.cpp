@@ -0,0 +1,60 @@
+/* This file is part of the KDE project
+ * SPDX-FileCopyrightText: 2026 Calligra developers
+ *
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#include "FilterEffectKernels.h"
+
+#include <QSemaphore>
+#include <QThread>
+#include <QThreadPool>
+
+#include <atomic>
+
+Q_GLOBAL_STATIC(QThreadPool, s_bandPool)
+
+#ifdef __SSE2__
+static std::atomic<bool> s_simdEnabled(true);
+#else
+static std::atomic<bool> s_simdEnabled(false);
+#endif
+
+/// the minimum number of rows worth a thread of their own
+#define MIN_BAND_SIZE 16
+
+void FilterEffectKernels::forEachBand(int count, const std::function<void(int begin, int end)> &function)
+{
+    const int bandCount = qBound(1, count / MIN_BAND_SIZE, QThread::idealThreadCount());
+    if (bandCount == 1) {
+        function(0, count);
+        return;
+    }
+
+    QSemaphore done;
+    for (int band = 1; band < bandCount; ++band) {
+        const int begin = count * band / bandCount;
+        const int end = count * (band + 1) / bandCount;
+        s_bandPool->start([&function, &done, begin, end]() {
+            function(begin, end);
+            done.release();
+        });
+    }
+    // the calling thread takes the first band instead of waiting idle
+    function(0, count / bandCount);
+    done.acquire(bandCount - 1);
+}
+
+bool FilterEffectKernels::simdEnabled()
+{
+    return s_simdEnabled.load(std::memory_order_relaxed);
+}
+
+void FilterEffectKernels::setSimdEnabled(bool enabled)
+{
+#ifdef __SSE2__
+    s_simdEnabled.store(enabled, std::memory_order_relaxed);
+#else
+    Q_UNUSED(enabled);
+#endif
+}
@@ -0,0 +1,59 @@
+/* This file is part of the KDE project
+ * SPDX-FileCopyrightText: 2026 Calligra developers
+ *
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#ifndef FILTEREFFECTKERNELS_H
+#define FILTEREFFECTKERNELS_H
+
+#include <QtGlobal>
+
+#include <functional>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+/**
+ * Helpers for the pixel loops of the filter effects.
+ *
+ * The effects work on premultiplied ARGB32 images, split into bands of rows that are
+ * processed in parallel. The per pixel math uses SSE2 where available, with the four
+ * channels of a pixel in the lanes of a vector (in memory order, i.e. blue first).
+ */
+namespace FilterEffectKernels
+{
+/**
+ * Call @p function for consecutive bands [begin, end) of [0, @p count) on a thread pool
+ * and wait until all of them are done. Small counts are handled in the calling thread.
+ */
+void forEachBand(int count, const std::function<void(int begin, int end)> &function);
+
+/// Return true if the SSE2 code is used, never without SSE2
+bool simdEnabled();
+
+/**
+ * Use the scalar code instead of the SSE2 code if @p enabled is false, so that
+ * tests can compare their results. Both give the same results.
+ */
+void setSimdEnabled(bool enabled);
+
+#ifdef __SSE2__
+/// unpack the channels of @p pixel into the 32 bit lanes of a vector
+inline __m128i unpackPixel(quint32 pixel)
+{
+    const __m128i zero = _mm_setzero_si128();
+    return _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(pixel), zero), zero);
+}
+
+/// pack the 32 bit lanes of @p channels into a pixel, saturated to [0, 255]
+inline quint32 packPixel(__m128i channels)
+{
+    const __m128i words = _mm_packs_epi32(channels, channels);
+    return _mm_cvtsi128_si32(_mm_packus_epi16(words, words));
+}
+#endif
+}
+
+#endif // FILTEREFFECTKERNELS_H
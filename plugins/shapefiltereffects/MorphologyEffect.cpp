@@ -5,6 +5,7 @@
  */
 
 #include "MorphologyEffect.h"
+#include "FilterEffectKernels.h"
 #include "KoFilterEffectLoadingContext.h"
 #include "KoFilterEffectRenderContext.h"
 #include "KoViewConverter.h"
@@ -13,8 +14,38 @@
 #include <KLocalizedString>
 #include <QImage>
 #include <QRect>
+#include <QVector>
+
+#include <algorithm>
 #include <cmath>
 
+namespace
+{
+/// set the channels of @p dst to the minimum (@p erode) or the maximum of them and those of @p src
+void combinePixels(quint32 *dst, const quint32 *src, int count, bool erode)
+{
+    int i = 0;
+#ifdef __SSE2__
+    if (FilterEffectKernels::simdEnabled()) {
+        for (; i + 4 <= count; i += 4) {
+            const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(dst + i));
+            const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), erode ? _mm_min_epu8(a, b) : _mm_max_epu8(a, b));
+        }
+    }
+#endif
+    for (; i < count; ++i) {
+        quint32 pixel = 0;
+        for (int shift = 0; shift < 32; shift += 8) {
+            const quint32 a = (dst[i] >> shift) & 0xff;
+            const quint32 b = (src[i] >> shift) & 0xff;
+            pixel |= (erode ? qMin(a, b) : qMax(a, b)) << shift;
+        }
+        dst[i] = pixel;
+    }
+}
+}
+
 MorphologyEffect::MorphologyEffect()
     : KoFilterEffect(MorphologyEffectId, i18n("Morphology"))
     , m_radius(0, 0)
@@ -54,59 +85,42 @@ QImage MorphologyEffect::processImage(const QImage &image, const KoFilterEffectR
     const int w = result.width();
     const int h = result.height();
 
-    // setup mask
-    const int maskSize = (1 + 2 * rx) * (1 + 2 * ry);
-    int *mask = new int[maskSize];
-    int index = 0;
-    for (int y = -ry; y <= ry; ++y) {
-        for (int x = -rx; x <= rx; ++x) {
-            mask[index] = y * w + x;
-            index++;
-        }
-    }
-
-    int dstPixel, srcPixel;
-    uchar s0, s1, s2, s3;
-    const uchar *src = image.constBits();
-    uchar *dst = result.bits();
-
     const QRect roi = context.filterRegion().toRect();
     const int minX = qMax(rx, roi.left());
     const int maxX = qMin(w - rx, roi.right());
     const int minY = qMax(ry, roi.top());
     const int maxY = qMin(h - ry, roi.bottom());
-    const int defValue = m_operator == Erode ? 255 : 0;
-
-    uchar *d = nullptr;
-
-    for (int row = minY; row < maxY; ++row) {
-        for (int col = minX; col < maxX; ++col) {
-            dstPixel = row * w + col;
-            s0 = s1 = s2 = s3 = defValue;
-            for (int i = 0; i < maskSize; ++i) {
-                srcPixel = dstPixel + mask[i];
-                const uchar *s = &src[4 * srcPixel];
-                if (m_operator == Erode) {
-                    s0 = qMin(s0, s[0]);
-                    s1 = qMin(s1, s[1]);
-                    s2 = qMin(s2, s[2]);
-                    s3 = qMin(s3, s[3]);
-                } else {
-                    s0 = qMax(s0, s[0]);
-                    s1 = qMax(s1, s[1]);
-                    s2 = qMax(s2, s[2]);
-                    s3 = qMax(s3, s[3]);
-                }
-            }
-            d = &dst[4 * dstPixel];
-            d[0] = s0;
-            d[1] = s1;
-            d[2] = s2;
-            d[3] = s3;
+    if (minX >= maxX || minY >= maxY)
+        return result;
+
+    const int count = maxX - minX;
+    const bool erode = m_operator == Erode;
+    const quint32 *src = reinterpret_cast<const quint32 *>(image.constBits());
+    quint32 *dst = reinterpret_cast<quint32 *>(result.bits());
+
+    // the neighborhood is a rectangle, so the rows of it are combined first
+    // and then the combined rows of the columns of it
+    const int rowCount = maxY - minY + 2 * ry;
+    QVector<quint32> rows(rowCount * count);
+    quint32 *rowData = rows.data();
+    FilterEffectKernels::forEachBand(rowCount, [&](int begin, int end) {
+        for (int row = begin; row < end; ++row) {
+            quint32 *d = rowData + row * count;
+            const quint32 *s = src + (minY - ry + row) * w + minX;
+            std::copy(s - rx, s - rx + count, d);
+            for (int x = -rx + 1; x <= rx; ++x)
+                combinePixels(d, s + x, count, erode);
         }
-    }
-
-    delete[] mask;
+    });
+    FilterEffectKernels::forEachBand(maxY - minY, [&](int begin, int end) {
+        for (int row = begin; row < end; ++row) {
+            quint32 *d = dst + (minY + row) * w + minX;
+            const quint32 *s = rowData + row * count;
+            std::copy(s, s + count, d);
+            for (int y = 1; y <= 2 * ry; ++y)
+                combinePixels(d, s + y * count, count, erode);
+        }
+    });
 
     return result;
 }
@@ -0,0 +1,148 @@
+/* This file is part of the KDE project
+ * SPDX-FileCopyrightText: 2026 Calligra developers
+ *
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#include "FilterEffectsBenchmark.h"
+
+#include "BlurEffect.h"
+#include "ColorMatrixEffect.h"
+#include "ConvolveMatrixEffect.h"
+#include "MorphologyEffect.h"
+
+#include <KoFilterEffectRenderContext.h>
+#include <KoViewConverter.h>
+
+#include <QImage>
+#include <QPainter>
+#include <QRadialGradient>
+#include <QTest>
+
+namespace
+{
+/// a shape like image with transparent surroundings, as painted by the shape manager
+QImage createImage(int size)
+{
+    QImage image(size, size, QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::transparent);
+    QPainter painter(&image);
+    painter.setRenderHint(QPainter::Antialiasing);
+    QRadialGradient gradient(size / 2, size / 2, size / 3);
+    gradient.setColorAt(0, QColor(255, 128, 0, 200));
+    gradient.setColorAt(1, QColor(0, 64, 255, 255));
+    painter.setBrush(gradient);
+    painter.setPen(QPen(Qt::black, 3));
+    painter.drawEllipse(QRectF(size / 8, size / 8, size * 3 / 4, size * 3 / 4));
+    return image;
+}
+
+void addSizes()
+{
+    QTest::addColumn<int>("size");
+    QTest::newRow("256") << 256;
+    QTest::newRow("1024") << 1024;
+    QTest::newRow("2048") << 2048;
+}
+}
+
+void FilterEffectsBenchmark::benchmarkBlur_data()
+{
+    QTest::addColumn<int>("size");
+    QTest::addColumn<QPointF>("deviation");
+    for (int size : {256, 1024, 2048}) {
+        QTest::addRow("%d small", size) << size << QPointF(1.5, 1.5);
+        QTest::addRow("%d large", size) << size << QPointF(12, 12);
+        QTest::addRow("%d x only", size) << size << QPointF(12, 0.5);
+    }
+}
+
+void FilterEffectsBenchmark::benchmarkBlur()
+{
+    QFETCH(int, size);
+    QFETCH(QPointF, deviation);
+
+    const QImage image = createImage(size);
+    KoViewConverter converter;
+    KoFilterEffectRenderContext context(converter);
+    // deviations in pixels
+    context.setShapeBoundingBox(QRectF(0, 0, 1, 1));
+    context.setFilterRegion(image.rect());
+
+    BlurEffect effect;
+    effect.setDeviation(deviation);
+    QBENCHMARK {
+        effect.processImage(image, context);
+    }
+}
+
+void FilterEffectsBenchmark::benchmarkMorphology_data()
+{
+    addSizes();
+}
+
+void FilterEffectsBenchmark::benchmarkMorphology()
+{
+    QFETCH(int, size);
+
+    const QImage image = createImage(size);
+    KoViewConverter converter;
+    KoFilterEffectRenderContext context(converter);
+    context.setShapeBoundingBox(QRectF(0, 0, 1, 1));
+    context.setFilterRegion(image.rect());
+
+    MorphologyEffect effect;
+    effect.setMorphologyRadius(QPointF(3, 3));
+    effect.setMorphologyOperator(MorphologyEffect::Dilate);
+    QBENCHMARK {
+        effect.processImage(image, context);
+    }
+}
+
+void FilterEffectsBenchmark::benchmarkConvolveMatrix_data()
+{
+    addSizes();
+}
+
+void FilterEffectsBenchmark::benchmarkConvolveMatrix()
+{
+    QFETCH(int, size);
+
+    const QImage image = createImage(size);
+    KoViewConverter converter;
+    KoFilterEffectRenderContext context(converter);
+    context.setShapeBoundingBox(QRectF(0, 0, 1, 1));
+    context.setFilterRegion(image.rect());
+
+    // sharpen
+    ConvolveMatrixEffect effect;
+    effect.setOrder(QPoint(3, 3));
+    effect.setKernel(QVector<qreal>{0, -1, 0, -1, 5, -1, 0, -1, 0});
+    QBENCHMARK {
+        effect.processImage(image, context);
+    }
+}
+
+void FilterEffectsBenchmark::benchmarkColorMatrix_data()
+{
+    addSizes();
+}
+
+void FilterEffectsBenchmark::benchmarkColorMatrix()
+{
+    QFETCH(int, size);
+
+    const QImage image = createImage(size);
+    KoViewConverter converter;
+    KoFilterEffectRenderContext context(converter);
+    context.setShapeBoundingBox(QRectF(0, 0, 1, 1));
+    context.setFilterRegion(image.rect());
+
+    ColorMatrixEffect effect;
+    effect.setSaturate(0.3);
+    QBENCHMARK {
+        effect.processImage(image, context);
+    }
+}
+
+QTEST_MAIN(FilterEffectsBenchmark)
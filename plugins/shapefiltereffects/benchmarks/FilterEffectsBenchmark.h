@@ -0,0 +1,26 @@
+/* This file is part of the KDE project
+ * SPDX-FileCopyrightText: 2026 Calligra developers
+ *
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#ifndef FILTEREFFECTSBENCHMARK_H
+#define FILTEREFFECTSBENCHMARK_H
+
+#include <QObject>
+
+class FilterEffectsBenchmark : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void benchmarkBlur_data();
+    void benchmarkBlur();
+    void benchmarkMorphology_data();
+    void benchmarkMorphology();
+    void benchmarkConvolveMatrix_data();
+    void benchmarkConvolveMatrix();
+    void benchmarkColorMatrix_data();
+    void benchmarkColorMatrix();
+};
+
+#endif
@@ -0,0 +1,498 @@
+/* This file is part of the KDE project
+ * SPDX-FileCopyrightText: 2026 Calligra developers
+ *
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#include "TestFilterEffects.h"
+
+#include "BlurEffect.h"
+#include "ColorMatrixEffect.h"
+#include "ConvolveMatrixEffect.h"
+#include "FilterEffectKernels.h"
+#include "MorphologyEffect.h"
+
+#include <KoFilterEffectRenderContext.h>
+#include <KoViewConverter.h>
+
+#include <QImage>
+#include <QRandomGenerator>
+#include <QTest>
+#include <QtMath>
+
+#include <cmath>
+
+namespace
+{
+/// the widths of the test images, odd so that the SSE2 loops have a scalar tail
+const int Widths[] = {1, 3, 7, 17, 33};
+const int Height = 37;
+
+/// a premultiplied image of random pixels, a quarter of them transparent
+QImage randomImage(int width, int height)
+{
+    QRandomGenerator random(quint32(width * 1000 + height));
+    QImage image(width, height, QImage::Format_ARGB32_Premultiplied);
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            const int alpha = random.bounded(4) ? random.bounded(256) : 0;
+            image.setPixel(x, y, qRgba(random.bounded(alpha + 1), random.bounded(alpha + 1), random.bounded(alpha + 1), alpha));
+        }
+    }
+    return image;
+}
+
+/// the largest difference of a channel of the pixels of @p image and @p other
+int maxDifference(const QImage &image, const QImage &other)
+{
+    if (image.size() != other.size() || image.format() != other.format())
+        return 256;
+    int difference = 0;
+    for (int y = 0; y < image.height(); ++y) {
+        for (int x = 0; x < image.width(); ++x) {
+            const QRgb a = image.pixel(x, y);
+            const QRgb b = other.pixel(x, y);
+            for (int shift = 0; shift < 32; shift += 8)
+                difference = qMax(difference, qAbs(int((a >> shift) & 0xff) - int((b >> shift) & 0xff)));
+        }
+    }
+    return difference;
+}
+
+/// process @p image with the scalar code instead of the SSE2 code
+QImage processScalar(const KoFilterEffect &effect, const QImage &image, const KoFilterEffectRenderContext &context)
+{
+    FilterEffectKernels::setSimdEnabled(false);
+    const QImage result = effect.processImage(image, context);
+    FilterEffectKernels::setSimdEnabled(true);
+    return result;
+}
+
+/**
+ * Blur the @p values as described by the SVG specification, with a gaussian kernel for
+ * small deviations and with three box blurs for large ones. The box averages are rounded
+ * the same way as by the effect, so that they are expected to be equal.
+ */
+QVector<int> referenceBlur(const QVector<int> &values, qreal deviation)
+{
+    const int count = values.size();
+    if (deviation < 2.0) {
+        const int radius = qCeil(3.0 * deviation);
+        QVector<double> kernel(2 * radius + 1);
+        double sum = 0.0;
+        for (int i = -radius; i <= radius; ++i) {
+            kernel[i + radius] = std::exp(-i * i / (2.0 * deviation * deviation));
+            sum += kernel[i + radius];
+        }
+        QVector<int> result(count);
+        for (int x = 0; x < count; ++x) {
+            double value = 0.0;
+            for (int i = qMax(0, x - radius); i <= qMin(count - 1, x + radius); ++i)
+                value += values[i] * kernel[i - x + radius] / sum;
+            result[x] = qBound(0, qRound(value), 255);
+        }
+        return result;
+    }
+
+    const auto box = [count](const QVector<int> &in, int size, int offset) {
+        QVector<int> out(count);
+        for (int x = 0; x < count; ++x) {
+            int sum = 0;
+            for (int i = qMax(0, x - offset); i < qMin(count, x - offset + size); ++i)
+                sum += in[i];
+            out[x] = qBound(0, int(std::lrintf(float(sum) * (1.0f / size))), 255);
+        }
+        return out;
+    };
+    const int size = qFloor(deviation * 3.0 * std::sqrt(2.0 * M_PI) / 4.0 + 0.5);
+    if (size % 2)
+        return box(box(box(values, size, size / 2), size, size / 2), size, size / 2);
+    return box(box(box(values, size, size / 2), size, size / 2 - 1), size + 1, size / 2);
+}
+
+/// blur the rows of @p image with the x and then the columns with the y @p deviation
+QImage referenceBlur(const QImage &image, const QPointF &deviation)
+{
+    const int width = image.width();
+    const int height = image.height();
+    QImage result(image.size(), QImage::Format_ARGB32_Premultiplied);
+    result.fill(0);
+    for (int shift = 0; shift < 32; shift += 8) {
+        QVector<QVector<int>> rows(height, QVector<int>(width));
+        for (int y = 0; y < height; ++y) {
+            for (int x = 0; x < width; ++x)
+                rows[y][x] = (image.pixel(x, y) >> shift) & 0xff;
+            rows[y] = referenceBlur(rows[y], deviation.x());
+        }
+        for (int x = 0; x < width; ++x) {
+            QVector<int> column(height);
+            for (int y = 0; y < height; ++y)
+                column[y] = rows[y][x];
+            column = referenceBlur(column, deviation.y());
+            for (int y = 0; y < height; ++y)
+                result.setPixel(x, y, result.pixel(x, y) | (quint32(column[y]) << shift));
+        }
+    }
+    return result;
+}
+
+/**
+ * Erode or dilate @p image with a neighborhood of @p rx by @p ry pixels around each pixel.
+ * Like the effect, only pixels with their neighborhood inside of the image are changed,
+ * and neither those of the last row and column.
+ */
+QImage referenceMorphology(const QImage &image, int rx, int ry, bool erode)
+{
+    QImage result = image;
+    for (int y = ry; y < qMin(image.height() - ry, image.height() - 1); ++y) {
+        for (int x = rx; x < qMin(image.width() - rx, image.width() - 1); ++x) {
+            quint32 pixel = 0;
+            for (int shift = 0; shift < 32; shift += 8) {
+                int value = erode ? 255 : 0;
+                for (int j = -ry; j <= ry; ++j) {
+                    for (int i = -rx; i <= rx; ++i) {
+                        const int channel = (image.pixel(x + i, y + j) >> shift) & 0xff;
+                        value = erode ? qMin(value, channel) : qMax(value, channel);
+                    }
+                }
+                pixel |= quint32(value) << shift;
+            }
+            result.setPixel(x, y, pixel);
+        }
+    }
+    return result;
+}
+
+/// the index of @p position into @p count values with the given @p edgeMode, or -1 for none
+int edgeIndex(int position, int count, ConvolveMatrixEffect::EdgeMode edgeMode)
+{
+    if (position >= 0 && position < count)
+        return position;
+    switch (edgeMode) {
+    case ConvolveMatrixEffect::Duplicate:
+        return qBound(0, position, count - 1);
+    case ConvolveMatrixEffect::Wrap:
+        return ((position % count) + count) % count;
+    case ConvolveMatrixEffect::None:
+        break;
+    }
+    return -1;
+}
+
+/// convolve @p image with the matrix of @p effect in double precision
+QImage referenceConvolveMatrix(const QImage &image, const ConvolveMatrixEffect &effect)
+{
+    const QPoint order = effect.order();
+    const QVector<qreal> kernel = effect.kernel();
+    const QPoint target = effect.target();
+    const int tx = target.x() >= 0 ? target.x() : order.x() / 2;
+    const int ty = target.y() >= 0 ? target.y() : order.y() / 2;
+    qreal divisor = effect.divisor();
+    if (divisor == 0.0) {
+        for (qreal k : kernel)
+            divisor += k;
+        if (divisor == 0.0)
+            divisor = 1.0;
+    }
+
+    QImage result = image;
+    for (int y = 0; y < image.height(); ++y) {
+        for (int x = 0; x < image.width(); ++x) {
+            quint32 pixel = 0;
+            for (int shift = 0; shift < 32; shift += 8) {
+                double sum = 0.0;
+                for (int j = 0; j < order.y(); ++j) {
+                    const int row = edgeIndex(y + j - ty, image.height(), effect.edgeMode());
+                    for (int i = 0; i < order.x(); ++i) {
+                        const int column = edgeIndex(x + i - tx, image.width(), effect.edgeMode());
+                        if (row >= 0 && column >= 0)
+                            sum += ((image.pixel(column, row) >> shift) & 0xff) * kernel[j * order.x() + i];
+                    }
+                }
+                pixel |= quint32(qBound(0.0, sum / divisor + effect.bias(), 255.0)) << shift;
+            }
+            if (effect.isPreserveAlphaEnabled())
+                pixel = (pixel & RGB_MASK) | (image.pixel(x, y) & ~RGB_MASK);
+            result.setPixel(x, y, pixel);
+        }
+    }
+    return result;
+}
+
+/**
+ * Apply @p matrix to the unpremultiplied colors of @p image in double precision. Like
+ * the effect, the pixels of the last row and column are not changed.
+ */
+QImage referenceColorMatrix(const QImage &image, const QVector<qreal> &matrix)
+{
+    QImage result = image;
+    for (int y = 0; y < image.height() - 1; ++y) {
+        for (int x = 0; x < image.width() - 1; ++x) {
+            const QRgb s = image.pixel(x, y);
+            const int a = qAlpha(s);
+            const double source[4] = {a > 0 ? double(qRed(s)) / a : 0.0, a > 0 ? double(qGreen(s)) / a : 0.0, a > 0 ? double(qBlue(s)) / a : 0.0, a / 255.0};
+            double destination[4];
+            for (int row = 0; row < 4; ++row) {
+                destination[row] = matrix[5 * row + 4];
+                for (int column = 0; column < 4; ++column)
+                    destination[row] += matrix[5 * row + column] * source[column];
+            }
+            const double alpha = destination[3] * 255.0;
+            result.setPixel(x,
+                            y,
+                            qRgba(int(qBound(0.0, destination[0] * alpha, 255.0)),
+                                  int(qBound(0.0, destination[1] * alpha, 255.0)),
+                                  int(qBound(0.0, destination[2] * alpha, 255.0)),
+                                  int(qBound(0.0, alpha, 255.0))));
+        }
+    }
+    return result;
+}
+}
+
+void TestFilterEffects::testBlur_data()
+{
+    QTest::addColumn<int>("width");
+    QTest::addColumn<QPointF>("deviation");
+    for (int width : Widths) {
+        QTest::addRow("%d gaussian", width) << width << QPointF(0.8, 0.8);
+        QTest::addRow("%d gaussian x y", width) << width << QPointF(1.9, 1.2);
+        // box sizes 6 and 9
+        QTest::addRow("%d even box", width) << width << QPointF(3, 3);
+        QTest::addRow("%d odd box", width) << width << QPointF(5, 5);
+        QTest::addRow("%d box x gaussian y", width) << width << QPointF(4, 0.7);
+    }
+}
+
+void TestFilterEffects::testBlur()
+{
+    QFETCH(int, width);
+    QFETCH(QPointF, deviation);
+
+    const QImage image = randomImage(width, Height);
+    KoViewConverter converter;
+    KoFilterEffectRenderContext context(converter);
+    // deviations in pixels
+    context.setShapeBoundingBox(QRectF(0, 0, 1, 1));
+    context.setFilterRegion(image.rect());
+
+    BlurEffect effect;
+    effect.setDeviation(deviation);
+    const QImage result = effect.processImage(image, context);
+    QCOMPARE(maxDifference(result, processScalar(effect, image, context)), 0);
+    // each gaussian pass may round differently than the one in double precision
+    const int tolerance = (deviation.x() < 2.0 ? 1 : 0) + (deviation.y() < 2.0 ? 1 : 0);
+    QVERIFY(maxDifference(result, referenceBlur(image, deviation)) <= tolerance);
+}
+
+void TestFilterEffects::testBlurZeroDeviation()
+{
+    const QImage image = randomImage(17, Height);
+    KoViewConverter converter;
+    KoFilterEffectRenderContext context(converter);
+    context.setShapeBoundingBox(QRectF(0, 0, 1, 1));
+    context.setFilterRegion(image.rect());
+
+    BlurEffect effect;
+    effect.setDeviation(QPointF(3, 0));
+    QCOMPARE(maxDifference(effect.processImage(image, context), image), 0);
+}
+
+void TestFilterEffects::testMorphology_data()
+{
+    QTest::addColumn<int>("width");
+    QTest::addColumn<QPointF>("radius");
+    QTest::addColumn<bool>("erode");
+    for (int width : Widths) {
+        QTest::addRow("%d erode", width) << width << QPointF(1, 1) << true;
+        QTest::addRow("%d dilate", width) << width << QPointF(1, 1) << false;
+        QTest::addRow("%d erode x", width) << width << QPointF(2.5, 0) << true;
+        QTest::addRow("%d dilate y", width) << width << QPointF(0, 3) << false;
+    }
+}
+
+void TestFilterEffects::testMorphology()
+{
+    QFETCH(int, width);
+    QFETCH(QPointF, radius);
+    QFETCH(bool, erode);
+
+    const QImage image = randomImage(width, Height);
+    KoViewConverter converter;
+    KoFilterEffectRenderContext context(converter);
+    // radii in pixels
+    context.setShapeBoundingBox(QRectF(0, 0, 1, 1));
+    context.setFilterRegion(image.rect());
+
+    MorphologyEffect effect;
+    effect.setMorphologyRadius(radius);
+    effect.setMorphologyOperator(erode ? MorphologyEffect::Erode : MorphologyEffect::Dilate);
+    const QImage result = effect.processImage(image, context);
+    QCOMPARE(maxDifference(result, processScalar(effect, image, context)), 0);
+    QCOMPARE(maxDifference(result, referenceMorphology(image, qCeil(radius.x()), qCeil(radius.y()), erode)), 0);
+}
+
+void TestFilterEffects::testMorphologyDilatePoint()
+{
+    QImage image(9, 9, QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::transparent);
+    image.setPixel(4, 4, qRgba(255, 255, 255, 255));
+    KoViewConverter converter;
+    KoFilterEffectRenderContext context(converter);
+    context.setShapeBoundingBox(QRectF(0, 0, 1, 1));
+    context.setFilterRegion(image.rect());
+
+    MorphologyEffect effect;
+    effect.setMorphologyRadius(QPointF(1, 2));
+    effect.setMorphologyOperator(MorphologyEffect::Dilate);
+    const QImage result = effect.processImage(image, context);
+
+    QImage expected(9, 9, QImage::Format_ARGB32_Premultiplied);
+    expected.fill(Qt::transparent);
+    for (int y = 2; y <= 6; ++y) {
+        for (int x = 3; x <= 5; ++x)
+            expected.setPixel(x, y, qRgba(255, 255, 255, 255));
+    }
+    QCOMPARE(maxDifference(result, expected), 0);
+}
+
+void TestFilterEffects::testConvolveMatrix_data()
+{
+    QTest::addColumn<int>("width");
+    QTest::addColumn<QPoint>("order");
+    QTest::addColumn<QVector<qreal>>("kernel");
+    QTest::addColumn<qreal>("divisor");
+    QTest::addColumn<qreal>("bias");
+    QTest::addColumn<QPoint>("target");
+    QTest::addColumn<int>("edgeMode");
+    QTest::addColumn<bool>("preserveAlpha");
+
+    const QVector<qreal> box(9, 1.0);
+    const QVector<qreal> edges = {-1, -1, -1, -1, 8, -1, -1, -1, -1};
+    const QVector<qreal> sharpen = {0, -1, 0, -1, 5, -1, 0, -1, 0};
+    QVector<qreal> ramp(15);
+    for (int i = 0; i < ramp.size(); ++i)
+        ramp[i] = i + 1;
+    for (int width : Widths) {
+        QTest::addRow("%d box", width) << width << QPoint(3, 3) << box << 0.0 << 0.0 << QPoint(-1, -1) << int(ConvolveMatrixEffect::Duplicate)
+                                       << false;
+        QTest::addRow("%d edges", width) << width << QPoint(3, 3) << edges << 0.0 << 0.0 << QPoint(-1, -1) << int(ConvolveMatrixEffect::Wrap)
+                                         << false;
+        QTest::addRow("%d sharpen", width) << width << QPoint(3, 3) << sharpen << 1.0 << 10.0 << QPoint(-1, -1)
+                                           << int(ConvolveMatrixEffect::Duplicate) << true;
+        QTest::addRow("%d ramp", width) << width << QPoint(5, 3) << ramp << 0.0 << 0.0 << QPoint(1, 2) << int(ConvolveMatrixEffect::None) << false;
+    }
+}
+
+void TestFilterEffects::testConvolveMatrix()
+{
+    QFETCH(int, width);
+    QFETCH(QPoint, order);
+    QFETCH(QVector<qreal>, kernel);
+    QFETCH(qreal, divisor);
+    QFETCH(qreal, bias);
+    QFETCH(QPoint, target);
+    QFETCH(int, edgeMode);
+    QFETCH(bool, preserveAlpha);
+
+    const QImage image = randomImage(width, Height);
+    KoViewConverter converter;
+    KoFilterEffectRenderContext context(converter);
+    context.setShapeBoundingBox(QRectF(0, 0, 1, 1));
+    context.setFilterRegion(image.rect());
+
+    ConvolveMatrixEffect effect;
+    effect.setOrder(order);
+    effect.setKernel(kernel);
+    effect.setDivisor(divisor);
+    effect.setBias(bias);
+    effect.setTarget(target);
+    effect.setEdgeMode(static_cast<ConvolveMatrixEffect::EdgeMode>(edgeMode));
+    effect.enablePreserveAlpha(preserveAlpha);
+    const QImage result = effect.processImage(image, context);
+    QCOMPARE(maxDifference(result, processScalar(effect, image, context)), 0);
+    // single precision may truncate to one less
+    QVERIFY(maxDifference(result, referenceConvolveMatrix(image, effect)) <= 1);
+}
+
+void TestFilterEffects::testConvolveMatrixEdgeMode_data()
+{
+    QTest::addColumn<int>("edgeMode");
+    QTest::addColumn<int>("firstColumn");
+    QTest::newRow("duplicate") << int(ConvolveMatrixEffect::Duplicate) << 0;
+    QTest::newRow("wrap") << int(ConvolveMatrixEffect::Wrap) << 6;
+    QTest::newRow("none") << int(ConvolveMatrixEffect::None) << -1;
+}
+
+void TestFilterEffects::testConvolveMatrixEdgeMode()
+{
+    QFETCH(int, edgeMode);
+    QFETCH(int, firstColumn);
+
+    const QImage image = randomImage(7, 5);
+    KoViewConverter converter;
+    KoFilterEffectRenderContext context(converter);
+    context.setShapeBoundingBox(QRectF(0, 0, 1, 1));
+    context.setFilterRegion(image.rect());
+
+    // shifts the image one pixel to the right
+    ConvolveMatrixEffect effect;
+    effect.setOrder(QPoint(3, 1));
+    effect.setKernel({1, 0, 0});
+    effect.setEdgeMode(static_cast<ConvolveMatrixEffect::EdgeMode>(edgeMode));
+    const QImage result = effect.processImage(image, context);
+    QCOMPARE(maxDifference(result, processScalar(effect, image, context)), 0);
+    for (int y = 0; y < image.height(); ++y) {
+        QCOMPARE(result.pixel(0, y), firstColumn >= 0 ? image.pixel(firstColumn, y) : 0u);
+        for (int x = 1; x < image.width(); ++x)
+            QCOMPARE(result.pixel(x, y), image.pixel(x - 1, y));
+    }
+}
+
+void TestFilterEffects::testColorMatrix_data()
+{
+    QTest::addColumn<int>("width");
+    QTest::addColumn<int>("type");
+    QTest::addColumn<qreal>("value");
+    for (int width : Widths) {
+        QTest::addRow("%d matrix", width) << width << int(ColorMatrixEffect::Matrix) << 0.0;
+        QTest::addRow("%d saturate", width) << width << int(ColorMatrixEffect::Saturate) << 0.3;
+        QTest::addRow("%d hue rotate", width) << width << int(ColorMatrixEffect::HueRotate) << 90.0;
+        QTest::addRow("%d luminance alpha", width) << width << int(ColorMatrixEffect::LuminanceAlpha) << 0.0;
+    }
+}
+
+void TestFilterEffects::testColorMatrix()
+{
+    QFETCH(int, width);
+    QFETCH(int, type);
+    QFETCH(qreal, value);
+
+    const QImage image = randomImage(width, Height);
+    KoViewConverter converter;
+    KoFilterEffectRenderContext context(converter);
+    context.setShapeBoundingBox(QRectF(0, 0, 1, 1));
+    context.setFilterRegion(image.rect());
+
+    ColorMatrixEffect effect;
+    switch (type) {
+    case ColorMatrixEffect::Matrix:
+        effect.setColorMatrix({0.5, 0.2, 0.1, 0.0, 0.1, 0.0, 1.0, 0.0, 0.0, 0.0, 0.3, 0.3, 0.3, 0.0, 0.0, 0.0, 0.0, 0.0, 0.8, 0.1});
+        break;
+    case ColorMatrixEffect::Saturate:
+        effect.setSaturate(value);
+        break;
+    case ColorMatrixEffect::HueRotate:
+        effect.setHueRotate(value);
+        break;
+    case ColorMatrixEffect::LuminanceAlpha:
+        effect.setLuminanceAlpha();
+        break;
+    }
+    const QImage result = effect.processImage(image, context);
+    QCOMPARE(maxDifference(result, processScalar(effect, image, context)), 0);
+    // single precision may truncate to one less
+    QVERIFY(maxDifference(result, referenceColorMatrix(image, effect.colorMatrix())) <= 1);
+}
+
+QTEST_MAIN(TestFilterEffects)
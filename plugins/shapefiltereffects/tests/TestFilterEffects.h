@@ -0,0 +1,34 @@
+/* This file is part of the KDE project
+ * SPDX-FileCopyrightText: 2026 Calligra developers
+ *
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#ifndef TESTFILTEREFFECTS_H
+#define TESTFILTEREFFECTS_H
+
+#include <QObject>
+
+/**
+ * Compares the SSE2 code of the filter effects with their scalar code, and both
+ * with straightforward reference implementations of the SVG filter primitives.
+ */
+class TestFilterEffects : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testBlur_data();
+    void testBlur();
+    void testBlurZeroDeviation();
+    void testMorphology_data();
+    void testMorphology();
+    void testMorphologyDilatePoint();
+    void testConvolveMatrix_data();
+    void testConvolveMatrix();
+    void testConvolveMatrixEdgeMode_data();
+    void testConvolveMatrixEdgeMode();
+    void testColorMatrix_data();
+    void testColorMatrix();
+};
+
+#endif // TESTFILTEREFFECTS_H
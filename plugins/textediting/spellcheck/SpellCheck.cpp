@@ -8,7 +8,6 @@
  */
 
 #include "SpellCheck.h"
-#include "BgSpellCheck.h"
 #include "SpellCheckDebug.h"
 #include "SpellCheckMenu.h"
 
@@ -25,19 +24,29 @@
 
 #include <QAction>
 #include <QApplication>
+#include <QMutexLocker>
+#include <QRecursiveMutex>
+#include <QSet>
 #include <QTextBlock>
 #include <QTextCharFormat>
 #include <QThread>
 #include <QTimer>
 
+// the number of blocks handed to the worker at once
+static const int BlocksPerBatch = 64;
+// the number of batches handed to the worker but not checked yet, more would only be checked after the next edit
+static const int MaxPendingBatches = 2;
+
 SpellCheck::SpellCheck()
     : m_document(nullptr)
-    , m_bgSpellCheck(nullptr)
+    , m_workerThread(nullptr)
+    , m_worker(nullptr)
+    , m_nextBatch(0)
+    , m_generation(0)
+    , m_results(20000)
     , m_enableSpellCheck(true)
     , m_documentIsLoading(false)
-    , m_isChecking(false)
     , m_spellCheckMenu(nullptr)
-    , m_activeSection(nullptr, 0, 0)
     , m_simpleEdit(false)
     , m_cursorPosition(0)
 {
@@ -52,18 +61,33 @@ SpellCheck::SpellCheck()
     KConfigGroup spellConfig = KSharedConfig::openConfig()->group("Spelling");
     m_enableSpellCheck = spellConfig.readEntry("autoSpellCheck", m_enableSpellCheck);
     spellCheck->setChecked(m_enableSpellCheck);
+    // the workers of other documents might be checking already
+    QMutexLocker locker(&SpellCheckWorker::sonnetMutex());
     m_speller = Sonnet::Speller(spellConfig.readEntry("defaultLanguage", "en_US"));
-    m_bgSpellCheck = new BgSpellCheck(m_speller, this);
+
+    m_workerThread = new QThread(this);
+    m_worker = new SpellCheckWorker();
+    m_worker->setDefaultLanguage(m_speller.language().isEmpty() ? QStringLiteral("en_US") : m_speller.language());
+    m_worker->setCheckUppercase(m_speller.testAttribute(Sonnet::Speller::CheckUppercase));
+    m_worker->moveToThread(m_workerThread);
+    connect(m_workerThread, &QThread::finished, m_worker, &QObject::deleteLater);
+    connect(m_worker, &SpellCheckWorker::checked, this, &SpellCheck::applyResults);
+    m_workerThread->start(QThread::LowPriority);
 
     m_spellCheckMenu = new SpellCheckMenu(m_speller, this);
+    locker.unlock();
     QPair<QString, QAction *> pair = m_spellCheckMenu->menuAction();
     addAction(pair.first, pair.second);
 
-    connect(m_bgSpellCheck, &BgSpellCheck::misspelledWord, this, &SpellCheck::highlightMisspelled);
-    connect(m_bgSpellCheck, &Sonnet::BackgroundChecker::done, this, &SpellCheck::finishedRun);
     connect(spellCheck, &QAction::toggled, this, &SpellCheck::setBackgroundSpellChecking);
 }
 
+SpellCheck::~SpellCheck()
+{
+    m_workerThread->quit();
+    m_workerThread->wait();
+}
+
 void SpellCheck::finishedWord(QTextDocument *document, int cursorPosition)
 {
     setDocument(document);
@@ -126,18 +150,26 @@ void SpellCheck::setDocument(QTextDocument *document)
 
 QStringList SpellCheck::availableBackends() const
 {
+    QMutexLocker locker(&SpellCheckWorker::sonnetMutex());
     return m_speller.availableBackends();
 }
 
 QStringList SpellCheck::availableLanguages() const
 {
+    QMutexLocker locker(&SpellCheckWorker::sonnetMutex());
     return m_speller.availableLanguages();
 }
 
 void SpellCheck::setDefaultLanguage(const QString &language)
 {
-    m_speller.setDefaultLanguage(language);
-    m_bgSpellCheck->setDefaultLanguage(language);
+    {
+        QMutexLocker locker(&SpellCheckWorker::sonnetMutex());
+        m_speller.setDefaultLanguage(language);
+    }
+    QMetaObject::invokeMethod(m_worker, [worker = m_worker, language]() {
+        worker->setDefaultLanguage(language);
+    });
+    clearResults();
     if (m_enableSpellCheck && m_document) {
         checkSection(m_document, 0, m_document->characterCount() - 1);
     }
@@ -168,12 +200,20 @@ void SpellCheck::setBackgroundSpellChecking(bool on)
 
 void SpellCheck::setSkipAllUppercaseWords(bool on)
 {
-    m_speller.setAttribute(Speller::CheckUppercase, !on);
+    {
+        QMutexLocker locker(&SpellCheckWorker::sonnetMutex());
+        m_speller.setAttribute(Sonnet::Speller::CheckUppercase, !on);
+    }
+    QMetaObject::invokeMethod(m_worker, [worker = m_worker, on]() {
+        worker->setCheckUppercase(!on);
+    });
+    clearResults();
 }
 
 void SpellCheck::setSkipRunTogetherWords(bool on)
 {
-    m_speller.setAttribute(Speller::SkipRunTogether, on);
+    QMutexLocker locker(&SpellCheckWorker::sonnetMutex());
+    m_speller.setAttribute(Sonnet::Speller::SkipRunTogether, on);
 }
 
 bool SpellCheck::addWordToPersonal(const QString &word, int startPosition)
@@ -182,16 +222,23 @@ bool SpellCheck::addWordToPersonal(const QString &word, int startPosition)
     if (!block.isValid())
         return false;
 
+    // the cached results might contain the word
+    clearResults();
+    QMetaObject::invokeMethod(m_worker, [worker = m_worker, word]() {
+        worker->addToSession(word);
+    });
     KoTextBlockData blockData(block);
     blockData.setMarkupsLayoutValidity(KoTextBlockData::Misspell, false);
     checkSection(m_document, block.position(), block.position() + block.length() - 1);
     // TODO we should probably recheck the entire document so other occurrences are also removed, but then again we should recheck every document (footer,header
     // etc) not sure how to do this
-    return m_bgSpellCheck->addWordToPersonal(word);
+    QMutexLocker locker(&SpellCheckWorker::sonnetMutex());
+    return m_speller.addToPersonal(word);
 }
 
 QString SpellCheck::defaultLanguage() const
 {
+    QMutexLocker locker(&SpellCheckWorker::sonnetMutex());
     return m_speller.defaultLanguage();
 }
 
@@ -202,31 +249,53 @@ bool SpellCheck::backgroundSpellChecking()
 
 bool SpellCheck::skipAllUppercaseWords()
 {
-    return m_speller.testAttribute(Speller::CheckUppercase);
+    QMutexLocker locker(&SpellCheckWorker::sonnetMutex());
+    return m_speller.testAttribute(Sonnet::Speller::CheckUppercase);
 }
 
 bool SpellCheck::skipRunTogetherWords()
 {
-    return m_speller.testAttribute(Speller::SkipRunTogether);
+    QMutexLocker locker(&SpellCheckWorker::sonnetMutex());
+    return m_speller.testAttribute(Sonnet::Speller::SkipRunTogether);
 }
 
 // TODO:
 // 1) When editing a misspelled word it should be spellchecked on the fly so the markup is removed when it is OK.
 // 2) Deleting a character should be treated as a simple edit
-void SpellCheck::highlightMisspelled(const QString &word, int startPosition, bool misspelled)
+void SpellCheck::applyMisspellings(const QTextBlock &block, const QVector<QPair<int, int>> &misspellings)
 {
-    if (!misspelled)
-        return;
+    KoTextBlockData blockData(block);
+    blockData.clearMarkups(KoTextBlockData::Misspell);
+    for (const QPair<int, int> &range : misspellings) {
+        blockData.appendMarkup(KoTextBlockData::Misspell, range.first, range.second);
+    }
+    blockData.setMarkupsLayoutValidity(KoTextBlockData::Misspell, false);
+}
 
-#if 0
-    // DEBUG
-class MyThread : public QThread { public: static void mySleep(unsigned long msecs) { msleep(msecs); }};
-static_cast<MyThread*>(QThread::currentThread())->mySleep(400);
-#endif
+void SpellCheck::clearResults()
+{
+    m_results.clear();
+    ++m_generation;
+}
 
-    QTextBlock block = m_activeSection.document->findBlock(startPosition);
-    KoTextBlockData blockData(block);
-    blockData.appendMarkup(KoTextBlockData::Misspell, startPosition - block.position(), startPosition - block.position() + word.trimmed().length());
+void SpellCheck::requeueBlocks(const QList<QTextCursor> &blocks)
+{
+    for (const QTextCursor &cursor : blocks) {
+        if (cursor.isNull())
+            continue;
+        const QTextBlock block = cursor.block();
+        const int from = block.position();
+        const int to = block.position() + block.length() - 1;
+        bool queued = false;
+        foreach (const SpellSections &ss, m_documentsQueue) {
+            if (ss.document == cursor.document() && ss.from <= from && ss.to >= to) {
+                queued = true;
+                break;
+            }
+        }
+        if (!queued)
+            m_documentsQueue.enqueue(SpellSections(cursor.document(), from, to));
+    }
 }
 
 void SpellCheck::documentChanged(int from, int charsRemoved, int charsAdded)
@@ -277,46 +346,103 @@ void SpellCheck::documentChanged(int from, int charsRemoved, int charsAdded)
 void SpellCheck::runQueue()
 {
     Q_ASSERT(QThread::currentThread() == QApplication::instance()->thread());
-    if (m_isChecking)
+    if (m_pendingBatches.size() >= MaxPendingBatches)
+        return;
+
+    // only copy the text of a batch of blocks at a time, so loading a long document does not block
+    QList<SpellCheckJob> jobs;
+    QList<QTextCursor> blocks;
+    QSet<QTextDocument *> updatedDocuments;
+    int visited = 0;
+    while (!m_documentsQueue.isEmpty() && jobs.size() < BlocksPerBatch && visited < 4 * BlocksPerBatch) {
+        SpellSections &section = m_documentsQueue.head();
+        QTextBlock block = section.document ? section.document->findBlock(section.from) : QTextBlock();
+        for (; block.isValid() && block.position() < section.to && jobs.size() < BlocksPerBatch && visited < 4 * BlocksPerBatch;
+             block = block.next(), ++visited) {
+            const QList<SpellCheckSegment> segments = SpellCheckWorker::segments(block);
+            const size_t key = SpellCheckWorker::key(segments);
+            if (segments.isEmpty()) {
+                applyMisspellings(block, QVector<QPair<int, int>>());
+                updatedDocuments.insert(section.document);
+            } else if (const QVector<QPair<int, int>> *misspellings = m_results.object(key)) {
+                applyMisspellings(block, *misspellings);
+                updatedDocuments.insert(section.document);
+            } else {
+                jobs.append(SpellCheckJob{key, segments});
+                blocks.append(QTextCursor(block));
+            }
+        }
+        if (block.isValid() && block.position() < section.to) {
+            section.from = block.position();
+        } else {
+            m_documentsQueue.dequeue();
+        }
+    }
+
+    if (!jobs.isEmpty()) {
+        const int batch = m_nextBatch++;
+        m_pendingBatches.insert(batch, PendingBatch{m_generation, blocks});
+        QMetaObject::invokeMethod(m_worker, [worker = m_worker, batch, jobs]() {
+            worker->check(batch, jobs);
+        });
+    }
+    foreach (QTextDocument *document, updatedDocuments) {
+        KoTextDocumentLayout *lay = qobject_cast<KoTextDocumentLayout *>(document->documentLayout());
+        if (lay)
+            lay->provider()->updateAll();
+    }
+    if (!m_documentsQueue.isEmpty())
+        QTimer::singleShot(0, this, &SpellCheck::runQueue);
+}
+
+void SpellCheck::applyResults(int batch, const QList<SpellCheckResult> &results)
+{
+    Q_ASSERT(QThread::currentThread() == QApplication::instance()->thread());
+    const PendingBatch pending = m_pendingBatches.take(batch);
+    if (pending.generation != m_generation) {
+        // checked with the settings from before clearResults(), neither cache nor apply that
+        if (m_enableSpellCheck)
+            requeueBlocks(pending.blocks);
+        runQueue();
         return;
-    while (!m_documentsQueue.isEmpty()) {
-        m_activeSection = m_documentsQueue.dequeue();
-        if (m_activeSection.document.isNull())
+    }
+
+    const QList<QTextCursor> &blocks = pending.blocks;
+    QSet<QTextDocument *> updatedDocuments;
+    for (int i = 0; i < results.size() && i < blocks.size(); ++i) {
+        m_results.insert(results[i].key, new QVector<QPair<int, int>>(results[i].misspellings));
+
+        // an edited block is checked again anyway, so only apply the result if the text is the same
+        const QTextCursor &cursor = blocks[i];
+        if (cursor.isNull() || !m_enableSpellCheck)
             continue;
-        QTextBlock block = m_activeSection.document->findBlock(m_activeSection.from);
-        if (!block.isValid())
+        const QTextBlock block = cursor.block();
+        if (!block.isValid() || SpellCheckWorker::key(SpellCheckWorker::segments(block)) != results[i].key)
             continue;
-        m_isChecking = true;
-        do {
-            KoTextBlockData blockData(block);
-            blockData.clearMarkups(KoTextBlockData::Misspell);
-            block = block.next();
-        } while (block.isValid() && block.position() < m_activeSection.to);
+        applyMisspellings(block, results[i].misspellings);
+        updatedDocuments.insert(cursor.document());
+    }
 
-        m_bgSpellCheck->startRun(m_activeSection.document, m_activeSection.from, m_activeSection.to);
-        break;
+    // and relayout the markups of the whole batch at once
+    foreach (QTextDocument *document, updatedDocuments) {
+        KoTextDocumentLayout *lay = qobject_cast<KoTextDocumentLayout *>(document->documentLayout());
+        if (lay)
+            lay->provider()->updateAll();
     }
+    runQueue();
 }
 
 void SpellCheck::configureSpellCheck()
 {
+    // the dialog changes the settings shared by all spellers, so the workers wait
+    // for it; being application modal, no document can be closed meanwhile
+    QMutexLocker locker(&SpellCheckWorker::sonnetMutex());
     Sonnet::ConfigDialog *dialog = new Sonnet::ConfigDialog(nullptr);
     connect(dialog, &Sonnet::ConfigDialog::languageChanged, this, &SpellCheck::setDefaultLanguage);
     dialog->exec();
     delete dialog;
 }
 
-void SpellCheck::finishedRun()
-{
-    Q_ASSERT(QThread::currentThread() == QApplication::instance()->thread());
-    m_isChecking = false;
-
-    KoTextDocumentLayout *lay = qobject_cast<KoTextDocumentLayout *>(m_activeSection.document->documentLayout());
-    lay->provider()->updateAll();
-
-    QTimer::singleShot(0, this, &SpellCheck::runQueue);
-}
-
 void SpellCheck::setCurrentCursorPosition(QTextDocument *document, int cursorPosition)
 {
     setDocument(document);
@@ -329,11 +455,14 @@ void SpellCheck::setCurrentCursorPosition(QTextDocument *document, int cursorPos
             if (int length = range.lastChar - range.firstChar) {
                 QString word = block.text().mid(range.firstChar, length);
                 m_spellCheckMenu->setMisspelled(word, block.position() + range.firstChar, length);
-                QString language = m_bgSpellCheck->currentLanguage();
-                if (!m_bgSpellCheck->currentLanguage().isEmpty() && !m_bgSpellCheck->currentCountry().isEmpty()) {
-                    language += '_';
+                QString language = defaultLanguage();
+                foreach (const SpellCheckSegment &segment, SpellCheckWorker::segments(block)) {
+                    if (segment.offset <= range.firstChar && range.firstChar < segment.offset + segment.text.length()) {
+                        if (!segment.language.isEmpty())
+                            language = segment.language;
+                        break;
+                    }
                 }
-                language += m_bgSpellCheck->currentCountry();
                 m_spellCheckMenu->setCurrentLanguage(language);
                 m_spellCheckMenu->setVisible(true);
                 m_spellCheckMenu->setEnabled(true);
@@ -12,24 +12,38 @@
 
 #include <KoTextEditingPlugin.h>
 
+#include "SpellCheckWorker.h"
+
+#include <QCache>
 #include <QPointer>
 #include <QQueue>
 #include <QTextCharFormat>
+#include <QTextCursor>
 #include <QTextDocument>
 #include <QTextLayout>
 #include <QTextStream>
 #include <sonnet/speller.h>
 
+class QTextBlock;
 class QTextDocument;
 class QTextStream;
-class BgSpellCheck;
+class QThread;
 class SpellCheckMenu;
 
+/**
+ * Spell checking while typing.
+ *
+ * The text of the blocks to check is copied and checked on a worker thread,
+ * see SpellCheckWorker. The results are cached by the content of the blocks,
+ * so unchanged blocks are never checked twice, and are applied to the
+ * blocks in batches.
+ */
 class SpellCheck : public KoTextEditingPlugin
 {
     Q_OBJECT
 public:
     SpellCheck();
+    ~SpellCheck() override;
 
     /// reimplemented from superclass
     void finishedWord(QTextDocument *document, int cursorPosition) override;
@@ -68,18 +82,38 @@ public Q_SLOTS:
     void setDefaultLanguage(const QString &lang);
 
 private Q_SLOTS:
-    void highlightMisspelled(const QString &word, int startPosition, bool misspelled = true);
-    void finishedRun();
+    void applyResults(int batch, const QList<SpellCheckResult> &results);
     void configureSpellCheck();
     void runQueue();
     void setBackgroundSpellChecking(bool b);
     void documentChanged(int from, int charsRemoved, int charsAdded);
 
 private:
+    friend class TestSpellCheck;
+
+    /// Replace the misspelled markups of @p block with @p misspellings
+    void applyMisspellings(const QTextBlock &block, const QVector<QPair<int, int>> &misspellings);
+    /// Forget the cached results and those of the batches being checked, e.g. after the dictionary changed
+    void clearResults();
+    /// Queue @p blocks to be checked again
+    void requeueBlocks(const QList<QTextCursor> &blocks);
+
     Sonnet::Speller m_speller;
     QPointer<QTextDocument> m_document;
     QString m_word;
-    BgSpellCheck *m_bgSpellCheck;
+    QThread *m_workerThread;
+    SpellCheckWorker *m_worker;
+    struct PendingBatch {
+        int generation = 0; ///< the value of m_generation when the batch was sent
+        QList<QTextCursor> blocks; ///< a cursor at the start of each block, as blocks move while editing
+    };
+    /// the batches being checked
+    QHash<int, PendingBatch> m_pendingBatches;
+    int m_nextBatch;
+    /// bumped by clearResults(), the results of batches sent before were checked with other settings
+    int m_generation;
+    /// the misspellings of checked blocks, by SpellCheckWorker::key()
+    QCache<size_t, QVector<QPair<int, int>>> m_results;
     struct SpellSections {
         SpellSections(QTextDocument *doc, int start, int end)
             : document(doc)
@@ -94,10 +128,8 @@ private:
     QQueue<SpellSections> m_documentsQueue;
     bool m_enableSpellCheck;
     bool m_documentIsLoading;
-    bool m_isChecking;
     QTextStream stream;
     SpellCheckMenu *m_spellCheckMenu;
-    SpellSections m_activeSection; // the section we are currently doing a run on;
     bool m_simpleEdit; // set when user is doing a simple edit, meaning we should not start spellchecking
     int m_cursorPosition; // simple edit cursor position
 };
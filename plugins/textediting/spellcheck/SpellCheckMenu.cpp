@@ -8,12 +8,15 @@
 #include "SpellCheckMenu.h"
 #include "SpellCheck.h"
 #include "SpellCheckDebug.h"
+#include "SpellCheckWorker.h"
 
 #include <KActionMenu>
 #include <KLocalizedString>
 
 #include <QAction>
 #include <QMenu>
+#include <QMutexLocker>
+#include <QRecursiveMutex>
 
 SpellCheckMenu::SpellCheckMenu(const Sonnet::Speller &speller, SpellCheck *spellCheck)
     : QObject(spellCheck)
@@ -60,7 +63,9 @@ void SpellCheckMenu::createSuggestionsMenu()
     m_suggestionsMenu->addAction(m_addToDictionaryAction);
     m_suggestionsMenu->addSeparator();
     if (!m_currentMisspelled.isEmpty()) {
+        QMutexLocker locker(&SpellCheckWorker::sonnetMutex());
         m_suggestions = m_speller.suggest(m_currentMisspelled);
+        locker.unlock();
         for (int i = 0; i < m_suggestions.count(); ++i) {
             const QString &suggestion = m_suggestions.at(i);
             QAction *action = new QAction(suggestion, m_suggestionsMenu);
@@ -78,7 +83,10 @@ void SpellCheckMenu::ignoreWord()
         return;
 
     // see comment in ctor why this will never work
-    m_speller.addToSession(m_currentMisspelled);
+    {
+        QMutexLocker locker(&SpellCheckWorker::sonnetMutex());
+        m_speller.addToSession(m_currentMisspelled);
+    }
 
     Q_EMIT clearHighlightingForWord(m_currentMisspelledPosition);
 
@@ -141,5 +149,6 @@ void SpellCheckMenu::replaceWord(const QString &suggestion)
 
 void SpellCheckMenu::setCurrentLanguage(const QString &language)
 {
+    QMutexLocker locker(&SpellCheckWorker::sonnetMutex());
     m_speller.setLanguage(language);
 }
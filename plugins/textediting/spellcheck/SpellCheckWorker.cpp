@@ -0,0 +1,145 @@
+/* This file is part of the KDE project
+ * SPDX-FileCopyrightText: 2026 Calligra developers
+ *
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ */
+
+#include "SpellCheckWorker.h"
+#include "SpellCheckDebug.h"
+
+#include <KoCharacterStyle.h>
+
+#include <sonnet/speller.h>
+
+#include <QMutexLocker>
+#include <QRecursiveMutex>
+#include <QTextBlock>
+#include <QTextBoundaryFinder>
+#include <QTextCharFormat>
+
+SpellCheckWorker::SpellCheckWorker(QObject *parent)
+    : QObject(parent)
+    , m_defaultLanguage("en_US")
+    , m_checkUppercase(true)
+{
+}
+
+SpellCheckWorker::~SpellCheckWorker()
+{
+    QMutexLocker locker(&sonnetMutex());
+    qDeleteAll(m_spellers);
+}
+
+QRecursiveMutex &SpellCheckWorker::sonnetMutex()
+{
+    static QRecursiveMutex mutex;
+    return mutex;
+}
+
+QList<SpellCheckSegment> SpellCheckWorker::segments(const QTextBlock &block)
+{
+    QList<SpellCheckSegment> result;
+    for (QTextBlock::iterator it = block.begin(); !it.atEnd(); ++it) {
+        const QTextFragment fragment = it.fragment();
+        if (!fragment.isValid())
+            continue;
+        const QTextCharFormat cf = fragment.charFormat();
+        QString language = cf.property(KoCharacterStyle::Language).toString();
+        const QString country = cf.property(KoCharacterStyle::Country).toString();
+        if (!language.isEmpty() && !country.isEmpty())
+            language += '_' + country;
+
+        const int offset = fragment.position() - block.position();
+        if (!result.isEmpty() && result.last().language == language && result.last().offset + result.last().text.length() == offset) {
+            result.last().text += fragment.text();
+        } else {
+            result.append(SpellCheckSegment{offset, fragment.text(), language});
+        }
+    }
+    return result;
+}
+
+size_t SpellCheckWorker::key(const QList<SpellCheckSegment> &segments)
+{
+    size_t seed = 0;
+    for (const SpellCheckSegment &segment : segments) {
+        seed = qHashMulti(seed, segment.offset, segment.text, segment.language);
+    }
+    return seed;
+}
+
+QVector<QPair<int, int>> SpellCheckWorker::misspellings(const SpellCheckJob &job)
+{
+    QVector<QPair<int, int>> result;
+    // held per block, so the GUI thread doesn't wait long for suggestions
+    QMutexLocker locker(&sonnetMutex());
+    for (const SpellCheckSegment &segment : job.segments) {
+        Sonnet::Speller *speller = this->speller(segment.language);
+        QTextBoundaryFinder finder(QTextBoundaryFinder::Word, segment.text);
+        int start = -1;
+        while (finder.toNextBoundary() != -1) {
+            const QTextBoundaryFinder::BoundaryReasons reasons = finder.boundaryReasons();
+            if ((reasons & QTextBoundaryFinder::EndOfItem) && start >= 0) {
+                const QString word = segment.text.mid(start, finder.position() - start);
+                bool check = false;
+                for (const QChar c : word) {
+                    if (c.isLetter()) {
+                        check = true;
+                        break;
+                    }
+                }
+                if (check && !m_checkUppercase && word == word.toUpper())
+                    check = false;
+                if (check && !m_sessionWords.contains(word) && speller->isMisspelled(word)) {
+                    result.append(qMakePair(segment.offset + start, segment.offset + finder.position()));
+                }
+                start = -1;
+            }
+            if (reasons & QTextBoundaryFinder::StartOfItem) {
+                start = finder.position();
+            }
+        }
+    }
+    return result;
+}
+
+void SpellCheckWorker::check(int batch, const QList<SpellCheckJob> &jobs)
+{
+    QList<SpellCheckResult> results;
+    results.reserve(jobs.size());
+    for (const SpellCheckJob &job : jobs) {
+        results.append(SpellCheckResult{job.key, misspellings(job)});
+    }
+    Q_EMIT checked(batch, results);
+}
+
+void SpellCheckWorker::setDefaultLanguage(const QString &language)
+{
+    m_defaultLanguage = language;
+}
+
+void SpellCheckWorker::setCheckUppercase(bool check)
+{
+    m_checkUppercase = check;
+}
+
+void SpellCheckWorker::addToSession(const QString &word)
+{
+    m_sessionWords.insert(word);
+}
+
+Sonnet::Speller *SpellCheckWorker::speller(const QString &language)
+{
+    const QString name = language.isEmpty() ? m_defaultLanguage : language;
+    Sonnet::Speller *speller = m_spellers.value(name);
+    if (!speller) {
+        speller = new Sonnet::Speller(name);
+        m_spellers.insert(name, speller);
+    }
+    // text in languages without a dictionary is checked with the default one
+    if (!speller->isValid() && !language.isEmpty() && name != m_defaultLanguage) {
+        debugSpellCheck << "no dictionary for" << name;
+        return this->speller(QString());
+    }
+    return speller;
+}
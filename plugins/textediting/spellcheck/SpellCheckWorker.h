@@ -0,0 +1,97 @@
+/* This file is part of the KDE project
+ * SPDX-FileCopyrightText: 2026 Calligra developers
+ *
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ */
+
+#ifndef SPELLCHECKWORKER_H
+#define SPELLCHECKWORKER_H
+
+#include <QHash>
+#include <QList>
+#include <QObject>
+#include <QPair>
+#include <QSet>
+#include <QString>
+#include <QVector>
+
+class QRecursiveMutex;
+class QTextBlock;
+
+namespace Sonnet
+{
+class Speller;
+}
+
+/// A part of the text of a block written in one language
+struct SpellCheckSegment {
+    int offset; ///< the position of the text in the block
+    QString text;
+    QString language; ///< e.g. "en_US", empty for the default language
+};
+
+/// The text of a block to be checked
+struct SpellCheckJob {
+    size_t key; ///< see SpellCheckWorker::key()
+    QList<SpellCheckSegment> segments;
+};
+
+/// The misspelled words of a block, as ranges of first and last + 1 character in the block
+struct SpellCheckResult {
+    size_t key;
+    QVector<QPair<int, int>> misspellings;
+};
+
+/**
+ * Checks the text of blocks for misspelled words.
+ *
+ * The worker lives on a thread of its own and only sees copies of the text,
+ * so it never touches a QTextDocument. Jobs are handed over in batches with
+ * check() and the results of every batch are reported at once with checked().
+ *
+ * Sonnet hands all Spellers of a language the same spell checker, and keeps
+ * those in a cache without any locking. So every call into Sonnet, also the
+ * ones on the GUI thread, has to hold sonnetMutex().
+ */
+class SpellCheckWorker : public QObject
+{
+    Q_OBJECT
+public:
+    explicit SpellCheckWorker(QObject *parent = nullptr);
+    ~SpellCheckWorker() override;
+
+    /// Split the text of @p block into parts of the same language
+    static QList<SpellCheckSegment> segments(const QTextBlock &block);
+
+    /// Return the key identifying the text and languages of @p segments
+    static size_t key(const QList<SpellCheckSegment> &segments);
+
+    /// Return the ranges of the misspelled words of @p job
+    QVector<QPair<int, int>> misspellings(const SpellCheckJob &job);
+
+    /// The lock serializing all calls into Sonnet of the process
+    static QRecursiveMutex &sonnetMutex();
+
+public Q_SLOTS:
+    void check(int batch, const QList<SpellCheckJob> &jobs);
+    void setDefaultLanguage(const QString &language);
+    void setCheckUppercase(bool check);
+    /// Accept @p word as correctly spelled from now on
+    void addToSession(const QString &word);
+
+Q_SIGNALS:
+    void checked(int batch, const QList<SpellCheckResult> &results);
+
+private:
+    Sonnet::Speller *speller(const QString &language);
+
+    QString m_defaultLanguage;
+    bool m_checkUppercase;
+    QHash<QString, Sonnet::Speller *> m_spellers;
+    QSet<QString> m_sessionWords;
+};
+
+Q_DECLARE_METATYPE(SpellCheckJob)
+Q_DECLARE_METATYPE(SpellCheckResult)
+
+#endif
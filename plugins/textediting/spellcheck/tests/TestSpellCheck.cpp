@@ -1,9 +1,15 @@
 #include "TestSpellCheck.h"
 
-#include "../BgSpellCheck.h"
+#include "../SpellCheck.h"
+#include "../SpellCheckWorker.h"
 
 #include <KoCharacterStyle.h>
+#include <KoTextBlockData.h>
 
+#include <sonnet/speller.h>
+
+#include <QSignalSpy>
+#include <QStandardPaths>
 #include <QTextBlock>
 #include <QTextCharFormat>
 #include <QTextCursor>
@@ -11,36 +17,40 @@
 
 #include <QTest>
 
-class MySpellCheck : public BgSpellCheck
+static bool hasDictionary()
 {
-public:
-    MySpellCheck(QObject *parent = nullptr)
-        : BgSpellCheck(parent)
-    {
-    }
+    return Sonnet::Speller(QStringLiteral("en_US")).isValid();
+}
 
-    QString publicFetchMoreText()
-    {
-        return fetchMoreText();
-    }
-    void start() override
-    {
-    }
-};
+static QPair<int, int> misspelledRange(const QTextBlock &block, int position)
+{
+    KoTextBlockData blockData(block);
+    const KoTextBlockData::MarkupRange range = blockData.findMarkup(KoTextBlockData::Misspell, position);
+    return qMakePair(range.firstChar, range.lastChar);
+}
+
+void TestSpellCheck::initTestCase()
+{
+    QStandardPaths::setTestModeEnabled(true);
+}
 
-void TestSpellCheck::testFetchMoreText()
+void TestSpellCheck::testSegments()
 {
-    MySpellCheck checker;
     QTextDocument doc;
     QString text("some simple text\na second parag with more text\n");
     doc.setPlainText(text);
 
-    checker.startRun(&doc, 0, text.size());
     QTextBlock block = doc.begin();
-    QCOMPARE(checker.publicFetchMoreText(), block.text());
+    QList<SpellCheckSegment> segments = SpellCheckWorker::segments(block);
+    QCOMPARE(segments.count(), 1);
+    QCOMPARE(segments[0].offset, 0);
+    QCOMPARE(segments[0].text, block.text());
+    QVERIFY(segments[0].language.isEmpty());
     block = block.next();
     QVERIFY(block.isValid());
-    QCOMPARE(checker.publicFetchMoreText(), block.text());
+    segments = SpellCheckWorker::segments(block);
+    QCOMPARE(segments.count(), 1);
+    QCOMPARE(segments[0].text, block.text());
 
     QTextCursor cursor(&doc);
     QTextCharFormat cf;
@@ -48,54 +58,205 @@ void TestSpellCheck::testFetchMoreText()
     cursor.setPosition(4, QTextCursor::KeepAnchor);
     cursor.mergeCharFormat(cf);
 
-    checker.startRun(&doc, 0, text.size());
     block = doc.begin();
-    QCOMPARE(checker.publicFetchMoreText(), QString("some"));
-    QCOMPARE(checker.publicFetchMoreText(), block.text().mid(4));
-    block = block.next();
-    QVERIFY(block.isValid());
-    QCOMPARE(checker.publicFetchMoreText(), block.text());
+    segments = SpellCheckWorker::segments(block);
+    QCOMPARE(segments.count(), 2);
+    QCOMPARE(segments[0].text, QString("some"));
+    QCOMPARE(segments[0].language, QString("pl"));
+    QCOMPARE(segments[1].offset, 4);
+    QCOMPARE(segments[1].text, block.text().mid(4));
+    QVERIFY(segments[1].language.isEmpty());
 
     // add some more
+    block = block.next();
     cursor.setPosition(block.position() + 2);
     cursor.movePosition(QTextCursor::NextWord, QTextCursor::KeepAnchor); // 'second'
     int position2 = cursor.anchor();
     int position3 = cursor.position();
     cf.setProperty(KoCharacterStyle::Language, QVariant("br"));
+    cf.setProperty(KoCharacterStyle::Country, QVariant("FR"));
     cursor.mergeCharFormat(cf);
     cursor.movePosition(QTextCursor::NextWord, QTextCursor::MoveAnchor, 2);
-    cursor.movePosition(QTextCursor::NextWord, QTextCursor::KeepAnchor); // 'with'
+    int position4 = cursor.position();
+    cursor.movePosition(QTextCursor::NextWord, QTextCursor::KeepAnchor); // 'more'
+    int position5 = cursor.position();
     cf.setProperty(KoCharacterStyle::Language, QVariant("en"));
+    cf.clearProperty(KoCharacterStyle::Country);
     cursor.mergeCharFormat(cf);
 
-    checker.startRun(&doc, 0, text.size());
-    checker.setDefaultLanguage("en_NZ");
-    block = doc.begin();
-    QCOMPARE(checker.publicFetchMoreText(), QString("some"));
-    QCOMPARE(checker.publicFetchMoreText(), block.text().mid(4));
-    block = block.next();
-    QVERIFY(block.isValid());
-    QCOMPARE(checker.publicFetchMoreText(), block.text().left(2));
-    QCOMPARE(checker.publicFetchMoreText(), text.mid(position2, position3 - position2));
-    QCOMPARE(checker.publicFetchMoreText(), text.mid(position3).trimmed());
-
-    // start a check in the middle of a block
-    checker.startRun(&doc, 4, 19);
-    block = doc.begin();
-    QCOMPARE(checker.publicFetchMoreText(), block.text().mid(4));
-    block = block.next();
-    QVERIFY(block.isValid());
-    QCOMPARE(checker.publicFetchMoreText(), block.text().left(2));
+    segments = SpellCheckWorker::segments(block);
+    QCOMPARE(segments.count(), 5);
+    QCOMPARE(segments[0].text, block.text().left(2));
+    QCOMPARE(segments[1].text, text.mid(position2, position3 - position2));
+    QCOMPARE(segments[1].language, QString("br_FR"));
+    QCOMPARE(segments[2].text, text.mid(position3, position4 - position3));
+    QCOMPARE(segments[3].offset, position4 - block.position());
+    QCOMPARE(segments[3].language, QString("en"));
+    QCOMPARE(segments[4].text, text.mid(position5).trimmed());
 }
 
-void TestSpellCheck::testFetchMoreText2()
+void TestSpellCheck::testSegments2()
 {
-    MySpellCheck checker;
     QTextDocument doc;
     doc.setPlainText("\n\n\nMostly Empty Parags.\n\n");
-    checker.startRun(&doc, 0, 20);
-    checker.setDefaultLanguage("en_NZ");
-    QCOMPARE(checker.publicFetchMoreText(), QString("Mostly Empty Parags."));
+    QTextBlock block = doc.begin();
+    QVERIFY(SpellCheckWorker::segments(block).isEmpty());
+    block = doc.findBlockByNumber(3);
+    const QList<SpellCheckSegment> segments = SpellCheckWorker::segments(block);
+    QCOMPARE(segments.count(), 1);
+    QCOMPARE(segments[0].text, QString("Mostly Empty Parags."));
+}
+
+void TestSpellCheck::testKey()
+{
+    QTextDocument doc;
+    doc.setPlainText("same text\nsame text\nother text");
+    QTextBlock first = doc.begin();
+    QTextBlock second = first.next();
+    QTextBlock third = second.next();
+
+    // results are cached by content, so equal blocks share them
+    QCOMPARE(SpellCheckWorker::key(SpellCheckWorker::segments(first)), SpellCheckWorker::key(SpellCheckWorker::segments(second)));
+    QVERIFY(SpellCheckWorker::key(SpellCheckWorker::segments(first)) != SpellCheckWorker::key(SpellCheckWorker::segments(third)));
+
+    // but not if the language differs
+    QTextCursor cursor(second);
+    cursor.movePosition(QTextCursor::EndOfBlock, QTextCursor::KeepAnchor);
+    QTextCharFormat cf;
+    cf.setProperty(KoCharacterStyle::Language, QVariant("de"));
+    cursor.mergeCharFormat(cf);
+    QVERIFY(SpellCheckWorker::key(SpellCheckWorker::segments(first)) != SpellCheckWorker::key(SpellCheckWorker::segments(second)));
+}
+
+void TestSpellCheck::testMisspellings()
+{
+    if (!hasDictionary())
+        QSKIP("needs an en_US dictionary");
+
+    SpellCheckWorker worker;
+    worker.setDefaultLanguage(QStringLiteral("en_US"));
+    SpellCheckJob job{0, {SpellCheckSegment{0, QStringLiteral("This sentense has one mistake"), QString()}}};
+    QVector<QPair<int, int>> misspellings = worker.misspellings(job);
+    QCOMPARE(misspellings.count(), 1);
+    QCOMPARE(misspellings[0], qMakePair(5, 13));
+
+    // the ranges are in the block, and languages without a dictionary use the default one
+    job.segments = {SpellCheckSegment{0, QStringLiteral("This "), QString()},
+                    SpellCheckSegment{5, QStringLiteral("sentense has one mistake"), QStringLiteral("xx_XX")}};
+    misspellings = worker.misspellings(job);
+    QCOMPARE(misspellings.count(), 1);
+    QCOMPARE(misspellings[0], qMakePair(5, 13));
+
+    job.segments = {SpellCheckSegment{0, QStringLiteral("QWXZPT"), QString()}};
+    QCOMPARE(worker.misspellings(job).count(), 1);
+    worker.setCheckUppercase(false);
+    QVERIFY(worker.misspellings(job).isEmpty());
+
+    job.segments = {SpellCheckSegment{0, QStringLiteral("sentense"), QString()}};
+    QCOMPARE(worker.misspellings(job).count(), 1);
+    worker.addToSession(QStringLiteral("sentense"));
+    QVERIFY(worker.misspellings(job).isEmpty());
+}
+
+void TestSpellCheck::testCheck()
+{
+    SpellCheckWorker worker;
+    QSignalSpy spy(&worker, &SpellCheckWorker::checked);
+    const QList<SpellCheckJob> jobs{SpellCheckJob{11, {SpellCheckSegment{0, QStringLiteral("one"), QString()}}},
+                                    SpellCheckJob{12, {SpellCheckSegment{0, QStringLiteral("two"), QString()}}}};
+    worker.check(7, jobs);
+
+    // the results of a batch are reported at once, in the order of the jobs
+    QCOMPARE(spy.count(), 1);
+    QCOMPARE(spy[0][0].toInt(), 7);
+    const QList<SpellCheckResult> results = spy[0][1].value<QList<SpellCheckResult>>();
+    QCOMPARE(results.count(), 2);
+    QCOMPARE(results[0].key, size_t(11));
+    QCOMPARE(results[1].key, size_t(12));
+}
+
+void TestSpellCheck::testCachedResults()
+{
+    SpellCheck spellCheck;
+    QTextDocument doc;
+    doc.setPlainText("first block\nsecond block");
+    const QTextBlock first = doc.begin();
+    const QTextBlock second = first.next();
+    const size_t firstKey = SpellCheckWorker::key(SpellCheckWorker::segments(first));
+    const size_t secondKey = SpellCheckWorker::key(SpellCheckWorker::segments(second));
+
+    spellCheck.m_pendingBatches.insert(100, SpellCheck::PendingBatch{spellCheck.m_generation, {QTextCursor(first), QTextCursor(second)}});
+    // the second block gets edited while it is being checked
+    QTextCursor(second).insertText(QStringLiteral("changed "));
+    spellCheck.applyResults(100, {SpellCheckResult{firstKey, {qMakePair(0, 5)}}, SpellCheckResult{secondKey, {qMakePair(0, 6)}}});
+
+    QVERIFY(!spellCheck.m_pendingBatches.contains(100));
+    QVERIFY(spellCheck.m_results.contains(firstKey));
+    QVERIFY(spellCheck.m_results.contains(secondKey));
+    QCOMPARE(misspelledRange(first, 2), qMakePair(0, 5));
+    // the edited block does not get the result for its old text
+    const QPair<int, int> range = misspelledRange(second, 2);
+    QCOMPARE(range.first, range.second);
+
+    // a block with the same text is not checked again
+    QTextDocument other;
+    other.setPlainText("first block");
+    const int batches = spellCheck.m_nextBatch;
+    spellCheck.checkSection(&other, 0, other.characterCount() - 1);
+    QCOMPARE(spellCheck.m_nextBatch, batches);
+    QCOMPARE(misspelledRange(other.begin(), 2), qMakePair(0, 5));
+}
+
+void TestSpellCheck::testOutdatedResults()
+{
+    SpellCheck spellCheck;
+    QTextDocument doc;
+    doc.setPlainText("some text");
+    const QTextBlock block = doc.begin();
+    const size_t key = SpellCheckWorker::key(SpellCheckWorker::segments(block));
+
+    spellCheck.m_pendingBatches.insert(100, SpellCheck::PendingBatch{spellCheck.m_generation, {QTextCursor(block)}});
+    // changing the settings while the batch is being checked outdates its results
+    spellCheck.setSkipAllUppercaseWords(true);
+    spellCheck.applyResults(100, {SpellCheckResult{key, {qMakePair(0, 4)}}});
+
+    QVERIFY(!spellCheck.m_results.contains(key));
+    const QPair<int, int> range = misspelledRange(block, 2);
+    QCOMPARE(range.first, range.second);
+
+    // but the block is checked again with the new settings
+    QCOMPARE(spellCheck.m_pendingBatches.count(), 1);
+    const SpellCheck::PendingBatch &pending = spellCheck.m_pendingBatches.begin().value();
+    QCOMPARE(pending.generation, spellCheck.m_generation);
+    QCOMPARE(pending.blocks.count(), 1);
+    QCOMPARE(pending.blocks[0].block(), block);
+}
+
+void TestSpellCheck::testBatches()
+{
+    SpellCheck spellCheck;
+    QTextDocument doc;
+    QStringList lines;
+    for (int i = 0; i < 200; ++i)
+        lines << QStringLiteral("the same sentense");
+    doc.setPlainText(lines.join('\n'));
+    const size_t key = SpellCheckWorker::key(SpellCheckWorker::segments(doc.begin()));
+
+    spellCheck.checkSection(&doc, 0, doc.characterCount() - 1);
+    QCOMPARE(spellCheck.m_pendingBatches.count(), 1);
+    QCOMPARE(spellCheck.m_pendingBatches.begin().value().blocks.count(), 64);
+
+    QTRY_VERIFY(spellCheck.m_pendingBatches.isEmpty() && spellCheck.m_documentsQueue.isEmpty());
+    // once the first result is cached the remaining blocks are not sent to the worker,
+    // and at most two batches are sent before a result comes back
+    QVERIFY(spellCheck.m_nextBatch <= 2);
+    QVERIFY(spellCheck.m_results.contains(key));
+
+    if (hasDictionary()) {
+        for (QTextBlock block = doc.begin(); block.isValid(); block = block.next()) {
+            QCOMPARE(misspelledRange(block, 10), qMakePair(9, 17));
+        }
+    }
 }
 
 QTEST_MAIN(TestSpellCheck)
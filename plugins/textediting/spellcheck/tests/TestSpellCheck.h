@@ -10,8 +10,15 @@ public:
     TestSpellCheck() = default;
 
 private Q_SLOTS:
-    void testFetchMoreText();
-    void testFetchMoreText2();
+    void initTestCase();
+    void testSegments();
+    void testSegments2();
+    void testKey();
+    void testMisspellings();
+    void testCheck();
+    void testCachedResults();
+    void testOutdatedResults();
+    void testBatches();
 };
 
 #endif
@@ -518,6 +518,17 @@ void Formula::setExpression(const QString &expr)
     d->valid = false;
 }
 
+void Formula::setExpression(const QString &expr, const Tokens &tokens)
+{
+    d->expression = expr;
+    if (tokens.valid()) {
+        compile(tokens);
+    } else {
+        d->dirty = true;
+        d->valid = false;
+    }
+}
+
 // Returns the expression associated with this formula.
 
 QString Formula::expression() const
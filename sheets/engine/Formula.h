@@ -345,6 +345,14 @@ public:
      */
     void setExpression(const QString &expr);
 
+    /**
+     * Sets the expression for this formula together with the tokens scan() would
+     * return for it, e.g. when an import filter already knows the structure of the
+     * formula. The tokens are compiled right away, so isValid() does not have to scan
+     * the expression again. They are not kept, tokens() scans the expression.
+     */
+    void setExpression(const QString &expr, const Tokens &tokens);
+
     /**
      * Gets the expression of this formula.
      */
@@ -405,4 +405,30 @@ void TestFormula::testInlineArrays()
 #endif
 }
 
+void TestFormula::testPrescannedTokens()
+{
+    const QString expr("=SUM(A1:A2)*2");
+    const Tokens tokens = Formula().scan(expr);
+    QVERIFY(tokens.valid());
+
+    Formula f(m_sheet);
+    f.setExpression(expr, tokens);
+    QVERIFY(f.isValid());
+    QCOMPARE(f.expression(), expr);
+    QCOMPARE(f.tokens().count(), tokens.count());
+    QCOMPARE(f.eval(), Value(15.0));
+
+    // a plain expression is scanned again
+    f.setExpression("=A1+1");
+    QCOMPARE(f.tokens().count(), 3);
+    QCOMPARE(f.eval(), Value(7));
+
+    // invalid tokens are not compiled
+    Tokens invalid;
+    invalid.setValid(false);
+    f.setExpression("=A1", invalid);
+    QCOMPARE(f.tokens().count(), 1);
+    QCOMPARE(f.eval(), Value(6));
+}
+
 QTEST_MAIN(TestFormula)
@@ -32,6 +32,7 @@ private Q_SLOTS:
     void testReferences();
     void testFunction();
     void testInlineArrays();
+    void testPrescannedTokens();
 
 private:
     Value evaluate(const QString &, Value &);
@@ -66,6 +66,7 @@ KPrAnimationDirector::KPrAnimationDirector(KoPAView *view, KoPACanvas *canvas, c
     , m_hasAnimation(false)
     , m_animationCache(nullptr)
     , m_state(PresentationState)
+    , m_prefetchPending(false)
 {
     Q_ASSERT(!m_pages.empty());
     m_animationCache = new KPrAnimationCache();
@@ -352,6 +353,33 @@ void KPrAnimationDirector::updateZoom(const QSize &size)
     // reinit page animation, because somi init method contain zoom
     updatePageAnimation();
     updateStepAnimation();
+    prefetchPages();
+}
+
+void KPrAnimationDirector::prefetchPages()
+{
+    m_prefetchPending = true;
+    // deferred, so the current page gets painted first
+    QTimer::singleShot(0, this, &KPrAnimationDirector::prefetchPendingPages);
+}
+
+void KPrAnimationDirector::prefetchPendingPages()
+{
+    // painting the pages now would make the running effect or animation stutter,
+    // this is called again from slotTimelineFinished() and finishAnimations()
+    if (!m_prefetchPending || m_state != PresentationState || m_timeLine.state() == QTimeLine::Running) {
+        return;
+    }
+    m_prefetchPending = false;
+
+    const QSize size = m_canvas->size();
+    for (int index = m_pageIndex - 1; index <= m_pageIndex + 1; ++index) {
+        KoPAPageBase *page = m_pages.value(index);
+        // the frames can only stand in for pages that look the same at every step
+        if (page && KPrSlidePrefetcher::isStatic(page)) {
+            m_slidePrefetcher.prefetch(page, size);
+        }
+    }
 }
 
 void KPrAnimationDirector::paintStep(QPainter &painter)
@@ -401,18 +429,32 @@ bool KPrAnimationDirector::nextStep()
 
         // run page effect if there is one
         if (effect) {
-            QPixmap oldPage(m_canvas->size());
-            m_canvas->render(&oldPage);
+            // use the prerendered pages if there are any, painting them now makes the effect stutter
+            KoPAPageBase *previousPage = m_pages[m_pageIndex - 1];
+            const QImage oldFrame = m_slidePrefetcher.frame(previousPage, m_canvas->size());
+            QPixmap oldPage;
+            if (!oldFrame.isNull() && KPrSlidePrefetcher::isStatic(previousPage)) {
+                oldPage = QPixmap::fromImage(oldFrame);
+            } else {
+                oldPage = QPixmap(m_canvas->size());
+                m_canvas->render(&oldPage);
+            }
 
             updateActivePage(m_pages[m_pageIndex]);
             updatePageAnimation();
             updateStepAnimation();
-            QPixmap newPage(m_canvas->size());
-            newPage.fill(Qt::white); // TODO
-            QPainter newPainter(&newPage);
-            newPainter.setClipRect(m_pageRect);
-            newPainter.setRenderHint(QPainter::Antialiasing);
-            paintStep(newPainter);
+            const QImage newFrame = m_slidePrefetcher.frame(m_pages[m_pageIndex], m_canvas->size());
+            QPixmap newPage;
+            if (!newFrame.isNull() && KPrSlidePrefetcher::isStatic(m_pages[m_pageIndex])) {
+                newPage = QPixmap::fromImage(newFrame);
+            } else {
+                newPage = QPixmap(m_canvas->size());
+                newPage.fill(Qt::white); // TODO
+                QPainter newPainter(&newPage);
+                newPainter.setClipRect(m_pageRect);
+                newPainter.setRenderHint(QPainter::Antialiasing);
+                paintStep(newPainter);
+            }
 
             m_state = EntryEffectState;
             m_pageEffectRunner = new KPrPageEffectRunner(oldPage, newPage, m_canvas, effect);
@@ -517,6 +559,10 @@ void KPrAnimationDirector::finishAnimations()
     m_animationCache->endStep(m_stepIndex);
     m_canvas->update();
     m_state = PresentationState;
+    // the time line is stopped by the callers after this
+    if (m_prefetchPending) {
+        QTimer::singleShot(0, this, &KPrAnimationDirector::prefetchPendingPages);
+    }
 }
 
 void KPrAnimationDirector::startTimeLine(int duration)
@@ -562,6 +608,9 @@ void KPrAnimationDirector::slotTimelineFinished()
         }
         break;
     }
+    if (m_prefetchPending) {
+        QTimer::singleShot(0, this, &KPrAnimationDirector::prefetchPendingPages);
+    }
 }
 
 void KPrAnimationDirector::deactivate()
@@ -29,6 +29,7 @@
 #include <QTransform>
 
 #include "KPrShapeAnimations.h"
+#include "KPrSlidePrefetcher.h"
 #include <KoZoomHandler.h>
 
 class QPainter;
@@ -158,6 +159,11 @@ protected:
     void updatePageAnimation();
     void updateStepAnimation();
 
+    /// Prerender the current and the neighbouring pages for the page effects
+    void prefetchPages();
+    /// Does the prerendering requested by prefetchPages() if no effect or animation is running
+    void prefetchPendingPages();
+
 protected Q_SLOTS:
     // update the zoom value
     void updateZoom(const QSize &size);
@@ -188,6 +194,8 @@ private:
 
     State m_state;
     QTimer m_autoTransitionTimer;
+    KPrSlidePrefetcher m_slidePrefetcher;
+    bool m_prefetchPending;
 };
 
 #endif /* KPRANIMATIONDIRECTOR_H */
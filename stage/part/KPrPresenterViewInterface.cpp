@@ -18,17 +18,22 @@
 
 #include <KoPACanvas.h>
 #include <KoPAPageBase.h>
+#include <KoPAUtil.h>
 #include <KoShape.h>
 #include <KoTextShapeData.h>
+#include <KoZoomHandler.h>
 
 #include "KPrEndOfSlideShowPage.h"
 #include "KPrNotes.h"
 #include "KPrPage.h"
+#include "KPrSlidePrefetcher.h"
 #include "StageDebug.h"
 
 KPrPresenterViewInterface::KPrPresenterViewInterface(const QList<KoPAPageBase *> &pages, KoPACanvas *canvas, QWidget *parent)
     : KPrPresenterViewBaseInterface(pages, parent)
     , m_canvas(canvas)
+    , m_slidePrefetcher(new KPrSlidePrefetcher(this))
+    , m_nextPage(nullptr)
 {
     QVBoxLayout *vLayout = new QVBoxLayout;
     QHBoxLayout *hLayout = new QHBoxLayout;
@@ -62,6 +67,12 @@ KPrPresenterViewInterface::KPrPresenterViewInterface(const QList<KoPAPageBase *>
     vLayout->addWidget(m_notesTextEdit);
 
     setLayout(vLayout);
+
+    connect(m_slidePrefetcher, &KPrSlidePrefetcher::frameReady, this, [this](KoPAPageBase *page, const QSize &size) {
+        if (page == m_nextPage && size == previewSize(page)) {
+            m_nextSlidePreview->setPixmap(QPixmap::fromImage(m_slidePrefetcher->frame(page, size)));
+        }
+    });
 }
 
 void KPrPresenterViewInterface::setActivePage(int pageIndex)
@@ -76,8 +87,9 @@ void KPrPresenterViewInterface::setActivePage(int pageIndex)
     KoPAPageBase *nextPage = nullptr;
     if (pageIndex != pageCount) {
         nextPage = m_pages.at(pageIndex + 1);
-        m_nextSlidePreview->setPixmap(nextPage->thumbnail(m_previewSize));
+        setNextSlidePreview(nextPage);
     } else { // End of presentation, just a black pixmap for the next slide preview
+        m_nextPage = nullptr;
         QPixmap pixmap(m_previewSize);
         pixmap.fill(Qt::black);
         m_nextSlidePreview->setPixmap(pixmap);
@@ -110,5 +122,36 @@ void KPrPresenterViewInterface::setPreviewSize(const QSize &size)
     } else {
         nextPage = m_pages.at(m_activePage);
     }
-    m_nextSlidePreview->setPixmap(nextPage->thumbnail(m_previewSize));
+    m_slidePrefetcher->clear();
+    setNextSlidePreview(nextPage);
+}
+
+void KPrPresenterViewInterface::setNextSlidePreview(KoPAPageBase *page)
+{
+    m_nextPage = page;
+    const QSize size = previewSize(page);
+    const QImage frame = m_slidePrefetcher->frame(page, size);
+    if (!frame.isNull()) {
+        m_nextSlidePreview->setPixmap(QPixmap::fromImage(frame));
+    } else {
+        // until the frame is rendered
+        m_nextSlidePreview->setPixmap(page->thumbnail(m_previewSize));
+        m_slidePrefetcher->prefetch(page, size);
+    }
+
+    // the slide after it is the next one to preview when going forward
+    const int index = m_pages.indexOf(page);
+    if (index >= 0 && index + 1 < m_pages.count()) {
+        KoPAPageBase *afterNextPage = m_pages.at(index + 1);
+        m_slidePrefetcher->prefetch(afterNextPage, previewSize(afterNextPage));
+    }
+}
+
+QSize KPrPresenterViewInterface::previewSize(KoPAPageBase *page) const
+{
+    // the same size as KoPAPageBase::thumbnail() uses
+    KoZoomHandler zoomHandler;
+    QSizeF size(m_previewSize);
+    KoPAUtil::setSizeAndZoom(page->pageLayout(), size, zoomHandler);
+    return size.toSize();
 }
@@ -16,6 +16,7 @@ class QTextEdit;
 
 class KoPACanvas;
 class KoPAPageBase;
+class KPrSlidePrefetcher;
 
 /**
  * KPrPresenterViewInterface
@@ -35,12 +36,19 @@ public Q_SLOTS:
     void setActivePage(int pageIndex) override;
 
 private:
+    /// Show @p page as next slide, prerendering it and the one after it if not done yet
+    void setNextSlidePreview(KoPAPageBase *page);
+    /// Returns the size of the preview of @p page, it has the aspect ratio of the page
+    QSize previewSize(KoPAPageBase *page) const;
+
     KoPACanvas *m_canvas;
     QLabel *m_currentSlideLabel;
     QLabel *m_nextSlideLabel;
     QLabel *m_nextSlidePreview;
     QTextEdit *m_notesTextEdit;
     QSize m_previewSize;
+    KPrSlidePrefetcher *m_slidePrefetcher;
+    KoPAPageBase *m_nextPage;
 };
 
 #endif
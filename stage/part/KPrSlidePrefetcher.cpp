@@ -0,0 +1,143 @@
+/* This file is part of the KDE project
+ * SPDX-FileCopyrightText: 2026 Calligra developers
+ *
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ */
+
+#include "KPrSlidePrefetcher.h"
+
+#include <QPainter>
+#include <QPicture>
+#include <QRunnable>
+#include <QThreadPool>
+
+#include <KoPAMasterPage.h>
+#include <KoPAPage.h>
+#include <KoPAUtil.h>
+#include <KoShapeContainer.h>
+#include <KoZoomHandler.h>
+
+#include "KPrPage.h"
+
+#include <functional>
+
+// the memory budget for the frames in kilobytes, enough for a few full screen slides
+static const int MAX_FRAME_CACHE_SIZE = 128 * 1024;
+
+/// Rasterizes a recorded slide on the thread pool of the KPrSlidePrefetcher
+class KPrSlideRenderJob : public QRunnable
+{
+public:
+    KPrSlideRenderJob(KPrSlidePrefetcher *prefetcher, const QPicture &picture, const QSize &size)
+        : m_prefetcher(prefetcher)
+        , m_picture(picture)
+        , m_size(size)
+    {
+    }
+
+    void run() override
+    {
+        QImage image(m_size, QImage::Format_RGB32);
+        image.fill(Qt::black);
+        QPainter painter(&image);
+        m_picture.play(&painter);
+        painter.end();
+        QMetaObject::invokeMethod(m_prefetcher, std::bind(finished, image), Qt::QueuedConnection);
+    }
+
+    /// called on the thread of the prefetcher with the rendered image
+    std::function<void(const QImage &)> finished;
+
+private:
+    KPrSlidePrefetcher *m_prefetcher;
+    QPicture m_picture;
+    QSize m_size;
+};
+
+static void waitUntilReady(const QList<KoShape *> &shapes, const KoViewConverter &converter)
+{
+    foreach (KoShape *shape, shapes) {
+        shape->waitUntilReady(converter, false);
+        if (KoShapeContainer *container = dynamic_cast<KoShapeContainer *>(shape)) {
+            waitUntilReady(container->shapes(), converter);
+        }
+    }
+}
+
+KPrSlidePrefetcher::KPrSlidePrefetcher(QObject *parent)
+    : QObject(parent)
+    , m_frames(MAX_FRAME_CACHE_SIZE)
+    , m_pool(new QThreadPool(this))
+{
+}
+
+KPrSlidePrefetcher::~KPrSlidePrefetcher()
+{
+    // renderings finishing now can't reach us anymore, as their queued calls die with us
+    m_pool->clear();
+    m_pool->waitForDone();
+}
+
+void KPrSlidePrefetcher::prefetch(KoPAPageBase *page, const QSize &size)
+{
+    const Key key{page, size};
+    if (!page || size.isEmpty() || m_frames.contains(key) || m_pending.contains(key)) {
+        return;
+    }
+
+    KoZoomHandler zoomHandler;
+    const KoPageLayout pageLayout = page->pageLayout();
+    KoPAUtil::setZoom(pageLayout, size, zoomHandler);
+    const QRect pageRect = KoPAUtil::pageRect(pageLayout, size, zoomHandler);
+
+    waitUntilReady(page->shapes(), zoomHandler);
+    KoPAPage *paPage = dynamic_cast<KoPAPage *>(page);
+    if (paPage && paPage->displayMasterShapes()) {
+        waitUntilReady(paPage->masterPage()->shapes(), zoomHandler);
+    }
+
+    // the same as KPrAnimationDirector::paintStep() paints, with all shapes shown
+    QPicture picture;
+    QPainter recorder(&picture);
+    recorder.fillRect(pageRect, Qt::white);
+    recorder.setClipRect(pageRect);
+    recorder.translate(pageRect.topLeft());
+    recorder.setRenderHint(QPainter::Antialiasing);
+    page->paintPage(recorder, zoomHandler);
+    recorder.end();
+
+    KPrSlideRenderJob *job = new KPrSlideRenderJob(this, picture, size);
+    job->finished = [this, key](const QImage &image) {
+        renderFinished(key, image);
+    };
+    m_pending.insert(key);
+    m_pool->start(job);
+}
+
+QImage KPrSlidePrefetcher::frame(KoPAPageBase *page, const QSize &size) const
+{
+    QImage *image = m_frames.object(Key{page, size});
+    return image ? *image : QImage();
+}
+
+bool KPrSlidePrefetcher::isStatic(KoPAPageBase *page)
+{
+    KPrPage *prPage = dynamic_cast<KPrPage *>(page);
+    return prPage && prPage->animations().steps().isEmpty();
+}
+
+void KPrSlidePrefetcher::clear()
+{
+    // renderings still running are dropped when they finish
+    m_pending.clear();
+    m_frames.clear();
+}
+
+void KPrSlidePrefetcher::renderFinished(const Key &key, const QImage &image)
+{
+    if (!m_pending.remove(key)) {
+        return; // cleared in between
+    }
+    m_frames.insert(key, new QImage(image), qMax<qsizetype>(1, image.sizeInBytes() / 1024));
+    Q_EMIT frameReady(key.page, key.size);
+}
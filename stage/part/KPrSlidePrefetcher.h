@@ -0,0 +1,78 @@
+/* This file is part of the KDE project
+ * SPDX-FileCopyrightText: 2026 Calligra developers
+ *
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ */
+
+#ifndef KPRSLIDEPREFETCHER_H
+#define KPRSLIDEPREFETCHER_H
+
+#include <QCache>
+#include <QImage>
+#include <QObject>
+#include <QSet>
+#include <QSize>
+
+#include "stage_export.h"
+
+class QThreadPool;
+class KoPAPageBase;
+
+/**
+ * Renders the slides of a presentation ahead of time, so changing to them does not
+ * have to wait for their shapes to be painted.
+ *
+ * A frame shows a slide the way the presentation does: scaled to fit the size of the
+ * frame, centered and surrounded by black. What the shapes paint is recorded in a
+ * QPicture on the GUI thread, as the shapes are not thread-safe, and replayed into the
+ * frame on a thread pool. frameReady() is emitted once a frame can be taken.
+ *
+ * The frames show all the shapes of a slide, so for slides with shape animations they
+ * only match the slide outside of the presentation.
+ */
+class STAGE_TEST_EXPORT KPrSlidePrefetcher : public QObject
+{
+    Q_OBJECT
+public:
+    explicit KPrSlidePrefetcher(QObject *parent = nullptr);
+    ~KPrSlidePrefetcher() override;
+
+    /// Render the frame of @p page at @p size in the background, unless that is done already
+    void prefetch(KoPAPageBase *page, const QSize &size);
+
+    /// Returns the frame of @p page at @p size, or a null image if it is not rendered (yet)
+    QImage frame(KoPAPageBase *page, const QSize &size) const;
+
+    /// Returns true if @p page has no shape animations, i.e. its frame shows it at every step
+    static bool isStatic(KoPAPageBase *page);
+
+    void clear();
+
+Q_SIGNALS:
+    /// emitted once the frame of @p page at @p size got rendered
+    void frameReady(KoPAPageBase *page, const QSize &size);
+
+private:
+    struct Key {
+        KoPAPageBase *page;
+        QSize size;
+
+        bool operator==(const Key &other) const
+        {
+            return page == other.page && size == other.size;
+        }
+    };
+    friend size_t qHash(const Key &key, size_t seed)
+    {
+        return qHashMulti(seed, key.page, key.size.width(), key.size.height());
+    }
+
+    void renderFinished(const Key &key, const QImage &image);
+
+    QCache<Key, QImage> m_frames;
+    QSet<Key> m_pending;
+    QThreadPool *m_pool;
+    friend class TestSlidePrefetcher;
+};
+
+#endif /* KPRSLIDEPREFETCHER_H */
@@ -0,0 +1,132 @@
+/* This file is part of the KDE project
+ * SPDX-FileCopyrightText: 2026 Calligra developers
+ *
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ */
+
+#include "TestSlidePrefetcher.h"
+
+#include "KPrPage.h"
+#include "KPrShapeAnimations.h"
+#include "KPrSlidePrefetcher.h"
+#include "KoPAMasterPage.h"
+#include "KoPAPage.h"
+#include "MockShapeAnimation.h"
+#include "PAMock.h"
+#include <MockShapes.h>
+
+#include <QTest>
+#include <QThreadPool>
+
+// a master page with a slide of 400x300 points
+static KoPAMasterPage *createMasterPage(MockDocument *doc)
+{
+    KoPAMasterPage *master = new KoPAMasterPage();
+    KoPageLayout layout = master->pageLayout();
+    layout.width = 400;
+    layout.height = 300;
+    master->setPageLayout(layout);
+    doc->insertPage(master, 0);
+    return master;
+}
+
+void TestSlidePrefetcher::prefetch()
+{
+    MockDocument doc;
+    KoPAMasterPage *master = createMasterPage(&doc);
+    KPrPage *page = new KPrPage(master, &doc);
+    doc.insertPage(page, 0);
+
+    KPrSlidePrefetcher prefetcher;
+    QList<QSize> ready;
+    connect(&prefetcher, &KPrSlidePrefetcher::frameReady, this, [&ready, page](KoPAPageBase *readyPage, const QSize &size) {
+        if (readyPage == page) {
+            ready << size;
+        }
+    });
+
+    const QSize size(400, 150);
+    prefetcher.prefetch(page, size);
+    // a second request while it is rendered does not render it again
+    prefetcher.prefetch(page, size);
+    QVERIFY(prefetcher.frame(page, size).isNull());
+
+    QTRY_COMPARE(ready.count(), 1);
+    QCOMPARE(ready.first(), size);
+    const QImage frame = prefetcher.frame(page, size);
+    QVERIFY(!frame.isNull());
+    QCOMPARE(frame.size(), size);
+    // the slide is scaled to fit, centered and surrounded by black
+    QCOMPARE(frame.pixel(20, 75), qRgb(0, 0, 0));
+    QCOMPARE(frame.pixel(200, 75), qRgb(255, 255, 255));
+    QCOMPARE(frame.pixel(380, 75), qRgb(0, 0, 0));
+
+    // other sizes are separate frames
+    QVERIFY(prefetcher.frame(page, QSize(200, 150)).isNull());
+
+    // a rendered frame is not rendered again
+    prefetcher.prefetch(page, size);
+    prefetcher.m_pool->waitForDone();
+    QCoreApplication::processEvents();
+    QCOMPARE(ready.count(), 1);
+}
+
+void TestSlidePrefetcher::clear()
+{
+    MockDocument doc;
+    KoPAMasterPage *master = createMasterPage(&doc);
+    KPrPage *page = new KPrPage(master, &doc);
+    doc.insertPage(page, 0);
+
+    KPrSlidePrefetcher prefetcher;
+    int ready = 0;
+    connect(&prefetcher, &KPrSlidePrefetcher::frameReady, this, [&ready]() {
+        ++ready;
+    });
+
+    // the rendering in progress is dropped when it finishes
+    const QSize size(200, 150);
+    prefetcher.prefetch(page, size);
+    prefetcher.clear();
+    prefetcher.m_pool->waitForDone();
+    // the result is handed over by a queued call
+    QCoreApplication::processEvents();
+    QCOMPARE(ready, 0);
+    QVERIFY(prefetcher.frame(page, size).isNull());
+
+    // and it can be requested again
+    prefetcher.prefetch(page, size);
+    QTRY_COMPARE(ready, 1);
+    QVERIFY(!prefetcher.frame(page, size).isNull());
+
+    // rendered frames are dropped too
+    prefetcher.clear();
+    QVERIFY(prefetcher.frame(page, size).isNull());
+}
+
+void TestSlidePrefetcher::isStatic()
+{
+    MockDocument doc;
+    KoPAMasterPage *master = createMasterPage(&doc);
+    KPrPage *page = new KPrPage(master, &doc);
+    doc.insertPage(page, 0);
+    QVERIFY(KPrSlidePrefetcher::isStatic(page));
+
+    // with shape animations the frame does not match every step
+    MockShape *shape = new MockShape();
+    shape->setSize(QSizeF(100, 100));
+    page->addShape(shape);
+    MockShapeAnimation *animation = new MockShapeAnimation(shape, nullptr);
+    animation->setPresetClass(KPrShapeAnimation::Entrance);
+    page->animations().add(animation);
+    QVERIFY(!page->animations().steps().isEmpty());
+    QVERIFY(!KPrSlidePrefetcher::isStatic(page));
+
+    // only pages of presentations have animations that are known
+    KoPAPage *paPage = new KoPAPage(master);
+    doc.insertPage(paPage, 0);
+    QVERIFY(!KPrSlidePrefetcher::isStatic(paPage));
+    QVERIFY(!KPrSlidePrefetcher::isStatic(nullptr));
+}
+
+QTEST_MAIN(TestSlidePrefetcher)
@@ -0,0 +1,21 @@
+/* This file is part of the KDE project
+ * SPDX-FileCopyrightText: 2026 Calligra developers
+ *
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ */
+
+#ifndef TESTSLIDEPREFETCHER_H
+#define TESTSLIDEPREFETCHER_H
+
+#include <QObject>
+
+class TestSlidePrefetcher : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void prefetch();
+    void clear();
+    void isStatic();
+};
+
+#endif // TESTSLIDEPREFETCHER_H
@@ -29,6 +29,8 @@ KWApplicationConfig::KWApplicationConfig()
     , m_statusBarShowZoom(true)
     , m_statusBarShowWordCount(false)
     , m_showInlineObjectVisualization(true)
+    , m_pageCacheEnabled(false)
+    , m_pageCacheSize(50)
     , m_zoom(100)
     , m_zoomMode(KoZoomMode::ZOOM_WIDTH)
     , m_autoSaveSeconds(KoDocument::defaultAutoSave())
@@ -59,6 +61,9 @@ void KWApplicationConfig::load(KWDocument *document)
 
     m_viewFrameBorders = interface.readEntry("ViewFrameBorders", m_viewFrameBorders);
 
+    m_pageCacheEnabled = interface.readEntry("PageCache", m_pageCacheEnabled);
+    m_pageCacheSize = interface.readEntry("PageCacheSize", m_pageCacheSize);
+
     m_zoom = interface.readEntry("Zoom", m_zoom);
     m_zoomMode = static_cast<KoZoomMode::Mode>(interface.readEntry("ZoomMode", (int)m_zoomMode));
 
@@ -125,6 +130,8 @@ void KWApplicationConfig::save()
     interface.writeEntry("ViewTableBorders", m_showTableBorders);
     interface.writeEntry("ViewSectionBounds", m_showSectionBounds);
     interface.writeEntry("ViewFrameBorders", m_viewFrameBorders);
+    interface.writeEntry("PageCache", m_pageCacheEnabled);
+    interface.writeEntry("PageCacheSize", m_pageCacheSize);
     interface.writeEntry("Zoom", m_zoom);
     interface.writeEntry("ZoomMode", (int)m_zoomMode);
     //    interface.writeEntry("showDocStruct", m_bShowDocStruct);
@@ -198,6 +198,31 @@ public:
         return m_zoomMode;
     }
 
+    /**
+     * Set if the canvases keep the rendered pages in a cache, which is rendered on
+     * worker threads. Only used for new canvases.
+     */
+    void setPageCacheEnabled(bool on)
+    {
+        m_pageCacheEnabled = on;
+    }
+
+    bool pageCacheEnabled() const
+    {
+        return m_pageCacheEnabled;
+    }
+
+    /// Set the maximum memory used by the page cache of a canvas in megabytes
+    void setPageCacheSize(int megabytes)
+    {
+        m_pageCacheSize = megabytes;
+    }
+
+    int pageCacheSize() const
+    {
+        return m_pageCacheSize;
+    }
+
     qreal defaultColumnSpacing() const
     {
         return m_defaultColumnSpacing;
@@ -217,6 +242,8 @@ private:
     bool m_statusBarShowMouse, m_statusBarShowZoom;
     bool m_statusBarShowWordCount;
     bool m_showInlineObjectVisualization;
+    bool m_pageCacheEnabled;
+    int m_pageCacheSize; /// < in megabytes
 
     int m_zoom; /// < zoom level in percent
     KoZoomMode::Mode m_zoomMode;
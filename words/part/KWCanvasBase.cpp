@@ -35,7 +35,9 @@
 #include <QBrush>
 #include <QPainter>
 #include <QPainterPath>
+#include <QPicture>
 #include <QThread>
+#include <QTimer>
 
 #include <sys/time.h>
 
@@ -53,10 +55,11 @@ KWCanvasBase::KWCanvasBase(KWDocument *document, QObject *parent)
     , m_currentZoom(0.0)
     , m_maxZoom(2.0)
     , m_pageCacheManager(nullptr)
+    , m_cacheSize(50)
 {
     m_shapeManager = new KoShapeManager(this);
     m_toolProxy = new KoToolProxy(this, parent);
-    // setCacheEnabled(true);
+    setCacheEnabled(document->config().pageCacheEnabled(), document->config().pageCacheSize());
 }
 
 KWCanvasBase::~KWCanvasBase()
@@ -223,6 +226,31 @@ void KWCanvasBase::paintGrid(QPainter &painter, KWViewMode::ViewMap &vm)
     painter.restore();
 }
 
+// Split a page of the given size into the rects which are rendered independently
+static QVector<QRect> exposedRects(const QSize &pageSize)
+{
+    const int UPDATE_WIDTH = 900;
+    const int UPDATE_HEIGHT = 128;
+
+    QVector<QRect> exposed;
+    int row = 0;
+    int heightLeft = pageSize.height();
+    while (heightLeft > 0) {
+        int height = qMin(heightLeft, UPDATE_HEIGHT);
+        int column = 0;
+        int columnLeft = pageSize.width();
+        while (columnLeft > 0) {
+            int width = qMin(columnLeft, UPDATE_WIDTH);
+            exposed << QRect(column, row, width, height);
+            columnLeft -= width;
+            column += width;
+        }
+        heightLeft -= height;
+        row += height;
+    }
+    return exposed;
+}
+
 void KWCanvasBase::paint(QPainter &painter, const QRectF &paintRect)
 {
     painter.translate(-m_documentOffset);
@@ -277,6 +305,7 @@ void KWCanvasBase::paint(QPainter &painter, const QRectF &paintRect)
             if (viewConverter()->zoom() <= m_maxZoom) { // we cache at the actual zoom level
 #endif
             QVector<KWViewMode::ViewMap> map = m_viewMode->mapExposedRects(paintRect.translated(m_documentOffset), viewConverter());
+            QList<KWPage> visiblePages;
 
             foreach (KWViewMode::ViewMap vm, map) {
                 painter.save();
@@ -296,18 +325,18 @@ void KWCanvasBase::paint(QPainter &painter, const QRectF &paintRect)
                 // Paint the contents of the page.
                 painter.setRenderHint(QPainter::Antialiasing);
 
-                // clear the cache if the zoom changed
-                qreal zoom = viewConverter()->zoom();
-                if (m_currentZoom != zoom) {
-                    m_pageCacheManager->clear();
-                    m_currentZoom = zoom;
-                }
+                // the cache keeps the pages of other zoom levels too, as placeholders
+                const qreal zoom = viewConverter()->zoom();
+                m_currentZoom = zoom;
 
-                KWPageCache *pageCache = m_pageCacheManager->take(vm.page);
+                KWPageCache *pageCache = m_pageCacheManager->take(vm.page, zoom);
 
                 if (!pageCache) {
                     pageCache =
                         m_pageCacheManager->cache(QSize(viewConverter()->documentToViewX(vm.page.width()), viewConverter()->documentToViewY(vm.page.height())));
+                    if (const KWPageCache *placeholder = m_pageCacheManager->placeholder(vm.page, zoom)) {
+                        pageCache->fillFrom(*placeholder);
+                    }
                 }
 
                 Q_ASSERT(!pageCache->cache.isEmpty());
@@ -330,33 +359,13 @@ void KWCanvasBase::paint(QPainter &painter, const QRectF &paintRect)
                 // need painting, because updateCanvas is not called when a page is done
                 // layouting.
                 if (pageCache->allExposed) {
-                    pageCache->exposed.clear();
-                    QRect rc(QPoint(0, 0), pageSizeView.toSize());
-
-                    const int UPDATE_WIDTH = 900;
-                    const int UPDATE_HEIGHT = 128;
-
-                    int row = 0;
-                    int heightLeft = rc.height();
-                    while (heightLeft > 0) {
-                        int height = qMin(heightLeft, UPDATE_HEIGHT);
-                        int column = 0;
-                        int columnLeft = rc.width();
-                        while (columnLeft > 0) {
-                            int width = qMin(columnLeft, UPDATE_WIDTH);
-                            QRect rc2(column, row, width, height);
-                            pageCache->exposed << rc2;
-                            columnLeft -= width;
-                            column += width;
-                        }
-                        heightLeft -= height;
-                        row += height;
-                    }
+                    pageCache->exposed = exposedRects(pageSizeView.toSize());
                     pageCache->allExposed = false;
                 }
 
                 // There is stuff to be repainted, so collect all the repaintable
-                // rects that are in view and paint them.
+                // rects that are in view and let them be rendered. Until that is
+                // done the previous content of the cache is shown.
                 if (!pageCache->exposed.isEmpty()) {
                     QRegion paintRegion;
                     QVector<QRect> remainingUnExposed;
@@ -366,58 +375,13 @@ void KWCanvasBase::paint(QPainter &painter, const QRectF &paintRect)
 
                         if (rc.intersects(clipRectOnPage.toRect())) {
                             paintRegion += rc;
-                            int tilex = 0, tiley = 0;
-                            for (int x = 0, i = 0; x < pageCache->m_tilesx; ++x) {
-                                int dx = pageCache->cache[i].width();
-                                for (int y = 0; y < pageCache->m_tilesy; ++y, ++i) {
-                                    QImage &img = pageCache->cache[i];
-                                    QRect tile(tilex, tiley, img.width(), img.height());
-                                    QRect toClear = tile.intersected(rc);
-                                    if (!toClear.isEmpty()) {
-                                        QPainter gc(&img);
-                                        gc.eraseRect(toClear.translated(-tilex, -tiley));
-                                        gc.end();
-                                    }
-                                    tiley += img.height();
-                                }
-                                tilex += dx;
-                                tiley = 0;
-                            }
                         } else {
                             remainingUnExposed << rc;
                         }
                     }
                     pageCache->exposed = remainingUnExposed;
                     if (!paintRegion.isEmpty()) {
-                        // paint the exposed regions of the page
-
-                        QRect r = paintRegion.boundingRect();
-                        QImage img(r.size(), QImage::Format_RGB16);
-                        img.fill(0xffff);
-
-                        // we paint to a small image as it is much faster the painting to the big image
-                        QPainter tilePainter(&img);
-                        tilePainter.setClipRect(QRect(QPoint(0, 0), r.size()));
-                        tilePainter.translate(-r.left(), -pageTopView - r.top());
-                        tilePainter.setRenderHint(QPainter::Antialiasing);
-                        shapeManager()->paint(tilePainter, *viewConverter(), false);
-
-                        int tilex = 0, tiley = 0;
-                        for (int x = 0, i = 0; x < pageCache->m_tilesx; ++x) {
-                            int dx = pageCache->cache[i].width();
-                            for (int y = 0; y < pageCache->m_tilesy; ++y, ++i) {
-                                QImage &tileImg = pageCache->cache[i];
-                                QRect tile(tilex, tiley, tileImg.width(), tileImg.height());
-                                QRect toPaint = tile.intersected(r);
-                                if (!toPaint.isEmpty()) {
-                                    QPainter imagePainter(&tileImg);
-                                    imagePainter.drawImage(r.topLeft() - QPoint(tilex, tiley), img);
-                                }
-                                tiley += tileImg.height();
-                            }
-                            tilex += dx;
-                            tiley = 0;
-                        }
+                        renderPage(vm.page, pageCache, paintRegion.boundingRect());
                     }
                 }
                 // paint from the cached page image on the original painter
@@ -439,7 +403,8 @@ void KWCanvasBase::paint(QPainter &painter, const QRectF &paintRect)
                 }
 
                 // put the cache back
-                m_pageCacheManager->insert(vm.page, pageCache);
+                m_pageCacheManager->insert(vm.page, zoom, pageCache);
+                visiblePages.append(vm.page);
                 // Paint the page decorations: border, shadow, etc.
                 paintPageDecorations(painter, vm);
 
@@ -455,6 +420,7 @@ void KWCanvasBase::paint(QPainter &painter, const QRectF &paintRect)
                     pageContentArea = contentArea;
                 }
             }
+            prefetchPages(visiblePages);
 #if 0
             }
             else { // we cache at 100%, but paint at the actual zoom level
@@ -621,16 +587,7 @@ void KWCanvasBase::paint(QPainter &painter, const QRectF &paintRect)
 void KWCanvasBase::updateCanvas(const QRectF &rc)
 {
     if (!m_cacheEnabled) { // no caching
-        QRectF zoomedRect = m_viewMode->documentToView(rc, viewConverter());
-        QVector<KWViewMode::ViewMap> map = m_viewMode->mapExposedRects(zoomedRect, viewConverter());
-        foreach (KWViewMode::ViewMap vm, map) {
-            vm.clipRect.adjust(-2, -2, 2, 2); // grow for anti-aliasing
-            QRect finalClip((int)(vm.clipRect.x() + vm.distance.x() - m_documentOffset.x()),
-                            (int)(vm.clipRect.y() + vm.distance.y() - m_documentOffset.y()),
-                            vm.clipRect.width(),
-                            vm.clipRect.height());
-            updateCanvasInternal(finalClip);
-        }
+        updateViewRect(rc);
     } else { // Caching at the actual zoom level
         if (viewConverter()->zoom() <= m_maxZoom) {
             QRectF zoomedRect = m_viewMode->documentToView(rc, viewConverter());
@@ -645,35 +602,13 @@ void KWCanvasBase::updateCanvas(const QRectF &rc)
                 if (!m_pageCacheManager) {
                     // no pageCacheManager, so create one for the current view. This happens only once!
                     // so on zoom change, we don't re-pre-generate weight/zoom images.
-                    m_pageCacheManager = new KWPageCacheManager(m_cacheSize);
+                    createPageCacheManager();
                 }
 
-                if (m_currentZoom != viewConverter()->zoom()) {
-                    m_currentZoom = viewConverter()->zoom();
-                    m_pageCacheManager->clear();
-                }
-
-                KWPageCache *pageCache = m_pageCacheManager->take(vm.page);
-                if (pageCache) {
-                    // if (rc.isNull()) {
-                    pageCache->allExposed = true;
-                    pageCache->exposed.clear();
-#if 0
-                    }
-                    else {
-                        qreal  pageTopDocument = vm.page.offsetInDocument();
-                        qreal  pageTopView = viewConverter()->documentToViewY(pageTopDocument);
-                        QRectF pageRectDocument = vm.page.rect();
-                        QRectF pageRectView = viewConverter()->documentToView(pageRectDocument);
+                m_currentZoom = viewConverter()->zoom();
 
-                        // translated from the page topleft to 0,0 for our cache image
-                        QRect clipRectOnPage = vm.clipRect.translated(-pageRectView.x(), -pageTopView);
-
-                        pageCache->exposed.append(clipRectOnPage);
-                    }
-#endif
-                    m_pageCacheManager->insert(vm.page, pageCache);
-                }
+                // the page needs to be rendered again at all zoom levels
+                m_pageCacheManager->invalidate(vm.page);
                 updateCanvasInternal(finalClip);
             }
         } else { // Cache at 100%, but update the canvas at the actual zoom level
@@ -709,35 +644,13 @@ void KWCanvasBase::updateCanvas(const QRectF &rc)
                 if (!m_pageCacheManager) {
                     // no pageCacheManager, so create one for the current view. This happens only once!
                     // so on zoom change, we don't re-pre-generate weight/zoom images.
-                    m_pageCacheManager = new KWPageCacheManager(m_cacheSize);
+                    createPageCacheManager();
                 }
 
-                if (m_currentZoom != 1.0) {
-                    m_pageCacheManager->clear();
-                    m_currentZoom = 1.0;
-                }
+                m_currentZoom = 1.0;
 
-                KWPageCache *pageCache = m_pageCacheManager->take(vm.page);
-                if (pageCache) {
-                    // if (rc.isNull()) {
-                    pageCache->allExposed = true;
-                    pageCache->exposed.clear();
-#if 0
-                    }
-                    else {
-                        qreal pageTopDocument = vm.page.offsetInDocument();
-                        qreal pageTopView = localViewConverter.documentToViewY(pageTopDocument);
-                        QRectF pageRectDocument = vm.page.rect();
-                        QRectF pageRectView = localViewConverter.documentToView(pageRectDocument);
-
-                        // translated from the page topleft to 0,0 for our cache image
-                        QRect clipRectOnPage = vm.clipRect.translated(-pageRectView.x(), -pageTopView);
-
-                        pageCache->exposed.append(clipRectOnPage);
-                    }
-#endif
-                    m_pageCacheManager->insert(vm.page, pageCache);
-                }
+                // the page needs to be rendered again at all zoom levels
+                m_pageCacheManager->invalidate(vm.page);
                 updateCanvasInternal(finalClip);
             }
         }
@@ -751,13 +664,88 @@ KoViewConverter *KWCanvasBase::viewConverter() const
 
 void KWCanvasBase::setCacheEnabled(bool enabled, int cacheSize, qreal maxZoom)
 {
-    if ((!m_pageCacheManager && enabled) || (m_cacheSize != cacheSize)) {
-        delete m_pageCacheManager;
-        m_pageCacheManager = new KWPageCacheManager(cacheSize);
-    }
+    const bool recreate = (!m_pageCacheManager && enabled) || (m_cacheSize != cacheSize);
     m_cacheEnabled = enabled;
     m_cacheSize = cacheSize;
     m_maxZoom = maxZoom;
+    if (recreate) {
+        createPageCacheManager();
+    }
+}
+
+void KWCanvasBase::createPageCacheManager()
+{
+    delete m_pageCacheManager;
+    m_pageCacheManager = new KWPageCacheManager(m_cacheSize);
+    QObject::connect(m_pageCacheManager, &KWPageCacheManager::pageRendered, m_pageCacheManager, [this](const KWPage &page, qreal zoom, const QRect &rect) {
+        pageRendered(page, zoom, rect);
+    });
+}
+
+void KWCanvasBase::updateViewRect(const QRectF &rc)
+{
+    QRectF zoomedRect = m_viewMode->documentToView(rc, viewConverter());
+    QVector<KWViewMode::ViewMap> map = m_viewMode->mapExposedRects(zoomedRect, viewConverter());
+    foreach (KWViewMode::ViewMap vm, map) {
+        vm.clipRect.adjust(-2, -2, 2, 2); // grow for anti-aliasing
+        QRect finalClip((int)(vm.clipRect.x() + vm.distance.x() - m_documentOffset.x()),
+                        (int)(vm.clipRect.y() + vm.distance.y() - m_documentOffset.y()),
+                        vm.clipRect.width(),
+                        vm.clipRect.height());
+        updateCanvasInternal(finalClip);
+    }
+}
+
+void KWCanvasBase::renderPage(const KWPage &page, KWPageCache *pageCache, const QRect &rect)
+{
+    const qreal pageTopView = viewConverter()->documentToViewY(page.offsetInDocument());
+
+    // The shapes can only be painted on this thread, but recording what they paint is cheap
+    // compared to rasterizing it, which is left to the thread pool of the cache manager.
+    QPicture picture;
+    QPainter recorder(&picture);
+    recorder.setClipRect(QRect(QPoint(0, 0), rect.size()));
+    recorder.translate(-rect.left(), -pageTopView - rect.top());
+    recorder.setRenderHint(QPainter::Antialiasing);
+    shapeManager()->paint(recorder, *viewConverter(), false);
+    recorder.end();
+
+    m_pageCacheManager->render(page, viewConverter()->zoom(), pageCache, rect, picture);
+}
+
+void KWCanvasBase::prefetchPages(const QList<KWPage> &visiblePages)
+{
+    if (visiblePages.isEmpty()) {
+        return;
+    }
+    const qreal zoom = viewConverter()->zoom();
+
+    QTimer::singleShot(0, m_pageCacheManager, [this, visiblePages, zoom]() {
+        if (!m_cacheEnabled || viewConverter()->zoom() != zoom) {
+            return;
+        }
+        foreach (const KWPage &page, m_pageCacheManager->pagesToPrefetch(visiblePages, zoom)) {
+            const QSize size(viewConverter()->documentToViewX(page.width()), viewConverter()->documentToViewY(page.height()));
+            KWPageCache *pageCache = m_pageCacheManager->cache(size);
+            if (const KWPageCache *placeholder = m_pageCacheManager->placeholder(page, zoom)) {
+                pageCache->fillFrom(*placeholder);
+            }
+            pageCache->allExposed = false;
+            renderPage(page, pageCache, QRect(QPoint(0, 0), size));
+            m_pageCacheManager->insert(page, zoom, pageCache);
+        }
+    });
+}
+
+void KWCanvasBase::pageRendered(const KWPage &page, qreal zoom, const QRect &rect)
+{
+    if (!m_cacheEnabled || !page.isValid() || zoom != viewConverter()->zoom()) {
+        return;
+    }
+    // repaint the canvas where the new content is, without invalidating the cache again
+    const QRectF pageRectView = viewConverter()->documentToView(page.rect());
+    const qreal pageTopView = viewConverter()->documentToViewY(page.offsetInDocument());
+    updateViewRect(viewConverter()->viewToDocument(QRectF(rect).translated(pageRectView.x(), pageTopView)));
 }
 
 QPoint KWCanvasBase::documentOffset() const
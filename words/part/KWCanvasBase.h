@@ -29,6 +29,7 @@ class QPainter;
 class KoToolProxy;
 class KoShape;
 class KoViewConverter;
+class KWPageCache;
 class KWPageCacheManager;
 
 class WORDS_EXPORT KWCanvasBase : public KoCanvasBase
@@ -77,14 +78,15 @@ public: // KoCanvasBase interface methods.
     void ensureVisible(const QRectF &rect) override;
 
     /**
-     * Enable or disable the page cache. The cache stores the rendered pages. It is
-     * emptied when the zoomlevel changes.
+     * Enable or disable the page cache. The cache stores the rendered pages, also
+     * of previously used zoomlevels which serve as placeholders until a page got
+     * rendered at the current zoomlevel. The rendering happens on worker threads,
+     * and the pages next to the visible ones are rendered in advance.
      *
      * @param enabled: if true, we cache the contents of the document for this canvas,
      *  for the current zoomlevel
-     * @param cacheSize: the maximum size for the cache. The cache will throw away
-     *  pages once this size is reached. Depending on Qt's implementation of QCache, the
-     *  unit is pages.
+     * @param cacheSize: the maximum size for the cache in megabytes. The cache will throw
+     *  away the least recently used pages once this size is reached.
      * @param maxZoom above this zoomlevel we'll paint a scaled version of the cache, instead
      *  of creating a new cache
      */
@@ -131,6 +133,16 @@ protected:
 
     virtual void updateCanvasInternal(const QRectF &clip) = 0;
 
+private:
+    void createPageCacheManager();
+    /// update the canvas for the document rect @p rc, without touching the page cache
+    void updateViewRect(const QRectF &rc);
+    /// let @p rect (in page coordinates) of the cache of @p page be rendered
+    void renderPage(const KWPage &page, KWPageCache *pageCache, const QRect &rect);
+    /// render the pages next to the visible ones in advance
+    void prefetchPages(const QList<KWPage> &visiblePages);
+    void pageRendered(const KWPage &page, qreal zoom, const QRect &rect);
+
 protected:
     KWDocument *m_document;
     KoShapeManager *m_shapeManager;
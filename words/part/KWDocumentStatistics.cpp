@@ -11,6 +11,7 @@
 #include "frames/KWTextFrameSet.h"
 
 #include <QDebug>
+#include <QHash>
 #include <QMetaMethod>
 #include <QPointer>
 #include <QRegularExpression>
@@ -18,10 +19,41 @@
 #include <QTextDocument>
 #include <QTimer>
 
+// the statistics of a single paragraph, the lines are taken from the layout every time
+struct KWBlockStatistics {
+    int revision = -1;
+    int length = -1;
+    quint64 generation = 0;
+    int charsWithSpace = 0;
+    int charsWithoutSpace = 0;
+    int words = 0;
+    int sentences = 0;
+    int syllables = 0;
+    int cjkChars = 0;
+
+    void add(const KWBlockStatistics &other, int sign)
+    {
+        charsWithSpace += sign * other.charsWithSpace;
+        charsWithoutSpace += sign * other.charsWithoutSpace;
+        words += sign * other.words;
+        sentences += sign * other.sentences;
+        syllables += sign * other.syllables;
+        cjkChars += sign * other.cjkChars;
+    }
+};
+
+// the cached statistics of all paragraphs of a text document, and their sum
+struct KWTextDocumentStatistics {
+    QHash<int, KWBlockStatistics> blocks; // by QTextBlock::fragmentIndex()
+    KWBlockStatistics total;
+    quint64 generation = 0;
+};
+
 class KWDocumentStatisticsPrivate
 {
 public:
     KWDocument *document;
+    QHash<const QTextDocument *, KWTextDocumentStatistics> documents;
     QTimer *timer;
     bool running;
     int charsWithSpace;
@@ -163,6 +195,7 @@ void KWDocumentStatistics::updateData()
     d->running = true;
     reset();
 
+    QHash<const QTextDocument *, KWTextDocumentStatistics> documents;
     foreach (KWFrameSet *fs, d->document->frameSets()) {
         QPointer<KWTextFrameSet> tfs = dynamic_cast<KWTextFrameSet *>(fs);
         if (!tfs)
@@ -171,13 +204,60 @@ void KWDocumentStatistics::updateData()
         QPointer<QTextDocument> doc = tfs->document();
         if (!doc)
             continue;
-        computeStatistics(*doc);
+        // only the paragraphs changed since the last update are counted again
+        KWTextDocumentStatistics statistics = d->documents.take(doc);
+        computeStatistics(*doc, statistics);
+        d->charsWithSpace += statistics.total.charsWithSpace;
+        d->charsWithoutSpace += statistics.total.charsWithoutSpace;
+        d->words += statistics.total.words;
+        d->sentences += statistics.total.sentences;
+        d->syllables += statistics.total.syllables;
+        d->cjkChars += statistics.total.cjkChars;
+        documents.insert(doc, statistics);
     }
+    // forget about the documents of removed frame sets
+    d->documents = documents;
     Q_EMIT refreshed();
     d->running = false;
 }
 
-void KWDocumentStatistics::computeStatistics(const QTextDocument &doc)
+void KWDocumentStatistics::computeStatistics(const QTextDocument &doc, KWTextDocumentStatistics &statistics)
+{
+    const quint64 generation = ++statistics.generation;
+    QTextBlock block = doc.begin();
+    while (block.isValid()) {
+        d->paragraphs += 1;
+        if (block.layout()) {
+            d->lines += block.layout()->lineCount();
+        }
+
+        // the revision of a block changes with every edit of it, the length guards against reused fragments
+        KWBlockStatistics &cached = statistics.blocks[block.fragmentIndex()];
+        if (cached.revision != block.revision() || cached.length != block.length()) {
+            // Don't be so heavy on large documents...
+            qApp->processEvents();
+            statistics.total.add(cached, -1);
+            cached = computeStatistics(block.text());
+            cached.revision = block.revision();
+            cached.length = block.length();
+            statistics.total.add(cached, 1);
+        }
+        cached.generation = generation;
+        block = block.next();
+    }
+
+    // and drop the paragraphs which are gone
+    for (auto it = statistics.blocks.begin(); it != statistics.blocks.end();) {
+        if (it->generation != generation) {
+            statistics.total.add(*it, -1);
+            it = statistics.blocks.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+KWBlockStatistics KWDocumentStatistics::computeStatistics(const QString &text)
 {
     // parts of words for better counting of syllables:
     // (only use reg exp if necessary -> speed up)
@@ -216,87 +296,78 @@ void KWDocumentStatistics::computeStatistics(const QTextDocument &doc)
     static QRegularExpression floatingPoint("\\d\\.\\d");
     static QRegularExpression acronyms("[A-Z]\\.+");
 
-    QTextBlock block = doc.begin();
-    while (block.isValid()) {
-        // Don't be so heavy on large documents...
-        qApp->processEvents();
-        d->paragraphs += 1;
-        d->charsWithSpace += block.text().length();
-        d->charsWithoutSpace += block.text().length() - block.text().count(QRegularExpression("\\s"));
-        if (block.layout()) {
-            d->lines += block.layout()->lineCount();
+    KWBlockStatistics statistics;
+    static QRegularExpression whitespace("\\s");
+    statistics.charsWithSpace = text.length();
+    statistics.charsWithoutSpace = text.length() - text.count(whitespace);
+    statistics.cjkChars = countCJKChars(text);
+
+    QString s = text;
+    // Syllable and Word count
+    // Algorithm mostly taken from Greg Fast's Lingua::EN::Syllable module for Perl.
+    // This guesses correct for 70-90% of English words, but the overall value
+    // is quite good, as some words get a number that's too high and others get
+    // one that's too low.
+    // IMPORTANT: please test any changes against the unit test
+    const QStringList wordlist = s.split(space, Qt::SkipEmptyParts);
+    statistics.words += wordlist.count();
+    for (QStringList::ConstIterator it1 = wordlist.begin(); it1 != wordlist.end(); ++it1) {
+        QString word = *it1;
+        word.remove(punctuation); // clean word from punctuation
+        if (word.length() <= 3) { // extension to the original algorithm
+            statistics.syllables++;
+            continue;
         }
-        d->cjkChars += countCJKChars(block.text());
-
-        QString s = block.text();
-
-        // Syllable and Word count
-        // Algorithm mostly taken from Greg Fast's Lingua::EN::Syllable module for Perl.
-        // This guesses correct for 70-90% of English words, but the overall value
-        // is quite good, as some words get a number that's too high and others get
-        // one that's too low.
-        // IMPORTANT: please test any changes against the unit test
-        const QStringList wordlist = s.split(space, Qt::SkipEmptyParts);
-        d->words += wordlist.count();
-        for (QStringList::ConstIterator it1 = wordlist.begin(); it1 != wordlist.end(); ++it1) {
-            QString word = *it1;
-            word.remove(punctuation); // clean word from punctuation
-            if (word.length() <= 3) { // extension to the original algorithm
-                d->syllables++;
-                continue;
+        word.remove(final_e);
+        const QStringList syls = word.split(vowels, Qt::SkipEmptyParts);
+        int word_syllables = 0;
+        for (QStringList::ConstIterator it = subs_syl.begin(); it != subs_syl.end(); ++it) {
+            if (word.indexOf(*it, 0, Qt::CaseInsensitive) != -1) {
+                word_syllables--;
             }
-            word.remove(final_e);
-            const QStringList syls = word.split(vowels, Qt::SkipEmptyParts);
-            int word_syllables = 0;
-            for (QStringList::ConstIterator it = subs_syl.begin(); it != subs_syl.end(); ++it) {
-                if (word.indexOf(*it, 0, Qt::CaseInsensitive) != -1) {
-                    word_syllables--;
-                }
-            }
-            for (auto &regexp : subs_syl_regexp) {
-                if (word.indexOf(regexp) != -1) {
-                    word_syllables--;
-                }
-            }
-            for (QStringList::ConstIterator it = add_syl.begin(); it != add_syl.end(); ++it) {
-                if (word.indexOf(*it, 0, Qt::CaseInsensitive) != -1) {
-                    word_syllables++;
-                }
-            }
-            for (auto &regexp : add_syl_regexp) {
-                if (word.indexOf(regexp) != -1) {
-                    word_syllables++;
-                }
+        }
+        for (auto &regexp : subs_syl_regexp) {
+            if (word.indexOf(regexp) != -1) {
+                word_syllables--;
             }
-            word_syllables += syls.count();
-            if (word_syllables == 0) {
-                word_syllables = 1;
+        }
+        for (QStringList::ConstIterator it = add_syl.begin(); it != add_syl.end(); ++it) {
+            if (word.indexOf(*it, 0, Qt::CaseInsensitive) != -1) {
+                word_syllables++;
             }
-            d->syllables += word_syllables;
         }
-
-        block = block.next();
-
-        // Sentence count
-        // Clean up for better result, destroys the original text but we only want to count
-        s = s.trimmed();
-        if (s.isEmpty()) {
-            continue;
+        for (auto &regexp : add_syl_regexp) {
+            if (word.indexOf(regexp) != -1) {
+                word_syllables++;
+            }
         }
-        QChar lastchar = s.at(s.length() - 1);
-        if (!s.isEmpty() && lastchar != QChar('.') && lastchar != QChar('?') && lastchar != QChar('!')) { // e.g. for headlines
-            s = s + '.';
+        word_syllables += syls.count();
+        if (word_syllables == 0) {
+            word_syllables = 1;
         }
-        s.replace(multiplePunctuation, "."); // count "..." as only one "."
-        s.replace(floatingPoint, "0,0"); // don't count floating point numbers as sentences
-        s.replace(acronyms, "*"); // don't count "U.S.A." as three sentences
-        for (int i = 0; i < s.length(); ++i) {
-            QChar ch = s[i];
-            if (ch == QChar('.') || ch == QChar('?') || ch == QChar('!')) {
-                ++d->sentences;
-            }
+        statistics.syllables += word_syllables;
+    }
+
+    // Sentence count
+    // Clean up for better result, destroys the original text but we only want to count
+    s = s.trimmed();
+    if (s.isEmpty()) {
+        return statistics;
+    }
+    QChar lastchar = s.at(s.length() - 1);
+    if (!s.isEmpty() && lastchar != QChar('.') && lastchar != QChar('?') && lastchar != QChar('!')) { // e.g. for headlines
+        s = s + '.';
+    }
+    s.replace(multiplePunctuation, "."); // count "..." as only one "."
+    s.replace(floatingPoint, "0,0"); // don't count floating point numbers as sentences
+    s.replace(acronyms, "*"); // don't count "U.S.A." as three sentences
+    for (int i = 0; i < s.length(); ++i) {
+        QChar ch = s[i];
+        if (ch == QChar('.') || ch == QChar('?') || ch == QChar('!')) {
+            ++statistics.sentences;
         }
     }
+    return statistics;
 }
 
 int KWDocumentStatistics::countCJKChars(const QString &text)
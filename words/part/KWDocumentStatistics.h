@@ -18,11 +18,16 @@ class QTextDocument;
 class KWDocument;
 
 class KWDocumentStatisticsPrivate;
+struct KWBlockStatistics;
+struct KWTextDocumentStatistics;
 
 /**
  * This class stores and compute statistics about a KWDocument
  * text content.
  * The @refreshed() signal must be listened to for the statistics to be enabled.
+ *
+ * The statistics of every paragraph are cached until its revision changes, so
+ * an update only has to count the paragraphs edited since the previous one.
  */
 class WORDS_EXPORT KWDocumentStatistics : public QObject
 {
@@ -65,7 +70,10 @@ Q_SIGNALS:
     void refreshed();
 
 private:
-    void computeStatistics(const QTextDocument &doc);
+    /// update @p statistics of @p doc for the paragraphs changed since the last call, and add up lines and paragraphs
+    void computeStatistics(const QTextDocument &doc, KWTextDocumentStatistics &statistics);
+    /// count the text statistics of a single paragraph
+    KWBlockStatistics computeStatistics(const QString &text);
     int countCJKChars(const QString &text);
     std::unique_ptr<KWDocumentStatisticsPrivate> d;
 
@@ -8,9 +8,46 @@
 #include "KWPageCacheManager.h"
 
 #include <QImage>
+#include <QPainter>
+#include <QPicture>
+#include <QRunnable>
+#include <QThreadPool>
+
+#include <algorithm>
+#include <functional>
 
 static const int MAX_TILE_SIZE = 1024;
 
+/// Rasterizes a recorded part of a page on the thread pool of the KWPageCacheManager
+class KWPageRenderJob : public QRunnable
+{
+public:
+    KWPageRenderJob(KWPageCacheManager *manager, const QPicture &picture, const QSize &size)
+        : m_manager(manager)
+        , m_picture(picture)
+        , m_size(size)
+    {
+    }
+
+    void run() override
+    {
+        QImage image(m_size, QImage::Format_RGB16);
+        image.fill(0xffff);
+        QPainter painter(&image);
+        m_picture.play(&painter);
+        painter.end();
+        QMetaObject::invokeMethod(m_manager, std::bind(finished, image), Qt::QueuedConnection);
+    }
+
+    /// called on the thread of the manager with the rendered image
+    std::function<void(const QImage &)> finished;
+
+private:
+    KWPageCacheManager *m_manager;
+    QPicture m_picture;
+    QSize m_size;
+};
+
 /*
 KWPageCache::KWPageCache(KWPageCacheManager *manager, QImage *img)
     : m_manager(manager), cache(img), allExposed(true)
@@ -24,6 +61,7 @@ KWPageCache::KWPageCache(KWPageCacheManager *manager, int w, int h)
     , m_tilesy(1)
     , m_size(w, h)
     , allExposed(true)
+    , generation(0)
 {
     if (w > MAX_TILE_SIZE || h > MAX_TILE_SIZE) {
         m_tilesx = w / MAX_TILE_SIZE;
@@ -43,34 +81,156 @@ KWPageCache::KWPageCache(KWPageCacheManager *manager, int w, int h)
     } else {
         cache.push_back(QImage(w, h, QImage::Format_RGB16));
     }
+    for (QImage &tile : cache) {
+        tile.fill(0xffff);
+    }
 }
 
 KWPageCache::~KWPageCache() = default;
 
+void KWPageCache::invalidate()
+{
+    allExposed = true;
+    exposed.clear();
+    ++generation;
+}
+
+void KWPageCache::fillFrom(const KWPageCache &other)
+{
+    const qreal sx = qreal(m_size.width()) / other.m_size.width();
+    const qreal sy = qreal(m_size.height()) / other.m_size.height();
+    int tilex = 0, tiley = 0;
+    for (int x = 0, i = 0; x < m_tilesx; ++x) {
+        int dx = cache[i].width();
+        for (int y = 0; y < m_tilesy; ++y, ++i) {
+            QImage &tileImg = cache[i];
+            QPainter painter(&tileImg);
+            painter.translate(-tilex, -tiley);
+            painter.scale(sx, sy);
+            int otherx = 0, othery = 0;
+            for (int ox = 0, j = 0; ox < other.m_tilesx; ++ox) {
+                int odx = other.cache[j].width();
+                for (int oy = 0; oy < other.m_tilesy; ++oy, ++j) {
+                    painter.drawImage(QPoint(otherx, othery), other.cache[j]);
+                    othery += other.cache[j].height();
+                }
+                otherx += odx;
+                othery = 0;
+            }
+            tiley += tileImg.height();
+        }
+        tilex += dx;
+        tiley = 0;
+    }
+}
+
+void KWPageCache::paintImage(const QPoint &position, const QImage &image)
+{
+    const QRect r(position, image.size());
+    int tilex = 0, tiley = 0;
+    for (int x = 0, i = 0; x < m_tilesx; ++x) {
+        int dx = cache[i].width();
+        for (int y = 0; y < m_tilesy; ++y, ++i) {
+            QImage &tileImg = cache[i];
+            QRect tile(tilex, tiley, tileImg.width(), tileImg.height());
+            if (tile.intersects(r)) {
+                QPainter imagePainter(&tileImg);
+                imagePainter.drawImage(r.topLeft() - QPoint(tilex, tiley), image);
+            }
+            tiley += tileImg.height();
+        }
+        tilex += dx;
+        tiley = 0;
+    }
+}
+
+qint64 KWPageCache::byteCount() const
+{
+    qint64 bytes = 0;
+    for (const QImage &tile : cache) {
+        bytes += tile.sizeInBytes();
+    }
+    return bytes;
+}
+
 KWPageCacheManager::KWPageCacheManager(int cacheSize)
-    : m_cache(cacheSize)
+    : m_cache(qMax(1, cacheSize) * 1024)
+    , m_pool(new QThreadPool(this))
 {
 }
 
 KWPageCacheManager::~KWPageCacheManager()
 {
+    // renderings finishing now can't reach us anymore, as their queued calls die with us
+    m_pool->clear();
+    m_pool->waitForDone();
     clear();
 }
 
-KWPageCache *KWPageCacheManager::take(const KWPage &page)
+KWPageCache *KWPageCacheManager::take(const KWPage &page, qreal zoom)
 {
-    KWPageCache *cache = nullptr;
-    if (m_cache.contains(page)) {
-        cache = m_cache.take(page);
+    return m_cache.take(Key{page, zoom});
+}
+
+void KWPageCacheManager::insert(const KWPage &page, qreal zoom, KWPageCache *cache)
+{
+    // the cost is in kilobytes; make sure always at least two pages can be cached
+    m_cache.insert(Key{page, zoom}, cache, qMin<qint64>(m_cache.maxCost() / 2, cache->byteCount() / 1024));
+}
+
+bool KWPageCacheManager::contains(const KWPage &page, qreal zoom) const
+{
+    return m_cache.contains(Key{page, zoom});
+}
+
+void KWPageCacheManager::invalidate(const KWPage &page)
+{
+    const QList<Key> keys = m_cache.keys();
+    for (const Key &key : keys) {
+        if (key.page == page) {
+            m_cache.object(key)->invalidate();
+        }
     }
-    return cache;
 }
 
-void KWPageCacheManager::insert(const KWPage &page, KWPageCache *cache)
+const KWPageCache *KWPageCacheManager::placeholder(const KWPage &page, qreal zoom) const
+{
+    // prefer the smallest zoom level above the requested one, so the placeholder is downscaled
+    auto better = [zoom](qreal candidate, qreal current) {
+        if ((candidate >= zoom) != (current >= zoom)) {
+            return candidate >= zoom;
+        }
+        return candidate >= zoom ? candidate < current : candidate > current;
+    };
+    const KWPageCache *best = nullptr;
+    qreal bestZoom = 0.0;
+    const QList<Key> keys = m_cache.keys();
+    for (const Key &key : keys) {
+        if (key.page != page || key.zoom == zoom) {
+            continue;
+        }
+        if (!best || better(key.zoom, bestZoom)) {
+            best = m_cache.object(key);
+            bestZoom = key.zoom;
+        }
+    }
+    return best;
+}
+
+QList<KWPage> KWPageCacheManager::pagesToPrefetch(const QList<KWPage> &visiblePages, qreal zoom) const
 {
-    QSize size = cache->m_size;
-    // make sure always at least two pages can be cached
-    m_cache.insert(page, cache, qMin(m_cache.maxCost() / 2, size.width() * size.height()));
+    QList<KWPage> pages;
+    if (visiblePages.isEmpty()) {
+        return pages;
+    }
+    // the pages next to the visible ones are the ones shown next when scrolling
+    const auto range = std::minmax_element(visiblePages.constBegin(), visiblePages.constEnd());
+    for (const KWPage &page : {range.first->previous(), range.second->next()}) {
+        if (page.isValid() && !contains(page, zoom)) {
+            pages.append(page);
+        }
+    }
+    return pages;
 }
 
 KWPageCache *KWPageCacheManager::cache(const QSize &size)
@@ -82,6 +242,26 @@ KWPageCache *KWPageCacheManager::cache(const QSize &size)
     return cache;
 }
 
+void KWPageCacheManager::render(const KWPage &page, qreal zoom, const KWPageCache *cache, const QRect &rect, const QPicture &picture)
+{
+    KWPageRenderJob *job = new KWPageRenderJob(this, picture, rect.size());
+    const int generation = cache->generation;
+    job->finished = [this, page, zoom, generation, rect](const QImage &image) {
+        renderFinished(page, zoom, generation, rect, image);
+    };
+    m_pool->start(job);
+}
+
+void KWPageCacheManager::renderFinished(const KWPage &page, qreal zoom, int generation, const QRect &rect, const QImage &image)
+{
+    KWPageCache *cache = m_cache.object(Key{page, zoom});
+    if (!cache || cache->generation != generation) {
+        return; // dropped or invalidated in between, a new rendering is on the way
+    }
+    cache->paintImage(rect.topLeft(), image);
+    Q_EMIT pageRendered(page, zoom, rect);
+}
+
 void KWPageCacheManager::clear()
 {
     m_cache.clear();
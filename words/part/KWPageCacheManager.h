@@ -8,15 +8,19 @@
 #define KWPAGECACHEMANAGER_H
 
 #include "KWPage.h"
+#include "words_export.h"
 // Qt
 #include <QCache>
 #include <QImage>
+#include <QObject>
 
 class QSize;
+class QPicture;
+class QThreadPool;
 
 class KWPageCacheManager;
 
-class KWPageCache
+class WORDS_TEST_EXPORT KWPageCache
 {
 public:
     /// create a pagecache object with the existing
@@ -26,6 +30,18 @@ public:
     KWPageCache(KWPageCacheManager *manager, int w, int h);
     ~KWPageCache();
 
+    /// Mark the whole page to be repainted and drop renderings still in progress
+    void invalidate();
+
+    /// Paint a scaled version of @p other into the tiles, shown until the real content is rendered
+    void fillFrom(const KWPageCache &other);
+
+    /// Paint @p image with its top left corner at @p position (in page coordinates) into the tiles
+    void paintImage(const QPoint &position, const QImage &image);
+
+    /// return the memory used by the tiles in bytes
+    qint64 byteCount() const;
+
     KWPageCacheManager *m_manager;
     QVector<QImage> cache;
     int m_tilesx, m_tilesy;
@@ -36,26 +52,82 @@ public:
     QVector<QRect> exposed;
     // true if the whole page should be repainted
     bool allExposed;
+    // increased with every invalidate(), renderings of an older generation are dropped
+    int generation;
 };
 
-class KWPageCacheManager
+/**
+ * Caches the rendered pages of a canvas at one or more zoom levels.
+ *
+ * The least recently used pages are dropped once the memory budget is used up,
+ * independent of the zoom level they were rendered at, so after zooming back the
+ * previous renderings are still available and others can serve as placeholders.
+ *
+ * Rasterizing the pages is done on a thread pool. The canvas records what to paint
+ * in a QPicture on the GUI thread (the shapes are not thread-safe), the replay of it
+ * into an image happens on the pool and pageRendered() is emitted once the result
+ * got copied into the tiles of the page.
+ */
+class WORDS_TEST_EXPORT KWPageCacheManager : public QObject
 {
+    Q_OBJECT
 public:
+    /// @param cacheSize the memory budget in megabytes
     explicit KWPageCacheManager(int cacheSize);
 
-    ~KWPageCacheManager();
+    ~KWPageCacheManager() override;
+
+    KWPageCache *take(const KWPage &page, qreal zoom);
 
-    KWPageCache *take(const KWPage &page);
+    void insert(const KWPage &page, qreal zoom, KWPageCache *cache);
 
-    void insert(const KWPage &page, KWPageCache *cache);
+    /// return true if there is a cache for @p page at @p zoom
+    bool contains(const KWPage &page, qreal zoom) const;
+
+    /// mark @p page to be repainted at all zoom levels, the old content is shown until then
+    void invalidate(const KWPage &page);
+
+    /// return a cache of @p page at any other zoom level to be used as placeholder, or nullptr
+    const KWPageCache *placeholder(const KWPage &page, qreal zoom) const;
+
+    /// return the pages next to @p visiblePages that are not cached at @p zoom yet, to be rendered in advance
+    QList<KWPage> pagesToPrefetch(const QList<KWPage> &visiblePages, qreal zoom) const;
 
     KWPageCache *cache(const QSize &size);
 
+    /**
+     * Rasterize @p picture on the thread pool and paint it into @p rect (in page coordinates)
+     * of @p cache, the cache of @p page at @p zoom, unless that got invalidated in between.
+     */
+    void render(const KWPage &page, qreal zoom, const KWPageCache *cache, const QRect &rect, const QPicture &picture);
+
     void clear();
 
+Q_SIGNALS:
+    /// emitted once @p rect (in page coordinates) of the cache of @p page at @p zoom got rendered
+    void pageRendered(const KWPage &page, qreal zoom, const QRect &rect);
+
 private:
-    QCache<KWPage, KWPageCache> m_cache;
+    struct Key {
+        KWPage page;
+        qreal zoom;
+
+        bool operator==(const Key &other) const
+        {
+            return page == other.page && zoom == other.zoom;
+        }
+    };
+    friend size_t qHash(const Key &key, size_t seed)
+    {
+        return qHashMulti(seed, key.page.hash(), key.zoom);
+    }
+
+    void renderFinished(const KWPage &page, qreal zoom, int generation, const QRect &rect, const QImage &image);
+
+    QCache<Key, KWPageCache> m_cache;
+    QThreadPool *m_pool;
     friend class KWPageCache;
+    friend class TestPageCacheManager;
 };
 
 #endif
@@ -168,6 +168,10 @@ void KWTextFrameSet::setupDocument()
     // the KoTextDocumentLayout needs to be setup after the actions above are done to prepare the document
     KoTextDocumentLayout *lay = new KoTextDocumentLayout(m_document, m_rootAreaProvider);
     lay->setWordprocessingMode();
+    if (m_textFrameSetType == Words::MainTextFrameSet) {
+        // long documents get layouted in slices so the first pages are shown and editable right away
+        lay->setBackgroundLayout(true);
+    }
 
     QObject::connect(lay,
                      &KoTextDocumentLayout::foundAnnotation,
@@ -0,0 +1,258 @@
+/* This file is part of the KDE project
+ * SPDX-FileCopyrightText: 2026 Calligra developers
+ *
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ */
+
+#include "TestPageCacheManager.h"
+
+#include <KWDocument.h>
+#include <KWPage.h>
+#include <KWPageCacheManager.h>
+
+#include "MockPart.h"
+
+#include <QPainter>
+#include <QPicture>
+#include <QThreadPool>
+#include <QtTest>
+
+static const QRgb white = qRgb(255, 255, 255);
+static const QRgb red = qRgb(255, 0, 0);
+static const QRgb blue = qRgb(0, 0, 255);
+
+// the color at @p x, @p y in page coordinates of the tiles of @p cache
+static QRgb pixel(const KWPageCache *cache, int x, int y)
+{
+    int tilex = 0, tiley = 0;
+    for (int tx = 0, i = 0; tx < cache->m_tilesx; ++tx) {
+        const int dx = cache->cache[i].width();
+        for (int ty = 0; ty < cache->m_tilesy; ++ty, ++i) {
+            const QImage &tile = cache->cache[i];
+            if (QRect(tilex, tiley, tile.width(), tile.height()).contains(x, y)) {
+                return tile.pixel(x - tilex, y - tiley);
+            }
+            tiley += tile.height();
+        }
+        tilex += dx;
+        tiley = 0;
+    }
+    return 0;
+}
+
+static QPicture filled(const QSize &size, const QColor &color)
+{
+    QPicture picture;
+    QPainter painter(&picture);
+    painter.fillRect(QRect(QPoint(0, 0), size), color);
+    painter.end();
+    return picture;
+}
+
+void TestPageCacheManager::waitForRenderings(KWPageCacheManager *manager)
+{
+    manager->m_pool->waitForDone();
+    // the results are handed over by queued calls
+    QCoreApplication::processEvents();
+}
+
+void TestPageCacheManager::testEviction()
+{
+    KWDocument doc(new MockPart);
+    QList<KWPage> pages;
+    for (int i = 0; i < 6; ++i) {
+        pages << doc.appendPage("Standard");
+    }
+
+    // a budget of 1 MB, a 400x400 page takes 312 kB and a 200x200 one 78 kB
+    KWPageCacheManager manager(1);
+    manager.insert(pages[0], 1.0, manager.cache(QSize(400, 400)));
+    manager.insert(pages[0], 0.5, manager.cache(QSize(200, 200)));
+    manager.insert(pages[1], 1.0, manager.cache(QSize(400, 400)));
+    manager.insert(pages[2], 1.0, manager.cache(QSize(400, 400)));
+    QVERIFY(manager.contains(pages[0], 1.0));
+    QVERIFY(manager.contains(pages[0], 0.5));
+
+    // using the first page makes it the most recently used one
+    KWPageCache *cache = manager.take(pages[0], 1.0);
+    QVERIFY(cache);
+    QVERIFY(!manager.contains(pages[0], 1.0));
+    manager.insert(pages[0], 1.0, cache);
+
+    // the least recently used page goes first, whatever its zoom level
+    manager.insert(pages[3], 0.5, manager.cache(QSize(200, 200)));
+    QVERIFY(!manager.contains(pages[0], 0.5));
+    QVERIFY(manager.contains(pages[0], 1.0));
+    QVERIFY(manager.contains(pages[1], 1.0));
+    QVERIFY(manager.contains(pages[2], 1.0));
+    QVERIFY(manager.contains(pages[3], 0.5));
+
+    manager.insert(pages[4], 1.0, manager.cache(QSize(400, 400)));
+    QVERIFY(!manager.contains(pages[1], 1.0));
+    QVERIFY(manager.contains(pages[0], 1.0));
+    QVERIFY(manager.contains(pages[2], 1.0));
+    QVERIFY(manager.contains(pages[3], 0.5));
+    QVERIFY(manager.contains(pages[4], 1.0));
+
+    // a page larger than the budget is still cached
+    manager.insert(pages[5], 4.0, manager.cache(QSize(1000, 1000)));
+    QVERIFY(manager.contains(pages[5], 4.0));
+
+    manager.clear();
+    QVERIFY(!manager.contains(pages[5], 4.0));
+    QVERIFY(!manager.contains(pages[0], 1.0));
+}
+
+void TestPageCacheManager::testRender()
+{
+    KWDocument doc(new MockPart);
+    KWPage page = doc.appendPage("Standard");
+
+    KWPageCacheManager manager(50);
+    QList<QRect> rendered;
+    QList<qreal> zooms;
+    connect(&manager, &KWPageCacheManager::pageRendered, this, [&rendered, &zooms, page](const KWPage &renderedPage, qreal zoom, const QRect &rect) {
+        if (renderedPage == page) {
+            rendered << rect;
+            zooms << zoom;
+        }
+    });
+
+    // the page is split into tiles, the rendered area covers all four of them
+    KWPageCache *cache = manager.cache(QSize(1500, 1200));
+    QCOMPARE(cache->m_tilesx, 2);
+    QCOMPARE(cache->m_tilesy, 2);
+    QCOMPARE(pixel(cache, 950, 950), white);
+    manager.insert(page, 1.5, cache);
+
+    const QRect rect(900, 900, 300, 250);
+    manager.render(page, 1.5, cache, rect, filled(rect.size(), Qt::red));
+    QVERIFY(rendered.isEmpty());
+    waitForRenderings(&manager);
+
+    QCOMPARE(rendered, QList<QRect>() << rect);
+    QCOMPARE(zooms, QList<qreal>() << 1.5);
+    QCOMPARE(pixel(cache, 950, 950), red);
+    QCOMPARE(pixel(cache, 1100, 950), red);
+    QCOMPARE(pixel(cache, 950, 1100), red);
+    QCOMPARE(pixel(cache, 1100, 1100), red);
+    QCOMPARE(pixel(cache, 899, 950), white);
+    QCOMPARE(pixel(cache, 1200, 1100), white);
+    QCOMPARE(pixel(cache, 1100, 1150), white);
+
+    // a page which is not in the cache any more is not painted
+    cache = manager.take(page, 1.5);
+    manager.render(page, 1.5, cache, rect, filled(rect.size(), Qt::blue));
+    waitForRenderings(&manager);
+    QCOMPARE(rendered.count(), 1);
+    QCOMPARE(pixel(cache, 950, 950), red);
+    delete cache;
+}
+
+void TestPageCacheManager::testInvalidate()
+{
+    KWDocument doc(new MockPart);
+    KWPage page = doc.appendPage("Standard");
+    KWPage otherPage = doc.appendPage("Standard");
+
+    KWPageCacheManager manager(50);
+    QList<QRect> rendered;
+    connect(&manager, &KWPageCacheManager::pageRendered, this, [&rendered](const KWPage &, qreal, const QRect &rect) {
+        rendered << rect;
+    });
+
+    KWPageCache *cache = manager.cache(QSize(300, 400));
+    cache->allExposed = false;
+    manager.insert(page, 1.0, cache);
+    KWPageCache *otherZoom = manager.cache(QSize(150, 200));
+    otherZoom->allExposed = false;
+    manager.insert(page, 0.5, otherZoom);
+    KWPageCache *otherCache = manager.cache(QSize(300, 400));
+    otherCache->allExposed = false;
+    manager.insert(otherPage, 1.0, otherCache);
+
+    // the page is edited while it is rendered, that result is outdated
+    const QRect staleRect(0, 0, 100, 100);
+    manager.render(page, 1.0, cache, staleRect, filled(staleRect.size(), Qt::red));
+    manager.invalidate(page);
+    const QRect rect(100, 100, 100, 100);
+    manager.render(page, 1.0, cache, rect, filled(rect.size(), Qt::blue));
+    waitForRenderings(&manager);
+
+    QCOMPARE(rendered, QList<QRect>() << rect);
+    QCOMPARE(pixel(cache, 50, 50), white);
+    QCOMPARE(pixel(cache, 150, 150), blue);
+
+    // all zoom levels of the page have to be repainted, the content stays until then
+    QVERIFY(cache->allExposed);
+    QVERIFY(otherZoom->allExposed);
+    QVERIFY(!otherCache->allExposed);
+    QVERIFY(manager.contains(page, 1.0));
+    QVERIFY(manager.contains(page, 0.5));
+}
+
+void TestPageCacheManager::testPlaceholder()
+{
+    KWDocument doc(new MockPart);
+    KWPage page = doc.appendPage("Standard");
+    KWPage otherPage = doc.appendPage("Standard");
+
+    KWPageCacheManager manager(50);
+    QVERIFY(!manager.placeholder(page, 1.0));
+
+    // the left half of the page is red at 50%
+    KWPageCache *small = manager.cache(QSize(100, 150));
+    QImage half(50, 150, QImage::Format_RGB16);
+    half.fill(Qt::red);
+    small->paintImage(QPoint(0, 0), half);
+    manager.insert(page, 0.5, small);
+    KWPageCache *large = manager.cache(QSize(400, 600));
+    manager.insert(page, 2.0, large);
+    KWPageCache *larger = manager.cache(QSize(600, 900));
+    manager.insert(page, 3.0, larger);
+
+    // a larger zoom level is preferred, the smallest of them
+    QCOMPARE(manager.placeholder(page, 1.0), large);
+    QCOMPARE(manager.placeholder(page, 2.5), larger);
+    // otherwise the largest of the smaller ones
+    QCOMPARE(manager.placeholder(page, 4.0), larger);
+    QCOMPARE(manager.placeholder(page, 0.25), small);
+    // never the page at the requested zoom level itself
+    QCOMPARE(manager.placeholder(page, 2.0), larger);
+    QVERIFY(!manager.placeholder(otherPage, 1.0));
+
+    // the placeholder is scaled to the new size
+    KWPageCache *cache = manager.cache(QSize(200, 300));
+    cache->fillFrom(*small);
+    QCOMPARE(pixel(cache, 10, 10), red);
+    QCOMPARE(pixel(cache, 90, 290), red);
+    QCOMPARE(pixel(cache, 110, 10), white);
+    QCOMPARE(pixel(cache, 190, 290), white);
+    delete cache;
+}
+
+void TestPageCacheManager::testPrefetch()
+{
+    KWDocument doc(new MockPart);
+    QList<KWPage> pages;
+    for (int i = 0; i < 5; ++i) {
+        pages << doc.appendPage("Standard");
+    }
+
+    KWPageCacheManager manager(50);
+    QVERIFY(manager.pagesToPrefetch(QList<KWPage>(), 1.0).isEmpty());
+
+    // the pages before and after the visible ones, in any order
+    QCOMPARE(manager.pagesToPrefetch(QList<KWPage>() << pages[2] << pages[1], 1.0), QList<KWPage>() << pages[0] << pages[3]);
+    QCOMPARE(manager.pagesToPrefetch(QList<KWPage>() << pages[0], 1.0), QList<KWPage>() << pages[1]);
+    QCOMPARE(manager.pagesToPrefetch(QList<KWPage>() << pages[4] << pages[3], 1.0), QList<KWPage>() << pages[2]);
+    QVERIFY(manager.pagesToPrefetch(pages, 1.0).isEmpty());
+
+    // pages cached at the zoom level are not rendered again
+    manager.insert(pages[0], 1.0, manager.cache(QSize(100, 100)));
+    manager.insert(pages[3], 0.5, manager.cache(QSize(50, 50)));
+    QCOMPARE(manager.pagesToPrefetch(QList<KWPage>() << pages[1] << pages[2], 1.0), QList<KWPage>() << pages[3]);
+    QCOMPARE(manager.pagesToPrefetch(QList<KWPage>() << pages[1] << pages[2], 0.5), QList<KWPage>() << pages[0]);
+}
+
+QTEST_MAIN(TestPageCacheManager)
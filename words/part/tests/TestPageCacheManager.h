@@ -0,0 +1,28 @@
+/* This file is part of the KDE project
+ * SPDX-FileCopyrightText: 2026 Calligra developers
+ *
+ * SPDX-License-Identifier: LGPL-2.0-or-later
+ */
+
+#ifndef TESTPAGECACHEMANAGER_H
+#define TESTPAGECACHEMANAGER_H
+
+#include <QObject>
+
+class KWPageCacheManager;
+
+class TestPageCacheManager : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS: // tests
+    void testEviction();
+    void testRender();
+    void testInvalidate();
+    void testPlaceholder();
+    void testPrefetch();
+
+private:
+    void waitForRenderings(KWPageCacheManager *manager);
+};
+
+#endif
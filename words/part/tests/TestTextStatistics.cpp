@@ -19,6 +19,8 @@
 
 #include <QApplication>
 #include <QSignalSpy>
+#include <QTextBlock>
+#include <QTextCursor>
 #include <QTextDocument>
 #include <QThread>
 
@@ -84,4 +86,61 @@ void TestTextStatistics::testListenBehaviour()
     QCOMPARE(stats->lines(), 1);
 }
 
+void TestTextStatistics::testIncrementalUpdate()
+{
+    KWDocument doc(new MockPart);
+    QSignalSpy spy(doc.statistics(), &KWDocumentStatistics::refreshed);
+
+    doc.initEmpty();
+    QTextDocument *textDocument = doc.mainFrameSet()->document();
+    textDocument->setHtml(
+        "<html><body><p>The first paragraph has some words.</p>"
+        "<p>The second one is going away. Really.</p>"
+        "<p>A third paragraph, which gets edited.</p></body></html>");
+
+    qApp->processEvents();
+    QThread::sleep(3);
+    qApp->processEvents();
+    QCOMPARE(spy.count(), 1);
+    const auto stats = doc.statistics();
+    QCOMPARE(stats->paragraphs(), 3);
+    QCOMPARE(stats->words(), 19);
+    QCOMPARE(stats->sentences(), 4);
+
+    // only the edited paragraphs are counted again, the totals have to match a full count
+    QTextCursor cursor(textDocument->findBlockByNumber(1));
+    cursor.select(QTextCursor::BlockUnderCursor);
+    cursor.removeSelectedText();
+    cursor = QTextCursor(textDocument->lastBlock());
+    cursor.movePosition(QTextCursor::EndOfBlock);
+    cursor.insertText(" Now with another sentence.");
+    cursor.insertBlock();
+    cursor.insertText("And a new last paragraph");
+
+    qApp->processEvents();
+    QThread::sleep(3);
+    qApp->processEvents();
+    QCOMPARE(spy.count(), 2);
+
+    KWDocument reference(new MockPart);
+    QSignalSpy referenceSpy(reference.statistics(), &KWDocumentStatistics::refreshed);
+    reference.initEmpty();
+    reference.mainFrameSet()->document()->setHtml(
+        "<html><body><p>The first paragraph has some words.</p>"
+        "<p>A third paragraph, which gets edited. Now with another sentence.</p>"
+        "<p>And a new last paragraph</p></body></html>");
+    qApp->processEvents();
+    QThread::sleep(3);
+    qApp->processEvents();
+    QCOMPARE(referenceSpy.count(), 1);
+    const auto referenceStats = reference.statistics();
+
+    QCOMPARE(stats->paragraphs(), 3);
+    QCOMPARE(stats->words(), referenceStats->words());
+    QCOMPARE(stats->sentences(), referenceStats->sentences());
+    QCOMPARE(stats->syllables(), referenceStats->syllables());
+    QCOMPARE(stats->charsWithSpace(), referenceStats->charsWithSpace());
+    QCOMPARE(stats->charsWithoutSpace(), referenceStats->charsWithoutSpace());
+}
+
 QTEST_MAIN(TestTextStatistics)
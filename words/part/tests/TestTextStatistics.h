@@ -15,6 +15,7 @@ class TestTextStatistics : public QObject
 private Q_SLOTS: // tests
     void testTextStatistics();
     void testListenBehaviour();
+    void testIncrementalUpdate();
 };
 
 #endif